@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 
 /*
  Hardware Configuration
@@ -19,5 +20,20 @@ namespace hw_config {
     // Tile density threshold for dense/sparse classification
     // Tiles with density >= DENSE_TILE_THRESHOLD are classified as dense, else sparse
     constexpr double DENSE_TILE_THRESHOLD = 0.05;  
+    
+    // Transposed SpMM (X^T * M): upper bound on the total size of thread-private
+    // output buffers before switching to a cached X^T
+    constexpr size_t TRANSPOSE_PRIVATE_BUFFER_BYTES = size_t(256) << 20;  // 256 MiB
+    
+    // SpGEMM: width of the B column panels, i.e. the per-thread dense accumulator size
+    constexpr int SPGEMM_PANEL_COLS = 32768;  // 128 KiB of float accumulators
+    
+    // Heavy-row hybrid SpMM: rows with nnz >= HEAVY_ROW_FRACTION * ncols (genes expressed
+    // in most cells) are computed as a dense block split across all threads
+    constexpr double HEAVY_ROW_FRACTION = 0.3;
+    
+    // Memory allocation for large arrays (CSR, W, Y)
+    constexpr size_t SIMD_ALIGNMENT = 64;                        // AVX-512 vector width in bytes
+    constexpr size_t HUGE_PAGE_BYTES = size_t(2) << 20;          // x86-64 huge page size (2 MiB)
+    constexpr size_t HUGE_PAGE_MIN_BYTES = size_t(2) << 20;      // Smaller arrays stay on 4 KiB pages
 }
-
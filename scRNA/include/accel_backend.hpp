@@ -0,0 +1,81 @@
+#pragma once
+#include "../config/hw_config.h"
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+/*
+ * Accelerator backend interface for the tile router
+ *
+ * process_tiles_with_predictor sends dense tiles to cuBLAS only when built with USE_CUDA.
+ * AccelBackend makes the dense path pluggable. The router prepares a dense tile on the host
+ * (materialise, permute), submits the GEMM, and keeps working on sparse tiles while the
+ * backend runs it. Tile results are still folded into Y in tile order, so Y does not depend
+ * on when the device finishes.
+ *
+ * The interface is header-only and pure virtual, so tile_spmm.cpp does not link any backend.
+ * Implementations:
+ *   SimulatedAccelerator (sim_accelerator.hpp) - worker threads plus a transfer / FLOP-rate
+ *                                                timing model, for CPU-only hosts
+ */
+
+typedef uint64_t AccelTicket;
+
+/* Counters and modelled times since the last reset_stats() */
+struct AccelStats {
+    size_t jobs = 0;
+    size_t bytes_h2d = 0;
+    size_t bytes_d2h = 0;
+    double flops = 0.0;
+    double h2d_ms = 0.0;            // Modelled host -> device transfer time (sum over jobs)
+    double compute_ms = 0.0;        // Modelled kernel time (sum over jobs)
+    double d2h_ms = 0.0;            // Modelled device -> host transfer time (sum over jobs)
+    double makespan_ms = 0.0;       // First submit to last modelled completion
+    double host_compute_ms = 0.0;   // Time the backend actually spent computing on the host
+    size_t late_jobs = 0;           // Jobs whose host computation ran past the modelled completion
+};
+
+class AccelBackend {
+public:
+    virtual ~AccelBackend() = default;
+
+    virtual string name() const = 0;
+
+    /**
+     * Queue Y = X * W on the device. Returns at once; the buffers must stay valid
+     * (and Y untouched) until poll() or wait() reports the ticket complete.
+     *
+     * @param X Dense matrix (row-major, M x K)
+     * @param W Dense matrix (row-major, K x N)
+     * @param Y Output (row-major, M x N); overwritten
+     */
+    virtual AccelTicket submit_gemm(const float* X, const float* W, float* Y, int M, int K, int N) = 0;
+
+    /**
+     * true once the job behind ticket has completed (never blocks).
+     */
+    virtual bool poll(AccelTicket ticket) = 0;
+
+    /**
+     * Block until the job behind ticket has completed.
+     */
+    virtual void wait(AccelTicket ticket) = 0;
+
+    /**
+     * Block until every submitted job has completed.
+     */
+    virtual void synchronize() = 0;
+
+    virtual AccelStats stats() const = 0;
+    virtual void reset_stats() = 0;
+};
+
+/* How process_tiles_with_predictor uses a backend */
+struct AccelRouting {
+    AccelBackend* backend = nullptr;                          // nullptr: dense tiles stay on the CPU / CUDA path
+    double threshold = hw_config::DENSE_TILE_THRESHOLD;       // Tiles with density >= threshold are offloaded
+    bool overlap = true;                                      // false: wait for each device tile before the next tile
+    int max_in_flight = 8;                                    // Tiles queued behind the oldest device tile before the router waits
+};
@@ -11,7 +11,7 @@ $CXX = "g++"
 $CXXFLAGS = "-std=c++17 -O3 -Wall -fopenmp -I../include"
 
 # Source files (from source/ directory)
-$SOURCES = @("../source/main.cpp", "../source/disk_to_memory.cpp", "../source/spmm_baseline.cpp")
+$SOURCES = @("../source/main.cpp", "../source/disk_to_memory.cpp", "../source/spmm_baseline.cpp", "../source/incremental_spmm.cpp", "../source/y_writer.cpp")
 $OUTPUT = "../build/run4.exe"
 $ALT_OUTPUT = "../build/run0.exe"
 
@@ -22,7 +22,7 @@ Write-Host "Compiling..." -ForegroundColor Yellow
 $hdf5Flags = pkg-config --cflags --libs hdf5
 
 # Build command (add -lhdf5_cpp for C++ API)
-$buildCmd = "$CXX $CXXFLAGS $($SOURCES -join ' ') -o $OUTPUT $hdf5Flags -lhdf5_cpp"
+$buildCmd = "$CXX $CXXFLAGS $($SOURCES -join ' ') -o $OUTPUT $hdf5Flags -lhdf5_cpp -lz"
 
 Write-Host $buildCmd -ForegroundColor Gray
 Write-Host ""
@@ -34,6 +34,7 @@ if ($LASTEXITCODE -eq 0) {
     Write-Host ""
     Write-Host "Usage: .\..\build\run4.exe X_file.h5 W_file.h5" -ForegroundColor Cyan
     Write-Host "Example: .\..\build\run4.exe d0.h5 w0.h5" -ForegroundColor Yellow
+    Write-Host "Append cells: .\..\build\run4.exe --append base_X_file.h5 delta_X_file.h5 W_file.h5" -ForegroundColor Cyan
 } else {
     Write-Host "Build failed!" -ForegroundColor Red
     exit $LASTEXITCODE
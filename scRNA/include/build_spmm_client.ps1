@@ -0,0 +1,36 @@
+
+# Build script for the resident SpMM service client (requests + benchmark)
+# Usage: .\build_spmm_client.ps1
+
+Write-Host "========================================" -ForegroundColor Cyan
+Write-Host "Building SpMM Service Client (spmm_client)" -ForegroundColor Cyan
+Write-Host "========================================" -ForegroundColor Cyan
+Write-Host ""
+
+# Compiler settings
+$CXX = "g++"
+$CXXFLAGS = "-std=c++17 -O3 -Wall -pthread -I../include"
+
+# Source files
+$SOURCES = @("../source/spmm_client_main.cpp", "../source/spmm_client.cpp")
+$OUTPUT = "../build/spmm_client.exe"
+
+Write-Host "Compiling..." -ForegroundColor Yellow
+
+# Build command (no HDF5: the client only talks to the socket)
+$buildCmd = "$CXX $CXXFLAGS $($SOURCES -join ' ') -o $OUTPUT"
+
+Write-Host $buildCmd -ForegroundColor Gray
+Write-Host ""
+
+Invoke-Expression $buildCmd
+
+if ($LASTEXITCODE -eq 0) {
+    Write-Host "Build successful!" -ForegroundColor Green
+    Write-Host ""
+    Write-Host "Usage: .\..\build\spmm_client.exe <socket_path> ping|stats|shutdown|project <w_spec> <out>|bench <w_spec> <requests> <concurrency> [one_shot_command]" -ForegroundColor Cyan
+    Write-Host "Example: .\..\build\spmm_client.exe /tmp/scrna_spmm.sock bench seed:1:32 200 4" -ForegroundColor Yellow
+} else {
+    Write-Host "Build failed!" -ForegroundColor Red
+    exit $LASTEXITCODE
+}
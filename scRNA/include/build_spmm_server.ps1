@@ -0,0 +1,39 @@
+
+# Build script for the resident SpMM service (server)
+# Usage: .\build_spmm_server.ps1
+
+Write-Host "========================================" -ForegroundColor Cyan
+Write-Host "Building Resident SpMM Server (spmm_server)" -ForegroundColor Cyan
+Write-Host "========================================" -ForegroundColor Cyan
+Write-Host ""
+
+# Compiler settings
+$CXX = "g++"
+$CXXFLAGS = "-std=c++17 -O3 -Wall -fopenmp -pthread -I../include"
+
+# Source files
+$SOURCES = @("../source/spmm_server_main.cpp", "../source/spmm_server.cpp", "../source/disk_to_memory.cpp", "../source/spmm_baseline.cpp", "../source/incremental_spmm.cpp")
+$OUTPUT = "../build/spmm_server.exe"
+
+Write-Host "Compiling..." -ForegroundColor Yellow
+
+# Get HDF5 flags from pkg-config
+$hdf5Flags = pkg-config --cflags --libs hdf5
+
+# Build command
+$buildCmd = "$CXX $CXXFLAGS $($SOURCES -join ' ') -o $OUTPUT $hdf5Flags -lhdf5_cpp"
+
+Write-Host $buildCmd -ForegroundColor Gray
+Write-Host ""
+
+Invoke-Expression $buildCmd
+
+if ($LASTEXITCODE -eq 0) {
+    Write-Host "Build successful!" -ForegroundColor Green
+    Write-Host ""
+    Write-Host "Usage: .\..\build\spmm_server.exe <X_file.h5> [socket_path] [max_batch] [batch_window_ms]" -ForegroundColor Cyan
+    Write-Host "Example: .\..\build\spmm_server.exe d4.h5 /tmp/scrna_spmm.sock 8 2" -ForegroundColor Yellow
+} else {
+    Write-Host "Build failed!" -ForegroundColor Red
+    exit $LASTEXITCODE
+}
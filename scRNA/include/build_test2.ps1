@@ -11,7 +11,7 @@ $CXX = "g++"
 $CXXFLAGS = "-std=c++17 -O3 -Wall -I../include"
 
 # Source files
-$SOURCES = @("../source/test2_perm_tiled_spmm.cpp", "../source/disk_to_memory.cpp", "../source/tiler.cpp", "../source/permutation.cpp", "../source/spmm.cpp", "../source/spmm_baseline.cpp")
+$SOURCES = @("../source/test2_perm_tiled_spmm.cpp", "../source/disk_to_memory.cpp", "../source/tiler.cpp", "../source/permutation.cpp", "../source/spmm.cpp", "../source/spmm_baseline.cpp", "../source/y_writer.cpp")
 $OUTPUT = "../build/run2.exe"
 
 Write-Host "Compiling..." -ForegroundColor Yellow
@@ -20,7 +20,7 @@ Write-Host "Compiling..." -ForegroundColor Yellow
 $hdf5Flags = pkg-config --cflags --libs hdf5
 
 # Build command
-$buildCmd = "$CXX $CXXFLAGS $($SOURCES -join ' ') -o $OUTPUT $hdf5Flags -lhdf5_cpp"
+$buildCmd = "$CXX $CXXFLAGS $($SOURCES -join ' ') -o $OUTPUT $hdf5Flags -lhdf5_cpp -lz"
 
 Write-Host $buildCmd -ForegroundColor Gray
 Write-Host ""
@@ -0,0 +1,39 @@
+
+# Build script for simulated accelerator backend test
+# Usage: .\build_test_accel_backend.ps1
+
+Write-Host "========================================" -ForegroundColor Cyan
+Write-Host "Building Simulated Accelerator Backend Test (test_accel_backend)" -ForegroundColor Cyan
+Write-Host "========================================" -ForegroundColor Cyan
+Write-Host ""
+
+# Compiler settings
+$CXX = "g++"
+$CXXFLAGS = "-std=c++17 -O3 -Wall -fopenmp -pthread -I../include"
+
+# Source files
+$SOURCES = @("../source/test_accel_backend.cpp", "../source/sim_accelerator.cpp", "../source/tile_spmm.cpp", "../source/tiler.cpp", "../source/permutation.cpp", "../source/spmm.cpp", "../source/spmm_baseline.cpp", "../source/dense_spmm.cpp", "../source/disk_to_memory.cpp")
+$OUTPUT = "../build/test_accel_backend.exe"
+
+Write-Host "Compiling..." -ForegroundColor Yellow
+
+# Get HDF5 flags from pkg-config
+$hdf5Flags = pkg-config --cflags --libs hdf5
+
+# Build command
+$buildCmd = "$CXX $CXXFLAGS $($SOURCES -join ' ') -o $OUTPUT $hdf5Flags -lhdf5_cpp"
+
+Write-Host $buildCmd -ForegroundColor Gray
+Write-Host ""
+
+Invoke-Expression $buildCmd
+
+if ($LASTEXITCODE -eq 0) {
+    Write-Host "Build successful!" -ForegroundColor Green
+    Write-Host ""
+    Write-Host "Usage: .\..\build\test_accel_backend.exe <X_file.h5> <W_file.h5> [streams]" -ForegroundColor Cyan
+    Write-Host "Example: .\..\build\test_accel_backend.exe d4.h5 w4.h5 2" -ForegroundColor Yellow
+} else {
+    Write-Host "Build failed!" -ForegroundColor Red
+    exit $LASTEXITCODE
+}
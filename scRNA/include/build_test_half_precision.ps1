@@ -0,0 +1,39 @@
+
+# Build script for fp16/bf16 W storage SpMM test
+# Usage: .\build_test_half_precision.ps1
+
+Write-Host "========================================" -ForegroundColor Cyan
+Write-Host "Building Half-Precision SpMM Test (test_half_precision)" -ForegroundColor Cyan
+Write-Host "========================================" -ForegroundColor Cyan
+Write-Host ""
+
+# Compiler settings (-march=native enables F16C / AVX-512 upconversion when the host has it)
+$CXX = "g++"
+$CXXFLAGS = "-std=c++17 -O3 -Wall -fopenmp -march=native -I../include"
+
+# Source files
+$SOURCES = @("../source/test_half_precision_spmm.cpp", "../source/half_spmm.cpp", "../source/disk_to_memory.cpp", "../source/spmm_baseline.cpp")
+$OUTPUT = "../build/test_half_precision.exe"
+
+Write-Host "Compiling..." -ForegroundColor Yellow
+
+# Get HDF5 flags from pkg-config
+$hdf5Flags = pkg-config --cflags --libs hdf5
+
+# Build command
+$buildCmd = "$CXX $CXXFLAGS $($SOURCES -join ' ') -o $OUTPUT $hdf5Flags -lhdf5_cpp"
+
+Write-Host $buildCmd -ForegroundColor Gray
+Write-Host ""
+
+Invoke-Expression $buildCmd
+
+if ($LASTEXITCODE -eq 0) {
+    Write-Host "Build successful!" -ForegroundColor Green
+    Write-Host ""
+    Write-Host "Usage: .\..\build\test_half_precision.exe <X_file.h5> <W_file.h5>" -ForegroundColor Cyan
+    Write-Host "Example: .\..\build\test_half_precision.exe d4.h5 w4.h5" -ForegroundColor Yellow
+} else {
+    Write-Host "Build failed!" -ForegroundColor Red
+    exit $LASTEXITCODE
+}
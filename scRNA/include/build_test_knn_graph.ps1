@@ -0,0 +1,39 @@
+
+# Build script for approximate kNN graph test
+# Usage: .\build_test_knn_graph.ps1
+
+Write-Host "========================================" -ForegroundColor Cyan
+Write-Host "Building Approximate kNN Graph Test (test_knn_graph)" -ForegroundColor Cyan
+Write-Host "========================================" -ForegroundColor Cyan
+Write-Host ""
+
+# Compiler settings (-march=native enables the AVX2 / AVX-512 distance kernels when the host has it)
+$CXX = "g++"
+$CXXFLAGS = "-std=c++17 -O3 -Wall -fopenmp -march=native -I../include"
+
+# Source files
+$SOURCES = @("../source/test_knn_graph.cpp", "../source/knn_graph.cpp", "../source/rsvd.cpp", "../source/spmm_transpose.cpp", "../source/disk_to_memory.cpp", "../source/spmm_baseline.cpp")
+$OUTPUT = "../build/test_knn_graph.exe"
+
+Write-Host "Compiling..." -ForegroundColor Yellow
+
+# Get HDF5 flags from pkg-config
+$hdf5Flags = pkg-config --cflags --libs hdf5
+
+# Build command
+$buildCmd = "$CXX $CXXFLAGS $($SOURCES -join ' ') -o $OUTPUT $hdf5Flags -lhdf5_cpp"
+
+Write-Host $buildCmd -ForegroundColor Gray
+Write-Host ""
+
+Invoke-Expression $buildCmd
+
+if ($LASTEXITCODE -eq 0) {
+    Write-Host "Build successful!" -ForegroundColor Green
+    Write-Host ""
+    Write-Host "Usage: .\..\build\test_knn_graph.exe <X_file.h5> [n_neighbors]" -ForegroundColor Cyan
+    Write-Host "Example: .\..\build\test_knn_graph.exe d4.h5 15" -ForegroundColor Yellow
+} else {
+    Write-Host "Build failed!" -ForegroundColor Red
+    exit $LASTEXITCODE
+}
@@ -0,0 +1,39 @@
+
+# Build script for pipelined SpMM test
+# Usage: .\build_test_pipeline_spmm.ps1
+
+Write-Host "========================================" -ForegroundColor Cyan
+Write-Host "Building Pipelined SpMM Test (test_pipeline_spmm)" -ForegroundColor Cyan
+Write-Host "========================================" -ForegroundColor Cyan
+Write-Host ""
+
+# Compiler settings
+$CXX = "g++"
+$CXXFLAGS = "-std=c++17 -O3 -Wall -fopenmp -pthread -I../include"
+
+# Source files
+$SOURCES = @("../source/test_pipeline_spmm.cpp", "../source/pipeline_spmm.cpp", "../source/disk_to_memory.cpp", "../source/spmm_baseline.cpp", "../source/incremental_spmm.cpp", "../source/y_writer.cpp")
+$OUTPUT = "../build/test_pipeline_spmm.exe"
+
+Write-Host "Compiling..." -ForegroundColor Yellow
+
+# Get HDF5 flags from pkg-config
+$hdf5Flags = pkg-config --cflags --libs hdf5
+
+# Build command
+$buildCmd = "$CXX $CXXFLAGS $($SOURCES -join ' ') -o $OUTPUT $hdf5Flags -lhdf5_cpp -lz"
+
+Write-Host $buildCmd -ForegroundColor Gray
+Write-Host ""
+
+Invoke-Expression $buildCmd
+
+if ($LASTEXITCODE -eq 0) {
+    Write-Host "Build successful!" -ForegroundColor Green
+    Write-Host ""
+    Write-Host "Usage: .\..\build\test_pipeline_spmm.exe <X_file.h5> <W_file.h5> [panel_cells] [queue_depth]" -ForegroundColor Cyan
+    Write-Host "Example: .\..\build\test_pipeline_spmm.exe d4.h5 w4.h5 16384 4" -ForegroundColor Yellow
+} else {
+    Write-Host "Build failed!" -ForegroundColor Red
+    exit $LASTEXITCODE
+}
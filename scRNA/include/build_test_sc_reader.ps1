@@ -0,0 +1,39 @@
+
+# Build script for native 10x / h5ad reader test
+# Usage: .\build_test_sc_reader.ps1
+
+Write-Host "========================================" -ForegroundColor Cyan
+Write-Host "Building Native 10x / h5ad Reader Test (test_sc_reader)" -ForegroundColor Cyan
+Write-Host "========================================" -ForegroundColor Cyan
+Write-Host ""
+
+# Compiler settings
+$CXX = "g++"
+$CXXFLAGS = "-std=c++17 -O3 -Wall -fopenmp -I../include"
+
+# Source files
+$SOURCES = @("../source/test_sc_reader.cpp", "../source/sc_reader.cpp", "../source/spmm_transpose.cpp", "../source/disk_to_memory.cpp", "../source/spmm_baseline.cpp")
+$OUTPUT = "../build/test_sc_reader.exe"
+
+Write-Host "Compiling..." -ForegroundColor Yellow
+
+# Get HDF5 flags from pkg-config
+$hdf5Flags = pkg-config --cflags --libs hdf5
+
+# Build command
+$buildCmd = "$CXX $CXXFLAGS $($SOURCES -join ' ') -o $OUTPUT $hdf5Flags -lhdf5_cpp"
+
+Write-Host $buildCmd -ForegroundColor Gray
+Write-Host ""
+
+Invoke-Expression $buildCmd
+
+if ($LASTEXITCODE -eq 0) {
+    Write-Host "Build successful!" -ForegroundColor Green
+    Write-Host ""
+    Write-Host "Usage: .\..\build\test_sc_reader.exe <X_file.h5|X_file.h5ad> [reference_X.h5] [feature_type]" -ForegroundColor Cyan
+    Write-Host "Example: .\..\build\test_sc_reader.exe pbmc.h5ad d4.h5" -ForegroundColor Yellow
+} else {
+    Write-Host "Build failed!" -ForegroundColor Red
+    exit $LASTEXITCODE
+}
@@ -0,0 +1,39 @@
+
+# Build script for shared-memory multi-process SpMM test
+# Usage: .\build_test_shm_spmm.ps1
+
+Write-Host "========================================" -ForegroundColor Cyan
+Write-Host "Building Shared-Memory Multi-Process SpMM Test (test_shm_spmm)" -ForegroundColor Cyan
+Write-Host "========================================" -ForegroundColor Cyan
+Write-Host ""
+
+# Compiler settings
+$CXX = "g++"
+$CXXFLAGS = "-std=c++17 -O3 -Wall -fopenmp -I../include"
+
+# Source files
+$SOURCES = @("../source/test_shm_spmm.cpp", "../source/shm_spmm.cpp", "../source/disk_to_memory.cpp", "../source/spmm_baseline.cpp")
+$OUTPUT = "../build/test_shm_spmm.exe"
+
+Write-Host "Compiling..." -ForegroundColor Yellow
+
+# Get HDF5 flags from pkg-config
+$hdf5Flags = pkg-config --cflags --libs hdf5
+
+# Build command
+$buildCmd = "$CXX $CXXFLAGS $($SOURCES -join ' ') -o $OUTPUT $hdf5Flags -lhdf5_cpp -lrt"
+
+Write-Host $buildCmd -ForegroundColor Gray
+Write-Host ""
+
+Invoke-Expression $buildCmd
+
+if ($LASTEXITCODE -eq 0) {
+    Write-Host "Build successful!" -ForegroundColor Green
+    Write-Host ""
+    Write-Host "Usage: .\..\build\test_shm_spmm.exe <X_file.h5> <W_file.h5> [max_workers]" -ForegroundColor Cyan
+    Write-Host "Example: .\..\build\test_shm_spmm.exe d4.h5 w4.h5 8" -ForegroundColor Yellow
+} else {
+    Write-Host "Build failed!" -ForegroundColor Red
+    exit $LASTEXITCODE
+}
@@ -0,0 +1,39 @@
+
+# Build script for fused SpMM + QC statistics test
+# Usage: .\build_test_spmm_stats.ps1
+
+Write-Host "========================================" -ForegroundColor Cyan
+Write-Host "Building Fused SpMM Statistics Test (test_spmm_stats)" -ForegroundColor Cyan
+Write-Host "========================================" -ForegroundColor Cyan
+Write-Host ""
+
+# Compiler settings
+$CXX = "g++"
+$CXXFLAGS = "-std=c++17 -O3 -Wall -fopenmp -I../include"
+
+# Source files
+$SOURCES = @("../source/test_spmm_stats.cpp", "../source/permutation.cpp", "../source/disk_to_memory.cpp", "../source/spmm_baseline.cpp", "../source/spmm.cpp", "../source/dense_spmm.cpp", "../source/tiler.cpp", "../source/tile_spmm.cpp")
+$OUTPUT = "../build/test_spmm_stats.exe"
+
+Write-Host "Compiling..." -ForegroundColor Yellow
+
+# Get HDF5 flags from pkg-config
+$hdf5Flags = pkg-config --cflags --libs hdf5
+
+# Build command
+$buildCmd = "$CXX $CXXFLAGS $($SOURCES -join ' ') -o $OUTPUT $hdf5Flags -lhdf5_cpp"
+
+Write-Host $buildCmd -ForegroundColor Gray
+Write-Host ""
+
+Invoke-Expression $buildCmd
+
+if ($LASTEXITCODE -eq 0) {
+    Write-Host "Build successful!" -ForegroundColor Green
+    Write-Host ""
+    Write-Host "Usage: .\..\build\test_spmm_stats.exe <X_file.h5> <W_file.h5>" -ForegroundColor Cyan
+    Write-Host "Example: .\..\build\test_spmm_stats.exe d4.h5 w4.h5" -ForegroundColor Yellow
+} else {
+    Write-Host "Build failed!" -ForegroundColor Red
+    exit $LASTEXITCODE
+}
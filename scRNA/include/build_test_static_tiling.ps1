@@ -0,0 +1,39 @@
+
+# Build script for compile-time tile geometry test
+# Usage: .\build_test_static_tiling.ps1
+
+Write-Host "========================================" -ForegroundColor Cyan
+Write-Host "Building Compile-Time Tile Geometry Test (test_static_tiling)" -ForegroundColor Cyan
+Write-Host "========================================" -ForegroundColor Cyan
+Write-Host ""
+
+# Compiler settings
+$CXX = "g++"
+$CXXFLAGS = "-std=c++17 -O3 -Wall -fopenmp -I../include"
+
+# Source files
+$SOURCES = @("../source/test_static_tiling.cpp", "../source/spmm.cpp", "../source/tiler.cpp", "../source/dense_spmm.cpp", "../source/spmm_baseline.cpp", "../source/disk_to_memory.cpp")
+$OUTPUT = "../build/test_static_tiling.exe"
+
+Write-Host "Compiling..." -ForegroundColor Yellow
+
+# Get HDF5 flags from pkg-config
+$hdf5Flags = pkg-config --cflags --libs hdf5
+
+# Build command
+$buildCmd = "$CXX $CXXFLAGS $($SOURCES -join ' ') -o $OUTPUT $hdf5Flags -lhdf5_cpp"
+
+Write-Host $buildCmd -ForegroundColor Gray
+Write-Host ""
+
+Invoke-Expression $buildCmd
+
+if ($LASTEXITCODE -eq 0) {
+    Write-Host "Build successful!" -ForegroundColor Green
+    Write-Host ""
+    Write-Host "Usage: .\..\build\test_static_tiling.exe <X_file.h5> <W_file.h5> [runs]" -ForegroundColor Cyan
+    Write-Host "Example: .\..\build\test_static_tiling.exe d4.h5 w4.h5 3" -ForegroundColor Yellow
+} else {
+    Write-Host "Build failed!" -ForegroundColor Red
+    exit $LASTEXITCODE
+}
@@ -0,0 +1,39 @@
+
+# Build script for chunked Y writer test
+# Usage: .\build_test_y_writer.ps1
+
+Write-Host "========================================" -ForegroundColor Cyan
+Write-Host "Building Chunked Y Writer Test (test_y_writer)" -ForegroundColor Cyan
+Write-Host "========================================" -ForegroundColor Cyan
+Write-Host ""
+
+# Compiler settings
+$CXX = "g++"
+$CXXFLAGS = "-std=c++17 -O3 -Wall -fopenmp -I../include"
+
+# Source files
+$SOURCES = @("../source/test_y_writer.cpp", "../source/disk_to_memory.cpp", "../source/spmm_baseline.cpp", "../source/incremental_spmm.cpp", "../source/y_writer.cpp")
+$OUTPUT = "../build/test_y_writer.exe"
+
+Write-Host "Compiling..." -ForegroundColor Yellow
+
+# Get HDF5 flags from pkg-config
+$hdf5Flags = pkg-config --cflags --libs hdf5
+
+# Build command
+$buildCmd = "$CXX $CXXFLAGS $($SOURCES -join ' ') -o $OUTPUT $hdf5Flags -lhdf5_cpp -lz"
+
+Write-Host $buildCmd -ForegroundColor Gray
+Write-Host ""
+
+Invoke-Expression $buildCmd
+
+if ($LASTEXITCODE -eq 0) {
+    Write-Host "Build successful!" -ForegroundColor Green
+    Write-Host ""
+    Write-Host "Usage: .\..\build\test_y_writer.exe <X_file.h5> <W_file.h5> [chunk_rows]" -ForegroundColor Cyan
+    Write-Host "Example: .\..\build\test_y_writer.exe d4.h5 w4.h5 4096" -ForegroundColor Yellow
+} else {
+    Write-Host "Build failed!" -ForegroundColor Red
+    exit $LASTEXITCODE
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <functional>
+#include <cstddef>
+
+using namespace std;
+
+/*
+ * Minimal rank communicator for distributed SpMM
+ *
+ * A rank only sees rank(), size(), barrier() and ordered point-to-point byte
+ * messages: per (sender, receiver) pair, messages arrive in the order they were
+ * sent, and the receiver must ask for exactly the size that was sent. The
+ * collectives built on top (broadcast) are linear from the root, which is the
+ * pattern dist_spmm uses. Every send / recv is counted, so callers can report
+ * communication volume per rank and per phase.
+ *
+ * Backends (an MPI backend only has to implement send_bytes / recv_bytes / barrier):
+ *   run_thread_ranks  - one thread per rank in this process, mailboxes under a mutex
+ *   run_process_ranks - one forked process per rank, byte rings in a shared mapping
+ * In both, rank 0 runs on the calling thread, so its results stay with the caller.
+ * If any rank throws, the others are woken with an abort, and the launcher rethrows
+ * the first error.
+ */
+
+struct CommCounters {
+    size_t bytes_sent = 0;
+    size_t bytes_received = 0;
+    size_t messages_sent = 0;
+    size_t messages_received = 0;
+};
+
+class Communicator {
+public:
+    virtual ~Communicator() = default;
+
+    virtual int rank() const = 0;
+    virtual int size() const = 0;
+    virtual void barrier() = 0;
+
+    /**
+     * Send bytes to rank dest. May return before dest has received them.
+     */
+    void send(int dest, const void* buf, size_t bytes);
+
+    /**
+     * Receive the next message from rank src into buf (bytes must match the sent size).
+     */
+    void recv(int src, void* buf, size_t bytes);
+
+    /**
+     * Copy buf from root to every other rank (linear: root sends size()-1 messages).
+     */
+    void broadcast(void* buf, size_t bytes, int root = 0);
+
+    template <typename T>
+    void send_vector(int dest, const vector<T>& v) {
+        size_t n = v.size();
+        send(dest, &n, sizeof(n));
+        if (n > 0) send(dest, v.data(), n * sizeof(T));
+    }
+
+    template <typename T>
+    vector<T> recv_vector(int src) {
+        size_t n = 0;
+        recv(src, &n, sizeof(n));
+        vector<T> v(n);
+        if (n > 0) recv(src, v.data(), n * sizeof(T));
+        return v;
+    }
+
+    const CommCounters& counters() const { return counters_; }
+
+protected:
+    virtual void send_bytes(int dest, const void* buf, size_t bytes) = 0;
+    virtual void recv_bytes(int src, void* buf, size_t bytes) = 0;
+
+    void check_peer(int peer) const;
+
+private:
+    CommCounters counters_;
+};
+
+/**
+ * Run fn on n ranks, one thread each, and wait for all of them.
+ *
+ * @param n Number of ranks (rank 0 runs on the calling thread)
+ * @param fn Rank body
+ */
+void run_thread_ranks(int n, const function<void(Communicator&)>& fn);
+
+/**
+ * Run fn on n ranks, one process each (ranks 1..n-1 are forked children), and wait
+ * for all of them. Only rank 0's side effects are visible to the caller.
+ *
+ * @param n Number of ranks (rank 0 runs in the calling process)
+ * @param fn Rank body
+ * @param channel_bytes Ring size per (sender, receiver) pair; larger messages are streamed through it
+ */
+void run_process_ranks(int n, const function<void(Communicator&)>& fn, size_t channel_bytes = 1 << 20);
@@ -0,0 +1,90 @@
+#pragma once
+#include "csr.hpp"
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <limits>
+
+using namespace std;
+
+/*
+ * Count Value Codec
+ *
+ * scRNA X values are raw UMI counts: mostly small non-negative integers.
+ * CountCSR stores each value as a narrow unsigned code (uint8 or uint16).
+ * Values that do not fit (large counts, non-integers, negatives) are written
+ * to a per-row escape table and their code is set to the ESCAPE sentinel.
+ * Column indices can optionally be narrowed to uint16 when ncols <= 65536.
+ *
+ * The encoding is lossless: decode_counts() reproduces the original CSR.
+ */
+
+template <typename CodeT, typename IndexT>
+struct CountCSR {
+    int nrows = 0;
+    int ncols = 0;
+    size_t nnz = 0;
+
+    vector<int>    indptr;      // size nrows+1 (same as CSR)
+    vector<IndexT> indices;     // size nnz, column indices
+    vector<CodeT>  codes;       // size nnz, value code or ESCAPE
+
+    // Escapes of row r are escapes[escape_ptr[r]..escape_ptr[r+1]), in nnz order
+    vector<int>    escape_ptr;  // size nrows+1
+    vector<float>  escapes;     // values that did not fit a code
+
+    static constexpr CodeT ESCAPE = numeric_limits<CodeT>::max();
+};
+
+using CountCSR8  = CountCSR<uint8_t,  int>;
+using CountCSR16 = CountCSR<uint16_t, int>;
+using CountCSR8N  = CountCSR<uint8_t,  uint16_t>;   // narrow indices
+using CountCSR16N = CountCSR<uint16_t, uint16_t>;   // narrow indices
+
+/**
+ * Encode a CSR matrix of counts.
+ * Throws if IndexT is too narrow for X.ncols.
+ *
+ * @param X Input CSR matrix (values are typically integer counts)
+ * @return Encoded matrix
+ */
+template <typename CodeT, typename IndexT>
+CountCSR<CodeT, IndexT> encode_counts(const CSR& X);
+
+/**
+ * Decode back to a standard CSR matrix (exact).
+ */
+template <typename CodeT, typename IndexT>
+CSR decode_counts(const CountCSR<CodeT, IndexT>& Xc);
+
+/**
+ * SpMM on encoded counts: Y = X * W
+ * Values are decoded inline while streaming; results match spmm_baseline exactly.
+ *
+ * @param Xc Encoded sparse matrix
+ * @param W Dense weight matrix (row-major)
+ * @param W_rows Number of rows in W
+ * @param W_cols Number of columns in W
+ * @param log_annotation Optional log file annotation for OpenMP thread logging. If empty, no logging is performed.
+ * @return Result vector Y (row-major, Xc.nrows x W_cols)
+ */
+template <typename CodeT, typename IndexT>
+vector<float> spmm_counts(const CountCSR<CodeT, IndexT>& Xc, const vector<float>& W, int W_rows, int W_cols,
+                          const string& log_annotation = "");
+
+/**
+ * Bytes of the encoded X (indptr + indices + codes + escape table).
+ */
+template <typename CodeT, typename IndexT>
+size_t count_csr_bytes(const CountCSR<CodeT, IndexT>& Xc) {
+    return Xc.indptr.size() * sizeof(int) + Xc.indices.size() * sizeof(IndexT)
+         + Xc.codes.size() * sizeof(CodeT) + Xc.escape_ptr.size() * sizeof(int)
+         + Xc.escapes.size() * sizeof(float);
+}
+
+/**
+ * Bytes of a standard CSR (indptr + indices + data).
+ */
+inline size_t csr_bytes(const CSR& X) {
+    return X.indptr.size() * sizeof(int) + X.indices.size() * sizeof(int) + X.data.size() * sizeof(float);
+}
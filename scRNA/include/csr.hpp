@@ -1,5 +1,6 @@
 #pragma once
 #include <vector>
+#include "huge_page_alloc.hpp"
 
 using namespace std;
 
@@ -15,6 +16,9 @@ using namespace std;
 
    indices: column indices of each stored nonzero
    data   : values of each stored nonzero
+
+   The arrays use HugePageAllocator: 64 B-aligned, and 2 MiB-aligned on huge pages
+   once they reach hw_config::HUGE_PAGE_MIN_BYTES (see huge_page_alloc.hpp).
  */
 
 struct CSR {
@@ -22,7 +26,7 @@ struct CSR {
     int ncols = 0;
     size_t nnz = 0;
 
-    vector<int>   indptr;    // size nrows+1
-    vector<int>   indices;   // size nnz
-    vector<float> data;      // size nnz
+    huge_vector<int>   indptr;    // size nrows+1
+    huge_vector<int>   indices;   // size nnz
+    huge_vector<float> data;      // size nnz
 };
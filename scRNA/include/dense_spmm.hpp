@@ -1,6 +1,7 @@
 #pragma once
 #include "csr.hpp"
 #include "tiler.hpp"
+#include "span.hpp"
 #include <vector>
 
 using namespace std;
@@ -15,9 +16,9 @@ using namespace std;
   @param W Dense weight matrix (row-major)
   @param W_cols Number of columns in W
   @param tile The dense tile to process
-  @param Y Output matrix (row-major, modified in-place)
+  @param Y Output matrix (row-major, modified in-place; a vector<float> converts implicitly)
   @param Y_cols Number of columns in Y
  */
 void dense_spmm_tile(const CSR& X, const vector<float>& W, int W_cols,
-                     const Tile& tile, vector<float>& Y, int Y_cols);
+                     const Tile& tile, Span<float> Y, int Y_cols);
 
@@ -0,0 +1,78 @@
+#pragma once
+#include "csr.hpp"
+#include "communicator.hpp"
+#include <vector>
+#include <string>
+#include <cstddef>
+
+using namespace std;
+
+/*
+ * Distributed SpMM over a Communicator
+ *
+ * Ranks form a grid_rows x grid_cols process grid. Rank r sits at grid row r / grid_cols
+ * and grid column r % grid_cols. X rows (genes) are cut into grid_rows panels and X columns
+ * (cells, i.e. W rows) into grid_cols ranges, both balanced by nnz:
+ *   OneD - grid_cols = 1: every rank owns a row panel of X and Y and needs all of W
+ *          (W is broadcast). Y panels are bitwise equal to spmm_baseline.
+ *   TwoD - rank (i, j) owns X block (panel i, range j) and only W rows of range j.
+ *          The partial Y panels of a grid row are summed on (i, 0) in column order.
+ * Rank 0 starts with all of X and W. Phases:
+ *   scatter X -> W -> local SpMM -> reduce Y (TwoD) -> gather Y to rank 0
+ * Bytes are counted per rank and phase. The scatter is reported on its own, since on a
+ * cluster X would normally be read by its owners. 1D costs each rank all of W,
+ * 2D only 1 / grid_cols of it plus the partial Y reduction.
+ */
+
+enum class DistPartition { OneD, TwoD };
+
+struct DistSpmmConfig {
+    DistPartition partition = DistPartition::OneD;
+    int grid_rows = 0;           // TwoD: process rows (0 = largest divisor of size() <= sqrt(size()))
+};
+
+struct DistPhaseBytes {
+    size_t sent = 0;
+    size_t received = 0;
+};
+
+/* One rank's share of the work and traffic (trivially copyable: gathered to rank 0) */
+struct DistRankStats {
+    int rank = 0;
+    int grid_row = 0;
+    int grid_col = 0;
+    int rows = 0;                // X block rows
+    int cols = 0;                // X block columns (W rows needed)
+    size_t nnz = 0;
+    DistPhaseBytes scatter_X, W, reduce_Y, gather_Y;
+    double compute_ms = 0.0;
+    double comm_ms = 0.0;        // W + reduce + gather
+    double total_ms = 0.0;
+};
+
+struct DistSpmmStats {
+    DistPartition partition = DistPartition::OneD;
+    int grid_rows = 0;
+    int grid_cols = 0;
+    vector<DistRankStats> ranks; // All ranks on rank 0; only its own entry elsewhere
+    size_t spmm_bytes = 0;       // Total bytes received in the W, reduce and gather phases (rank 0 only)
+    size_t scatter_bytes = 0;    // Total bytes received in the X scatter (rank 0 only)
+    double total_ms = 0.0;
+};
+
+/**
+ * Collective: every rank of comm must call it with the same cfg.
+ *
+ * @param comm Communicator (rank 0 is the root)
+ * @param X Sparse CSR matrix (genes x cells); read on rank 0 only
+ * @param W Dense matrix (row-major, W_rows x W_cols); read on rank 0 only
+ * @param W_rows Number of rows in W (must equal X.ncols); rank 0 only
+ * @param W_cols Number of columns in W; rank 0 only
+ * @param cfg Partitioning
+ * @param stats Optional traffic / timing report
+ * @param log_annotation Optional log file annotation (e.g., "4" for "4_dist.txt"); used on rank 0. If empty, no logging is performed.
+ * @return Y (row-major, X.nrows x W_cols) on rank 0; empty on other ranks
+ */
+vector<float> dist_spmm(Communicator& comm, const CSR& X, const vector<float>& W, int W_rows, int W_cols,
+                        const DistSpmmConfig& cfg = DistSpmmConfig(), DistSpmmStats* stats = nullptr,
+                        const string& log_annotation = "");
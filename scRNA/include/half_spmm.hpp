@@ -0,0 +1,183 @@
+#pragma once
+#include "csr.hpp"
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+
+using namespace std;
+
+/*
+ * Reduced-Precision Storage for W and Y
+ *
+ * W (and optionally Y) can be stored as IEEE fp16 or bfloat16 to halve the
+ * bytes streamed per nonzero. Values are upconverted to fp32 inside the
+ * kernel and all accumulation is done in fp32.
+ */
+
+enum class StoragePrecision {
+    FP32,   // 32-bit IEEE float (baseline)
+    FP16,   // 16-bit IEEE half (1-5-10)
+    BF16    // bfloat16 (1-8-7), same exponent range as fp32
+};
+
+/**
+ * Dense row-major matrix stored in 16-bit precision.
+ * data holds raw fp16 or bf16 bit patterns, depending on precision.
+ */
+struct HalfMatrix {
+    int rows = 0;
+    int cols = 0;
+    StoragePrecision precision = StoragePrecision::FP16;
+    vector<uint16_t> data;   // size rows*cols
+};
+
+/**
+ * Scalar fp32 -> fp16 conversion (round to nearest even, handles inf/nan/subnormals).
+ */
+inline uint16_t float_to_fp16(float f) {
+    uint32_t x;
+    memcpy(&x, &f, sizeof(x));
+    uint32_t sign = (x >> 16) & 0x8000u;
+    uint32_t exp  = (x >> 23) & 0xFFu;
+    uint32_t mant = x & 0x7FFFFFu;
+
+    if (exp == 0xFFu) {
+        // inf or nan (keep a quiet nan payload bit)
+        return static_cast<uint16_t>(sign | 0x7C00u | (mant ? 0x200u : 0u));
+    }
+    int e = static_cast<int>(exp) - 127 + 15;
+    if (e >= 31) {
+        return static_cast<uint16_t>(sign | 0x7C00u);  // overflow -> inf
+    }
+    if (e <= 0) {
+        if (e < -10) return static_cast<uint16_t>(sign);  // underflow -> signed zero
+        // subnormal half
+        mant |= 0x800000u;
+        int shift = 14 - e;
+        uint32_t half_mant = mant >> shift;
+        uint32_t rem = mant & ((1u << shift) - 1u);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rem > halfway || (rem == halfway && (half_mant & 1u))) half_mant++;
+        return static_cast<uint16_t>(sign | half_mant);
+    }
+    uint32_t half = sign | (static_cast<uint32_t>(e) << 10) | (mant >> 13);
+    uint32_t rem = mant & 0x1FFFu;
+    if (rem > 0x1000u || (rem == 0x1000u && (half & 1u))) half++;  // may carry into exponent (correct)
+    return static_cast<uint16_t>(half);
+}
+
+/**
+ * Scalar fp16 -> fp32 conversion.
+ */
+inline float fp16_to_float(uint16_t h) {
+    uint32_t sign = (static_cast<uint32_t>(h) & 0x8000u) << 16;
+    uint32_t exp  = (h >> 10) & 0x1Fu;
+    uint32_t mant = h & 0x3FFu;
+    uint32_t x;
+    if (exp == 0) {
+        if (mant == 0) {
+            x = sign;
+        } else {
+            // normalize subnormal
+            int e = -1;
+            do { e++; mant <<= 1; } while ((mant & 0x400u) == 0);
+            x = sign | (static_cast<uint32_t>(127 - 15 - e) << 23) | ((mant & 0x3FFu) << 13);
+        }
+    } else if (exp == 0x1Fu) {
+        x = sign | 0x7F800000u | (mant << 13);
+    } else {
+        x = sign | ((exp + 127 - 15) << 23) | (mant << 13);
+    }
+    float f;
+    memcpy(&f, &x, sizeof(f));
+    return f;
+}
+
+/**
+ * Scalar fp32 -> bf16 conversion (round to nearest even, nan preserved).
+ */
+inline uint16_t float_to_bf16(float f) {
+    uint32_t x;
+    memcpy(&x, &f, sizeof(x));
+    if ((x & 0x7FFFFFFFu) > 0x7F800000u) {
+        return static_cast<uint16_t>((x >> 16) | 0x40u);  // quiet nan
+    }
+    uint32_t rounding_bias = 0x7FFFu + ((x >> 16) & 1u);
+    return static_cast<uint16_t>((x + rounding_bias) >> 16);
+}
+
+/**
+ * Scalar bf16 -> fp32 conversion (exact).
+ */
+inline float bf16_to_float(uint16_t h) {
+    uint32_t x = static_cast<uint32_t>(h) << 16;
+    float f;
+    memcpy(&f, &x, sizeof(f));
+    return f;
+}
+
+/**
+ * Convert a row-major fp32 matrix to 16-bit storage.
+ * Uses F16C for fp16 when compiled with it.
+ *
+ * @param M fp32 matrix (row-major, rows x cols)
+ * @param precision FP16 or BF16 (FP32 is rejected)
+ * @return HalfMatrix with converted values
+ */
+HalfMatrix to_half_matrix(const vector<float>& M, int rows, int cols, StoragePrecision precision);
+
+/**
+ * Load W from HDF5 (via load_W_h5) and convert it to 16-bit storage at load time.
+ *
+ * @param w_h5_path Path to HDF5 file containing W matrix
+ * @param precision Target storage precision (FP16 or BF16)
+ * @param log_annotation Optional log file annotation (e.g., "0" for log0.txt). If empty, no logging is performed.
+ * @return W in 16-bit storage
+ */
+HalfMatrix load_W_h5_half(const string& w_h5_path, StoragePrecision precision, const string& log_annotation = "");
+
+/**
+ * Convert a 16-bit matrix back to fp32 (row-major).
+ */
+vector<float> half_matrix_to_float(const HalfMatrix& M);
+
+/**
+ * SpMM with 16-bit W: Y = X * W, fp32 accumulation, fp32 Y.
+ * W rows are upconverted on the fly (F16C / AVX-512 where available, scalar otherwise).
+ *
+ * @param X Sparse CSR matrix
+ * @param W Reduced-precision W (W.rows must equal X.ncols)
+ * @param log_annotation Optional log file annotation for OpenMP thread logging. If empty, no logging is performed.
+ * @return Result vector Y (row-major, X.nrows x W.cols)
+ */
+vector<float> spmm_baseline_half(const CSR& X, const HalfMatrix& W, const string& log_annotation = "");
+
+/**
+ * SpMM with 16-bit W and 16-bit Y storage.
+ * Each Y row is accumulated in an fp32 scratch row and rounded once when stored.
+ *
+ * @param X Sparse CSR matrix
+ * @param W Reduced-precision W
+ * @param Y_precision Storage precision of the returned Y (FP16 or BF16)
+ * @return Y in 16-bit storage (X.nrows x W.cols)
+ */
+HalfMatrix spmm_baseline_half_Y(const CSR& X, const HalfMatrix& W, StoragePrecision Y_precision);
+
+/**
+ * Bytes per element for a storage precision.
+ */
+inline size_t storage_bytes(StoragePrecision p) {
+    return (p == StoragePrecision::FP32) ? sizeof(float) : sizeof(uint16_t);
+}
+
+/**
+ * Human-readable precision name ("fp32", "fp16", "bf16").
+ */
+inline string storage_precision_name(StoragePrecision p) {
+    switch (p) {
+        case StoragePrecision::FP16: return "fp16";
+        case StoragePrecision::BF16: return "bf16";
+        default: return "fp32";
+    }
+}
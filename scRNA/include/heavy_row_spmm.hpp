@@ -0,0 +1,77 @@
+#pragma once
+#include "csr.hpp"
+#include "tiler.hpp"
+#include "span.hpp"
+#include "../config/hw_config.h"
+#include <vector>
+#include <string>
+#include <cstddef>
+
+using namespace std;
+
+/*
+ * Heavy-row hybrid SpMM
+ *
+ * Housekeeping genes are nonzero in nearly every cell. Each one is a single CSR row
+ * with nnz close to ncols, so spmm_baseline's static row schedule leaves one thread
+ * working through it while the others wait. Such rows also skew tile classification.
+ *
+ * split_heavy_rows moves every row with nnz >= fraction * ncols into a dense block and
+ * empties those rows in the sparse remainder, which keeps the shape of X. The block is
+ * stored cell-major (ncols x heavy rows), so one pass over W serves all heavy rows.
+ * spmm_heavy_split then
+ *   - runs the remainder through spmm_baseline_into or spmm_tiled_into; heavy rows come out zero
+ *     and all other rows match the plain engine bit for bit,
+ *   - computes the heavy rows as a dense GEMM with the cell dimension split across all
+ *     threads; per-thread partial sums are added in thread order.
+ * At the default fraction the block takes at most about 1.7x the bytes of the CSR rows it replaces.
+ */
+
+struct HeavyRowSplit {
+    CSR light;                   // X with the heavy rows emptied (same shape as X)
+    vector<int> heavy_rows;      // Rows moved to the dense block, ascending
+    vector<float> dense;         // ncols x heavy_rows.size(), row-major
+    size_t heavy_nnz = 0;        // Nonzeros moved to the dense block
+    int threshold_nnz = 0;       // Rows with at least this many nonzeros are heavy
+    double split_ms = 0.0;
+};
+
+struct HeavyRowStats {
+    double sparse_ms = 0.0;      // Remainder through the sparse engine
+    double dense_ms = 0.0;       // Dense GEMM plus the scatter into Y
+    size_t num_tiles = 0;        // Tiles used by the sparse engine (tiled only)
+};
+
+/**
+ * Separate the heavy rows of X.
+ *
+ * @param X Sparse CSR matrix (genes x cells)
+ * @param fraction A row is heavy if its nnz >= fraction * X.ncols (> 1 disables the split)
+ * @param log_annotation Optional log file annotation (e.g., "0" for log0.txt). If empty, no logging is performed.
+ */
+HeavyRowSplit split_heavy_rows(const CSR& X, double fraction = hw_config::HEAVY_ROW_FRACTION,
+                               const string& log_annotation = "");
+
+/**
+ * Hybrid SpMM: Y = X * W on a split X.
+ *
+ * @param S Output of split_heavy_rows
+ * @param W Dense weight matrix (row-major)
+ * @param W_rows Number of rows in W (must equal X.ncols)
+ * @param W_cols Number of columns in W
+ * @param tiling Tiling for the sparse remainder (spmm_tiled_into); nullptr = spmm_baseline_into
+ * @param stats Optional timing report
+ * @param log_annotation Optional log file annotation. If empty, no logging is performed.
+ * @return Y (row-major, X.nrows x W_cols)
+ */
+vector<float> spmm_heavy_split(const HeavyRowSplit& S, const vector<float>& W, int W_rows, int W_cols,
+                               const TilingConfig* tiling = nullptr, HeavyRowStats* stats = nullptr,
+                               const string& log_annotation = "");
+
+/**
+ * Dense part of spmm_heavy_split on its own: overwrite the heavy rows of Y with
+ * their rows of X * W and leave every other row untouched.
+ *
+ * @param Y Output (row-major, X.nrows x W_cols)
+ */
+void spmm_heavy_rows_into(const HeavyRowSplit& S, const vector<float>& W, int W_cols, Span<float> Y);
@@ -0,0 +1,196 @@
+#pragma once
+#include "../config/hw_config.h"
+#include <vector>
+#include <atomic>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <sys/mman.h>
+
+using namespace std;
+
+/*
+ * Aligned / huge-page allocation for large arrays
+ *
+ * Streaming hundreds of MB of CSR indices/data (and gathering W rows at random)
+ * on 4 KiB pages costs a dTLB miss every few cache lines. HugePageAllocator
+ * serves arrays of at least HUGE_PAGE_MIN_BYTES from 2 MiB-aligned anonymous
+ * mappings and, by policy:
+ *   Off         - madvise(MADV_NOHUGEPAGE): plain 4 KiB pages (for comparison)
+ *   Transparent - madvise(MADV_HUGEPAGE): transparent huge pages (default)
+ *   Explicit    - mmap(MAP_HUGETLB) from the reserved hugetlbfs pool, falling
+ *                 back to Transparent when the pool is empty or unsupported
+ * Smaller arrays come from aligned_alloc with SIMD_ALIGNMENT (64 B, AVX-512).
+ *
+ * The policy is process-wide: set_huge_page_policy(), or SCRNA_HUGE_PAGES=off|thp|explicit
+ * in the environment. It only affects allocations made after it is set.
+ * Everything is header-only so CSR can use it without extra sources in the build scripts.
+ */
+
+enum class HugePagePolicy { Off, Transparent, Explicit };
+
+struct HugePageCounters {
+    atomic<size_t> explicit_bytes{0};       // Served from the hugetlbfs pool
+    atomic<size_t> transparent_bytes{0};    // 2 MiB-aligned, MADV_HUGEPAGE
+    atomic<size_t> plain_bytes{0};          // 2 MiB-aligned, MADV_NOHUGEPAGE
+    atomic<size_t> small_bytes{0};          // aligned_alloc (below HUGE_PAGE_MIN_BYTES)
+    atomic<size_t> explicit_fallbacks{0};   // MAP_HUGETLB failed, fell back to THP
+    atomic<size_t> madvise_failures{0};     // madvise rejected (e.g. THP compiled out)
+};
+
+inline HugePageCounters& huge_page_counters() {
+    static HugePageCounters counters;
+    return counters;
+}
+
+inline atomic<int>& huge_page_policy_slot() {
+    static atomic<int> policy([] {
+        const char* env = getenv("SCRNA_HUGE_PAGES");
+        if (env != nullptr) {
+            string v = env;
+            if (v == "off" || v == "0") return static_cast<int>(HugePagePolicy::Off);
+            if (v == "explicit" || v == "hugetlb") return static_cast<int>(HugePagePolicy::Explicit);
+        }
+        return static_cast<int>(HugePagePolicy::Transparent);
+    }());
+    return policy;
+}
+
+inline HugePagePolicy get_huge_page_policy() {
+    return static_cast<HugePagePolicy>(huge_page_policy_slot().load());
+}
+
+inline void set_huge_page_policy(HugePagePolicy policy) {
+    huge_page_policy_slot().store(static_cast<int>(policy));
+}
+
+inline const char* huge_page_policy_name(HugePagePolicy policy) {
+    switch (policy) {
+        case HugePagePolicy::Off: return "off";
+        case HugePagePolicy::Transparent: return "transparent";
+        case HugePagePolicy::Explicit: return "explicit";
+    }
+    return "?";
+}
+
+inline size_t huge_page_round_up(size_t bytes, size_t unit) {
+    return (bytes + unit - 1) / unit * unit;
+}
+
+/**
+ * Apply the current policy to the 2 MiB-aligned interior of an existing buffer.
+ * For buffers not owned by HugePageAllocator (e.g. std::vector W / Y): call it
+ * after reserve() and before the pages are first written, or it has no effect
+ * until khugepaged collapses the range.
+ */
+inline void advise_huge_pages(void* ptr, size_t bytes) {
+    if (ptr == nullptr || bytes < hw_config::HUGE_PAGE_MIN_BYTES) return;
+    uintptr_t begin = huge_page_round_up(reinterpret_cast<uintptr_t>(ptr), hw_config::HUGE_PAGE_BYTES);
+    uintptr_t end = (reinterpret_cast<uintptr_t>(ptr) + bytes) / hw_config::HUGE_PAGE_BYTES * hw_config::HUGE_PAGE_BYTES;
+    if (end <= begin) return;
+    int advice = get_huge_page_policy() == HugePagePolicy::Off ? MADV_NOHUGEPAGE : MADV_HUGEPAGE;
+    if (madvise(reinterpret_cast<void*>(begin), end - begin, advice) != 0) {
+        huge_page_counters().madvise_failures++;
+    }
+}
+
+/**
+ * Allocate bytes: 64 B-aligned below HUGE_PAGE_MIN_BYTES, otherwise a 2 MiB-aligned
+ * mapping handled per policy. Throws bad_alloc on failure.
+ */
+inline void* huge_page_alloc(size_t bytes) {
+    HugePageCounters& counters = huge_page_counters();
+    if (bytes < hw_config::HUGE_PAGE_MIN_BYTES) {
+        size_t len = huge_page_round_up(bytes ? bytes : 1, hw_config::SIMD_ALIGNMENT);
+        void* p = aligned_alloc(hw_config::SIMD_ALIGNMENT, len);
+        if (p == nullptr) throw bad_alloc();
+        counters.small_bytes += len;
+        return p;
+    }
+
+    const size_t page = hw_config::HUGE_PAGE_BYTES;
+    size_t len = huge_page_round_up(bytes, page);
+    HugePagePolicy policy = get_huge_page_policy();
+
+    if (policy == HugePagePolicy::Explicit) {
+        void* p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            counters.explicit_bytes += len;
+            return p;
+        }
+        counters.explicit_fallbacks++;
+    }
+
+    // Over-map by one huge page and trim, so the range starts on a 2 MiB boundary
+    size_t span = len + page;
+    void* raw = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) throw bad_alloc();
+    uintptr_t raw_addr = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = huge_page_round_up(raw_addr, page);
+    if (aligned > raw_addr) munmap(raw, aligned - raw_addr);
+    uintptr_t tail = aligned + len;
+    if (raw_addr + span > tail) munmap(reinterpret_cast<void*>(tail), raw_addr + span - tail);
+
+    void* p = reinterpret_cast<void*>(aligned);
+    bool off = policy == HugePagePolicy::Off;
+    if (madvise(p, len, off ? MADV_NOHUGEPAGE : MADV_HUGEPAGE) != 0) {
+        counters.madvise_failures++;
+    }
+    (off ? counters.plain_bytes : counters.transparent_bytes) += len;
+    return p;
+}
+
+/**
+ * Release memory from huge_page_alloc (bytes must match the allocation request).
+ */
+inline void huge_page_free(void* ptr, size_t bytes) {
+    if (ptr == nullptr) return;
+    if (bytes < hw_config::HUGE_PAGE_MIN_BYTES) {
+        free(ptr);
+    } else {
+        // Large mappings (hugetlbfs or trimmed anonymous) are always whole huge pages
+        munmap(ptr, huge_page_round_up(bytes, hw_config::HUGE_PAGE_BYTES));
+    }
+}
+
+/**
+ * std::allocator replacement backed by huge_page_alloc.
+ */
+template <typename T>
+struct HugePageAllocator {
+    using value_type = T;
+
+    HugePageAllocator() noexcept = default;
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        if (n > size_t(-1) / sizeof(T)) throw bad_alloc();
+        return static_cast<T*>(huge_page_alloc(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t n) noexcept { huge_page_free(p, n * sizeof(T)); }
+
+    template <typename U>
+    bool operator==(const HugePageAllocator<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const HugePageAllocator<U>&) const noexcept { return false; }
+};
+
+template <typename T>
+using huge_vector = vector<T, HugePageAllocator<T>>;
+
+/**
+ * std::vector<T> of n value-initialised elements whose pages were advised per policy
+ * before the zero fill. For W / Y, which the APIs pass as std::vector: they get huge
+ * pages, but only malloc's alignment (16 B), unlike huge_vector.
+ */
+template <typename T>
+inline vector<T> make_huge_page_vector(size_t n) {
+    vector<T> v;
+    v.reserve(n);
+    advise_huge_pages(v.data(), n * sizeof(T));
+    v.resize(n);
+    return v;
+}
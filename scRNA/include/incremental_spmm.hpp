@@ -0,0 +1,128 @@
+#pragma once
+#include "csr.hpp"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+using namespace std;
+
+/*
+ * Incremental SpMM for appended cells
+ *
+ * X is genes x cells and grows by new cell batches (new columns, same genes);
+ * W grows by the matching rows. With X' = [X | dX] and W' = [W; dW]:
+ *
+ *   Y' = X' * W' = X * W + dX * dW = Y + dX * W'[cells:, :]
+ *
+ * so only dX is multiplied and Y is updated in place. A text sidecar next to
+ * Y (<y_path>.meta) records, per X segment, its path, shape, nnz, file size,
+ * mtime and a content fingerprint, plus fingerprints of the W prefix and of Y,
+ * so an append can check that the base X, W and Y are the ones Y was built from.
+ */
+
+/**
+ * One appended X file (the base matrix is segment 0).
+ */
+struct XSegmentMeta {
+    string path;
+    int cells = 0;
+    size_t nnz = 0;
+    uint64_t file_size = 0;
+    long long mtime = 0;          // filesystem last_write_time (clock ticks)
+    uint64_t hash = 0;            // csr_fingerprint of the segment as loaded
+};
+
+struct IncrementalMeta {
+    int genes = 0;
+    int cells = 0;                // Total cells over all segments (= rows of W used)
+    int K = 0;
+    size_t nnz = 0;
+    uint64_t w_hash = 0;          // dense_fingerprint of W[0:cells, :]
+    uint64_t y_hash = 0;          // dense_fingerprint of Y
+    vector<XSegmentMeta> segments;
+};
+
+/**
+ * 64-bit content fingerprint of a CSR matrix (shape, indptr, indices, data).
+ */
+uint64_t csr_fingerprint(const CSR& X);
+
+/**
+ * 64-bit content fingerprint of a dense float array.
+ */
+uint64_t dense_fingerprint(const float* data, size_t count);
+
+/**
+ * Sidecar metadata path for a Y file ("<y_path>.meta").
+ */
+string incremental_meta_path(const string& y_path);
+
+/**
+ * Describe one X file for the metadata (file size and mtime are read from disk).
+ */
+XSegmentMeta describe_x_segment(const CSR& X, const string& x_path);
+
+/**
+ * Metadata for a freshly computed Y = X * W.
+ */
+IncrementalMeta make_incremental_meta(const CSR& X, const string& x_path, const vector<float>& Y,
+                                      const vector<float>& W, int W_rows, int W_cols);
+
+/**
+ * Write / read the sidecar. Both throw runtime_error on I/O or format errors.
+ */
+void save_incremental_meta(const IncrementalMeta& meta, const string& meta_path);
+IncrementalMeta load_incremental_meta(const string& meta_path);
+
+/**
+ * Check that an X segment on disk is unchanged.
+ * Fast path: same file size and mtime. If the size matches but the mtime does not,
+ * or full is set, the file is reloaded and its fingerprint compared.
+ *
+ * @param seg Segment metadata
+ * @param full Always rehash the content
+ * @param reason Set to a description when the check fails
+ * @return true if the segment is unchanged
+ */
+bool validate_x_segment(const XSegmentMeta& seg, bool full, string& reason);
+
+/**
+ * Append cells: Y += dX * W[meta.cells : meta.cells + dX.ncols, :], in place.
+ * Validates shapes and the W prefix / Y fingerprints against meta, then updates meta.
+ *
+ * @param Y Existing result (row-major, genes x K), updated in place
+ * @param meta Metadata of Y, updated with the new segment
+ * @param X_delta New cells as CSR (genes x new_cells)
+ * @param delta_path Path of the delta X file (recorded in meta)
+ * @param W Full weight matrix including the new rows (row-major, W_rows x W_cols)
+ * @param W_rows Number of rows in W (must equal meta.cells + X_delta.ncols)
+ * @param W_cols Number of columns in W (must equal meta.K)
+ * @param log_annotation Optional log file annotation (e.g., "4" for "4_incremental.txt"). If empty, no logging is performed.
+ */
+void spmm_append_cells(vector<float>& Y, IncrementalMeta& meta, const CSR& X_delta, const string& delta_path,
+                       const vector<float>& W, int W_rows, int W_cols, const string& log_annotation = "");
+
+/**
+ * Load Y ("Y" dataset, rows x cols) from HDF5.
+ */
+vector<float> load_Y_h5(const string& y_path, int& rows, int& cols);
+
+/**
+ * Overwrite the existing "Y" dataset of y_path in place (same shape), or create the file.
+ * Throws on HDF5 errors.
+ */
+void write_Y_h5(const vector<float>& Y, int rows, int cols, const string& y_path);
+
+/**
+ * Full incremental pipeline: validate the base segments and Y against the sidecar,
+ * load dX and W, append, write Y in place and update the sidecar.
+ *
+ * @param y_path Existing Y file (with <y_path>.meta)
+ * @param delta_x_path New cells in 10x HDF5 layout
+ * @param w_path W covering all cells (base + new)
+ * @param full_validation Rehash every base segment instead of the size/mtime fast path
+ * @param log_annotation Optional log file annotation
+ * @return true on success, false on failure (reason printed to stderr)
+ */
+bool incremental_run_from_disk(const string& y_path, const string& delta_x_path, const string& w_path,
+                               bool full_validation = false, const string& log_annotation = "");
@@ -0,0 +1,113 @@
+#pragma once
+#include "csr.hpp"
+#include "span.hpp"
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+/*
+ * Matrix-specialised SpMM kernels, generated and compiled at run time
+ *
+ * For a fixed X that meets many W, JitSpmmKernel writes C++ source specialised to the
+ * sparsity structure of X (not its values) and to the K of W:
+ *   - rows are emitted in SELL-style chunks of rows_per_chunk rows, one function per chunk,
+ *     with every row's offset into indices/data and its length hard-coded (no indptr reads)
+ *   - rows with nnz <= unroll_max use a fully unrolled body instantiated for that exact length
+ *   - K is a compile-time constant, so the inner loop over K has a fixed trip count
+ * The source is compiled with the system compiler into a shared object (the compiler, each
+ * whitespace-separated flag and the paths are shell-quoted on the command line). The object is
+ * cached under cache_dir by structure fingerprint, K and flags, and loaded with dlopen,
+ * so a later run on the same X skips the compile. Values are still read from X.data, so
+ * normalised or rescaled copies of X with the same structure reuse the kernel.
+ *
+ * If the cache directory cannot be created or written, there is no compiler, compilation
+ * fails or dlopen fails, the kernel falls back to spmm_fixed_k_into, the generic
+ * K-specialised kernel, and records why. The generated code keeps spmm_baseline's per-row
+ * summation order and is built with -ffp-contract=off, so all three kernels give identical Y.
+ */
+
+struct JitConfig {
+    string cache_dir = "../build/jit_cache";
+    string compiler;             // Empty: $CXX if set, else "g++"
+    // -fno-loop-unroll-and-jam: GCC otherwise jams pairs of nonzeros of a long row and the
+    // K loop is left scalar
+    string flags = "-O3 -march=native -ffp-contract=off -fno-loop-unroll-and-jam -fopenmp -shared -fPIC";
+    int rows_per_chunk = 8;      // Rows per generated chunk function (also the OpenMP work unit)
+    int unroll_max = 16;         // Rows with at most this many nonzeros get a fully unrolled body
+};
+
+struct JitBuildInfo {
+    string fingerprint;          // Hex structure fingerprint of X
+    string so_path;              // Cached shared object
+    bool jitted = false;         // false: running the generic fallback
+    bool cache_hit = false;      // Shared object was already in the cache
+    string fallback_reason;
+    double fingerprint_ms = 0.0;
+    double codegen_ms = 0.0;
+    double compile_ms = 0.0;
+    double load_ms = 0.0;
+    size_t source_bytes = 0;
+    size_t unrolled_rows = 0;    // Rows with a fully unrolled body
+};
+
+/**
+ * 64-bit fingerprint of the shape, indptr and indices of X (values are not included).
+ */
+uint64_t csr_structure_fingerprint(const CSR& X);
+
+/**
+ * Generic K-specialised SpMM: Y = X * W with W_cols instantiated as a compile-time
+ * constant for K = 8, 16, 32, 64, 128 (other K use spmm_baseline_into). Same per-row
+ * summation order as spmm_baseline.
+ *
+ * @param Y Output (row-major, X.nrows x W_cols); overwritten
+ */
+void spmm_fixed_k_into(const CSR& X, const vector<float>& W, int W_rows, int W_cols, Span<float> Y);
+
+class JitSpmmKernel {
+public:
+    /**
+     * Build (or load from the cache) the kernel for X and K.
+     *
+     * @param X Sparse CSR matrix whose structure the kernel is specialised to
+     * @param K Number of columns of the W matrices it will be run with
+     * @param cfg Compiler, cache and code-generation options
+     * @param log_annotation Optional log file annotation (e.g., "4" for "4_jit.txt"). If empty, no logging is performed.
+     */
+    JitSpmmKernel(const CSR& X, int K, const JitConfig& cfg = JitConfig(), const string& log_annotation = "");
+    ~JitSpmmKernel();
+
+    JitSpmmKernel(const JitSpmmKernel&) = delete;
+    JitSpmmKernel& operator=(const JitSpmmKernel&) = delete;
+
+    /**
+     * Y = X * W. X must have the structure the kernel was built for: the shape, nnz and
+     * structure fingerprint are checked on every call, and a mismatch throws runtime_error.
+     *
+     * @param Y Output (row-major, X.nrows x W_cols); overwritten
+     */
+    void run_into(const CSR& X, const vector<float>& W, int W_rows, int W_cols, Span<float> Y) const;
+
+    vector<float> run(const CSR& X, const vector<float>& W, int W_rows, int W_cols) const;
+
+    const JitBuildInfo& info() const { return info_; }
+    bool jitted() const { return info_.jitted; }
+
+private:
+    typedef void (*KernelFn)(const int* indices, const float* data, const float* W, float* Y);
+
+    string generate_source(const CSR& X) const;
+
+    JitConfig cfg_;
+    JitBuildInfo info_;
+    int K_ = 0;
+    int nrows_ = 0;
+    int ncols_ = 0;
+    size_t nnz_ = 0;
+    uint64_t fingerprint_ = 0;   // csr_structure_fingerprint of the X the kernel was built for
+    void* handle_ = nullptr;
+    KernelFn fn_ = nullptr;
+};
@@ -0,0 +1,70 @@
+#pragma once
+#include "csr.hpp"
+#include <vector>
+#include <string>
+
+using namespace std;
+
+/*
+ * Approximate kNN graph over the rows of a dense embedding (n points x dim,
+ * row-major), e.g. cell scores from rsvd or any projected matrix.
+ *
+ *   1. Random-projection forest: each tree splits points by random hyperplanes
+ *      until leaves hold <= leaf_size points; all pairs inside a leaf seed the lists.
+ *   2. NN-descent: neighbors of neighbors (and reverse neighbors) refine the lists
+ *      until fewer than delta * n * k updates happen in an iteration.
+ * Both phases only ever write the neighbor list of the point being processed
+ * (leaves of one tree are disjoint; NN-descent is pull-style from a snapshot),
+ * so the parallel loops need no locks.
+ *
+ * The graph is returned as CSR (n x n): row i holds its k neighbors (sorted by
+ * index) with Euclidean distances as values.
+ */
+
+struct KnnParams {
+    int k = 15;                   // Neighbors per point (excluding the point itself)
+    int rp_trees = 4;             // Random-projection trees for initialization (0 = random init)
+    int leaf_size = 0;            // Max points per leaf (0 = max(2k, 32))
+    int max_iters = 10;           // NN-descent iterations
+    double delta = 0.001;         // Stop when updates < delta * n * k
+    int max_candidates = 0;       // New/old neighbors sampled per point per iteration (0 = k)
+    unsigned seed = 42;
+};
+
+struct KnnStats {
+    size_t distance_evals = 0;
+    int iterations = 0;
+    vector<size_t> updates_per_iter;
+    double rp_forest_ms = 0.0;
+    double descent_ms = 0.0;
+    double total_ms = 0.0;
+};
+
+/**
+ * Squared Euclidean distance (AVX-512 / AVX2 when available, fully unrolled for dim = 32).
+ */
+float squared_l2(const float* a, const float* b, int dim);
+
+/**
+ * Approximate kNN graph via RP forest + NN-descent.
+ *
+ * @param Y Dense embedding (row-major, n x dim)
+ * @param n Number of points (rows of Y)
+ * @param dim Embedding dimension (columns of Y)
+ * @param params k, forest and descent settings
+ * @param stats Optional output for distance evaluations, iterations and timing
+ * @param log_annotation Optional log file annotation (e.g., "4" for "4_knn.txt"). If empty, no logging is performed.
+ * @return kNN graph as CSR (n x n, k entries per row, values = distances)
+ */
+CSR build_knn_graph(const vector<float>& Y, int n, int dim, const KnnParams& params,
+                    KnnStats* stats = nullptr, const string& log_annotation = "");
+
+/**
+ * Exact kNN graph by brute force (O(n^2 dim)); reference for recall.
+ */
+CSR exact_knn_graph(const vector<float>& Y, int n, int dim, int k);
+
+/**
+ * Fraction of exact neighbors found by the approximate graph (same k per row).
+ */
+double knn_recall(const CSR& approx, const CSR& exact);
@@ -251,6 +251,44 @@ inline void log_openmp_threads_tilepredpermspmm(const string& annotation, int nu
     log_to_file_tilepredpermspmm(annotation, ss.str());
 }
 
+/**
+ Helper function to get log file path for per-experiment logs
+ 
+ @param annotation Log file annotation (e.g., "2" for "2_<experiment>.txt")
+ @param experiment Experiment suffix (e.g., "halfprec" for "2_halfprec.txt")
+ @param base_path Base directory for logs (default: "../logs/")
+ @return Full path to log file
+ */
+inline string log_file_path_experiment(const string& annotation, const string& experiment,
+                                       const string& base_path = "../logs/") {
+    string prefix = annotation.empty() ? "0" : annotation;
+    return base_path + prefix + "_" + experiment + ".txt";
+}
+
+/**
+ Helper function to reset a per-experiment log file
+ */
+inline void reset_log_experiment(const string& annotation, const string& experiment,
+                                 const string& base_path = "../logs/") {
+    string log_filename = log_file_path_experiment(annotation, experiment, base_path);
+    fs::create_directories(fs::path(log_filename).parent_path());
+    ofstream log(log_filename, ios::trunc);
+}
+
+/**
+ Helper function to append to a per-experiment log file
+ */
+inline void log_to_file_experiment(const string& annotation, const string& experiment, const string& message,
+                                   const string& base_path = "../logs/") {
+    string log_filename = log_file_path_experiment(annotation, experiment, base_path);
+    fs::create_directories(fs::path(log_filename).parent_path());
+    ofstream log(log_filename, ios::app);
+    if (log.is_open()) {
+        log << message;
+        log.close();
+    }
+}
+
 #ifdef USE_CUDA
 #include "dense_spmm_cuda.hpp"
 
@@ -0,0 +1,53 @@
+#pragma once
+#include "csr.hpp"
+#include "../config/hw_config.h"
+#include <string>
+
+using namespace std;
+
+/*
+ * Parallel MatrixMarket (.mtx) reader
+ *
+ * Reads "%%MatrixMarket matrix coordinate real|integer|pattern general|symmetric"
+ * files, such as the ones mmwrite produces in sanitycheck/mtxreaderH5*.py or the
+ * Cell Ranger MEX matrix.mtx, straight into CSR:
+ *   1. mmap the file; parse the banner and size line
+ *   2. split the entries at line boundaries, one chunk per thread
+ *   3. each thread parses its chunk with from_chars into (row, col, value)
+ *      triplets and counts entries per output row
+ *   4. scan the per-thread counts and scatter in thread order (parallel counting
+ *      sort, as in transpose_csr), then sort any row that arrived out of order
+ * The result has sorted column indices, so it matches the HDF5 loader for the
+ * same matrix.
+ *
+ * Orientation: scanpy's mmwrite writes cells x genes, while Cell Ranger's MEX and
+ * our CSR are genes x cells. Set transpose for the former.
+ */
+
+struct MtxReadOptions {
+    bool transpose = false;                   // File is cells x genes: return its transpose (genes x cells)
+    int num_threads = hw_config::NUM_THREADS; // Parser threads
+};
+
+struct MtxReadStats {
+    size_t file_bytes = 0;
+    size_t entries = 0;            // Entries in the file (before symmetric expansion)
+    int threads = 0;
+    double map_ms = 0.0;           // open + mmap + banner
+    double parse_ms = 0.0;         // Parallel text -> triplets
+    double build_ms = 0.0;         // Counting sort into CSR
+    double total_ms = 0.0;
+    double parse_gb_per_s = 0.0;   // file_bytes / parse_ms
+};
+
+/**
+ * Load a MatrixMarket coordinate file as CSR.
+ *
+ * @param mtx_path Path to the .mtx file
+ * @param options Orientation and thread count
+ * @param stats Optional timing / throughput report
+ * @param log_annotation Optional log file annotation (e.g., "0" for log0.txt). If empty, no logging is performed.
+ * @return CSR with sorted column indices (values as float; pattern entries are 1)
+ */
+CSR load_mtx_as_csr(const string& mtx_path, const MtxReadOptions& options = MtxReadOptions(),
+                    MtxReadStats* stats = nullptr, const string& log_annotation = "");
@@ -0,0 +1,61 @@
+#pragma once
+#include "csr.hpp"
+#include <vector>
+#include <string>
+
+using namespace std;
+
+/*
+ * Fused Normalization + SpMM
+ *
+ * Applies the standard scRNA preprocessing on the fly inside the SpMM kernel,
+ * without creating a modified copy of X (rows = genes, columns = cells):
+ *
+ *   x' = log1p(x * s_c)        s_c = target_sum / library_size(c)
+ *   z  = (x' - mu_g) / sd_g    optional per-gene centering / scaling
+ *   Y  = Z * W
+ *
+ * Centering is handled algebraically so sparsity is preserved:
+ *   Y[g,:] = (sum_c x'[g,c] W[c,:] - mu_g * colsum(W)) / sd_g
+ * mu_g and sd_g are accumulated in the same pass as the product, since each
+ * gene is one CSR row.
+ */
+
+struct NormalizeParams {
+    bool library_size = true;   // Scale each cell to target_sum total counts
+    double target_sum = 1e4;    // 1e4 (scanpy default); use 1e6 for CPM
+    bool log1p = true;          // Apply log1p after library-size scaling
+    bool center = false;        // Subtract per-gene mean (rank-1 correction on Y)
+    bool scale = false;         // Divide by per-gene standard deviation (ddof = 1)
+};
+
+/**
+ * Per-cell scale factors s_c = target_sum / library_size(c), in one pass over X.
+ * Cells with zero library size get a factor of 0.
+ *
+ * @param X CSR matrix (genes x cells)
+ * @param target_sum Total counts each cell is scaled to
+ * @return Scale factor per column of X (size X.ncols)
+ */
+vector<float> compute_cell_scale_factors(const CSR& X, double target_sum);
+
+/**
+ * Scale factors from precomputed library sizes (e.g., from a statistics pass).
+ */
+vector<float> cell_scale_factors_from_library_size(const vector<double>& library_size, double target_sum);
+
+/**
+ * Fused normalize + SpMM: Y = normalize(X) * W
+ *
+ * @param X Sparse CSR matrix (genes x cells), raw counts
+ * @param W Dense weight matrix (row-major, cells x W_cols)
+ * @param W_rows Number of rows in W
+ * @param W_cols Number of columns in W
+ * @param params Normalization options
+ * @param cell_scale Optional precomputed per-cell scale factors; computed from X if null and params.library_size is set
+ * @param log_annotation Optional log file annotation for OpenMP thread logging. If empty, no logging is performed.
+ * @return Result vector Y (row-major, X.nrows x W_cols)
+ */
+vector<float> spmm_normalized(const CSR& X, const vector<float>& W, int W_rows, int W_cols,
+                              const NormalizeParams& params, const vector<float>* cell_scale = nullptr,
+                              const string& log_annotation = "");
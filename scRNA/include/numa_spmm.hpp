@@ -0,0 +1,164 @@
+#pragma once
+#include "csr.hpp"
+#include "span.hpp"
+#include "../config/hw_config.h"
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstddef>
+
+using namespace std;
+
+/*
+ * NUMA-aware SpMM
+ *
+ * On a multi-socket node the loader first-touches every CSR array from one
+ * thread, so all pages land on one socket and the other socket's threads read
+ * across the interconnect. NUMA mode instead:
+ *   - pins OpenMP threads to CPUs, grouped by socket (NUMA node), for the duration of
+ *     each parallel region (every thread gets its previous affinity mask back afterwards),
+ *   - splits X into one contiguous row panel per node, balanced by nnz,
+ *   - allocates each panel's indptr/indices/data and its Y rows uninitialised and
+ *     first-touches them from the threads that will later compute those rows,
+ *   - replicates W once per node, first-touched by that node's threads.
+ *
+ * Topology comes from /sys/devices/system/node (no libnuma dependency). On a
+ * single-node machine, or if sysfs is unavailable, everything runs as one node.
+ */
+
+/**
+ * CPUs per NUMA node, restricted to the CPUs this process may run on.
+ */
+struct NumaTopology {
+    vector<vector<int>> node_cpus;     // node_cpus[n] = CPU ids of node n
+    int num_nodes() const { return static_cast<int>(node_cpus.size()); }
+    int num_cpus() const;
+};
+
+/**
+ * Read the NUMA topology from sysfs (falls back to one node with all allowed CPUs).
+ */
+NumaTopology detect_numa_topology();
+
+struct NumaConfig {
+    int num_threads = hw_config::NUM_THREADS;  // Total threads across all nodes
+    bool pin_threads = true;                   // Bind each thread to one CPU of its node
+    bool replicate_W = true;                   // One W copy per node (else W is shared)
+};
+
+/**
+ * Uninitialised buffer for trivially copyable T: unlike vector<T>, allocation does
+ * not touch the pages, so the first write decides which node they live on.
+ */
+template <typename T>
+class NumaBuffer {
+public:
+    NumaBuffer() = default;
+    explicit NumaBuffer(size_t n) { allocate(n); }
+    ~NumaBuffer() { free(ptr_); }
+    NumaBuffer(const NumaBuffer&) = delete;
+    NumaBuffer& operator=(const NumaBuffer&) = delete;
+    NumaBuffer(NumaBuffer&& o) noexcept : ptr_(o.ptr_), size_(o.size_) { o.ptr_ = nullptr; o.size_ = 0; }
+    NumaBuffer& operator=(NumaBuffer&& o) noexcept {
+        if (this != &o) {
+            free(ptr_);
+            ptr_ = o.ptr_; size_ = o.size_;
+            o.ptr_ = nullptr; o.size_ = 0;
+        }
+        return *this;
+    }
+
+    void allocate(size_t n) {
+        free(ptr_);
+        ptr_ = n ? static_cast<T*>(malloc(n * sizeof(T))) : nullptr;
+        if (n && ptr_ == nullptr) throw bad_alloc();
+        size_ = n;
+    }
+
+    T* data() { return ptr_; }
+    const T* data() const { return ptr_; }
+    size_t size() const { return size_; }
+    T& operator[](size_t i) { return ptr_[i]; }
+    const T& operator[](size_t i) const { return ptr_[i]; }
+
+private:
+    T* ptr_ = nullptr;
+    size_t size_ = 0;
+};
+
+/**
+ * Row panel of X owned by one NUMA node. indptr is rebased to the panel (indptr[0] = 0).
+ */
+struct NumaPanel {
+    int node = 0;
+    int row_begin = 0;                 // Global row range [row_begin, row_end)
+    int row_end = 0;
+    size_t nnz = 0;
+    NumaBuffer<int> indptr;
+    NumaBuffer<int> indices;
+    NumaBuffer<float> data;
+};
+
+/**
+ * X placed across NUMA nodes, plus the thread -> node / CPU / row-range plan
+ * that the placement was first-touched with (and that spmm_numa must reuse).
+ */
+struct NumaCSR {
+    int nrows = 0;
+    int ncols = 0;
+    size_t nnz = 0;
+    NumaTopology topology;
+    NumaConfig cfg;
+    vector<NumaPanel> panels;          // One per node that received threads
+    vector<int> thread_panel;          // thread -> index into panels
+    vector<int> thread_cpu;            // thread -> pinned CPU (-1 if not pinned)
+    vector<int> thread_row_begin;      // thread -> global row range it touches and computes
+    vector<int> thread_row_end;
+    bool pinned = false;               // All threads were pinned successfully
+    double placement_ms = 0.0;
+};
+
+/**
+ * Per-node timings and achieved bandwidth of one spmm_numa call.
+ * Bytes are compulsory traffic: the node's CSR panel, its W replica (read once)
+ * and its Y rows (written once).
+ */
+struct NumaSpmmStats {
+    vector<double> node_ms;            // Slowest thread of the node
+    vector<double> node_bytes;
+    vector<double> node_gbps;
+    double replicate_ms = 0.0;         // W replication (first touch per node)
+    double compute_ms = 0.0;
+};
+
+/**
+ * Split X into per-node row panels and first-touch them from pinned threads.
+ *
+ * @param X Sparse CSR matrix (as loaded)
+ * @param cfg Thread count and placement options
+ * @param log_annotation Optional log file annotation (e.g., "4" for "4_numa.txt"). If empty, no logging is performed.
+ */
+NumaCSR numa_place_csr(const CSR& X, const NumaConfig& cfg = NumaConfig(), const string& log_annotation = "");
+
+/**
+ * NUMA-aware SpMM into caller storage: Y = X * W on the placed panels.
+ * Each node reads its own panel and W replica. Every pinned thread zeroes and writes
+ * only its own rows of Y, so an untouched Y (e.g. a fresh NumaBuffer) is first-touched
+ * row range by row range on the node that computes it.
+ *
+ * @param X Placed matrix from numa_place_csr
+ * @param W Dense weight matrix (row-major)
+ * @param W_rows Number of rows in W
+ * @param W_cols Number of columns in W
+ * @param Y Output (row-major, X.nrows x W_cols); overwritten
+ * @param stats Optional per-node timing and bandwidth report
+ * @param log_annotation Optional log file annotation. If empty, no logging is performed.
+ */
+void spmm_numa_into(const NumaCSR& X, const vector<float>& W, int W_rows, int W_cols, Span<float> Y,
+                    NumaSpmmStats* stats = nullptr, const string& log_annotation = "");
+
+/**
+ * spmm_numa_into on a newly allocated, uninitialised Y (row-major, genes x W_cols).
+ */
+NumaBuffer<float> spmm_numa(const NumaCSR& X, const vector<float>& W, int W_rows, int W_cols,
+                            NumaSpmmStats* stats = nullptr, const string& log_annotation = "");
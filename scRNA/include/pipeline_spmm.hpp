@@ -0,0 +1,73 @@
+#pragma once
+#include "csr.hpp"
+#include "y_writer.hpp"
+#include <vector>
+#include <string>
+
+using namespace std;
+
+/*
+ * Pipelined end-to-end SpMM: load -> filter -> tile -> compute -> store
+ *
+ * The sequential path loads all of X, then W, then computes, then saves Y. Here
+ * X flows through the stages in panels of cells, one thread per stage, connected
+ * by bounded lock-free SPSC queues, so HDF5 reads, filtering, binning and SpMM
+ * overlap:
+ *   load    - hyperslab reads of one cell panel of the 10x CSC (indptr/indices/data)
+ *             and of the matching W rows
+ *   filter  - value-threshold filter (drops |x| < filter_threshold, as the PIM filter)
+ *   tile    - bins the panel's nonzeros by gene: CSC panel -> genes x panel_cells CSR
+ *   compute - Y += X_panel * W_panel (OpenMP over genes)
+ *   store   - writes Y to HDF5 in row blocks through YWriter (chunked, optionally compressed)
+ *
+ * The 10x file is stored by cell, so panels are cell (column) blocks and every
+ * panel contributes to every row of Y: the store stage can only start once the
+ * last panel is computed, and overlaps with the hand-off of Y row blocks rather
+ * than with loading. Within each gene row nonzeros are still accumulated in
+ * ascending cell order, so Y matches spmm_baseline bit for bit (without filtering).
+ */
+
+struct PipelineConfig {
+    int panel_cells = 16384;          // Cells per panel
+    int queue_depth = 4;              // Capacity of each inter-stage queue (panels)
+    double filter_threshold = 0.0;    // Drop |x| < threshold; <= 0 passes everything through
+    string y_path;                    // Output Y file ("Y" dataset); empty = no store stage
+    int store_rows = 4096;            // Rows of Y per store block (a multiple of y_writer.chunk_rows
+                                      // keeps compression on the writer's parallel path)
+    YWriterConfig y_writer;           // Y layout / compression
+};
+
+struct PipelineStageStats {
+    string name;
+    size_t items = 0;                 // Panels (or Y blocks) processed
+    size_t nnz = 0;                   // Nonzeros that went through the stage
+    double busy_ms = 0.0;             // Time spent working
+    double wait_in_ms = 0.0;          // Blocked on an empty input queue
+    double wait_out_ms = 0.0;         // Blocked on a full output queue
+    double out_mean_occupancy = 0.0;  // Mean output queue fill at push time (items)
+    double out_full_fraction = 0.0;   // Fraction of pushes that filled the output queue
+    int out_capacity = 0;
+};
+
+struct PipelineStats {
+    vector<PipelineStageStats> stages;
+    double total_ms = 0.0;
+    size_t nnz_in = 0;                // Nonzeros read from disk
+    size_t nnz_kept = 0;              // Nonzeros after filtering
+    string bottleneck;                // Stage with the largest busy time
+    YWriteStats y_write;              // Store stage write statistics
+};
+
+/**
+ * Run the pipelined end-to-end SpMM.
+ *
+ * @param x_h5_path X in 10x HDF5 layout (genes x cells, stored by cell)
+ * @param w_h5_path W ("W" dataset, cells x K)
+ * @param cfg Panel size, queue depth, filter and output options
+ * @param stats Optional per-stage throughput and queue occupancy report
+ * @param log_annotation Optional log file annotation (e.g., "4" for "4_pipeline.txt"). If empty, no logging is performed.
+ * @return Y (row-major, genes x K)
+ */
+vector<float> pipelined_spmm_from_disk(const string& x_h5_path, const string& w_h5_path,
+                                       const PipelineConfig& cfg = PipelineConfig(),
+                                       PipelineStats* stats = nullptr, const string& log_annotation = "");
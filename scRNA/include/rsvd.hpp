@@ -0,0 +1,70 @@
+#pragma once
+#include "csr.hpp"
+#include <vector>
+#include <string>
+
+using namespace std;
+
+/*
+ * Randomized SVD / PCA
+ *
+ * Computes the top-k singular triplets of A = X - mu * 1^T (X is genes x cells,
+ * mu is the per-gene mean over cells) with the randomized range finder:
+ *
+ *   Y = A * Omega            (Omega: cells x l Gaussian, l = k + oversample)
+ *   Q = qr(Y)
+ *   repeat power_iters:  Q = qr(A * qr(A^T * Q))
+ *   B^T = A^T * Q,  svd(B) -> U = Q * U_B, S, V
+ *
+ * A is never formed: centering is applied implicitly as a rank-1 correction
+ * around the SpMM products, so X stays sparse. X * M uses spmm_baseline,
+ * X^T * M uses spmm_transpose (no per-call X^T).
+ */
+
+struct RsvdParams {
+    int k = 32;               // Number of components
+    int oversample = 10;      // Extra random directions (l = k + oversample)
+    int power_iters = 2;      // Subspace (power) iterations
+    bool center = true;       // Implicit per-gene mean-centering (PCA)
+    unsigned seed = 42;       // Seed for the Gaussian test matrix
+};
+
+struct RsvdResult {
+    int k = 0;
+    int nrows = 0;            // genes
+    int ncols = 0;            // cells
+    vector<float> U;          // nrows x k, row-major (gene loadings)
+    vector<float> S;          // k singular values, descending
+    vector<float> V;          // ncols x k, row-major (right singular vectors; cell scores = V * diag(S))
+    double total_variance = 0.0;   // ||A||_F^2 / (ncols - 1), for explained-variance ratios
+
+    // Timing breakdown (ms)
+    double spmm_ms = 0.0;         // X * M products
+    double spmm_t_ms = 0.0;       // X^T * M products
+    double qr_ms = 0.0;           // orthonormalizations
+    double small_svd_ms = 0.0;    // l x l eigenproblem and back-projection
+    double total_ms = 0.0;
+};
+
+/**
+ * Randomized truncated SVD / PCA of a CSR matrix.
+ *
+ * @param X Sparse CSR matrix (genes x cells)
+ * @param params Rank, oversampling, power iterations, centering, seed
+ * @param log_annotation Optional log file annotation (e.g., "4" for "4_rsvd.txt"). If empty, no logging is performed.
+ * @return Top-k singular triplets and timing
+ */
+RsvdResult randomized_svd(const CSR& X, const RsvdParams& params, const string& log_annotation = "");
+
+/**
+ * Orthonormalize the columns of a row-major rows x cols matrix in place
+ * (modified Gram-Schmidt with one re-orthogonalization pass, in double).
+ * Columns that become numerically zero are replaced by zeros.
+ */
+void orthonormalize_columns(vector<float>& M, int rows, int cols);
+
+/**
+ * Eigen-decomposition of a symmetric n x n matrix (row-major, double) with cyclic Jacobi.
+ * Eigenvalues are returned in descending order; eigenvectors are the columns of evecs (row-major n x n).
+ */
+void symmetric_eigen_jacobi(const vector<double>& A, int n, vector<double>& evals, vector<double>& evecs);
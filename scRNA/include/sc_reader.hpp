@@ -0,0 +1,108 @@
+#pragma once
+#include "csr.hpp"
+#include <string>
+#include <vector>
+#include <memory>
+
+using namespace std;
+
+namespace H5 {
+class H5File;
+}
+
+/*
+ * Native readers for raw single-cell count files
+ *
+ * Reads the files Cell Ranger and AnnData write directly, so the Python step in
+ * sanitycheck/mtxreaderH5*.py is not needed before the pipeline:
+ *   10x HDF5 v3 - matrix/{data,indices,indptr,shape,barcodes,features/{id,name,feature_type}}
+ *                 (also our own d*.h5, which have no names: genes and cells are then "0", "1", ...)
+ *   10x HDF5 v2 - <genome>/{data,indices,indptr,shape,barcodes,genes,gene_names}
+ *                 (genes holds the ids; v2 has no feature types, all are "Gene Expression")
+ *   .h5ad       - X as a csr_matrix / csc_matrix group (cells x genes) or a dense dataset,
+ *                 obs/var names from each group's index column
+ * HDF5 converts the stored types on read (int32 counts, int64 indices/indptr).
+ *
+ * X is always returned as genes x cells CSR with sorted column indices, the same
+ * orientation as load_X_h5_as_csr. Cell-major storage (10x, h5ad CSR) is read as a
+ * cells x genes CSR and turned around with the parallel transpose_csr. h5ad CSC is
+ * already gene-major and only needs its rows sorted. Dense h5ad X is streamed in cell
+ * blocks. Names are read only when first asked for.
+ */
+
+enum class ScFormat { TenXV3, TenXV2, H5adCSR, H5adCSC, H5adDense };
+
+const char* sc_format_name(ScFormat format);
+
+struct ScReadOptions {
+    string feature_type;              // Keep only features of this type (e.g., "Gene Expression"); empty = all
+    bool unique_gene_names = true;    // Suffix duplicate gene names with -1, -2, ... (like var_names_make_unique)
+    int dense_block_cells = 4096;     // Dense h5ad X: cells per streamed block
+};
+
+class ScDataset {
+public:
+    /**
+     * Open path and detect its layout. Only shapes and attributes are read here
+     * (plus feature types when options.feature_type is set).
+     *
+     * @param path 10x .h5 or AnnData .h5ad file
+     * @param options Feature selection and reading options
+     */
+    explicit ScDataset(const string& path, const ScReadOptions& options = ScReadOptions());
+    ~ScDataset();
+
+    ScDataset(const ScDataset&) = delete;
+    ScDataset& operator=(const ScDataset&) = delete;
+
+    ScFormat format() const { return format_; }
+    int n_genes() const { return static_cast<int>(kept_rows_.empty() ? n_genes_file_ : kept_rows_.size()); }
+    int n_cells() const { return n_cells_; }
+    size_t nnz_stored() const { return nnz_stored_; }   // Before feature selection (0 for dense X)
+
+    /**
+     * Load X as genes x cells CSR (selected features only).
+     *
+     * @param log_annotation Optional log file annotation (e.g., "0" for log0.txt). If empty, no logging is performed.
+     */
+    CSR load_X(const string& log_annotation = "");
+
+    // Per-gene and per-cell annotations, loaded on first use
+    const vector<string>& gene_names();
+    const vector<string>& gene_ids();
+    const vector<string>& feature_types();
+    const vector<string>& barcodes();
+
+private:
+    CSR load_cell_major();
+    CSR load_gene_major();
+    CSR load_dense();
+    vector<string> read_gene_column(const string& column);
+    vector<string> select_rows(vector<string> all) const;
+
+    string path_;
+    ScReadOptions options_;
+    unique_ptr<H5::H5File> file_;
+    ScFormat format_;
+    string group_;                    // Matrix group ("matrix", "<genome>" or "X")
+    int n_genes_file_ = 0;
+    int n_cells_ = 0;
+    size_t nnz_stored_ = 0;
+    vector<int> kept_rows_;           // Selected feature rows (empty = all)
+
+    vector<string> gene_names_, gene_ids_, feature_types_, barcodes_;
+    bool have_gene_names_ = false, have_gene_ids_ = false, have_feature_types_ = false, have_barcodes_ = false;
+};
+
+/**
+ * Detect the layout of path and load X as genes x cells CSR.
+ *
+ * @param path 10x .h5 or AnnData .h5ad file
+ * @param log_annotation Optional log file annotation (e.g., "0" for log0.txt). If empty, no logging is performed.
+ */
+CSR load_sc_h5_as_csr(const string& path, const string& log_annotation = "");
+
+/**
+ * Make names unique in place: the second and later copies of a name get "-1", "-2", ...
+ */
+void make_names_unique(vector<string>& names);
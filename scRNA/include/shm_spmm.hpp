@@ -0,0 +1,100 @@
+#pragma once
+#include "csr.hpp"
+#include "../config/hw_config.h"
+#include <vector>
+#include <string>
+#include <cstddef>
+
+using namespace std;
+
+/*
+ * Multi-process SpMM over POSIX shared memory
+ *
+ * A coordinator copies X (CSR) and W once into a shared-memory segment
+ * (shm_open + mmap) and splits the work into shards:
+ *   GenePanels - contiguous row (gene) ranges, balanced by nnz. Each worker writes its own
+ *                rows of the shared Y, so Y matches spmm_baseline bit for bit.
+ *   CellRanges - contiguous column (cell) ranges, balanced by nnz. Each worker writes a
+ *                full genes x K partial Y of its own. The coordinator sums the partials in
+ *                worker order, so the result is deterministic but rounds differently.
+ * Workers are separate processes. Each one maps the segment by name and computes its shard
+ * single-threaded. The local launcher forks them. A remote or exec'd worker only needs the
+ * segment name and its index (shm_spmm_worker), which is the step towards multi-node runs.
+ *
+ * Segment layout (64 B aligned sections): header, shard bounds, per-worker results,
+ * indptr, indices, data, W, Y (GenePanels: genes x K; CellRanges: workers x genes x K).
+ */
+
+enum class ShmShardMode { GenePanels, CellRanges };
+
+struct ShmSpmmConfig {
+    int num_workers = hw_config::NUM_THREADS;        // Worker processes
+    ShmShardMode mode = ShmShardMode::GenePanels;
+};
+
+struct ShmSpmmStats {
+    size_t shm_bytes = 0;            // Segment size
+    double setup_ms = 0.0;           // Create the segment and copy X / W (once per ShmSpmm)
+    double launch_ms = 0.0;          // fork of all workers
+    double compute_ms = 0.0;         // Launch to last worker exit
+    double reduce_ms = 0.0;          // CellRanges: summing the partial Ys
+    double copy_out_ms = 0.0;        // Shared Y -> returned vector
+    double total_ms = 0.0;           // run() wall time
+    vector<double> worker_ms;        // Compute time measured inside each worker
+    vector<size_t> worker_nnz;       // Nonzeros per shard
+};
+
+/**
+ * Shared-memory SpMM session: X and W are copied into the segment once, and
+ * every run() launches a fresh set of workers over it. The segment is unlinked
+ * in the destructor.
+ */
+class ShmSpmm {
+public:
+    /**
+     * @param X Sparse CSR matrix (genes x cells)
+     * @param W Dense matrix (row-major, W_rows x W_cols)
+     * @param W_rows Number of rows in W (must equal X.ncols)
+     * @param W_cols Number of columns in W
+     * @param cfg Worker count and shard mode
+     */
+    ShmSpmm(const CSR& X, const vector<float>& W, int W_rows, int W_cols,
+            const ShmSpmmConfig& cfg = ShmSpmmConfig());
+    ~ShmSpmm();
+
+    ShmSpmm(const ShmSpmm&) = delete;
+    ShmSpmm& operator=(const ShmSpmm&) = delete;
+
+    /**
+     * Compute Y = X * W with the worker processes.
+     *
+     * @param stats Optional timing report (setup_ms is the session's one-off cost)
+     * @param log_annotation Optional log file annotation (e.g., "4" for "4_shm.txt"). If empty, no logging is performed.
+     * @return Y (row-major, X.nrows x W_cols)
+     */
+    vector<float> run(ShmSpmmStats* stats = nullptr, const string& log_annotation = "");
+
+    const string& name() const { return name_; }
+
+private:
+    string name_;
+    void* base_ = nullptr;
+    size_t bytes_ = 0;
+    ShmSpmmConfig cfg_;
+    double setup_ms_ = 0.0;
+};
+
+/**
+ * One-shot convenience: create a session, run once, tear it down.
+ */
+vector<float> spmm_shm(const CSR& X, const vector<float>& W, int W_rows, int W_cols,
+                       const ShmSpmmConfig& cfg = ShmSpmmConfig(), ShmSpmmStats* stats = nullptr,
+                       const string& log_annotation = "");
+
+/**
+ * Worker entry point: map segment shm_name and compute shard worker.
+ * Runs without OpenMP, so it is safe in a forked child.
+ *
+ * @return 0 on success, non-zero on failure
+ */
+int shm_spmm_worker(const string& shm_name, int worker);
@@ -0,0 +1,105 @@
+#pragma once
+#include "accel_backend.hpp"
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+using namespace std;
+
+/*
+ * Simulated accelerator
+ *
+ * Studies CPU/device routing and overlap on hosts without a GPU. Each submitted GEMM is
+ * computed by one of the device's own worker threads (serial, same summation order as
+ * dense_spmm_cpu_tile_into), so results can be checked. Its completion time comes from a
+ * model of a discrete device:
+ *   host -> device copy  one copy engine:     latency + bytes(X, W) / h2d bandwidth
+ *   kernel               `streams` engines:   launch overhead + 2*M*K*N / FLOP rate
+ *   device -> host copy  one copy engine:     latency + bytes(Y) / d2h bandwidth
+ * Each job is scheduled at submit time on the model timeline: every stage starts when its
+ * engine is free and the previous stage has finished. Modelled times only depend on the
+ * submit order and submit times, so the same run gives the same device figures.
+ *
+ * With pace set, a worker holds a finished job until its modelled completion, so the host
+ * sees device latency on the wall clock. A job whose host computation alone takes longer
+ * than the model completes late and is counted in AccelStats::late_jobs. This happens when
+ * the host has fewer free cores than the device has streams.
+ */
+
+struct SimAccelConfig {
+    int streams = 2;                 // Kernel engines (one worker thread each)
+    double h2d_gbps = 25.0;          // Host -> device bandwidth (GB/s, PCIe 4.0 x16)
+    double d2h_gbps = 25.0;          // Device -> host bandwidth (GB/s)
+    double transfer_latency_us = 10.0;
+    double launch_us = 5.0;          // Kernel launch overhead
+    double gflops = 10000.0;         // Sustained fp32 GEMM rate (GFLOP/s)
+    bool pace = true;                // Hold completions until the modelled time
+};
+
+class SimulatedAccelerator : public AccelBackend {
+public:
+    explicit SimulatedAccelerator(const SimAccelConfig& cfg = SimAccelConfig());
+    ~SimulatedAccelerator() override;
+
+    SimulatedAccelerator(const SimulatedAccelerator&) = delete;
+    SimulatedAccelerator& operator=(const SimulatedAccelerator&) = delete;
+
+    string name() const override;
+    AccelTicket submit_gemm(const float* X, const float* W, float* Y, int M, int K, int N) override;
+    bool poll(AccelTicket ticket) override;
+    void wait(AccelTicket ticket) override;
+    void synchronize() override;
+    AccelStats stats() const override;
+    void reset_stats() override;
+
+    /**
+     * Modelled time of one job on an idle device (ms).
+     */
+    double model_job_ms(int M, int K, int N) const;
+
+    const SimAccelConfig& config() const { return cfg_; }
+
+private:
+    typedef chrono::steady_clock Clock;
+
+    struct Job {
+        AccelTicket ticket = 0;
+        const float* X = nullptr;
+        const float* W = nullptr;
+        float* Y = nullptr;
+        int M = 0, K = 0, N = 0;
+        double done_us = 0.0;        // Modelled completion, relative to epoch_
+    };
+
+    void worker_loop();
+    bool ticket_done(AccelTicket ticket) const;
+    double h2d_us(size_t bytes) const;
+    double d2h_us(size_t bytes) const;
+    double kernel_us(int M, int K, int N) const;
+
+    SimAccelConfig cfg_;
+    mutable mutex m_;
+    condition_variable work_cv_;     // Workers wait for jobs
+    condition_variable done_cv_;     // Callers wait for completions
+    deque<Job> queue_;
+    vector<thread> workers_;
+    deque<unsigned char> done_;      // done_[t - done_base_]; completed front entries are dropped
+    AccelTicket done_base_ = 0;      // Tickets below this have completed
+    AccelTicket next_ticket_ = 0;
+    size_t in_flight_ = 0;
+    bool stop_ = false;
+
+    // Model timeline (microseconds since epoch_)
+    Clock::time_point epoch_;
+    bool started_ = false;
+    double h2d_free_us_ = 0.0;
+    double d2h_free_us_ = 0.0;
+    vector<double> stream_free_us_;
+    double first_submit_us_ = 0.0;
+    double last_done_us_ = 0.0;
+    AccelStats stats_;
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <string>
+#include <stdexcept>
+
+using namespace std;
+
+/*
+ * Non-owning view of a contiguous buffer (std::span is C++20; the project builds with C++17).
+ * Used by the *_into SpMM entry points, which write into caller-provided storage so
+ * repeated runs and multi-W batches can reuse one Y allocation.
+ */
+template <typename T>
+struct Span {
+    T* data = nullptr;
+    size_t size = 0;
+
+    Span() = default;
+    Span(T* d, size_t n) : data(d), size(n) {}
+    Span(vector<T>& v) : data(v.data()), size(v.size()) {}
+
+    T& operator[](size_t i) const { return data[i]; }
+    T* begin() const { return data; }
+    T* end() const { return data + size; }
+
+    /**
+     * Sub-view [offset, offset + count).
+     */
+    Span subspan(size_t offset, size_t count) const { return Span(data + offset, count); }
+};
+
+/**
+ * Throw if an output span holds fewer than needed elements.
+ */
+template <typename T>
+inline void require_span_size(const Span<T>& s, size_t needed, const string& name) {
+    if (s.size < needed) {
+        throw runtime_error("Output buffer too small: " + name + " has " + to_string(s.size)
+                           + " elements, needs " + to_string(needed));
+    }
+}
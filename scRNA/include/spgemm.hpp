@@ -0,0 +1,73 @@
+#pragma once
+#include "csr.hpp"
+#include "../config/hw_config.h"
+#include <vector>
+#include <string>
+
+using namespace std;
+
+/*
+ * Sparse-Sparse Matrix Multiplication (SpGEMM): C = A * B, all CSR.
+ *
+ * Row-wise Gustavson in two phases:
+ *   symbolic - count distinct output columns per row, prefix-sum into C.indptr
+ *   numeric  - accumulate values into the preallocated C
+ * B is split into column panels with the tiler (tile_rows = B.nrows, tile_cols =
+ * panel_cols), so a dense accumulator never exceeds panel_cols entries per thread.
+ * Per row and panel, a dense or a hash accumulator is used (Auto picks by the
+ * row's product count relative to the panel width).
+ *
+ * Optional top-k per row keeps only the k largest |values|, so similarity
+ * outputs (X * X^T, X^T * X) stay sparse.
+ */
+
+enum class SpgemmAccumulator {
+    Auto,
+    Dense,
+    Hash
+};
+
+struct SpgemmParams {
+    SpgemmAccumulator accumulator = SpgemmAccumulator::Auto;
+    int top_k = 0;                                    // Keep k largest |values| per row (0 = keep all)
+    bool exclude_diagonal = false;                    // Drop C(i, i) (self-similarity)
+    int panel_cols = hw_config::SPGEMM_PANEL_COLS;    // Column panel width of B (accumulator bound)
+};
+
+struct SpgemmStats {
+    size_t products = 0;          // Scalar multiply-adds (sum over A nonzeros of B row lengths)
+    size_t nnz_unpruned = 0;      // Output nnz before top-k / diagonal removal
+    size_t nnz_out = 0;
+    size_t dense_rows = 0;        // (row, panel) pairs handled by the dense accumulator
+    size_t hash_rows = 0;         // (row, panel) pairs handled by the hash accumulator
+    int num_panels = 0;
+    double panel_ms = 0.0;        // Splitting B into column panels
+    double symbolic_ms = 0.0;
+    double numeric_ms = 0.0;
+    double total_ms = 0.0;
+};
+
+/**
+ * SpGEMM: C = A * B
+ *
+ * @param A Sparse CSR matrix (m x k)
+ * @param B Sparse CSR matrix (k x n)
+ * @param params Accumulator choice, top-k pruning, diagonal removal, panel width
+ * @param stats Optional output for product counts and phase timing
+ * @param log_annotation Optional log file annotation (e.g., "4" for "4_spgemm.txt"). If empty, no logging is performed.
+ * @return C as CSR (m x n), column indices sorted within each row
+ */
+CSR spgemm(const CSR& A, const CSR& B, const SpgemmParams& params = SpgemmParams(),
+           SpgemmStats* stats = nullptr, const string& log_annotation = "");
+
+/**
+ * Gene-gene co-expression: C = X * X^T (genes x genes) for X genes x cells.
+ */
+CSR gene_coexpression(const CSR& X, const SpgemmParams& params = SpgemmParams(),
+                      SpgemmStats* stats = nullptr, const string& log_annotation = "");
+
+/**
+ * Cell-cell similarity: C = X^T * X (cells x cells) for X genes x cells.
+ */
+CSR cell_similarity(const CSR& X, const SpgemmParams& params = SpgemmParams(),
+                    SpgemmStats* stats = nullptr, const string& log_annotation = "");
@@ -1,6 +1,8 @@
 #pragma once
 #include "csr.hpp"
 #include "tiler.hpp"
+#include "spmm_stats.hpp"
+#include "span.hpp"
 #include <vector>
 #include <string>
 #include <stdexcept>
@@ -12,8 +14,21 @@ using namespace std;
  * Sparse-Dense Matrix Multiplication: Y = X * W
  * Pure computation function - no timing or logging.
  * @param log_annotation Optional log file annotation for OpenMP thread logging (e.g., "0" for log0.txt). If empty, no logging is performed.
+ * @param stats Optional statistics sink; if set, per-gene/per-cell QC stats are accumulated in the same pass
  */
-vector<float> spmm_baseline(const CSR& X, const vector<float>& W, int W_rows, int W_cols, const string& log_annotation = "");
+vector<float> spmm_baseline(const CSR& X, const vector<float>& W, int W_rows, int W_cols, const string& log_annotation = "",
+                            SpmmStats* stats = nullptr);
+
+/**
+ * Sparse-Dense Matrix Multiplication into a caller-provided buffer: Y = X * W (or Y += X * W).
+ * Same kernel as spmm_baseline; no allocation for Y, so one buffer can be reused across runs.
+ * @param Y Output (row-major, X.nrows x W_cols); must hold at least X.nrows * W_cols elements
+ * @param zero_Y Zero Y before accumulating; pass false if Y is already zeroed or to accumulate into it
+ * @param log_annotation Optional log file annotation for OpenMP thread logging. If empty, no logging is performed.
+ * @param stats Optional statistics sink; if set, per-gene/per-cell QC stats are accumulated in the same pass
+ */
+void spmm_baseline_into(const CSR& X, const vector<float>& W, int W_rows, int W_cols, Span<float> Y,
+                        bool zero_Y = true, const string& log_annotation = "", SpmmStats* stats = nullptr);
 
 /**
  * Tiled SpMM: Y = X * W using 2D tiling
@@ -29,7 +44,19 @@ vector<float> spmm_baseline(const CSR& X, const vector<float>& W, int W_rows, in
  * @param W_cols Number of columns in W
  * @param cfg Tiling configuration
  * @param log_annotation Optional log file annotation (e.g., "0" for log0.txt). If empty, no logging is performed.
+ * @param stats Optional statistics sink; if set, per-gene/per-cell QC stats are accumulated tile by tile
  * @return Pair of (result vector Y, number of tiles used)
  */
 pair<vector<float>, size_t> spmm_tiled(const CSR& X, const vector<float>& W, int W_rows, int W_cols, 
-                                       const TilingConfig& cfg, const string& log_annotation = "");
\ No newline at end of file
+                                       const TilingConfig& cfg, const string& log_annotation = "",
+                                       SpmmStats* stats = nullptr);
+
+/**
+ * Tiled SpMM into a caller-provided buffer (see spmm_tiled).
+ * @param Y Output (row-major, X.nrows x W_cols); must hold at least X.nrows * W_cols elements
+ * @param zero_Y Zero Y before accumulating; pass false if Y is already zeroed or to accumulate into it
+ * @return Number of tiles used
+ */
+size_t spmm_tiled_into(const CSR& X, const vector<float>& W, int W_rows, int W_cols,
+                       const TilingConfig& cfg, Span<float> Y, bool zero_Y = true,
+                       const string& log_annotation = "", SpmmStats* stats = nullptr);
@@ -0,0 +1,64 @@
+#pragma once
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/*
+ * Client side of the resident SpMM service (see spmm_server.hpp for the protocol).
+ */
+
+/**
+ * One persistent connection to the service.
+ */
+class SpmmClient {
+public:
+    /**
+     * Connect to the service socket. Throws runtime_error on failure.
+     */
+    explicit SpmmClient(const string& socket_path);
+    ~SpmmClient();
+
+    SpmmClient(const SpmmClient&) = delete;
+    SpmmClient& operator=(const SpmmClient&) = delete;
+
+    /**
+     * Send one request line and wait for the response line (without newline).
+     */
+    string request(const string& line);
+
+private:
+    int fd_ = -1;
+    string buffer_;
+};
+
+struct ServiceBenchResult {
+    int requests = 0;
+    int concurrency = 0;
+    int failures = 0;
+    double wall_ms = 0.0;
+    double throughput_rps = 0.0;
+    double latency_p50_ms = 0.0;
+    double latency_p95_ms = 0.0;
+    double latency_max_ms = 0.0;
+    double avg_batch = 0.0;       // Mean batch size reported by the server
+};
+
+/**
+ * Send `requests` PROJECT requests from `concurrency` connections in parallel and
+ * measure client-side latency and throughput.
+ *
+ * @param socket_path Service socket
+ * @param w_spec W specification (file:<path> or seed:<seed>:<K>); seeds are offset per request
+ * @param output_path Output path for Y ("none" to skip writing)
+ * @param requests Total number of requests
+ * @param concurrency Number of parallel client connections
+ */
+ServiceBenchResult bench_service(const string& socket_path, const string& w_spec, const string& output_path,
+                                 int requests, int concurrency);
+
+/**
+ * Run a one-shot command `runs` times (via the shell) and return the mean wall time per run in ms.
+ * Returns a negative value if the command fails.
+ */
+double bench_one_shot(const string& command, int runs);
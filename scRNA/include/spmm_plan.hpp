@@ -0,0 +1,128 @@
+#pragma once
+#include "csr.hpp"
+#include "tiler.hpp"
+#include "heavy_row_spmm.hpp"
+#include "span.hpp"
+#include "../config/hw_config.h"
+#include <vector>
+#include <string>
+#include <cstddef>
+
+using namespace std;
+
+/*
+ * Inspector-executor SpMM
+ *
+ * spmm_baseline, spmm_tiled and process_tiles_with_predictor analyse X again on every
+ * call. SpmmPlan does that analysis once per X. Inspection has four steps:
+ *   1. heavy rows   - rows with nnz >= heavy_fraction * ncols go to a dense block
+ *                     (split_heavy_rows), but only rows larger than one sparse panel's share
+ *                     of nnz: the panels balance every smaller row at CSR cost
+ *   2. tiling       - make_2d_tiles + predict_tile_density on the rest picks candidate tiles
+ *   3. conversion   - a candidate is materialised as a dense tile only if scanning its cells is
+ *                     cheaper than loading its CSR indices (cells * dense_cell_cost < nnz; the
+ *                     nnz * K multiply-adds are the same on both paths). Everything else stays
+ *                     in a sparse remainder CSR that keeps global column indices
+ *   4. partitioning - the remainder is cut into nnz-balanced row panels, and dense tiles are
+ *                     grouped by tile row so that bands can run in parallel without races
+ * execute() then only touches W and Y:
+ *   sparse panels (overwrite Y) -> dense tile bands (add) -> heavy rows (overwrite)
+ * Dense tiles keep their column order, so they read their rows of W in place. The sparse
+ * panels use spmm_baseline's inner loop, so rows that have no dense tile and are not heavy
+ * match spmm_baseline bit for bit.
+ *
+ * Inspection cost is reported on its own. break_even_runs() gives the number of executions
+ * after which the plan has paid for itself against an unplanned call.
+ */
+
+struct SpmmPlanConfig {
+    TilingConfig tiling;                                      // Tile grid (permutation pointers are ignored)
+    double dense_threshold = hw_config::DENSE_TILE_THRESHOLD; // Tile density that makes a tile a dense candidate
+    // Cost of one dense cell relative to one CSR nonzero. The dense tile loop only
+    // matches CSR when nearly every cell is nonzero, so only such tiles go dense
+    double dense_cell_cost = 0.95;
+    bool dense_tiles = true;                                  // false: all tiles stay in the sparse remainder
+    double heavy_fraction = hw_config::HEAVY_ROW_FRACTION;    // > 1 disables the heavy-row split
+    int panels_per_thread = 4;                                // Sparse row panels per OpenMP thread
+};
+
+/* Inspection report */
+struct SpmmPlanInfo {
+    double heavy_ms = 0.0;
+    double tiling_ms = 0.0;
+    double convert_ms = 0.0;
+    double partition_ms = 0.0;
+    double inspect_ms = 0.0;          // Sum of the above
+    size_t heavy_rows = 0;
+    size_t heavy_nnz = 0;
+    size_t num_tiles = 0;
+    size_t dense_tiles = 0;
+    size_t dense_nnz = 0;
+    size_t sparse_nnz = 0;
+    size_t sparse_panels = 0;
+    size_t plan_bytes = 0;            // Storage owned by the plan
+};
+
+struct SpmmPlanExecStats {
+    double sparse_ms = 0.0;
+    double dense_ms = 0.0;
+    double heavy_ms = 0.0;
+    double total_ms = 0.0;
+};
+
+/* One dense tile of X */
+struct PlanDenseTile {
+    int row_start = 0;
+    int col_start = 0;
+    int rows = 0;
+    int cols = 0;
+    size_t offset = 0;                // Into SpmmPlan's dense storage: rows x cols, row-major
+};
+
+class SpmmPlan {
+public:
+    /**
+     * Inspect X (copied into the plan's own formats; X may be released afterwards).
+     *
+     * @param X Sparse CSR matrix (genes x cells)
+     * @param cfg Routing and partitioning options
+     * @param log_annotation Optional log file annotation (e.g., "4" for "4_plan.txt"). If empty, no logging is performed.
+     */
+    explicit SpmmPlan(const CSR& X, const SpmmPlanConfig& cfg = SpmmPlanConfig(), const string& log_annotation = "");
+
+    /**
+     * Execute Y = X * W with the plan.
+     *
+     * @param W Dense weight matrix (row-major, W_rows x W_cols)
+     * @param W_rows Number of rows in W (must equal X.ncols)
+     * @param W_cols Number of columns in W
+     * @param Y Output (row-major, X.nrows x W_cols); overwritten
+     * @param stats Optional timing report
+     */
+    void execute_into(const vector<float>& W, int W_rows, int W_cols, Span<float> Y,
+                      SpmmPlanExecStats* stats = nullptr) const;
+
+    vector<float> execute(const vector<float>& W, int W_rows, int W_cols, SpmmPlanExecStats* stats = nullptr) const;
+
+    /**
+     * Executions after which inspect + n * planned_ms <= n * unplanned_ms
+     * (infinity if the plan is not faster than the unplanned call).
+     */
+    double break_even_runs(double unplanned_ms, double planned_ms) const;
+
+    const SpmmPlanInfo& info() const { return info_; }
+    int nrows() const { return nrows_; }
+    int ncols() const { return ncols_; }
+
+private:
+    int nrows_ = 0;
+    int ncols_ = 0;
+    SpmmPlanConfig cfg_;
+    SpmmPlanInfo info_;
+    HeavyRowSplit heavy_;                  // Dense heavy rows (light CSR released after inspection)
+    CSR sparse_;                           // Remainder: not heavy, not in a dense tile
+    vector<int> panel_bounds_;             // Sparse row panels [panel_bounds_[p], panel_bounds_[p + 1])
+    vector<PlanDenseTile> dense_tiles_;    // Grouped by tile row
+    vector<int> band_bounds_;              // Dense tiles of band b: [band_bounds_[b], band_bounds_[b + 1])
+    vector<float> dense_values_;
+};
@@ -0,0 +1,95 @@
+#pragma once
+#include "csr.hpp"
+#include <vector>
+#include <string>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include <atomic>
+#include <future>
+#include <set>
+#include <memory>
+#include <chrono>
+
+using namespace std;
+
+/*
+ * Resident SpMM service
+ *
+ * Loads X once and serves projection requests over a Unix domain socket, so
+ * repeated projections skip process startup, HDF5 open and the CSC -> CSR transpose.
+ *
+ * Protocol: one text line per request, one line per response.
+ *   PROJECT <w_spec> <output_path>   w_spec = file:<W.h5> | seed:<seed>:<K>
+ *                                    output_path = "none" to skip writing Y
+ *     -> OK <queue_ms> <compute_ms> <batch_size>
+ *   PING     -> OK pong
+ *   STATS    -> OK requests=<n> batches=<n> avg_batch=<x> compute_ms=<x>
+ *   SHUTDOWN -> OK bye   (requests not yet in a batch get ERR server shutting down)
+ *   (errors) -> ERR <message>
+ *
+ * Requests arriving within batch_window_ms of each other (up to max_batch) are
+ * served by one multi-W pass: their W are concatenated column-wise so X is
+ * streamed once for the whole batch, then Y is split per request.
+ */
+
+struct SpmmServerConfig {
+    string socket_path = "/tmp/scrna_spmm.sock";
+    int max_batch = 8;            // Max requests per multi-W pass
+    double batch_window_ms = 2.0; // How long the first request waits for companions
+    string log_annotation;        // Log annotation for "<annotation>_service.txt" (empty = no logging)
+};
+
+/**
+ * Procedural W: cells x K, N(0, 1) entries from a seeded generator.
+ */
+vector<float> procedural_W(int rows, int K, unsigned seed);
+
+class SpmmServer {
+public:
+    SpmmServer(CSR X, const SpmmServerConfig& cfg);
+    ~SpmmServer();
+
+    /**
+     * Bind the socket and serve until a SHUTDOWN request (blocking).
+     * Throws runtime_error if the socket cannot be created.
+     */
+    void run();
+
+private:
+    struct Job {
+        string w_spec;
+        string output_path;
+        chrono::high_resolution_clock::time_point enqueued;
+        promise<string> response;
+    };
+
+    void handle_connection(int fd);
+    string handle_request(const string& line);
+    void batch_loop();
+    void process_batch(vector<unique_ptr<Job>>& batch);
+
+    CSR X_;
+    SpmmServerConfig cfg_;
+    vector<float> batch_W_;      // Concatenated W of the current batch (batch thread only)
+    vector<float> batch_Y_;      // Y of the current batch, reused across batches
+
+    mutex queue_mutex_;
+    condition_variable queue_cv_;
+    deque<unique_ptr<Job>> queue_;
+
+    // Connection handlers are detached; run() waits for active_handlers_ to drop to zero
+    mutex clients_mutex_;
+    condition_variable handlers_cv_;
+    set<int> client_fds_;
+    size_t active_handlers_ = 0;
+
+    atomic<bool> stopping_{false};
+    int listen_fd_ = -1;
+
+    // Counters (batch thread only, read under queue_mutex_)
+    size_t total_requests_ = 0;
+    size_t total_batches_ = 0;
+    double total_compute_ms_ = 0.0;
+};
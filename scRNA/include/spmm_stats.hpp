@@ -0,0 +1,134 @@
+#pragma once
+#include "csr.hpp"
+#include <vector>
+#include <algorithm>
+#include <omp.h>
+
+using namespace std;
+
+/*
+ * SpMM statistics sink
+ *
+ * Per-gene (row) and per-cell (column) QC statistics accumulated while an SpMM
+ * engine streams X, so no separate QC pass is needed:
+ *   row_nnz, row_sum, row_sumsq   - genes: cells expressing, total counts, sum of squares
+ *   col_nnz, col_sum              - cells: genes detected, library size
+ * Rows are owned by one thread in the row-parallel engines and are written directly;
+ * column totals go through thread-private buffers reduced at the end.
+ */
+
+struct SpmmStats {
+    int nrows = 0;
+    int ncols = 0;
+    vector<int> row_nnz;
+    vector<double> row_sum;
+    vector<double> row_sumsq;
+    vector<int> col_nnz;
+    vector<double> col_sum;
+};
+
+/**
+ * Size and zero all statistics for an nrows x ncols matrix.
+ */
+inline void reset_spmm_stats(SpmmStats& stats, int nrows, int ncols) {
+    stats.nrows = nrows;
+    stats.ncols = ncols;
+    stats.row_nnz.assign(nrows, 0);
+    stats.row_sum.assign(nrows, 0.0);
+    stats.row_sumsq.assign(nrows, 0.0);
+    stats.col_nnz.assign(ncols, 0);
+    stats.col_sum.assign(ncols, 0.0);
+}
+
+/**
+ * Thread-private column accumulators: one (ncols) slice per thread, reduced into the sink.
+ */
+struct SpmmStatsColumnBuffers {
+    int ncols = 0;
+    int num_threads = 0;
+    vector<int> nnz;
+    vector<double> sum;
+
+    SpmmStatsColumnBuffers(int ncols_, int num_threads_)
+        : ncols(ncols_), num_threads(num_threads_),
+          nnz(static_cast<size_t>(num_threads_) * ncols_, 0),
+          sum(static_cast<size_t>(num_threads_) * ncols_, 0.0) {}
+
+    int* nnz_for(int tid) { return nnz.data() + static_cast<size_t>(tid) * ncols; }
+    double* sum_for(int tid) { return sum.data() + static_cast<size_t>(tid) * ncols; }
+
+    /**
+     * Add all thread slices into stats.col_nnz / stats.col_sum (parallel over columns).
+     */
+    void reduce_into(SpmmStats& stats) const {
+        #pragma omp parallel for schedule(static)
+        for (int c = 0; c < ncols; c++) {
+            int n = 0;
+            double s = 0.0;
+            for (int t = 0; t < num_threads; t++) {
+                n += nnz[static_cast<size_t>(t) * ncols + c];
+                s += sum[static_cast<size_t>(t) * ncols + c];
+            }
+            stats.col_nnz[c] += n;
+            stats.col_sum[c] += s;
+        }
+    }
+};
+
+/**
+ * Per-gene mean over all cells (zeros included).
+ */
+inline vector<double> spmm_stats_row_mean(const SpmmStats& stats) {
+    vector<double> mean(stats.nrows, 0.0);
+    if (stats.ncols == 0) return mean;
+    for (int i = 0; i < stats.nrows; i++) {
+        mean[i] = stats.row_sum[i] / stats.ncols;
+    }
+    return mean;
+}
+
+/**
+ * Per-gene sample variance over all cells (ddof=1, zeros included), as used for HVG ranking.
+ */
+inline vector<double> spmm_stats_row_variance(const SpmmStats& stats) {
+    vector<double> var(stats.nrows, 0.0);
+    if (stats.ncols < 2) return var;
+    for (int i = 0; i < stats.nrows; i++) {
+        double mean = stats.row_sum[i] / stats.ncols;
+        double v = (stats.row_sumsq[i] - stats.ncols * mean * mean) / (stats.ncols - 1);
+        var[i] = max(0.0, v);
+    }
+    return var;
+}
+
+/**
+ * Standalone statistics pass over X (reference for the fused engines / QC without SpMM).
+ */
+inline void compute_spmm_stats(const CSR& X, SpmmStats& stats) {
+    reset_spmm_stats(stats, X.nrows, X.ncols);
+    SpmmStatsColumnBuffers col_buffers(X.ncols, omp_get_max_threads());
+
+    #pragma omp parallel
+    {
+        int tid = omp_get_thread_num();
+        int* col_nnz = col_buffers.nnz_for(tid);
+        double* col_sum = col_buffers.sum_for(tid);
+
+        #pragma omp for schedule(static)
+        for (int i = 0; i < X.nrows; i++) {
+            double s = 0.0, sq = 0.0;
+            for (int idx = X.indptr[i]; idx < X.indptr[i + 1]; idx++) {
+                double v = X.data[idx];
+                s += v;
+                sq += v * v;
+                col_nnz[X.indices[idx]]++;
+                col_sum[X.indices[idx]] += v;
+            }
+            stats.row_nnz[i] = X.indptr[i + 1] - X.indptr[i];
+            stats.row_sum[i] = s;
+            stats.row_sumsq[i] = sq;
+        }
+    }
+
+    col_buffers.reduce_into(stats);
+}
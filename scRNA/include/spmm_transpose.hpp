@@ -0,0 +1,88 @@
+#pragma once
+#include "csr.hpp"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+using namespace std;
+
+/*
+ * Transposed SpMM: Z = X^T * M without materializing X^T per call.
+ *
+ * Two strategies over the row-oriented CSR:
+ *   PrivateBuffers  - each thread scatters into a private (X.ncols x M_cols) buffer,
+ *                     buffers are reduced in parallel. No extra copy of X, but the
+ *                     reduction costs threads * X.ncols * M_cols.
+ *   CachedTranspose - X^T is built once in parallel (as a CSR of X^T) and kept in a
+ *                     TransposeCache; every call is then a plain row-parallel SpMM.
+ * Auto picks between them from output size, thread count and nnz.
+ */
+
+enum class TransposeStrategy {
+    Auto,
+    PrivateBuffers,
+    CachedTranspose
+};
+
+/**
+ * Holds X^T (as CSR) built once for repeated transposed products.
+ * Keyed on the contents of the X it was built from (shape, nnz and a checksum of indptr,
+ * indices and data), not its address: a different matrix, or the same one modified in
+ * place, is a miss and X^T is rebuilt. Each use re-reads X once to check the key.
+ */
+struct TransposeCache {
+    CSR XT;
+    int source_nrows = 0;
+    int source_ncols = 0;
+    size_t source_nnz = 0;
+    uint64_t source_checksum = 0;
+    bool built = false;
+    double build_ms = 0.0;
+};
+
+/**
+ * 64-bit checksum of the shape, indptr, indices and data of X.
+ */
+uint64_t csr_content_checksum(const CSR& X);
+
+/**
+ * true if cache holds X^T for exactly this X.
+ */
+bool transpose_cache_matches(const TransposeCache& cache, const CSR& X);
+
+/**
+ * Parallel CSR transpose (equivalently CSR -> CSC of the same matrix).
+ * Column indices within each output row are sorted ascending.
+ *
+ * @param X Input CSR matrix (nrows x ncols)
+ * @return X^T as CSR (ncols x nrows)
+ */
+CSR transpose_csr(const CSR& X);
+
+/**
+ * Choose a strategy for Z = X^T * M.
+ *
+ * @param X Sparse CSR matrix
+ * @param M_cols Number of columns of M (and Z)
+ * @param num_threads Number of OpenMP threads that will run the product
+ * @param cache Optional cache; an already-built cache for X always wins
+ * @return PrivateBuffers or CachedTranspose
+ */
+TransposeStrategy select_transpose_strategy(const CSR& X, int M_cols, int num_threads,
+                                            const TransposeCache* cache = nullptr);
+
+/**
+ * Transposed SpMM: Z = X^T * M
+ *
+ * @param X Sparse CSR matrix (nrows x ncols)
+ * @param M Dense matrix (row-major, X.nrows x M_cols)
+ * @param M_rows Number of rows in M (must equal X.nrows)
+ * @param M_cols Number of columns in M
+ * @param strategy Strategy (Auto selects with select_transpose_strategy)
+ * @param cache Optional cache for CachedTranspose; without one, X^T is built and dropped per call
+ * @param log_annotation Optional log file annotation (e.g., "4" for "4_spmmT.txt"). If empty, no logging is performed.
+ * @return Z (row-major, X.ncols x M_cols)
+ */
+vector<float> spmm_transpose(const CSR& X, const vector<float>& M, int M_rows, int M_cols,
+                             TransposeStrategy strategy = TransposeStrategy::Auto,
+                             TransposeCache* cache = nullptr, const string& log_annotation = "");
@@ -0,0 +1,78 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+using namespace std;
+
+/*
+ * Bounded lock-free single-producer / single-consumer queue
+ *
+ * Ring buffer with one slot kept free; head is written only by the consumer and
+ * tail only by the producer, so push/pop need no locks or CAS. close() is called
+ * by the producer once it is done; the consumer drains what is left.
+ * Occupancy is sampled on every push for pipeline reports.
+ */
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) : slots_(capacity + 1) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * Producer: enqueue item if there is room (item is moved from only on success).
+     */
+    bool try_push(T& item) {
+        size_t tail = tail_.load(memory_order_relaxed);
+        size_t next = (tail + 1) % slots_.size();
+        if (next == head_.load(memory_order_acquire)) return false;
+        slots_[tail] = std::move(item);
+        tail_.store(next, memory_order_release);
+
+        size_t used = (next + slots_.size() - head_.load(memory_order_relaxed)) % slots_.size();
+        occupancy_sum_ += used;
+        pushes_++;
+        if (used == capacity()) full_pushes_++;
+        return true;
+    }
+
+    /**
+     * Consumer: dequeue into item if the queue is not empty.
+     */
+    bool try_pop(T& item) {
+        size_t head = head_.load(memory_order_relaxed);
+        if (head == tail_.load(memory_order_acquire)) return false;
+        item = std::move(slots_[head]);
+        head_.store((head + 1) % slots_.size(), memory_order_release);
+        return true;
+    }
+
+    void close() { closed_.store(true, memory_order_release); }
+    bool closed() const { return closed_.load(memory_order_acquire); }
+
+    /**
+     * True once the producer has closed the queue and everything has been popped.
+     */
+    bool drained() const {
+        return closed() && head_.load(memory_order_acquire) == tail_.load(memory_order_acquire);
+    }
+
+    size_t capacity() const { return slots_.size() - 1; }
+
+    // Producer-side statistics (read after the producer has finished)
+    size_t pushes() const { return pushes_; }
+    double mean_occupancy() const { return pushes_ ? static_cast<double>(occupancy_sum_) / pushes_ : 0.0; }
+    double full_fraction() const { return pushes_ ? static_cast<double>(full_pushes_) / pushes_ : 0.0; }
+
+private:
+    vector<T> slots_;
+    alignas(64) atomic<size_t> head_{0};
+    alignas(64) atomic<size_t> tail_{0};
+    atomic<bool> closed_{false};
+    size_t occupancy_sum_ = 0;
+    size_t pushes_ = 0;
+    size_t full_pushes_ = 0;
+};
@@ -0,0 +1,196 @@
+#pragma once
+#include "csr.hpp"
+#include "tiler.hpp"
+#include "span.hpp"
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+using namespace std;
+
+/*
+ * Compile-time tile geometry
+ *
+ * make_2d_tiles and spmm_tiled_into take the tile shape from TilingConfig at run time,
+ * so block indices need an integer division per nonzero. Every tile also rescans its rows
+ * and compares each column against the tile bounds, and the K loop has a runtime trip count.
+ *
+ * The engine here is instantiated for power-of-two shapes (32/64/128/256 rows x 32/64/128/256
+ * columns):
+ *   - block indices are shifts (i >> ROW_SHIFT) and offsets are masks (i & ROW_MASK)
+ *   - one pass per row band keeps a cursor per row in a fixed-size stack buffer
+ *     (int[TILE_ROWS]). Each column tile then only advances those cursors, so each nonzero is
+ *     visited once rather than once per column tile
+ *   - the K loop is instantiated for K = 8, 16, 32, 64, 128 (the set spmm_fixed_k_into
+ *     covers) with a constant trip count and unrolled by 8 (full unrolling was about 3x
+ *     slower at K = 128 in test_static_tiling)
+ *   - row bands write disjoint rows of Y and run in parallel
+ * find_static_tiling() is the runtime dispatch table keyed by (tile_rows, tile_cols).
+ * make_2d_tiles and spmm_tiled_into use it when TilingConfig::static_dispatch is set (it is
+ * off by default) and the shape is in the table. Other shapes, the statistics sink and rows
+ * with unsorted column indices stay on the runtime path.
+ *
+ * Within a row, nonzeros are still added in column-tile order and then index order, as in
+ * spmm_tiled_into. For sorted rows Y is therefore bitwise equal to the runtime path.
+ */
+
+template <int TR, int TC>
+struct StaticTileGeometry {
+    static_assert(TR > 0 && (TR & (TR - 1)) == 0, "tile rows must be a power of two");
+    static_assert(TC > 0 && (TC & (TC - 1)) == 0, "tile cols must be a power of two");
+
+    static constexpr int log2(int v) { return v <= 1 ? 0 : 1 + log2(v >> 1); }
+
+    static constexpr int TILE_ROWS = TR;
+    static constexpr int TILE_COLS = TC;
+    static constexpr int ROW_SHIFT = log2(TR);
+    static constexpr int COL_SHIFT = log2(TC);
+    static constexpr int ROW_MASK = TR - 1;
+    static constexpr int COL_MASK = TC - 1;
+
+    static constexpr int row_tiles(int nrows) { return (nrows + ROW_MASK) >> ROW_SHIFT; }
+    static constexpr int col_tiles(int ncols) { return (ncols + COL_MASK) >> COL_SHIFT; }
+};
+
+/* Column indices ascending within every row (the HDF5, MatrixMarket and h5ad loaders guarantee it) */
+inline bool csr_rows_sorted(const CSR& X) {
+    for (int i = 0; i < X.nrows; i++) {
+        for (int idx = X.indptr[i] + 1; idx < X.indptr[i + 1]; idx++) {
+            if (X.indices[idx] < X.indices[idx - 1]) return false;
+        }
+    }
+    return true;
+}
+
+/* Same tiles as make_2d_tiles, with shift arithmetic */
+template <int TR, int TC>
+vector<Tile> make_2d_tiles_static(const CSR& X) {
+    using G = StaticTileGeometry<TR, TC>;
+    const int num_row_tiles = G::row_tiles(X.nrows);
+    const int num_col_tiles = G::col_tiles(X.ncols);
+
+    vector<Tile> tiles(static_cast<size_t>(num_row_tiles) * num_col_tiles);
+    for (int rb = 0; rb < num_row_tiles; rb++) {
+        for (int cb = 0; cb < num_col_tiles; cb++) {
+            Tile& tile = tiles[static_cast<size_t>(rb) * num_col_tiles + cb];
+            tile.row_start = rb << G::ROW_SHIFT;
+            tile.row_end = min(tile.row_start + TR, X.nrows);
+            tile.col_start = cb << G::COL_SHIFT;
+            tile.col_end = min(tile.col_start + TC, X.ncols);
+        }
+    }
+
+    for (int i = 0; i < X.nrows; i++) {
+        Tile* band = tiles.data() + static_cast<size_t>(i >> G::ROW_SHIFT) * num_col_tiles;
+        for (int idx = X.indptr[i]; idx < X.indptr[i + 1]; idx++) {
+            band[X.indices[idx] >> G::COL_SHIFT].nnz++;
+        }
+    }
+    return tiles;
+}
+
+/* y += x * w over K columns; K = 0 means the runtime W_cols. Fixed K is unrolled by 8 */
+template <int K>
+inline void static_tile_axpy(float* __restrict__ y, float x, const float* __restrict__ w, int W_cols) {
+    if constexpr (K > 0) {
+        #pragma GCC unroll 8
+        for (int j = 0; j < K; j++) y[j] += x * w[j];
+    } else {
+        for (int j = 0; j < W_cols; j++) y[j] += x * w[j];
+    }
+}
+
+/* One row band, all column tiles in order (Y accumulated, not zeroed) */
+template <int TR, int TC, int K>
+void spmm_static_tile_band(const CSR& X, const float* W, int W_cols, int rb, float* Y) {
+    using G = StaticTileGeometry<TR, TC>;
+    int cursor[TR];     // Next nonzero of each row of the band
+    int row_end[TR];
+
+    const int row0 = rb << G::ROW_SHIFT;
+    const int rows = min(TR, X.nrows - row0);
+    for (int r = 0; r < rows; r++) {
+        cursor[r] = X.indptr[row0 + r];
+        row_end[r] = X.indptr[row0 + r + 1];
+    }
+
+    const int num_col_tiles = G::col_tiles(X.ncols);
+    for (int cb = 0; cb < num_col_tiles; cb++) {
+        for (int r = 0; r < rows; r++) {
+            float* y = Y + static_cast<size_t>(row0 + r) * W_cols;
+            int idx = cursor[r];
+            while (idx < row_end[r] && (X.indices[idx] >> G::COL_SHIFT) == cb) {
+                static_tile_axpy<K>(y, X.data[idx], W + static_cast<size_t>(X.indices[idx]) * W_cols, W_cols);
+                idx++;
+            }
+            cursor[r] = idx;
+        }
+    }
+}
+
+template <int TR, int TC, int K>
+void spmm_static_tiles_k(const CSR& X, const float* W, int W_cols, float* Y) {
+    const int num_row_tiles = StaticTileGeometry<TR, TC>::row_tiles(X.nrows);
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int rb = 0; rb < num_row_tiles; rb++) {
+        spmm_static_tile_band<TR, TC, K>(X, W, W_cols, rb, Y);
+    }
+}
+
+/* Y += X * W with compile-time tile geometry (rows of X must be sorted) */
+template <int TR, int TC>
+void spmm_static_tiles(const CSR& X, const vector<float>& W, int W_cols, Span<float> Y) {
+    switch (W_cols) {
+        case 8:   spmm_static_tiles_k<TR, TC, 8>(X, W.data(), W_cols, Y.data); break;
+        case 16:  spmm_static_tiles_k<TR, TC, 16>(X, W.data(), W_cols, Y.data); break;
+        case 32:  spmm_static_tiles_k<TR, TC, 32>(X, W.data(), W_cols, Y.data); break;
+        case 64:  spmm_static_tiles_k<TR, TC, 64>(X, W.data(), W_cols, Y.data); break;
+        case 128: spmm_static_tiles_k<TR, TC, 128>(X, W.data(), W_cols, Y.data); break;
+        default:  spmm_static_tiles_k<TR, TC, 0>(X, W.data(), W_cols, Y.data); break;
+    }
+}
+
+/* Dispatch table entry: the instantiations for one tile shape */
+struct StaticTilingKernels {
+    int tile_rows;
+    int tile_cols;
+    vector<Tile> (*make_tiles)(const CSR& X);
+    void (*spmm)(const CSR& X, const vector<float>& W, int W_cols, Span<float> Y);
+};
+
+template <int TR, int TC>
+constexpr StaticTilingKernels static_tiling_entry() {
+    return StaticTilingKernels{TR, TC, &make_2d_tiles_static<TR, TC>, &spmm_static_tiles<TR, TC>};
+}
+
+/* Index of a tile side in the table (32 -> 0 ... 256 -> 3), -1 if not instantiated */
+constexpr int static_tile_side_index(int side) {
+    return side == 32 ? 0 : side == 64 ? 1 : side == 128 ? 2 : side == 256 ? 3 : -1;
+}
+
+/**
+ * Kernels for a tile shape, or nullptr if the shape has no compile-time instantiation.
+ */
+inline const StaticTilingKernels* find_static_tiling(int tile_rows, int tile_cols) {
+    static const StaticTilingKernels table[16] = {
+        static_tiling_entry<32, 32>(),  static_tiling_entry<32, 64>(),
+        static_tiling_entry<32, 128>(), static_tiling_entry<32, 256>(),
+        static_tiling_entry<64, 32>(),  static_tiling_entry<64, 64>(),
+        static_tiling_entry<64, 128>(), static_tiling_entry<64, 256>(),
+        static_tiling_entry<128, 32>(), static_tiling_entry<128, 64>(),
+        static_tiling_entry<128, 128>(), static_tiling_entry<128, 256>(),
+        static_tiling_entry<256, 32>(), static_tiling_entry<256, 64>(),
+        static_tiling_entry<256, 128>(), static_tiling_entry<256, 256>(),
+    };
+    const int ri = static_tile_side_index(tile_rows);
+    const int ci = static_tile_side_index(tile_cols);
+    if (ri < 0 || ci < 0) return nullptr;
+    return &table[ri * 4 + ci];
+}
+
+/**
+ * Kernels for cfg, or nullptr if cfg disables static dispatch or its shape is not instantiated.
+ */
+inline const StaticTilingKernels* find_static_tiling(const TilingConfig& cfg) {
+    return cfg.static_dispatch ? find_static_tiling(cfg.tile_rows, cfg.tile_cols) : nullptr;
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+using namespace std;
+
+/*
+ * Bump allocator for per-tile scratch buffers
+ *
+ * The tile kernels need a handful of short-lived buffers per tile (extracted CSR,
+ * W rows, dense X, permutation maps, permuted copies, Y). A TileArena hands them
+ * out from one reserved block and is reset after each tile, so once the block is
+ * large enough the tile loop performs no heap allocations.
+ *
+ * If a request does not fit, an overflow block is allocated (and counted); the next
+ * reset() folds the overflow into a single larger block, so the arena converges
+ * to the peak footprint after one oversized tile.
+ */
+
+class TileArena {
+public:
+    static constexpr size_t ALIGNMENT = 64;
+
+    TileArena() = default;
+    TileArena(const TileArena&) = delete;
+    TileArena& operator=(const TileArena&) = delete;
+
+    /**
+     * Make sure at least bytes are available in the primary block (only grows).
+     */
+    void reserve(size_t bytes) {
+        if (bytes <= capacity_) return;
+        block_.reset(new unsigned char[bytes + ALIGNMENT]);
+        capacity_ = bytes;
+        offset_ = 0;
+        heap_allocations_++;
+    }
+
+    /**
+     * Uninitialised storage for n objects of trivially copyable T, aligned to ALIGNMENT.
+     * Valid until the next reset().
+     */
+    template <typename T>
+    T* alloc(size_t n) {
+        size_t bytes = round_up(n * sizeof(T));
+        used_ += bytes;
+        peak_ = max(peak_, used_);
+        if (offset_ + bytes <= capacity_) {
+            T* ptr = reinterpret_cast<T*>(aligned_base(block_.get()) + offset_);
+            offset_ += bytes;
+            return ptr;
+        }
+        overflow_.emplace_back(new unsigned char[bytes + ALIGNMENT]);
+        heap_allocations_++;
+        return reinterpret_cast<T*>(aligned_base(overflow_.back().get()));
+    }
+
+    /**
+     * Release everything handed out since the last reset.
+     */
+    void reset() {
+        if (!overflow_.empty()) {
+            overflow_.clear();
+            reserve(peak_);
+        }
+        offset_ = 0;
+        used_ = 0;
+        resets_++;
+    }
+
+    size_t capacity() const { return capacity_; }
+    size_t peak_bytes() const { return peak_; }
+    size_t heap_allocations() const { return heap_allocations_; }   // Block + overflow allocations so far
+    size_t resets() const { return resets_; }
+
+private:
+    static size_t round_up(size_t bytes) { return (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT; }
+    static unsigned char* aligned_base(unsigned char* p) {
+        uintptr_t addr = reinterpret_cast<uintptr_t>(p);
+        return p + ((ALIGNMENT - addr % ALIGNMENT) % ALIGNMENT);
+    }
+
+    unique_ptr<unsigned char[]> block_;
+    size_t capacity_ = 0;
+    size_t offset_ = 0;
+    size_t used_ = 0;
+    size_t peak_ = 0;
+    size_t heap_allocations_ = 0;
+    size_t resets_ = 0;
+    vector<unique_ptr<unsigned char[]>> overflow_;
+};
+
+/**
+ * Arena of the calling thread. Lives as long as the thread, so repeated tile
+ * loops on the same thread reuse the block sized by the first one.
+ */
+inline TileArena& thread_tile_arena() {
+    static thread_local TileArena arena;
+    return arena;
+}
+
+/**
+ * Upper bound on the scratch a tile of M rows x K cols needs with N output columns:
+ * extracted CSR (nnz <= M*K), W rows, and the dense path's dense X, two permuted
+ * copies, permuted W, permuted and final Y, nnz counts and permutation maps.
+ */
+inline size_t tile_arena_bytes(int M, int K, int N) {
+    auto a = [](size_t bytes) { return (bytes + TileArena::ALIGNMENT - 1) / TileArena::ALIGNMENT * TileArena::ALIGNMENT; };
+    size_t m = static_cast<size_t>(M), k = static_cast<size_t>(K), n = static_cast<size_t>(N);
+    size_t extracted = a((m + 1) * sizeof(int)) + a(m * k * sizeof(int)) + a(m * k * sizeof(float))
+                     + a(k * n * sizeof(float));
+    size_t dense = 3 * a(m * k * sizeof(float)) + a(k * n * sizeof(float)) + 2 * a(m * n * sizeof(float))
+                 + a(m * sizeof(size_t)) + a(k * sizeof(size_t)) + a(m * sizeof(int)) + a(k * sizeof(int));
+    return extracted + dense;
+}
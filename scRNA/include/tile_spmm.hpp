@@ -2,6 +2,10 @@
 #include "csr.hpp"
 #include "tiler.hpp"
 #include "permutation.hpp"
+#include "spmm_stats.hpp"
+#include "tile_arena.hpp"
+#include "span.hpp"
+#include "accel_backend.hpp"
 #include <vector>
 
 using namespace std;
@@ -102,9 +106,57 @@ vector<float> dense_perm_spmm_tile(const CSR& X_tile, const vector<float>& W_til
 vector<float> sparse_spmm_tile(const CSR& X_tile, const vector<float>& W_tile, 
                                int W_tile_rows, int W_cols);
 
+/**
+ * Tile extracted into arena storage: same layout as CSR, but the arrays are
+ * borrowed from a TileArena and valid until its next reset().
+ */
+struct TileCSRView {
+    int nrows = 0;
+    int ncols = 0;
+    size_t nnz = 0;
+    int* indptr = nullptr;
+    int* indices = nullptr;
+    float* data = nullptr;
+};
+
+/**
+ * Arena variant of extract_tile_csr (no heap allocation once the arena is sized).
+ */
+TileCSRView extract_tile_csr(const CSR& X, const Tile& tile, TileArena& arena);
+
+/**
+ * Arena variant of extract_tile_W.
+ * @return Pointer to (tile.col_end - tile.col_start) x W_cols floats in the arena
+ */
+float* extract_tile_W(const vector<float>& W, int W_rows, int W_cols, const Tile& tile, TileArena& arena);
+
+/**
+ * CPU dense GEMM into a caller-provided buffer: Y_dense = X_dense * W_dense (or Y_dense += ...).
+ * @param Y_dense Output (row-major, M × N); must hold at least M * N elements
+ * @param zero_Y Overwrite Y_dense; pass false to accumulate into it
+ */
+void dense_spmm_cpu_tile_into(const float* X_dense, const float* W_dense, Span<float> Y_dense,
+                              int M, int K, int N, bool zero_Y = true);
+
+/**
+ * Arena variant of dense_perm_spmm_tile: same permutation workflow, with every
+ * intermediate taken from the arena. Y_tile (X_tile.nrows x W_cols) is overwritten.
+ */
+void dense_perm_spmm_tile(const TileCSRView& X_tile, const float* W_tile,
+                          int W_tile_rows, int W_cols, float* Y_tile, TileArena& arena);
+
+/**
+ * Arena variant of sparse_spmm_tile. Y_tile (X_tile.nrows x W_cols) is overwritten.
+ */
+void sparse_spmm_tile(const TileCSRView& X_tile, const float* W_tile,
+                      int W_tile_rows, int W_cols, float* Y_tile);
+
 /**
  * Process all tiles with predictor-based routing and accumulate metrics.
  * This function handles the entire tiled SpMM workflow with logging.
+ * Per-tile scratch comes from the calling thread's TileArena (reserved for the
+ * largest tile up front and reset after every tile), so the steady-state tile
+ * loop performs no heap allocations.
  * 
  * @param X_original Original CSR matrix
  * @param W_original Original weight matrix (row-major)
@@ -112,11 +164,30 @@ vector<float> sparse_spmm_tile(const CSR& X_tile, const vector<float>& W_tile,
  * @param W_cols Number of columns in W
  * @param tiles Vector of tiles to process
  * @param log_annotation Log file annotation (e.g., "2" for "2_tilepredpermspmm.txt")
+ * @param stats Optional statistics sink; per-gene/per-cell QC stats are folded in from each extracted tile
+ * @param accel Optional accelerator routing: tiles at or above accel->threshold are prepared on the
+ *              host and run on accel->backend while the loop continues with the next tiles
  * @return Result matrix Y (row-major)
  */
 vector<float> process_tiles_with_predictor(const CSR& X_original, 
                                           const vector<float>& W_original,
                                           int W_rows, int W_cols,
                                           const vector<Tile>& tiles,
-                                          const string& log_annotation);
+                                          const string& log_annotation,
+                                          SpmmStats* stats = nullptr,
+                                          const AccelRouting* accel = nullptr);
+
 
+/**
+ * process_tiles_with_predictor into a caller-provided buffer.
+ * @param Y Output (row-major, X_original.nrows x W_cols); must hold at least X_original.nrows * W_cols elements
+ * @param zero_Y Zero Y before accumulating; pass false if Y is already zeroed or to accumulate into it
+ */
+void process_tiles_with_predictor_into(const CSR& X_original,
+                                       const vector<float>& W_original,
+                                       int W_rows, int W_cols,
+                                       const vector<Tile>& tiles,
+                                       Span<float> Y, bool zero_Y,
+                                       const string& log_annotation,
+                                       SpmmStats* stats = nullptr,
+                                       const AccelRouting* accel = nullptr);
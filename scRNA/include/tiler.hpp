@@ -57,6 +57,10 @@ struct TilingConfig {
     const vector<int>* perm_c = nullptr;      // Column permutation: new_col = perm_c[old_col]
     const vector<int>* inv_perm_c = nullptr;  // Inverse column permutation: old_col = inv_perm_c[new_col]
     
+    // Opt in to the compile-time tile engine (static_tiling.hpp) for power-of-two shapes
+    // from 32 to 256. Off by default. When enabled, spmm_tiled_into scans X once per call (csr_rows_sorted) before using it.
+    bool static_dispatch = false;
+    
     // Constructor with default values from hw_config
     TilingConfig() 
         : tile_rows(hw_config::TILE_ROWS), 
@@ -0,0 +1,122 @@
+#pragma once
+#include "../config/hw_config.h"
+#include <vector>
+#include <string>
+#include <memory>
+#include <chrono>
+
+using namespace std;
+
+namespace H5 {
+class H5File;
+class DataSet;
+}
+
+/*
+ * Chunked, optionally compressed writer for the "Y" dataset (rows x cols float)
+ *
+ * Y is stored in chunks of chunk_rows full rows. Row slabs can be written as they
+ * complete (pipelined / out-of-core runs) instead of in one serial write at the end.
+ * With deflate, chunk-aligned slabs are shuffled and compressed in parallel (OpenMP,
+ * zlib) and handed to HDF5 with H5Dwrite_chunk, so compression is no longer a serial
+ * tail. Unaligned slabs go through a regular hyperslab write, where HDF5 applies
+ * the same filters itself. The file reads back with any HDF5 reader.
+ * LZ4 uses the registered HDF5 LZ4 filter plugin (id 32004) when it is available,
+ * and deflate otherwise.
+ *
+ * Errors are thrown as runtime_error. Nothing is swallowed.
+ */
+
+enum class YCompression { None, Deflate, LZ4 };
+
+struct YWriterConfig {
+    int chunk_rows = 4096;                    // Rows per chunk; <= 0 = contiguous layout (no compression)
+    YCompression compression = YCompression::None;
+    int deflate_level = 4;                    // 1 (fast) .. 9 (small)
+    bool shuffle = true;                      // Byte-shuffle before deflate (helps float data)
+    int num_threads = hw_config::NUM_THREADS; // Parallel compression threads
+};
+
+struct YWriteStats {
+    string layout;                 // "contiguous" or "chunked"
+    string compression;            // Filter actually used (e.g., "deflate-4+shuffle", "none")
+    size_t raw_bytes = 0;          // Y bytes handed to the writer
+    size_t stored_bytes = 0;       // Dataset storage size on disk (after close)
+    size_t slabs = 0;              // write_rows calls
+    size_t direct_chunks = 0;      // Chunks compressed by the writer and written directly
+    double compress_ms = 0.0;      // Parallel compression time
+    double write_ms = 0.0;         // HDF5 write time (including filters it applies itself)
+    double total_ms = 0.0;         // Create to close
+    double mb_per_s = 0.0;         // raw_bytes / total_ms
+};
+
+class YWriter {
+public:
+    /**
+     * Create (truncate) path and its "Y" dataset.
+     *
+     * @param path Output HDF5 file; parent directories are created
+     * @param rows Rows of Y
+     * @param cols Columns of Y
+     * @param cfg Chunking / compression options
+     */
+    YWriter(const string& path, int rows, int cols, const YWriterConfig& cfg = YWriterConfig());
+    ~YWriter();
+
+    YWriter(const YWriter&) = delete;
+    YWriter& operator=(const YWriter&) = delete;
+
+    /**
+     * Write rows [row_begin, row_begin + row_count) from slab (row-major, row_count x cols).
+     * Slabs starting on a chunk boundary and covering whole chunks (or ending at the last
+     * row) take the parallel compression path.
+     */
+    void write_rows(int row_begin, int row_count, const float* slab);
+
+    /**
+     * Flush and close the file, and fill in the final statistics. Called by the destructor
+     * if needed (which then ignores errors), so call it explicitly to see them.
+     */
+    void close();
+
+    const YWriteStats& stats() const { return stats_; }
+
+private:
+    bool direct_chunk_slab(int row_begin, int row_count) const;
+    void write_direct_chunks(int row_begin, int row_count, const float* slab);
+    void write_hyperslab(int row_begin, int row_count, const float* slab);
+
+    string path_;
+    int rows_;
+    int cols_;
+    int chunk_rows_;
+    YWriterConfig cfg_;
+    bool deflate_;                    // Writer-side deflate (parallel direct chunk path)
+    unique_ptr<H5::H5File> file_;
+    unique_ptr<H5::DataSet> dataset_;
+    YWriteStats stats_;
+    chrono::high_resolution_clock::time_point start_;
+};
+
+/**
+ * Write Y in one call through YWriter. Throws runtime_error on failure.
+ *
+ * @param Y Row-major rows x cols
+ * @param rows Rows of Y
+ * @param cols Columns of Y
+ * @param path Output HDF5 file ("Y" dataset)
+ * @param cfg Chunking / compression options
+ * @param stats Optional write statistics
+ * @param log_annotation Optional log file annotation (e.g., "4" for "4_ywrite.txt"). If empty, no logging is performed.
+ */
+void save_Y_h5(const vector<float>& Y, int rows, int cols, const string& path,
+               const YWriterConfig& cfg = YWriterConfig(), YWriteStats* stats = nullptr,
+               const string& log_annotation = "");
+
+/**
+ * save_Y_h5 for the drivers: reports a failure on stderr instead of throwing.
+ *
+ * @return true if Y was written
+ */
+bool try_save_Y_h5(const vector<float>& Y, int rows, int cols, const string& path,
+                   const YWriterConfig& cfg = YWriterConfig(), const string& log_annotation = "");
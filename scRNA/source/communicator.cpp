@@ -0,0 +1,428 @@
+#include "../include/communicator.hpp"
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <sched.h>
+#include <stdexcept>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include <memory>
+#include <exception>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include <new>
+
+using namespace std;
+
+static const char* ABORT_MESSAGE = "communicator aborted: another rank failed";
+
+void Communicator::check_peer(int peer) const {
+    if (peer < 0 || peer >= size() || peer == rank()) {
+        throw runtime_error("communicator: invalid peer " + to_string(peer) + " for rank "
+                           + to_string(rank()) + " of " + to_string(size()));
+    }
+}
+
+void Communicator::send(int dest, const void* buf, size_t bytes) {
+    check_peer(dest);
+    send_bytes(dest, buf, bytes);
+    counters_.bytes_sent += bytes;
+    counters_.messages_sent++;
+}
+
+void Communicator::recv(int src, void* buf, size_t bytes) {
+    check_peer(src);
+    recv_bytes(src, buf, bytes);
+    counters_.bytes_received += bytes;
+    counters_.messages_received++;
+}
+
+void Communicator::broadcast(void* buf, size_t bytes, int root) {
+    if (rank() == root) {
+        for (int r = 0; r < size(); r++) {
+            if (r != root) send(r, buf, bytes);
+        }
+    } else {
+        recv(root, buf, bytes);
+    }
+}
+
+/* ---------------- Threads: one mailbox per (sender, receiver) ---------------- */
+
+struct ThreadWorld {
+    struct Mailbox {
+        mutex m;
+        condition_variable cv;
+        deque<vector<char>> messages;
+    };
+
+    explicit ThreadWorld(int n) : n(n), boxes(static_cast<size_t>(n) * n) {
+        for (auto& b : boxes) b = make_unique<Mailbox>();
+    }
+
+    Mailbox& box(int src, int dst) { return *boxes[static_cast<size_t>(src) * n + dst]; }
+
+    void abort() {
+        aborted.store(true);
+        for (auto& b : boxes) {
+            lock_guard<mutex> lock(b->m);
+            b->cv.notify_all();
+        }
+        lock_guard<mutex> lock(barrier_m);
+        barrier_cv.notify_all();
+    }
+
+    int n;
+    vector<unique_ptr<Mailbox>> boxes;
+    mutex barrier_m;
+    condition_variable barrier_cv;
+    int arrived = 0;
+    size_t generation = 0;
+    atomic<bool> aborted{false};
+};
+
+class ThreadCommunicator : public Communicator {
+public:
+    ThreadCommunicator(ThreadWorld& world, int rank) : world_(world), rank_(rank) {}
+
+    int rank() const override { return rank_; }
+    int size() const override { return world_.n; }
+
+    void barrier() override {
+        unique_lock<mutex> lock(world_.barrier_m);
+        size_t gen = world_.generation;
+        if (++world_.arrived == world_.n) {
+            world_.arrived = 0;
+            world_.generation++;
+            world_.barrier_cv.notify_all();
+            return;
+        }
+        world_.barrier_cv.wait(lock, [&] { return world_.generation != gen || world_.aborted.load(); });
+        if (world_.generation == gen) throw runtime_error(ABORT_MESSAGE);
+    }
+
+protected:
+    void send_bytes(int dest, const void* buf, size_t bytes) override {
+        const char* p = static_cast<const char*>(buf);
+        vector<char> message(p, p + bytes);
+        ThreadWorld::Mailbox& box = world_.box(rank_, dest);
+        lock_guard<mutex> lock(box.m);
+        box.messages.push_back(std::move(message));
+        box.cv.notify_one();
+    }
+
+    void recv_bytes(int src, void* buf, size_t bytes) override {
+        ThreadWorld::Mailbox& box = world_.box(src, rank_);
+        unique_lock<mutex> lock(box.m);
+        box.cv.wait(lock, [&] { return !box.messages.empty() || world_.aborted.load(); });
+        if (box.messages.empty()) throw runtime_error(ABORT_MESSAGE);
+        vector<char> message = std::move(box.messages.front());
+        box.messages.pop_front();
+        lock.unlock();
+        if (message.size() != bytes) {
+            throw runtime_error("communicator: rank " + to_string(rank_) + " expected " + to_string(bytes)
+                               + " bytes from rank " + to_string(src) + ", got " + to_string(message.size()));
+        }
+        if (bytes > 0) memcpy(buf, message.data(), bytes);
+    }
+
+private:
+    ThreadWorld& world_;
+    int rank_;
+};
+
+void run_thread_ranks(int n, const function<void(Communicator&)>& fn) {
+    if (n < 1) throw runtime_error("run_thread_ranks: need at least one rank");
+    ThreadWorld world(n);
+    mutex error_m;
+    exception_ptr first_error;
+
+    auto body = [&](int r) {
+        try {
+            ThreadCommunicator comm(world, r);
+            fn(comm);
+        } catch (...) {
+            {
+                lock_guard<mutex> lock(error_m);
+                if (!first_error) first_error = current_exception();
+            }
+            world.abort();
+        }
+    };
+
+    vector<thread> threads;
+    for (int r = 1; r < n; r++) threads.emplace_back(body, r);
+    body(0);
+    for (auto& t : threads) t.join();
+    if (first_error) rethrow_exception(first_error);
+}
+
+/* ---------------- Processes: byte rings in a MAP_SHARED mapping ---------------- */
+
+static_assert(atomic<uint64_t>::is_always_lock_free, "shared-memory rings need lock-free 64-bit atomics");
+static_assert(atomic<int>::is_always_lock_free, "shared-memory rings need lock-free atomics");
+
+struct ProcShared {
+    atomic<int> aborted;
+    atomic<int> arrived;
+    atomic<uint64_t> generation;
+    atomic<int> error_rank;        // First rank that failed (-1 = none)
+    char error[512];
+};
+
+/* Per (sender, receiver) ring: head written by the sender, tail by the receiver */
+struct alignas(64) ProcChannel {
+    atomic<uint64_t> head;
+    char pad[56];
+    atomic<uint64_t> tail;
+    char pad2[56];
+};
+
+/* Forked ranks seen from the parent, so rank 0 notices a child that died without reporting */
+struct ChildWatch {
+    vector<pid_t> pids;          // pids[i] is rank i + 1
+    vector<bool> reaped;
+    string signal_error;
+
+    void record(size_t i, int status, void* base);
+    bool poll(void* base, bool block);
+};
+
+static size_t align64(size_t n) {
+    return (n + 63) / 64 * 64;
+}
+
+class ProcessCommunicator : public Communicator {
+public:
+    ProcessCommunicator(void* base, int n, size_t channel_bytes, int rank, ChildWatch* watch = nullptr)
+        : base_(static_cast<char*>(base)), n_(n), cap_(channel_bytes), rank_(rank), watch_(watch) {}
+
+    int rank() const override { return rank_; }
+    int size() const override { return n_; }
+
+    void barrier() override {
+        ProcShared& s = shared();
+        uint64_t gen = s.generation.load(memory_order_acquire);
+        if (s.arrived.fetch_add(1, memory_order_acq_rel) + 1 == n_) {
+            s.arrived.store(0, memory_order_relaxed);
+            s.generation.fetch_add(1, memory_order_release);
+            return;
+        }
+        int spins = 0;
+        while (s.generation.load(memory_order_acquire) == gen) wait_step(spins);
+    }
+
+    static size_t segment_bytes(int n, size_t channel_bytes) {
+        size_t pairs = static_cast<size_t>(n) * n;
+        return align64(sizeof(ProcShared)) + pairs * sizeof(ProcChannel) + pairs * align64(channel_bytes);
+    }
+
+    static void init_segment(void* base, int n) {
+        ProcShared* s = new (base) ProcShared;
+        s->aborted.store(0);
+        s->arrived.store(0);
+        s->generation.store(0);
+        s->error_rank.store(-1);
+        s->error[0] = '\0';
+        char* channels = static_cast<char*>(base) + align64(sizeof(ProcShared));
+        for (size_t p = 0; p < static_cast<size_t>(n) * n; p++) {
+            ProcChannel* c = new (channels + p * sizeof(ProcChannel)) ProcChannel;
+            c->head.store(0);
+            c->tail.store(0);
+        }
+    }
+
+    /* Record the first failure and wake every waiting rank */
+    static void fail(void* base, int rank, const char* what) {
+        ProcShared& s = *static_cast<ProcShared*>(base);
+        int expected = -1;
+        if (s.error_rank.compare_exchange_strong(expected, rank)) {
+            snprintf(s.error, sizeof(s.error), "%s", what);
+        }
+        s.aborted.store(1, memory_order_release);
+    }
+
+protected:
+    void send_bytes(int dest, const void* buf, size_t bytes) override {
+        uint64_t header = bytes;
+        stream_out(dest, &header, sizeof(header));
+        stream_out(dest, buf, bytes);
+    }
+
+    void recv_bytes(int src, void* buf, size_t bytes) override {
+        uint64_t header = 0;
+        stream_in(src, &header, sizeof(header));
+        if (header != bytes) {
+            throw runtime_error("communicator: rank " + to_string(rank_) + " expected " + to_string(bytes)
+                               + " bytes from rank " + to_string(src) + ", got " + to_string(header));
+        }
+        stream_in(src, buf, bytes);
+    }
+
+private:
+    ProcShared& shared() { return *reinterpret_cast<ProcShared*>(base_); }
+
+    ProcChannel& channel(int src, int dst) {
+        return *reinterpret_cast<ProcChannel*>(base_ + align64(sizeof(ProcShared))
+                                               + (static_cast<size_t>(src) * n_ + dst) * sizeof(ProcChannel));
+    }
+
+    char* ring(int src, int dst) {
+        size_t pairs = static_cast<size_t>(n_) * n_;
+        return base_ + align64(sizeof(ProcShared)) + pairs * sizeof(ProcChannel)
+             + (static_cast<size_t>(src) * n_ + dst) * align64(cap_);
+    }
+
+    void wait_step(int& spins) {
+        if (shared().aborted.load(memory_order_acquire)) throw runtime_error(ABORT_MESSAGE);
+        if (++spins > 64) sched_yield();
+        if (watch_ != nullptr && spins % 4096 == 0) watch_->poll(base_, false);
+    }
+
+    void stream_out(int dest, const void* buf, size_t bytes) {
+        ProcChannel& c = channel(rank_, dest);
+        char* r = ring(rank_, dest);
+        const char* p = static_cast<const char*>(buf);
+        uint64_t head = c.head.load(memory_order_relaxed);
+        int spins = 0;
+        while (bytes > 0) {
+            uint64_t space = cap_ - (head - c.tail.load(memory_order_acquire));
+            if (space == 0) {
+                wait_step(spins);
+                continue;
+            }
+            size_t offset = head % cap_;
+            size_t chunk = min<size_t>({bytes, space, cap_ - offset});
+            memcpy(r + offset, p, chunk);
+            head += chunk;
+            p += chunk;
+            bytes -= chunk;
+            c.head.store(head, memory_order_release);
+            spins = 0;
+        }
+    }
+
+    void stream_in(int src, void* buf, size_t bytes) {
+        ProcChannel& c = channel(src, rank_);
+        const char* r = ring(src, rank_);
+        char* p = static_cast<char*>(buf);
+        uint64_t tail = c.tail.load(memory_order_relaxed);
+        int spins = 0;
+        while (bytes > 0) {
+            uint64_t available = c.head.load(memory_order_acquire) - tail;
+            if (available == 0) {
+                wait_step(spins);
+                continue;
+            }
+            size_t offset = tail % cap_;
+            size_t chunk = min<size_t>({bytes, available, cap_ - offset});
+            memcpy(p, r + offset, chunk);
+            tail += chunk;
+            p += chunk;
+            bytes -= chunk;
+            c.tail.store(tail, memory_order_release);
+            spins = 0;
+        }
+    }
+
+    char* base_;
+    int n_;
+    size_t cap_;
+    int rank_;
+    ChildWatch* watch_;
+};
+
+void ChildWatch::record(size_t i, int status, void* base) {
+    reaped[i] = true;
+    if (WIFSIGNALED(status) && signal_error.empty()) {
+        signal_error = "killed by signal " + to_string(WTERMSIG(status));
+        ProcessCommunicator::fail(base, static_cast<int>(i + 1), signal_error.c_str());
+    } else if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        ProcessCommunicator::fail(base, static_cast<int>(i + 1), "exited with an error");
+    }
+}
+
+/* Reap finished children (block: until all are gone); returns true when none are left */
+bool ChildWatch::poll(void* base, bool block) {
+    size_t left = 0;
+    for (bool r : reaped) left += r ? 0 : 1;
+    while (left > 0) {
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, block ? 0 : WNOHANG);
+        if (pid < 0 && errno == EINTR) continue;
+        if (pid <= 0) break;
+        for (size_t i = 0; i < pids.size(); i++) {
+            if (pids[i] == pid && !reaped[i]) {
+                record(i, status, base);
+                left--;
+            }
+        }
+    }
+    return left == 0;
+}
+
+void run_process_ranks(int n, const function<void(Communicator&)>& fn, size_t channel_bytes) {
+    if (n < 1) throw runtime_error("run_process_ranks: need at least one rank");
+    if (channel_bytes < 64) throw runtime_error("run_process_ranks: channel_bytes must be at least 64");
+    size_t bytes = ProcessCommunicator::segment_bytes(n, channel_bytes);
+    void* base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        throw runtime_error("run_process_ranks: cannot map " + to_string(bytes) + " bytes: " + strerror(errno));
+    }
+    ProcessCommunicator::init_segment(base, n);
+
+    // Flush stdio so forked children do not repeat buffered output
+    fflush(nullptr);
+    ChildWatch watch;
+    for (int r = 1; r < n; r++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            int status = 0;
+            try {
+                ProcessCommunicator comm(base, n, channel_bytes, r);
+                fn(comm);
+            } catch (const exception& e) {
+                ProcessCommunicator::fail(base, r, e.what());
+                status = 1;
+            } catch (...) {
+                ProcessCommunicator::fail(base, r, "unknown error");
+                status = 1;
+            }
+            fflush(nullptr);
+            _exit(status);
+        }
+        if (pid < 0) {
+            ProcessCommunicator::fail(base, 0, ("fork failed for rank " + to_string(r) + ": " + strerror(errno)).c_str());
+            break;
+        }
+        watch.pids.push_back(pid);
+        watch.reaped.push_back(false);
+    }
+
+    exception_ptr rank0_error;
+    if (static_cast<int>(watch.pids.size()) == n - 1) {
+        try {
+            ProcessCommunicator comm(base, n, channel_bytes, 0, &watch);
+            fn(comm);
+        } catch (const exception& e) {
+            rank0_error = current_exception();
+            ProcessCommunicator::fail(base, 0, e.what());
+        } catch (...) {
+            rank0_error = current_exception();
+            ProcessCommunicator::fail(base, 0, "unknown error");
+        }
+    }
+    watch.poll(base, true);
+
+    ProcShared& s = *static_cast<ProcShared*>(base);
+    int error_rank = s.error_rank.load();
+    string error = s.error;
+    munmap(base, bytes);
+    if (error_rank == 0 && rank0_error) rethrow_exception(rank0_error);
+    if (error_rank >= 0) throw runtime_error("rank " + to_string(error_rank) + ": " + error);
+}
@@ -0,0 +1,142 @@
+#include "../include/count_codec.hpp"
+#include "../include/logger.hpp"
+#include <stdexcept>
+#include <cmath>
+#include <omp.h>
+
+using namespace std;
+
+/*
+  A value gets a direct code if it is a non-negative integer below the ESCAPE sentinel.
+  Negative zero is escaped so the round trip stays bit-exact.
+ */
+template <typename CodeT>
+static inline bool fits_code(float v) {
+    return v >= 0.0f && !signbit(v) && v < static_cast<float>(numeric_limits<CodeT>::max())
+           && v == floor(v);
+}
+
+template <typename CodeT, typename IndexT>
+CountCSR<CodeT, IndexT> encode_counts(const CSR& X) {
+    if (static_cast<long long>(X.ncols) - 1 > static_cast<long long>(numeric_limits<IndexT>::max())) {
+        throw runtime_error("encode_counts: ncols=" + to_string(X.ncols)
+                           + " does not fit the narrow index type");
+    }
+
+    CountCSR<CodeT, IndexT> Xc;
+    Xc.nrows = X.nrows;
+    Xc.ncols = X.ncols;
+    Xc.nnz = X.nnz;
+    Xc.indptr.assign(X.indptr.begin(), X.indptr.end());
+    Xc.indices.resize(X.nnz);
+    Xc.codes.resize(X.nnz);
+    Xc.escape_ptr.assign(X.nrows + 1, 0);
+
+    // First pass: count escapes per row
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < X.nrows; i++) {
+        int n_esc = 0;
+        for (int idx = X.indptr[i]; idx < X.indptr[i + 1]; idx++) {
+            if (!fits_code<CodeT>(X.data[idx])) n_esc++;
+        }
+        Xc.escape_ptr[i + 1] = n_esc;
+    }
+    for (int i = 0; i < X.nrows; i++) {
+        Xc.escape_ptr[i + 1] += Xc.escape_ptr[i];
+    }
+    Xc.escapes.resize(Xc.escape_ptr[X.nrows]);
+
+    // Second pass: write codes, narrowed indices and escapes
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < X.nrows; i++) {
+        int esc = Xc.escape_ptr[i];
+        for (int idx = X.indptr[i]; idx < X.indptr[i + 1]; idx++) {
+            float v = X.data[idx];
+            Xc.indices[idx] = static_cast<IndexT>(X.indices[idx]);
+            if (fits_code<CodeT>(v)) {
+                Xc.codes[idx] = static_cast<CodeT>(v);
+            } else {
+                Xc.codes[idx] = Xc.ESCAPE;
+                Xc.escapes[esc++] = v;
+            }
+        }
+    }
+
+    return Xc;
+}
+
+template <typename CodeT, typename IndexT>
+CSR decode_counts(const CountCSR<CodeT, IndexT>& Xc) {
+    CSR X;
+    X.nrows = Xc.nrows;
+    X.ncols = Xc.ncols;
+    X.nnz = Xc.nnz;
+    X.indptr.assign(Xc.indptr.begin(), Xc.indptr.end());
+    X.indices.resize(Xc.nnz);
+    X.data.resize(Xc.nnz);
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < Xc.nrows; i++) {
+        int esc = Xc.escape_ptr[i];
+        for (int idx = Xc.indptr[i]; idx < Xc.indptr[i + 1]; idx++) {
+            CodeT c = Xc.codes[idx];
+            X.indices[idx] = static_cast<int>(Xc.indices[idx]);
+            X.data[idx] = (c == Xc.ESCAPE) ? Xc.escapes[esc++] : static_cast<float>(c);
+        }
+    }
+
+    return X;
+}
+
+template <typename CodeT, typename IndexT>
+vector<float> spmm_counts(const CountCSR<CodeT, IndexT>& Xc, const vector<float>& W, int W_rows, int W_cols,
+                          const string& log_annotation) {
+    if (Xc.ncols != W_rows) {
+        throw runtime_error("Matrix dimension mismatch: X.ncols=" + to_string(Xc.ncols)
+                           + " != W.nrows=" + to_string(W_rows));
+    }
+
+    if (!log_annotation.empty()) {
+        log_openmp_threads(log_annotation, omp_get_max_threads());
+    }
+
+    int Y_cols = W_cols;
+    vector<float> Y(static_cast<size_t>(Xc.nrows) * Y_cols, 0.0f);
+
+    const CodeT* codes = Xc.codes.data();
+    const IndexT* indices = Xc.indices.data();
+    const float* escapes = Xc.escapes.data();
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < Xc.nrows; i++) {
+        int esc = Xc.escape_ptr[i];
+        float* y_row = Y.data() + static_cast<size_t>(i) * Y_cols;
+
+        for (int idx = Xc.indptr[i]; idx < Xc.indptr[i + 1]; idx++) {
+            CodeT c = codes[idx];
+            // Decode inline: escapes are rare, so this branch is well predicted
+            float x_val = (c == Xc.ESCAPE) ? escapes[esc++] : static_cast<float>(c);
+            const float* w_row = W.data() + static_cast<size_t>(indices[idx]) * W_cols;
+
+            for (int j = 0; j < W_cols; j++) {
+                y_row[j] += x_val * w_row[j];
+            }
+        }
+    }
+
+    return Y;
+}
+
+// Explicit instantiations for the supported code/index widths
+#define INSTANTIATE_COUNT_CODEC(CodeT, IndexT)                                                        \
+    template CountCSR<CodeT, IndexT> encode_counts<CodeT, IndexT>(const CSR&);                        \
+    template CSR decode_counts<CodeT, IndexT>(const CountCSR<CodeT, IndexT>&);                        \
+    template vector<float> spmm_counts<CodeT, IndexT>(const CountCSR<CodeT, IndexT>&,                 \
+                                                      const vector<float>&, int, int, const string&);
+
+INSTANTIATE_COUNT_CODEC(uint8_t,  int)
+INSTANTIATE_COUNT_CODEC(uint16_t, int)
+INSTANTIATE_COUNT_CODEC(uint8_t,  uint16_t)
+INSTANTIATE_COUNT_CODEC(uint16_t, uint16_t)
+
+#undef INSTANTIATE_COUNT_CODEC
@@ -6,7 +6,7 @@ using namespace std;
   Dense Tile SpMM Processing: Processes all nonzeros within the tile's row and column range
  */
 void dense_spmm_tile(const CSR& X, const vector<float>& W, int W_cols,
-                     const Tile& tile, vector<float>& Y, int Y_cols) {
+                     const Tile& tile, Span<float> Y, int Y_cols) {
     // For each row in this dense tile
     for (int i = tile.row_start; i < tile.row_end; i++) {
         int row_start = X.indptr[i];
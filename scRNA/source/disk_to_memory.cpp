@@ -68,7 +68,7 @@ CSR load_X_h5_as_csr(const string& x_h5_path, const string& log_annotation) {
             csr.indptr[i + 1] += csr.indptr[i];
         }
         
-        vector<int> row_counters = csr.indptr;
+        vector<int> row_counters(csr.indptr.begin(), csr.indptr.end());
         for (int col = 0; col < n_cells; col++) {
             for (int idx = indptr[col]; idx < indptr[col + 1]; idx++) {
                 int row = indices[idx];
@@ -116,7 +116,7 @@ vector<float> load_W_h5(const string& w_h5_path, int& nrows, int& k, const strin
         nrows = dims[0];
         k = dims[1];
         
-        W_data.resize(nrows * k);
+        W_data = make_huge_page_vector<float>(static_cast<size_t>(nrows) * k);
         dataset.read(W_data.data(), PredType::NATIVE_FLOAT);
         
         cout << "[disk_to_memory] W shape: " << nrows << " x " << k << endl;
@@ -0,0 +1,274 @@
+#include "../include/dist_spmm.hpp"
+#include "../include/logger.hpp"
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <iomanip>
+#include <type_traits>
+
+using namespace std;
+
+static_assert(is_trivially_copyable<DistRankStats>::value, "DistRankStats is sent as raw bytes");
+
+static double ms_since(chrono::high_resolution_clock::time_point t) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - t).count() / 1000.0;
+}
+
+/* Split prefix (size n + 1, nondecreasing) into parts ranges of about equal weight */
+static vector<int64_t> balanced_bounds(const vector<long long>& prefix, int parts) {
+    const int n = static_cast<int>(prefix.size()) - 1;
+    vector<int64_t> bounds(parts + 1, 0);
+    for (int p = 1; p < parts; p++) {
+        long long target = prefix.back() * p / parts;
+        int64_t b = lower_bound(prefix.begin(), prefix.end(), target) - prefix.begin();
+        bounds[p] = max(bounds[p - 1], min<int64_t>(b, n));
+    }
+    bounds[parts] = n;
+    return bounds;
+}
+
+/* Rows [r0, r1) and columns [c0, c1) of X, with column indices relative to c0 */
+static CSR extract_block(const CSR& X, int r0, int r1, int c0, int c1) {
+    CSR B;
+    B.nrows = r1 - r0;
+    B.ncols = c1 - c0;
+    B.indptr.assign(B.nrows + 1, 0);
+    for (int i = r0; i < r1; i++) {
+        auto first = lower_bound(X.indices.begin() + X.indptr[i], X.indices.begin() + X.indptr[i + 1], c0);
+        auto last = lower_bound(first, X.indices.begin() + X.indptr[i + 1], c1);
+        B.indptr[i - r0 + 1] = B.indptr[i - r0] + static_cast<int>(last - first);
+    }
+    B.nnz = B.indptr[B.nrows];
+    B.indices.resize(B.nnz);
+    B.data.resize(B.nnz);
+    for (int i = r0; i < r1; i++) {
+        int begin = static_cast<int>(lower_bound(X.indices.begin() + X.indptr[i],
+                                                 X.indices.begin() + X.indptr[i + 1], c0) - X.indices.begin());
+        int out = B.indptr[i - r0];
+        for (int idx = begin; out < B.indptr[i - r0 + 1]; idx++, out++) {
+            B.indices[out] = X.indices[idx] - c0;
+            B.data[out] = X.data[idx];
+        }
+    }
+    return B;
+}
+
+static DistPhaseBytes phase_bytes(const CommCounters& before, const CommCounters& after) {
+    DistPhaseBytes b;
+    b.sent = after.bytes_sent - before.bytes_sent;
+    b.received = after.bytes_received - before.bytes_received;
+    return b;
+}
+
+vector<float> dist_spmm(Communicator& comm, const CSR& X, const vector<float>& W, int W_rows, int W_cols,
+                        const DistSpmmConfig& cfg, DistSpmmStats* stats, const string& log_annotation) {
+    auto start = chrono::high_resolution_clock::now();
+    const int P = comm.size();
+    const int rank = comm.rank();
+
+    // Process grid (same on every rank)
+    int grid_rows = P, grid_cols = 1;
+    if (cfg.partition == DistPartition::TwoD) {
+        grid_rows = cfg.grid_rows;
+        if (grid_rows <= 0) {
+            grid_rows = 1;
+            for (int d = 1; d * d <= P; d++) {
+                if (P % d == 0) grid_rows = d;
+            }
+        }
+        if (P % grid_rows != 0) {
+            throw runtime_error("dist spmm: grid_rows=" + to_string(grid_rows) + " does not divide "
+                               + to_string(P) + " ranks");
+        }
+        grid_cols = P / grid_rows;
+    }
+    const int gi = rank / grid_cols;
+    const int gj = rank % grid_cols;
+
+    // Shapes and partition bounds, decided on rank 0
+    vector<int64_t> meta(3 + grid_rows + 1 + grid_cols + 1, 0);
+    if (rank == 0) {
+        if (X.ncols != W_rows) {
+            throw runtime_error("Matrix dimension mismatch: X.ncols=" + to_string(X.ncols)
+                               + " != W.nrows=" + to_string(W_rows));
+        }
+        meta[0] = X.nrows;
+        meta[1] = X.ncols;
+        meta[2] = W_cols;
+        vector<long long> row_prefix(X.indptr.begin(), X.indptr.end());
+        vector<long long> col_prefix(X.ncols + 1, 0);
+        for (size_t idx = 0; idx < X.nnz; idx++) col_prefix[X.indices[idx] + 1]++;
+        for (int c = 0; c < X.ncols; c++) col_prefix[c + 1] += col_prefix[c];
+        vector<int64_t> rb = balanced_bounds(row_prefix, grid_rows);
+        vector<int64_t> cb = balanced_bounds(col_prefix, grid_cols);
+        copy(rb.begin(), rb.end(), meta.begin() + 3);
+        copy(cb.begin(), cb.end(), meta.begin() + 3 + grid_rows + 1);
+    }
+    comm.broadcast(meta.data(), meta.size() * sizeof(int64_t));
+    const int nrows = static_cast<int>(meta[0]);
+    const int K = static_cast<int>(meta[2]);
+    const int64_t* row_bounds = meta.data() + 3;
+    const int64_t* col_bounds = meta.data() + 3 + grid_rows + 1;
+    auto block_of = [&](int r, int& r0, int& r1, int& c0, int& c1) {
+        r0 = static_cast<int>(row_bounds[r / grid_cols]);
+        r1 = static_cast<int>(row_bounds[r / grid_cols + 1]);
+        c0 = static_cast<int>(col_bounds[r % grid_cols]);
+        c1 = static_cast<int>(col_bounds[r % grid_cols + 1]);
+    };
+    int r0, r1, c0, c1;
+    block_of(rank, r0, r1, c0, c1);
+    const int rows = r1 - r0;
+    const int cols = c1 - c0;
+
+    DistRankStats me;
+    me.rank = rank;
+    me.grid_row = gi;
+    me.grid_col = gj;
+    me.rows = rows;
+    me.cols = cols;
+
+    // Scatter X blocks from rank 0
+    CommCounters c_start = comm.counters();
+    CSR block;
+    if (rank == 0) {
+        for (int r = 1; r < P; r++) {
+            int b_r0, b_r1, b_c0, b_c1;
+            block_of(r, b_r0, b_r1, b_c0, b_c1);
+            CSR B = extract_block(X, b_r0, b_r1, b_c0, b_c1);
+            comm.send(r, B.indptr.data(), sizeof(int) * (B.nrows + 1));
+            comm.send(r, B.indices.data(), sizeof(int) * B.nnz);
+            comm.send(r, B.data.data(), sizeof(float) * B.nnz);
+        }
+        block = extract_block(X, r0, r1, c0, c1);
+    } else {
+        block.nrows = rows;
+        block.ncols = cols;
+        block.indptr.resize(rows + 1);
+        comm.recv(0, block.indptr.data(), sizeof(int) * (rows + 1));
+        block.nnz = block.indptr[rows];
+        block.indices.resize(block.nnz);
+        block.data.resize(block.nnz);
+        comm.recv(0, block.indices.data(), sizeof(int) * block.nnz);
+        comm.recv(0, block.data.data(), sizeof(float) * block.nnz);
+    }
+    me.nnz = block.nnz;
+    CommCounters c_scatter = comm.counters();
+    me.scatter_X = phase_bytes(c_start, c_scatter);
+
+    // W rows [c0, c1) to every rank of grid column j (OneD: all of W to every rank)
+    auto t_comm = chrono::high_resolution_clock::now();
+    vector<float> W_recv;
+    const float* W_block = nullptr;
+    if (rank == 0) {
+        for (int r = 1; r < P; r++) {
+            int b_r0, b_r1, b_c0, b_c1;
+            block_of(r, b_r0, b_r1, b_c0, b_c1);
+            comm.send(r, W.data() + static_cast<size_t>(b_c0) * K, sizeof(float) * static_cast<size_t>(b_c1 - b_c0) * K);
+        }
+        W_block = W.data() + static_cast<size_t>(c0) * K;
+    } else {
+        W_recv.resize(static_cast<size_t>(cols) * K);
+        comm.recv(0, W_recv.data(), sizeof(float) * W_recv.size());
+        W_block = W_recv.data();
+    }
+    CommCounters c_W = comm.counters();
+    me.W = phase_bytes(c_scatter, c_W);
+    double comm_ms = ms_since(t_comm);
+
+    // Local SpMM: same loop as spmm_baseline, one thread per rank
+    auto t_compute = chrono::high_resolution_clock::now();
+    vector<float> Y_part(static_cast<size_t>(rows) * K, 0.0f);
+    for (int i = 0; i < rows; i++) {
+        float* y = Y_part.data() + static_cast<size_t>(i) * K;
+        for (int idx = block.indptr[i]; idx < block.indptr[i + 1]; idx++) {
+            int k = block.indices[idx];
+            float x_val = block.data[idx];
+            for (int j = 0; j < K; j++) {
+                y[j] += x_val * W_block[static_cast<size_t>(k) * K + j];
+            }
+        }
+    }
+    me.compute_ms = ms_since(t_compute);
+
+    // Reduce partial Y panels of each grid row onto its column 0, in column order
+    t_comm = chrono::high_resolution_clock::now();
+    if (gj > 0) {
+        comm.send(gi * grid_cols, Y_part.data(), sizeof(float) * Y_part.size());
+    } else if (grid_cols > 1) {
+        vector<float> incoming(Y_part.size());
+        for (int j = 1; j < grid_cols; j++) {
+            comm.recv(gi * grid_cols + j, incoming.data(), sizeof(float) * incoming.size());
+            for (size_t e = 0; e < Y_part.size(); e++) Y_part[e] += incoming[e];
+        }
+    }
+    CommCounters c_reduce = comm.counters();
+    me.reduce_Y = phase_bytes(c_W, c_reduce);
+
+    // Gather Y panels on rank 0
+    vector<float> Y;
+    if (rank == 0) {
+        Y = make_huge_page_vector<float>(static_cast<size_t>(nrows) * K);
+        copy(Y_part.begin(), Y_part.end(), Y.begin());
+        for (int i = 1; i < grid_rows; i++) {
+            size_t panel = static_cast<size_t>(row_bounds[i + 1] - row_bounds[i]) * K;
+            comm.recv(i * grid_cols, Y.data() + static_cast<size_t>(row_bounds[i]) * K, sizeof(float) * panel);
+        }
+    } else if (gj == 0) {
+        comm.send(0, Y_part.data(), sizeof(float) * Y_part.size());
+    }
+    CommCounters c_gather = comm.counters();
+    me.gather_Y = phase_bytes(c_reduce, c_gather);
+    me.comm_ms = comm_ms + ms_since(t_comm);
+    me.total_ms = ms_since(start);
+
+    // Per-rank reports to rank 0 (not part of the phase volumes)
+    vector<DistRankStats> all;
+    if (rank == 0) {
+        all.resize(P);
+        all[0] = me;
+        for (int r = 1; r < P; r++) comm.recv(r, &all[r], sizeof(DistRankStats));
+    } else {
+        comm.send(0, &me, sizeof(DistRankStats));
+        all.push_back(me);
+    }
+
+    DistSpmmStats local;
+    DistSpmmStats& st = stats ? *stats : local;
+    st.partition = cfg.partition;
+    st.grid_rows = grid_rows;
+    st.grid_cols = grid_cols;
+    st.ranks = all;
+    st.spmm_bytes = 0;
+    st.scatter_bytes = 0;
+    if (rank == 0) {
+        for (const auto& s : all) {
+            st.spmm_bytes += s.W.received + s.reduce_Y.received + s.gather_Y.received;
+            st.scatter_bytes += s.scatter_X.received;
+        }
+    }
+    st.total_ms = ms_since(start);
+
+    if (rank == 0 && !log_annotation.empty()) {
+        stringstream ss;
+        ss << fixed << setprecision(3);
+        ss << "dist spmm: " << (cfg.partition == DistPartition::OneD ? "1D" : "2D") << ", " << P << " ranks, grid "
+           << grid_rows << " x " << grid_cols << ", total " << st.total_ms << "ms, spmm traffic "
+           << st.spmm_bytes / 1e6 << " MB, X scatter " << st.scatter_bytes / 1e6 << " MB" << endl;
+        ss << setw(6) << "rank" << setw(6) << "grid" << setw(10) << "rows" << setw(10) << "cols"
+           << setw(12) << "nnz" << setw(12) << "X in MB" << setw(12) << "W in MB" << setw(12) << "red in MB"
+           << setw(12) << "gat in MB" << setw(12) << "out MB" << setw(12) << "compute ms" << setw(12) << "comm ms" << endl;
+        for (const auto& s : all) {
+            size_t out = s.W.sent + s.reduce_Y.sent + s.gather_Y.sent;
+            ss << setw(6) << s.rank << setw(3) << s.grid_row << "," << setw(2) << s.grid_col
+               << setw(10) << s.rows << setw(10) << s.cols << setw(12) << s.nnz
+               << setw(12) << s.scatter_X.received / 1e6 << setw(12) << s.W.received / 1e6
+               << setw(12) << s.reduce_Y.received / 1e6 << setw(12) << s.gather_Y.received / 1e6
+               << setw(12) << out / 1e6 << setw(12) << s.compute_ms << setw(12) << s.comm_ms << endl;
+        }
+        log_to_file_experiment(log_annotation, "dist", ss.str());
+    }
+    return Y;
+}
@@ -0,0 +1,233 @@
+#include "../include/half_spmm.hpp"
+#include "../include/disk_to_memory.hpp"
+#include "../include/logger.hpp"
+#include <iostream>
+#include <chrono>
+#include <stdexcept>
+#include <algorithm>
+#include <omp.h>
+#if defined(__F16C__) || defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+HalfMatrix to_half_matrix(const vector<float>& M, int rows, int cols, StoragePrecision precision) {
+    if (precision == StoragePrecision::FP32) {
+        throw runtime_error("to_half_matrix: FP32 is not a 16-bit storage precision");
+    }
+    size_t n = static_cast<size_t>(rows) * static_cast<size_t>(cols);
+    if (M.size() != n) {
+        throw runtime_error("to_half_matrix: size mismatch (" + to_string(M.size())
+                           + " != " + to_string(n) + ")");
+    }
+
+    HalfMatrix H;
+    H.rows = rows;
+    H.cols = cols;
+    H.precision = precision;
+    H.data.resize(n);
+
+    long long n_ll = static_cast<long long>(n);
+    if (precision == StoragePrecision::FP16) {
+        #pragma omp parallel for schedule(static)
+        for (long long i = 0; i < n_ll; i += 8) {
+            #ifdef __F16C__
+            if (i + 8 <= n_ll) {
+                __m256 v = _mm256_loadu_ps(M.data() + i);
+                __m128i h = _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(H.data.data() + i), h);
+                continue;
+            }
+            #endif
+            for (long long j = i; j < min(i + 8, n_ll); j++) {
+                H.data[j] = float_to_fp16(M[j]);
+            }
+        }
+    } else {
+        #pragma omp parallel for schedule(static)
+        for (long long i = 0; i < n_ll; i++) {
+            H.data[i] = float_to_bf16(M[i]);
+        }
+    }
+
+    return H;
+}
+
+HalfMatrix load_W_h5_half(const string& w_h5_path, StoragePrecision precision, const string& log_annotation) {
+    auto start = chrono::high_resolution_clock::now();
+
+    int nrows = 0, k = 0;
+    vector<float> W_fp32 = load_W_h5(w_h5_path, nrows, k, "");
+    HalfMatrix W = to_half_matrix(W_fp32, nrows, k, precision);
+
+    cout << "[half_spmm] W converted to " << storage_precision_name(precision) << endl;
+
+    auto end = chrono::high_resolution_clock::now();
+    auto duration_us = chrono::duration_cast<chrono::microseconds>(end - start).count();
+    double duration_ms = duration_us / 1000.0;
+
+    if (!log_annotation.empty()) {
+        log_load_W_metrics(log_annotation, nrows, k, duration_ms);
+    }
+
+    return W;
+}
+
+vector<float> half_matrix_to_float(const HalfMatrix& M) {
+    vector<float> F(M.data.size());
+    long long n = static_cast<long long>(M.data.size());
+
+    if (M.precision == StoragePrecision::FP16) {
+        #pragma omp parallel for schedule(static)
+        for (long long i = 0; i < n; i++) {
+            F[i] = fp16_to_float(M.data[i]);
+        }
+    } else {
+        #pragma omp parallel for schedule(static)
+        for (long long i = 0; i < n; i++) {
+            F[i] = bf16_to_float(M.data[i]);
+        }
+    }
+
+    return F;
+}
+
+/*
+  Accumulate y[0..K) += x_val * upconvert(w[0..K)).
+  Vector paths handle full 16/8-lane chunks, the scalar tail handles the rest.
+ */
+template <StoragePrecision P>
+static inline void axpy_half_row(float* __restrict y, const uint16_t* __restrict w, float x_val, int K) {
+    int j = 0;
+
+#if defined(__AVX512F__)
+    __m512 xv512 = _mm512_set1_ps(x_val);
+    for (; j + 16 <= K; j += 16) {
+        __m256i h = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + j));
+        __m512 wv;
+        // maskz forms: the unmasked ones trip GCC's -Wmaybe-uninitialized on their undefined passthrough
+        if constexpr (P == StoragePrecision::FP16) {
+            wv = _mm512_maskz_cvtph_ps(0xFFFF, h);
+        } else {
+            // bf16 -> fp32 is an exact 16-bit shift (this is what AVX512-BF16 vcvtpbh2ps lowers to)
+            __m512i wi = _mm512_maskz_cvtepu16_epi32(0xFFFF, h);
+            wv = _mm512_castsi512_ps(_mm512_maskz_slli_epi32(0xFFFF, wi, 16));
+        }
+        __m512 yv = _mm512_loadu_ps(y + j);
+        yv = _mm512_fmadd_ps(xv512, wv, yv);
+        _mm512_storeu_ps(y + j, yv);
+    }
+#endif
+
+#if defined(__AVX2__)
+    __m256 xv = _mm256_set1_ps(x_val);
+    for (; j + 8 <= K; j += 8) {
+        __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + j));
+        __m256 wv;
+        if constexpr (P == StoragePrecision::FP16) {
+            #ifdef __F16C__
+            wv = _mm256_cvtph_ps(h);
+            #else
+            break;  // no F16C: leave fp16 to the scalar tail
+            #endif
+        } else {
+            wv = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(h), 16));
+        }
+        __m256 yv = _mm256_loadu_ps(y + j);
+        #ifdef __FMA__
+        yv = _mm256_fmadd_ps(xv, wv, yv);
+        #else
+        yv = _mm256_add_ps(yv, _mm256_mul_ps(xv, wv));
+        #endif
+        _mm256_storeu_ps(y + j, yv);
+    }
+#endif
+
+    for (; j < K; j++) {
+        float wf = (P == StoragePrecision::FP16) ? fp16_to_float(w[j]) : bf16_to_float(w[j]);
+        y[j] += x_val * wf;
+    }
+}
+
+template <StoragePrecision P>
+static void spmm_half_rows(const CSR& X, const HalfMatrix& W, float* Y) {
+    int K = W.cols;
+    const uint16_t* Wd = W.data.data();
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < X.nrows; i++) {
+        float* y_row = Y + static_cast<size_t>(i) * K;
+        for (int idx = X.indptr[i]; idx < X.indptr[i + 1]; idx++) {
+            int k = X.indices[idx];
+            axpy_half_row<P>(y_row, Wd + static_cast<size_t>(k) * K, X.data[idx], K);
+        }
+    }
+}
+
+vector<float> spmm_baseline_half(const CSR& X, const HalfMatrix& W, const string& log_annotation) {
+    if (X.ncols != W.rows) {
+        throw runtime_error("Matrix dimension mismatch: X.ncols=" + to_string(X.ncols)
+                           + " != W.nrows=" + to_string(W.rows));
+    }
+    if (W.precision == StoragePrecision::FP32) {
+        throw runtime_error("spmm_baseline_half: W must be fp16 or bf16");
+    }
+
+    if (!log_annotation.empty()) {
+        log_openmp_threads(log_annotation, omp_get_max_threads());
+    }
+
+    vector<float> Y(static_cast<size_t>(X.nrows) * W.cols, 0.0f);
+
+    if (W.precision == StoragePrecision::FP16) {
+        spmm_half_rows<StoragePrecision::FP16>(X, W, Y.data());
+    } else {
+        spmm_half_rows<StoragePrecision::BF16>(X, W, Y.data());
+    }
+
+    return Y;
+}
+
+HalfMatrix spmm_baseline_half_Y(const CSR& X, const HalfMatrix& W, StoragePrecision Y_precision) {
+    if (X.ncols != W.rows) {
+        throw runtime_error("Matrix dimension mismatch: X.ncols=" + to_string(X.ncols)
+                           + " != W.nrows=" + to_string(W.rows));
+    }
+    if (W.precision == StoragePrecision::FP32 || Y_precision == StoragePrecision::FP32) {
+        throw runtime_error("spmm_baseline_half_Y: W and Y must be fp16 or bf16");
+    }
+
+    int K = W.cols;
+    HalfMatrix Y;
+    Y.rows = X.nrows;
+    Y.cols = K;
+    Y.precision = Y_precision;
+    Y.data.resize(static_cast<size_t>(X.nrows) * K);
+
+    #pragma omp parallel
+    {
+        // fp32 accumulator for one Y row, reused across rows of this thread
+        vector<float> acc(K);
+
+        #pragma omp for schedule(static)
+        for (int i = 0; i < X.nrows; i++) {
+            fill(acc.begin(), acc.end(), 0.0f);
+            for (int idx = X.indptr[i]; idx < X.indptr[i + 1]; idx++) {
+                const uint16_t* w_row = W.data.data() + static_cast<size_t>(X.indices[idx]) * K;
+                if (W.precision == StoragePrecision::FP16) {
+                    axpy_half_row<StoragePrecision::FP16>(acc.data(), w_row, X.data[idx], K);
+                } else {
+                    axpy_half_row<StoragePrecision::BF16>(acc.data(), w_row, X.data[idx], K);
+                }
+            }
+            uint16_t* y_row = Y.data.data() + static_cast<size_t>(i) * K;
+            for (int j = 0; j < K; j++) {
+                y_row[j] = (Y_precision == StoragePrecision::FP16) ? float_to_fp16(acc[j])
+                                                                   : float_to_bf16(acc[j]);
+            }
+        }
+    }
+
+    return Y;
+}
@@ -0,0 +1,160 @@
+#include "../include/heavy_row_spmm.hpp"
+#include "../include/spmm.hpp"
+#include "../include/logger.hpp"
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <iomanip>
+#include <omp.h>
+
+using namespace std;
+
+static double ms_since(chrono::high_resolution_clock::time_point t) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - t).count() / 1000.0;
+}
+
+HeavyRowSplit split_heavy_rows(const CSR& X, double fraction, const string& log_annotation) {
+    if (!(fraction > 0.0)) {
+        throw runtime_error("split_heavy_rows: fraction must be positive, got " + to_string(fraction));
+    }
+    auto start = chrono::high_resolution_clock::now();
+    HeavyRowSplit S;
+    double threshold = ceil(fraction * X.ncols);
+    S.threshold_nnz = threshold > X.ncols ? X.ncols + 1 : max(1, static_cast<int>(threshold));
+
+    for (int i = 0; i < X.nrows; i++) {
+        int row_nnz = X.indptr[i + 1] - X.indptr[i];
+        if (row_nnz >= S.threshold_nnz) {
+            S.heavy_rows.push_back(i);
+            S.heavy_nnz += row_nnz;
+        }
+    }
+    const int H = static_cast<int>(S.heavy_rows.size());
+
+    // Sparse remainder: same rows, heavy ones left empty
+    CSR& L = S.light;
+    L.nrows = X.nrows;
+    L.ncols = X.ncols;
+    L.nnz = X.nnz - S.heavy_nnz;
+    L.indptr.resize(X.nrows + 1);
+    L.indptr[0] = 0;
+    for (int i = 0, h = 0; i < X.nrows; i++) {
+        bool heavy = h < H && S.heavy_rows[h] == i;
+        if (heavy) h++;
+        L.indptr[i + 1] = L.indptr[i] + (heavy ? 0 : X.indptr[i + 1] - X.indptr[i]);
+    }
+    L.indices.resize(L.nnz);
+    L.data.resize(L.nnz);
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (int i = 0; i < X.nrows; i++) {
+        int n = L.indptr[i + 1] - L.indptr[i];
+        if (n == 0) continue;
+        copy(X.indices.begin() + X.indptr[i], X.indices.begin() + X.indptr[i] + n, L.indices.begin() + L.indptr[i]);
+        copy(X.data.begin() + X.indptr[i], X.data.begin() + X.indptr[i] + n, L.data.begin() + L.indptr[i]);
+    }
+
+    // Dense block, cell-major
+    S.dense = make_huge_page_vector<float>(static_cast<size_t>(X.ncols) * H);
+    #pragma omp parallel for schedule(static)
+    for (int h = 0; h < H; h++) {
+        int i = S.heavy_rows[h];
+        for (int idx = X.indptr[i]; idx < X.indptr[i + 1]; idx++) {
+            S.dense[static_cast<size_t>(X.indices[idx]) * H + h] = X.data[idx];
+        }
+    }
+    S.split_ms = ms_since(start);
+
+    if (!log_annotation.empty()) {
+        stringstream ss;
+        ss << fixed << setprecision(3);
+        ss << "heavy rows: " << H << " (nnz " << S.heavy_nnz << ", "
+           << (X.nnz > 0 ? 100.0 * S.heavy_nnz / X.nnz : 0.0) << "% of nnz, threshold "
+           << S.threshold_nnz << " nnz per row), split time: " << S.split_ms << "ms" << endl;
+        log_to_file(log_annotation, ss.str());
+    }
+    return S;
+}
+
+/*
+  Y[heavy rows] = dense^T * W. Each thread takes a contiguous range of cells and
+  accumulates all heavy rows into its own H x K buffer; the buffers are then summed
+  in thread order, so the result does not depend on scheduling.
+ */
+void spmm_heavy_rows_into(const HeavyRowSplit& S, const vector<float>& W, int W_cols, Span<float> Y) {
+    const int H = static_cast<int>(S.heavy_rows.size());
+    if (H == 0) return;
+    require_span_size(Y, static_cast<size_t>(S.light.nrows) * W_cols, "Y");
+    const int ncols = S.light.ncols;
+    const int K = W_cols;
+    const int max_threads = omp_get_max_threads();
+    vector<float> partial(static_cast<size_t>(max_threads) * H * K, 0.0f);
+
+    #pragma omp parallel
+    {
+        int tid = omp_get_thread_num();
+        int nthreads = omp_get_num_threads();
+        int c0 = static_cast<int>(static_cast<long long>(ncols) * tid / nthreads);
+        int c1 = static_cast<int>(static_cast<long long>(ncols) * (tid + 1) / nthreads);
+        float* acc = partial.data() + static_cast<size_t>(tid) * H * K;
+        for (int c = c0; c < c1; c++) {
+            const float* w = W.data() + static_cast<size_t>(c) * K;
+            const float* d = S.dense.data() + static_cast<size_t>(c) * H;
+            for (int h = 0; h < H; h++) {
+                float x_val = d[h];
+                if (x_val == 0.0f) continue;
+                float* a = acc + static_cast<size_t>(h) * K;
+                for (int j = 0; j < K; j++) {
+                    a[j] += x_val * w[j];
+                }
+            }
+        }
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (int h = 0; h < H; h++) {
+        float* y = Y.data + static_cast<size_t>(S.heavy_rows[h]) * K;
+        for (int j = 0; j < K; j++) {
+            float sum = 0.0f;
+            for (int t = 0; t < max_threads; t++) sum += partial[(static_cast<size_t>(t) * H + h) * K + j];
+            y[j] = sum;
+        }
+    }
+}
+
+vector<float> spmm_heavy_split(const HeavyRowSplit& S, const vector<float>& W, int W_rows, int W_cols,
+                               const TilingConfig* tiling, HeavyRowStats* stats, const string& log_annotation) {
+    if (S.light.ncols != W_rows) {
+        throw runtime_error("Matrix dimension mismatch: X.ncols=" + to_string(S.light.ncols)
+                           + " != W.nrows=" + to_string(W_rows));
+    }
+    vector<float> Y = make_huge_page_vector<float>(static_cast<size_t>(S.light.nrows) * W_cols);
+
+    auto start = chrono::high_resolution_clock::now();
+    size_t num_tiles = 0;
+    if (tiling != nullptr) {
+        num_tiles = spmm_tiled_into(S.light, W, W_rows, W_cols, *tiling, Y, false, log_annotation);
+    } else {
+        spmm_baseline_into(S.light, W, W_rows, W_cols, Y, false, log_annotation);
+    }
+    double sparse_ms = ms_since(start);
+
+    start = chrono::high_resolution_clock::now();
+    spmm_heavy_rows_into(S, W, W_cols, Y);
+    double dense_ms = ms_since(start);
+
+    if (stats != nullptr) {
+        stats->sparse_ms = sparse_ms;
+        stats->dense_ms = dense_ms;
+        stats->num_tiles = num_tiles;
+    }
+    if (!log_annotation.empty()) {
+        stringstream ss;
+        ss << fixed << setprecision(3);
+        ss << "heavy-row spmm: sparse " << sparse_ms << "ms (" << S.light.nnz << " nnz), dense "
+           << dense_ms << "ms (" << S.heavy_rows.size() << " rows)" << endl;
+        log_to_file(log_annotation, ss.str());
+    }
+    return Y;
+}
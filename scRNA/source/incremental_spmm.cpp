@@ -0,0 +1,333 @@
+#include "../include/incremental_spmm.hpp"
+#include "../include/disk_to_memory.hpp"
+#include "../include/logger.hpp"
+#include <H5Cpp.h>
+#include <stdexcept>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <omp.h>
+
+using namespace std;
+using namespace H5;
+namespace fs = std::filesystem;
+
+static const char* META_MAGIC = "scRNA-incremental-meta";
+static const int META_VERSION = 1;
+
+/*
+  Word-wise FNV-1a style mixing (8 bytes per step, byte tail).
+ */
+static uint64_t mix_bytes(uint64_t h, const void* ptr, size_t bytes) {
+    const unsigned char* p = static_cast<const unsigned char*>(ptr);
+    const uint64_t prime = 0x100000001b3ULL;
+    size_t i = 0;
+    for (; i + 8 <= bytes; i += 8) {
+        uint64_t w;
+        memcpy(&w, p + i, 8);
+        h = (h ^ w) * prime;
+        h ^= h >> 32;
+    }
+    for (; i < bytes; i++) {
+        h = (h ^ p[i]) * prime;
+    }
+    return h;
+}
+
+uint64_t csr_fingerprint(const CSR& X) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    int64_t shape[3] = {X.nrows, X.ncols, static_cast<int64_t>(X.nnz)};
+    h = mix_bytes(h, shape, sizeof(shape));
+    h = mix_bytes(h, X.indptr.data(), X.indptr.size() * sizeof(int));
+    h = mix_bytes(h, X.indices.data(), X.indices.size() * sizeof(int));
+    h = mix_bytes(h, X.data.data(), X.data.size() * sizeof(float));
+    return h;
+}
+
+uint64_t dense_fingerprint(const float* data, size_t count) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    uint64_t n = count;
+    h = mix_bytes(h, &n, sizeof(n));
+    return mix_bytes(h, data, count * sizeof(float));
+}
+
+string incremental_meta_path(const string& y_path) {
+    return y_path + ".meta";
+}
+
+XSegmentMeta describe_x_segment(const CSR& X, const string& x_path) {
+    XSegmentMeta seg;
+    seg.path = x_path;
+    seg.cells = X.ncols;
+    seg.nnz = X.nnz;
+    seg.file_size = fs::file_size(x_path);
+    seg.mtime = fs::last_write_time(x_path).time_since_epoch().count();
+    seg.hash = csr_fingerprint(X);
+    return seg;
+}
+
+IncrementalMeta make_incremental_meta(const CSR& X, const string& x_path, const vector<float>& Y,
+                                      const vector<float>& W, int W_rows, int W_cols) {
+    if (X.ncols != W_rows) {
+        throw runtime_error("Matrix dimension mismatch: X.ncols=" + to_string(X.ncols)
+                           + " != W.nrows=" + to_string(W_rows));
+    }
+    IncrementalMeta meta;
+    meta.genes = X.nrows;
+    meta.cells = X.ncols;
+    meta.K = W_cols;
+    meta.nnz = X.nnz;
+    meta.w_hash = dense_fingerprint(W.data(), static_cast<size_t>(W_rows) * W_cols);
+    meta.y_hash = dense_fingerprint(Y.data(), Y.size());
+    meta.segments.push_back(describe_x_segment(X, x_path));
+    return meta;
+}
+
+void save_incremental_meta(const IncrementalMeta& meta, const string& meta_path) {
+    // Write to a temporary file and rename, so a crash never leaves a half-written sidecar
+    string tmp_path = meta_path + ".tmp";
+    {
+        ofstream out(tmp_path, ios::trunc);
+        if (!out) {
+            throw runtime_error("Cannot write incremental metadata: " + tmp_path);
+        }
+        out << META_MAGIC << " " << META_VERSION << "\n";
+        out << "genes " << meta.genes << "\n";
+        out << "cells " << meta.cells << "\n";
+        out << "K " << meta.K << "\n";
+        out << "nnz " << meta.nnz << "\n";
+        out << hex << "w_hash " << meta.w_hash << "\n";
+        out << "y_hash " << meta.y_hash << "\n" << dec;
+        out << "segments " << meta.segments.size() << "\n";
+        for (const auto& seg : meta.segments) {
+            // Path last: it may contain spaces
+            out << "segment " << seg.cells << " " << seg.nnz << " " << seg.file_size << " "
+                << seg.mtime << " " << hex << seg.hash << dec << " " << seg.path << "\n";
+        }
+        if (!out) {
+            throw runtime_error("Cannot write incremental metadata: " + tmp_path);
+        }
+    }
+    fs::rename(tmp_path, meta_path);
+}
+
+IncrementalMeta load_incremental_meta(const string& meta_path) {
+    ifstream in(meta_path);
+    if (!in) {
+        throw runtime_error("Missing incremental metadata: " + meta_path);
+    }
+
+    auto expect = [&](const string& key) {
+        string k;
+        in >> k;
+        if (!in || k != key) {
+            throw runtime_error("Corrupt incremental metadata (expected '" + key + "'): " + meta_path);
+        }
+    };
+
+    IncrementalMeta meta;
+    int version = 0;
+    expect(META_MAGIC);
+    in >> version;
+    if (version != META_VERSION) {
+        throw runtime_error("Unsupported incremental metadata version " + to_string(version) + ": " + meta_path);
+    }
+    size_t num_segments = 0;
+    expect("genes");    in >> meta.genes;
+    expect("cells");    in >> meta.cells;
+    expect("K");        in >> meta.K;
+    expect("nnz");      in >> meta.nnz;
+    expect("w_hash");   in >> hex >> meta.w_hash;
+    expect("y_hash");   in >> meta.y_hash >> dec;
+    expect("segments"); in >> num_segments;
+
+    for (size_t s = 0; s < num_segments; s++) {
+        XSegmentMeta seg;
+        expect("segment");
+        in >> seg.cells >> seg.nnz >> seg.file_size >> seg.mtime >> hex >> seg.hash >> dec;
+        in.get();  // single separator before the path
+        getline(in, seg.path);
+        if (!in) {
+            throw runtime_error("Corrupt incremental metadata (segment " + to_string(s) + "): " + meta_path);
+        }
+        meta.segments.push_back(seg);
+    }
+    return meta;
+}
+
+bool validate_x_segment(const XSegmentMeta& seg, bool full, string& reason) {
+    error_code ec;
+    if (!fs::exists(seg.path, ec)) {
+        reason = "missing X segment: " + seg.path;
+        return false;
+    }
+    uint64_t size = fs::file_size(seg.path, ec);
+    if (ec || size != seg.file_size) {
+        reason = "X segment size changed: " + seg.path;
+        return false;
+    }
+    long long mtime = fs::last_write_time(seg.path, ec).time_since_epoch().count();
+    if (!full && !ec && mtime == seg.mtime) {
+        return true;
+    }
+
+    // Same size, different mtime (or full check requested): compare content
+    CSR X = load_X_h5_as_csr(seg.path, "");
+    if (X.ncols != seg.cells || X.nnz != seg.nnz || csr_fingerprint(X) != seg.hash) {
+        reason = "X segment content changed: " + seg.path;
+        return false;
+    }
+    return true;
+}
+
+void spmm_append_cells(vector<float>& Y, IncrementalMeta& meta, const CSR& X_delta, const string& delta_path,
+                       const vector<float>& W, int W_rows, int W_cols, const string& log_annotation) {
+    auto start = chrono::high_resolution_clock::now();
+
+    if (X_delta.nrows != meta.genes) {
+        throw runtime_error("Matrix dimension mismatch: dX.nrows=" + to_string(X_delta.nrows)
+                           + " != genes=" + to_string(meta.genes));
+    }
+    if (W_cols != meta.K) {
+        throw runtime_error("Matrix dimension mismatch: W.ncols=" + to_string(W_cols)
+                           + " != K=" + to_string(meta.K));
+    }
+    if (W_rows != meta.cells + X_delta.ncols) {
+        throw runtime_error("Matrix dimension mismatch: W.nrows=" + to_string(W_rows)
+                           + " != cells+dX.ncols=" + to_string(meta.cells + X_delta.ncols));
+    }
+    if (Y.size() != static_cast<size_t>(meta.genes) * meta.K) {
+        throw runtime_error("Y size does not match incremental metadata");
+    }
+    if (dense_fingerprint(Y.data(), Y.size()) != meta.y_hash) {
+        throw runtime_error("Y does not match incremental metadata (modified or stale)");
+    }
+    if (dense_fingerprint(W.data(), static_cast<size_t>(meta.cells) * W_cols) != meta.w_hash) {
+        throw runtime_error("W rows of the existing cells changed; Y must be recomputed");
+    }
+
+    // Y += dX * W[offset:, :]
+    const float* W_new = W.data() + static_cast<size_t>(meta.cells) * W_cols;
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < X_delta.nrows; i++) {
+        float* y_row = Y.data() + static_cast<size_t>(i) * W_cols;
+        for (int idx = X_delta.indptr[i]; idx < X_delta.indptr[i + 1]; idx++) {
+            float x_val = X_delta.data[idx];
+            const float* w_row = W_new + static_cast<size_t>(X_delta.indices[idx]) * W_cols;
+            for (int j = 0; j < W_cols; j++) {
+                y_row[j] += x_val * w_row[j];
+            }
+        }
+    }
+
+    meta.segments.push_back(describe_x_segment(X_delta, delta_path));
+    meta.cells += X_delta.ncols;
+    meta.nnz += X_delta.nnz;
+    meta.w_hash = dense_fingerprint(W.data(), static_cast<size_t>(W_rows) * W_cols);
+    meta.y_hash = dense_fingerprint(Y.data(), Y.size());
+
+    if (!log_annotation.empty()) {
+        auto end = chrono::high_resolution_clock::now();
+        double ms = chrono::duration_cast<chrono::microseconds>(end - start).count() / 1000.0;
+        stringstream ss;
+        ss << "incremental append: " << X_delta.ncols << " cells, nnz " << X_delta.nnz
+           << " (total cells " << meta.cells << ", total nnz " << meta.nnz
+           << ", segments " << meta.segments.size() << ")" << endl;
+        ss << fixed << setprecision(3) << "incremental append time: " << ms << "ms" << endl;
+        log_to_file_experiment(log_annotation, "incremental", ss.str());
+    }
+}
+
+vector<float> load_Y_h5(const string& y_path, int& rows, int& cols) {
+    vector<float> Y;
+    try {
+        H5File file(y_path, H5F_ACC_RDONLY);
+        DataSet dataset = file.openDataSet("Y");
+        hsize_t dims[2];
+        dataset.getSpace().getSimpleExtentDims(dims);
+        rows = static_cast<int>(dims[0]);
+        cols = static_cast<int>(dims[1]);
+        Y.resize(static_cast<size_t>(rows) * cols);
+        dataset.read(Y.data(), PredType::NATIVE_FLOAT);
+    } catch (Exception& e) {
+        throw runtime_error("HDF5 error loading Y from " + y_path + ": " + e.getDetailMsg());
+    }
+    return Y;
+}
+
+void write_Y_h5(const vector<float>& Y, int rows, int cols, const string& y_path) {
+    try {
+        if (fs::exists(y_path)) {
+            H5File file(y_path, H5F_ACC_RDWR);
+            DataSet dataset = file.openDataSet("Y");
+            hsize_t dims[2];
+            dataset.getSpace().getSimpleExtentDims(dims);
+            if (dims[0] == static_cast<hsize_t>(rows) && dims[1] == static_cast<hsize_t>(cols)) {
+                dataset.write(Y.data(), PredType::NATIVE_FLOAT);
+                return;
+            }
+        }
+        fs::path parent = fs::path(y_path).parent_path();
+        if (!parent.empty()) fs::create_directories(parent);
+        H5File file(y_path, H5F_ACC_TRUNC);
+        hsize_t dims[2] = {static_cast<hsize_t>(rows), static_cast<hsize_t>(cols)};
+        DataSpace dataspace(2, dims);
+        DataSet dataset = file.createDataSet("Y", PredType::NATIVE_FLOAT, dataspace);
+        dataset.write(Y.data(), PredType::NATIVE_FLOAT);
+    } catch (Exception& e) {
+        throw runtime_error("HDF5 error writing Y to " + y_path + ": " + e.getDetailMsg());
+    }
+}
+
+bool incremental_run_from_disk(const string& y_path, const string& delta_x_path, const string& w_path,
+                               bool full_validation, const string& log_annotation) {
+    try {
+        auto start = chrono::high_resolution_clock::now();
+        string meta_path = incremental_meta_path(y_path);
+        IncrementalMeta meta = load_incremental_meta(meta_path);
+
+        for (const auto& seg : meta.segments) {
+            string reason;
+            if (!validate_x_segment(seg, full_validation, reason)) {
+                throw runtime_error("Base X changed, full recompute required (" + reason + ")");
+            }
+        }
+        auto t_validate = chrono::high_resolution_clock::now();
+
+        int Y_rows, Y_cols;
+        vector<float> Y = load_Y_h5(y_path, Y_rows, Y_cols);
+        CSR X_delta = load_X_h5_as_csr(delta_x_path, "");
+        int W_rows, W_cols;
+        vector<float> W = load_W_h5(w_path, W_rows, W_cols, "");
+        auto t_load = chrono::high_resolution_clock::now();
+
+        spmm_append_cells(Y, meta, X_delta, delta_x_path, W, W_rows, W_cols, log_annotation);
+        auto t_append = chrono::high_resolution_clock::now();
+
+        write_Y_h5(Y, Y_rows, Y_cols, y_path);
+        save_incremental_meta(meta, meta_path);
+        auto end = chrono::high_resolution_clock::now();
+
+        if (!log_annotation.empty()) {
+            auto ms = [](chrono::high_resolution_clock::time_point a, chrono::high_resolution_clock::time_point b) {
+                return chrono::duration_cast<chrono::microseconds>(b - a).count() / 1000.0;
+            };
+            stringstream ss;
+            ss << fixed << setprecision(3);
+            ss << "incremental validation (" << (full_validation ? "full" : "fast") << ") time: "
+               << ms(start, t_validate) << "ms" << endl;
+            ss << "incremental load time: " << ms(t_validate, t_load) << "ms" << endl;
+            ss << "incremental compute time: " << ms(t_load, t_append) << "ms" << endl;
+            ss << "incremental store time: " << ms(t_append, end) << "ms" << endl;
+            log_to_file_experiment(log_annotation, "incremental", ss.str());
+        }
+        return true;
+    } catch (const exception& e) {
+        cerr << "Error in incremental_run_from_disk: " << e.what() << endl;
+        return false;
+    }
+}
@@ -0,0 +1,331 @@
+#include "../include/jit_spmm.hpp"
+#include "../include/spmm.hpp"
+#include "../include/logger.hpp"
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <filesystem>
+#include <dlfcn.h>
+#include <unistd.h>
+#include <omp.h>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+/* Bump when the generated code changes, so stale shared objects are not reused */
+static const int JIT_CODEGEN_VERSION = 1;
+
+static double ms_since(chrono::high_resolution_clock::time_point t) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - t).count() / 1000.0;
+}
+
+/* FNV-1a over 32-bit words */
+static uint64_t fnv_mix(uint64_t h, uint32_t v) {
+    return (h ^ v) * 0x100000001b3ULL;
+}
+
+static uint64_t fnv_string(uint64_t h, const string& s) {
+    for (unsigned char c : s) h = fnv_mix(h, c);
+    return h;
+}
+
+static string hex64(uint64_t v) {
+    stringstream ss;
+    ss << hex << setw(16) << setfill('0') << v;
+    return ss.str();
+}
+
+uint64_t csr_structure_fingerprint(const CSR& X) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    h = fnv_mix(h, static_cast<uint32_t>(X.nrows));
+    h = fnv_mix(h, static_cast<uint32_t>(X.ncols));
+    h = fnv_mix(h, static_cast<uint32_t>(X.nnz));
+    h = fnv_mix(h, static_cast<uint32_t>(static_cast<uint64_t>(X.nnz) >> 32));
+    for (int i = 0; i <= X.nrows; i++) h = fnv_mix(h, static_cast<uint32_t>(X.indptr[i]));
+    for (size_t idx = 0; idx < X.nnz; idx++) h = fnv_mix(h, static_cast<uint32_t>(X.indices[idx]));
+    return h;
+}
+
+/* Baseline inner loop with K fixed at compile time: the j loop has a constant trip count */
+template <int K>
+static void spmm_fixed_k_kernel(const CSR& X, const float* W, float* Y) {
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < X.nrows; i++) {
+        float* __restrict__ y = Y + static_cast<size_t>(i) * K;
+        for (int j = 0; j < K; j++) y[j] = 0.0f;
+        for (int idx = X.indptr[i]; idx < X.indptr[i + 1]; idx++) {
+            const float x_val = X.data[idx];
+            const float* __restrict__ w = W + static_cast<size_t>(X.indices[idx]) * K;
+            for (int j = 0; j < K; j++) y[j] += x_val * w[j];
+        }
+    }
+}
+
+void spmm_fixed_k_into(const CSR& X, const vector<float>& W, int W_rows, int W_cols, Span<float> Y) {
+    if (X.ncols != W_rows) {
+        throw runtime_error("Matrix dimension mismatch: X.ncols=" + to_string(X.ncols)
+                           + " != W.nrows=" + to_string(W_rows));
+    }
+    require_span_size(Y, static_cast<size_t>(X.nrows) * W_cols, "Y");
+
+    switch (W_cols) {
+        case 8:   spmm_fixed_k_kernel<8>(X, W.data(), Y.data); break;
+        case 16:  spmm_fixed_k_kernel<16>(X, W.data(), Y.data); break;
+        case 32:  spmm_fixed_k_kernel<32>(X, W.data(), Y.data); break;
+        case 64:  spmm_fixed_k_kernel<64>(X, W.data(), Y.data); break;
+        case 128: spmm_fixed_k_kernel<128>(X, W.data(), Y.data); break;
+        default:  spmm_baseline_into(X, W, W_rows, W_cols, Y); break;
+    }
+}
+
+string JitSpmmKernel::generate_source(const CSR& X) const {
+    const int R = cfg_.rows_per_chunk;
+    const int num_chunks = (X.nrows + R - 1) / R;
+    stringstream src;
+    src << "// Generated by jit_spmm: X " << X.nrows << " x " << X.ncols << ", nnz " << X.nnz
+        << ", fingerprint " << info_.fingerprint << "\n"
+        << "#include <cstddef>\n"
+        << "#define RS __restrict__\n"
+        << "static constexpr int K = " << K_ << ";\n"
+        << "static constexpr int NUM_CHUNKS = " << num_chunks << ";\n"
+        << "// Short row: the nonzeros are unrolled inside the K loop, so each y[j] is summed in registers\n"
+        << "// in the same order as the generic loop\n"
+        << "template <int L>\n"
+        << "static inline void row_fixed(const int* RS ix, const float* RS v, const float* RS W, float* RS y) {\n"
+        << "    for (int j = 0; j < K; j++) {\n"
+        << "        float s = 0.0f;\n"
+        << "#pragma GCC unroll " << max(cfg_.unroll_max, 1) << "\n"
+        << "        for (int e = 0; e < L; e++) s += v[e] * W[static_cast<size_t>(ix[e]) * K + j];\n"
+        << "        y[j] = s;\n"
+        << "    }\n"
+        << "}\n"
+        << "// Long row: one out-of-line copy, so the chunk functions stay small\n"
+        << "__attribute__((noinline))\n"
+        << "static void row_long(int n, const int* RS ix, const float* RS v, const float* RS W, float* RS y) {\n"
+        << "    for (int j = 0; j < K; j++) y[j] = 0.0f;\n"
+        << "    for (int e = 0; e < n; e++) {\n"
+        << "        const float x = v[e];\n"
+        << "        const float* RS w = W + static_cast<size_t>(ix[e]) * K;\n"
+        << "        for (int j = 0; j < K; j++) y[j] += x * w[j];\n"
+        << "    }\n"
+        << "}\n"
+        << "static inline void row_zero(float* RS y) {\n"
+        << "    for (int j = 0; j < K; j++) y[j] = 0.0f;\n"
+        << "}\n";
+
+    // One function per chunk: offsets and lengths are literals
+    for (int c = 0; c < num_chunks; c++) {
+        src << "static void chunk_" << c << "(const int* RS ix, const float* RS v, const float* RS W, float* RS Y) {\n";
+        const int row_end = min(X.nrows, (c + 1) * R);
+        for (int i = c * R; i < row_end; i++) {
+            const int off = X.indptr[i];
+            const int len = X.indptr[i + 1] - off;
+            const string y = "Y + " + to_string(static_cast<size_t>(i) * K_) + "UL";
+            if (len == 0) {
+                src << "    row_zero(" << y << ");\n";
+            } else if (len <= cfg_.unroll_max) {
+                src << "    row_fixed<" << len << ">(ix + " << off << ", v + " << off << ", W, " << y << ");\n";
+            } else {
+                src << "    row_long(" << len << ", ix + " << off << ", v + " << off << ", W, " << y << ");\n";
+            }
+        }
+        src << "}\n";
+    }
+
+    src << "typedef void (*chunk_fn)(const int*, const float*, const float*, float*);\n"
+        << "static const chunk_fn CHUNKS[] = {";
+    for (int c = 0; c < num_chunks; c++) {
+        src << (c % 8 == 0 ? "\n    " : " ") << "chunk_" << c << ",";
+    }
+    src << "\n};\n"
+        << "extern \"C\" int jit_spmm_k() { return K; }\n"
+        << "extern \"C\" int jit_spmm_nrows() { return " << X.nrows << "; }\n"
+        << "extern \"C\" const char* jit_spmm_fingerprint() { return \"" << info_.fingerprint << "\"; }\n"
+        << "extern \"C\" void jit_spmm(const int* ix, const float* v, const float* W, float* Y) {\n"
+        << "#pragma omp parallel for schedule(dynamic, 1)\n"
+        << "    for (int c = 0; c < NUM_CHUNKS; c++) CHUNKS[c](ix, v, W, Y);\n"
+        << "}\n";
+    return src.str();
+}
+
+/* Single-quoted for /bin/sh, so no character of s is interpreted by the shell */
+static string shell_quote(const string& s) {
+    string q = "'";
+    for (char c : s) {
+        if (c == '\'') q += "'\\''";
+        else q += c;
+    }
+    return q + "'";
+}
+
+/* Each whitespace-separated token of s quoted on its own ($CXX may be e.g. "ccache g++") */
+static string shell_quote_words(const string& s) {
+    stringstream in(s);
+    string word, out;
+    while (in >> word) out += (out.empty() ? "" : " ") + shell_quote(word);
+    return out;
+}
+
+/* Last few lines of a compiler log, for the fallback reason */
+static string log_tail(const string& path, size_t max_lines = 5) {
+    ifstream in(path);
+    vector<string> lines;
+    string line;
+    while (getline(in, line)) lines.push_back(line);
+    size_t first = lines.size() > max_lines ? lines.size() - max_lines : 0;
+    string tail;
+    for (size_t i = first; i < lines.size(); i++) tail += (tail.empty() ? "" : " | ") + lines[i];
+    return tail;
+}
+
+JitSpmmKernel::JitSpmmKernel(const CSR& X, int K, const JitConfig& cfg, const string& log_annotation)
+    : cfg_(cfg), K_(K), nrows_(X.nrows), ncols_(X.ncols), nnz_(X.nnz) {
+    if (K < 1) {
+        throw runtime_error("JitSpmmKernel: K must be positive");
+    }
+    if (cfg.rows_per_chunk < 1) {
+        throw runtime_error("JitSpmmKernel: rows_per_chunk must be at least 1");
+    }
+    if (cfg_.compiler.empty()) {
+        const char* env_cxx = getenv("CXX");
+        cfg_.compiler = env_cxx != nullptr && env_cxx[0] != '\0' ? env_cxx : "g++";
+    }
+
+    // Fingerprint: structure of X plus everything that changes the generated object
+    auto start = chrono::high_resolution_clock::now();
+    fingerprint_ = csr_structure_fingerprint(X);
+    info_.fingerprint = hex64(fingerprint_);
+    uint64_t key = fnv_string(0xcbf29ce484222325ULL, info_.fingerprint);
+    key = fnv_string(key, cfg_.compiler + " " + cfg_.flags);
+    key = fnv_mix(key, static_cast<uint32_t>(K));
+    key = fnv_mix(key, static_cast<uint32_t>(cfg_.rows_per_chunk));
+    key = fnv_mix(key, static_cast<uint32_t>(cfg_.unroll_max));
+    key = fnv_mix(key, static_cast<uint32_t>(JIT_CODEGEN_VERSION));
+    info_.fingerprint_ms = ms_since(start);
+
+    const fs::path dir(cfg_.cache_dir);
+    const string base = "spmm_" + info_.fingerprint + "_k" + to_string(K) + "_" + hex64(key).substr(0, 8);
+    info_.so_path = (dir / (base + ".so")).string();
+    for (int i = 0; i < X.nrows; i++) {
+        int len = X.indptr[i + 1] - X.indptr[i];
+        if (len > 0 && len <= cfg_.unroll_max) info_.unrolled_rows++;
+    }
+
+    error_code ec;
+    fs::create_directories(dir, ec);
+    if (ec || !fs::is_directory(dir)) {
+        info_.fallback_reason = "cannot create cache directory " + dir.string()
+                                + (ec ? ": " + ec.message() : string(""));
+    } else {
+        info_.cache_hit = fs::exists(info_.so_path, ec);
+    }
+
+    if (info_.fallback_reason.empty() && !info_.cache_hit) {
+        start = chrono::high_resolution_clock::now();
+        string source = generate_source(X);
+        info_.source_bytes = source.size();
+        // Per-process names, then an atomic rename, so concurrent builds of the same X do not collide
+        const string tag = "." + to_string(getpid());
+        const string src_path = (dir / (base + tag + ".cpp")).string();
+        const string tmp_path = (dir / (base + tag + ".so")).string();
+        const string log_path = (dir / (base + tag + ".log")).string();
+        bool written;
+        {
+            ofstream out(src_path);
+            out << source;
+            written = static_cast<bool>(out);
+        }
+        info_.codegen_ms = ms_since(start);
+
+        if (!written) {
+            fs::remove(src_path, ec);
+            info_.fallback_reason = "cannot write generated source " + src_path;
+        } else {
+            start = chrono::high_resolution_clock::now();
+            const string cmd = shell_quote_words(cfg_.compiler) + " " + shell_quote_words(cfg_.flags)
+                               + " -o " + shell_quote(tmp_path) + " " + shell_quote(src_path)
+                               + " > " + shell_quote(log_path) + " 2>&1";
+            int rc = system(cmd.c_str());
+            info_.compile_ms = ms_since(start);
+            fs::remove(src_path, ec);
+            if (rc == 0 && fs::exists(tmp_path, ec)) {
+                fs::remove(log_path, ec);
+                fs::rename(tmp_path, info_.so_path, ec);
+                if (ec) info_.fallback_reason = "could not move " + tmp_path + " into the cache: " + ec.message();
+            } else {
+                fs::remove(tmp_path, ec);
+                string tail = log_tail(log_path);
+                info_.fallback_reason = "compile failed (" + cfg_.compiler + ", exit " + to_string(rc) + ")"
+                                        + (tail.empty() ? "" : ": " + tail);
+            }
+        }
+    }
+
+    if (info_.fallback_reason.empty()) {
+        start = chrono::high_resolution_clock::now();
+        handle_ = dlopen(info_.so_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (handle_ == nullptr) {
+            const char* err = dlerror();
+            info_.fallback_reason = string("dlopen failed: ") + (err != nullptr ? err : "unknown error");
+        } else {
+            auto k_fn = reinterpret_cast<int (*)()>(dlsym(handle_, "jit_spmm_k"));
+            auto rows_fn = reinterpret_cast<int (*)()>(dlsym(handle_, "jit_spmm_nrows"));
+            auto fp_fn = reinterpret_cast<const char* (*)()>(dlsym(handle_, "jit_spmm_fingerprint"));
+            fn_ = reinterpret_cast<KernelFn>(dlsym(handle_, "jit_spmm"));
+            // Guard against a stale or foreign object under the same name
+            if (fn_ == nullptr || k_fn == nullptr || rows_fn == nullptr || fp_fn == nullptr
+                || k_fn() != K_ || rows_fn() != nrows_ || info_.fingerprint != fp_fn()) {
+                info_.fallback_reason = "cached object " + info_.so_path + " does not match X";
+                dlclose(handle_);
+                handle_ = nullptr;
+                fn_ = nullptr;
+            }
+        }
+        info_.load_ms = ms_since(start);
+    }
+    info_.jitted = fn_ != nullptr;
+
+    if (!log_annotation.empty()) {
+        stringstream ss;
+        ss << fixed << setprecision(3);
+        ss << "jit kernel " << info_.fingerprint << " K=" << K_ << ": "
+           << (info_.jitted ? (info_.cache_hit ? "loaded from cache" : "compiled") : "generic fallback")
+           << ", fingerprint " << info_.fingerprint_ms << "ms, codegen " << info_.codegen_ms << "ms ("
+           << info_.source_bytes << " bytes), compile " << info_.compile_ms << "ms, load " << info_.load_ms << "ms, "
+           << info_.unrolled_rows << " unrolled rows";
+        if (!info_.fallback_reason.empty()) ss << ", reason: " << info_.fallback_reason;
+        log_to_file_experiment(log_annotation, "jit", ss.str());
+    }
+}
+
+JitSpmmKernel::~JitSpmmKernel() {
+    if (handle_ != nullptr) dlclose(handle_);
+}
+
+void JitSpmmKernel::run_into(const CSR& X, const vector<float>& W, int W_rows, int W_cols, Span<float> Y) const {
+    if (X.ncols != W_rows) {
+        throw runtime_error("Matrix dimension mismatch: X.ncols=" + to_string(X.ncols)
+                           + " != W.nrows=" + to_string(W_rows));
+    }
+    // The generated code hard-codes row offsets and lengths, so the structure must match exactly
+    if (X.nrows != nrows_ || X.ncols != ncols_ || X.nnz != nnz_ || csr_structure_fingerprint(X) != fingerprint_) {
+        throw runtime_error("JitSpmmKernel: X does not match the matrix the kernel was built for");
+    }
+    if (!info_.jitted || W_cols != K_) {
+        spmm_fixed_k_into(X, W, W_rows, W_cols, Y);
+        return;
+    }
+    require_span_size(Y, static_cast<size_t>(X.nrows) * W_cols, "Y");
+    fn_(X.indices.data(), X.data.data(), W.data(), Y.data);
+}
+
+vector<float> JitSpmmKernel::run(const CSR& X, const vector<float>& W, int W_rows, int W_cols) const {
+    vector<float> Y(static_cast<size_t>(X.nrows) * W_cols);
+    run_into(X, W, W_rows, W_cols, Y);
+    return Y;
+}
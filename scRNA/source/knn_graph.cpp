@@ -0,0 +1,438 @@
+#include "../include/knn_graph.hpp"
+#include "../include/logger.hpp"
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <iomanip>
+#include <omp.h>
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+using namespace std::chrono;
+
+#if defined(__AVX512F__)
+// Horizontal sum; masked extract avoids GCC's uninitialized-operand warning in _mm512_reduce_add_ps
+static inline float hsum512(__m512 v) {
+    __m256 lo = _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xFF, _mm512_castps_pd(v), 0));
+    __m256 hi = _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xFF, _mm512_castps_pd(v), 1));
+    __m256 s8 = _mm256_add_ps(lo, hi);
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(s8), _mm256_extractf128_ps(s8, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+    return _mm_cvtss_f32(s);
+}
+#endif
+
+float squared_l2(const float* a, const float* b, int dim) {
+#if defined(__AVX512F__)
+    if (dim == 32) {
+        __m512 d0 = _mm512_sub_ps(_mm512_loadu_ps(a), _mm512_loadu_ps(b));
+        __m512 d1 = _mm512_sub_ps(_mm512_loadu_ps(a + 16), _mm512_loadu_ps(b + 16));
+        __m512 acc = _mm512_fmadd_ps(d1, d1, _mm512_mul_ps(d0, d0));
+        return hsum512(acc);
+    }
+    __m512 acc = _mm512_setzero_ps();
+    int j = 0;
+    for (; j + 16 <= dim; j += 16) {
+        __m512 d = _mm512_sub_ps(_mm512_loadu_ps(a + j), _mm512_loadu_ps(b + j));
+        acc = _mm512_fmadd_ps(d, d, acc);
+    }
+    if (j < dim) {
+        __mmask16 m = static_cast<__mmask16>((1u << (dim - j)) - 1);
+        __m512 d = _mm512_sub_ps(_mm512_maskz_loadu_ps(m, a + j), _mm512_maskz_loadu_ps(m, b + j));
+        acc = _mm512_fmadd_ps(d, d, acc);
+    }
+    return hsum512(acc);
+#elif defined(__AVX2__)
+    __m256 acc = _mm256_setzero_ps();
+    int j = 0;
+    for (; j + 8 <= dim; j += 8) {
+        __m256 d = _mm256_sub_ps(_mm256_loadu_ps(a + j), _mm256_loadu_ps(b + j));
+        #ifdef __FMA__
+        acc = _mm256_fmadd_ps(d, d, acc);
+        #else
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(d, d));
+        #endif
+    }
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+    float sum = _mm_cvtss_f32(s);
+    for (; j < dim; j++) {
+        float d = a[j] - b[j];
+        sum += d * d;
+    }
+    return sum;
+#else
+    float sum = 0.0f;
+    for (int j = 0; j < dim; j++) {
+        float d = a[j] - b[j];
+        sum += d * d;
+    }
+    return sum;
+#endif
+}
+
+/*
+  Fixed-size neighbor lists: k slots per point (id -1 = empty), squared distances,
+  and a "new" flag per slot for NN-descent.
+ */
+struct NeighborLists {
+    int n;
+    int k;
+    vector<int> ids;
+    vector<float> dists;
+    vector<char> is_new;
+
+    NeighborLists(int n_, int k_)
+        : n(n_), k(k_),
+          ids(static_cast<size_t>(n_) * k_, -1),
+          dists(static_cast<size_t>(n_) * k_, numeric_limits<float>::infinity()),
+          is_new(static_cast<size_t>(n_) * k_, 0) {}
+
+    bool contains(int i, int cand) const {
+        const int* row = ids.data() + static_cast<size_t>(i) * k;
+        for (int s = 0; s < k; s++) {
+            if (row[s] == cand) return true;
+        }
+        return false;
+    }
+
+    // Replace the current farthest neighbor of i if cand is closer (caller checked duplicates)
+    bool insert(int i, int cand, float dist) {
+        size_t base = static_cast<size_t>(i) * k;
+        int worst = 0;
+        for (int s = 1; s < k; s++) {
+            if (dists[base + s] > dists[base + worst]) worst = s;
+        }
+        if (dist >= dists[base + worst]) return false;
+        ids[base + worst] = cand;
+        dists[base + worst] = dist;
+        is_new[base + worst] = 1;
+        return true;
+    }
+};
+
+/*
+  One random-projection tree: perm is partitioned in place, leaves are [begin, end) ranges.
+ */
+static vector<pair<int, int>> build_rp_tree(const vector<float>& Y, int dim, vector<int>& perm,
+                                            int leaf_size, mt19937& rng) {
+    vector<pair<int, int>> leaves;
+    vector<pair<int, int>> stack;
+    stack.emplace_back(0, static_cast<int>(perm.size()));
+    vector<float> normal(dim);
+
+    while (!stack.empty()) {
+        auto [begin, end] = stack.back();
+        stack.pop_back();
+        int size = end - begin;
+        if (size <= leaf_size) {
+            leaves.emplace_back(begin, end);
+            continue;
+        }
+
+        // Hyperplane bisecting two random points
+        uniform_int_distribution<int> pick(begin, end - 1);
+        int a = perm[pick(rng)];
+        int b = perm[pick(rng)];
+        const float* ya = Y.data() + static_cast<size_t>(a) * dim;
+        const float* yb = Y.data() + static_cast<size_t>(b) * dim;
+        float offset = 0.0f;
+        for (int j = 0; j < dim; j++) {
+            normal[j] = ya[j] - yb[j];
+            offset += normal[j] * 0.5f * (ya[j] + yb[j]);
+        }
+
+        auto mid_it = partition(perm.begin() + begin, perm.begin() + end, [&](int p) {
+            const float* yp = Y.data() + static_cast<size_t>(p) * dim;
+            float s = 0.0f;
+            for (int j = 0; j < dim; j++) s += normal[j] * yp[j];
+            return s < offset;
+        });
+        int mid = static_cast<int>(mid_it - perm.begin());
+
+        // Degenerate split (identical points): fall back to halving
+        if (mid == begin || mid == end) {
+            mid = begin + size / 2;
+        }
+        stack.emplace_back(begin, mid);
+        stack.emplace_back(mid, end);
+    }
+
+    return leaves;
+}
+
+CSR build_knn_graph(const vector<float>& Y, int n, int dim, const KnnParams& params,
+                    KnnStats* stats, const string& log_annotation) {
+    if (static_cast<size_t>(n) * dim != Y.size()) {
+        throw runtime_error("Matrix dimension mismatch: Y.size=" + to_string(Y.size())
+                           + " != n*dim=" + to_string(static_cast<size_t>(n) * dim));
+    }
+    if (params.k <= 0) {
+        throw runtime_error("kNN requires k > 0");
+    }
+
+    KnnStats local_stats;
+    KnnStats& st = stats ? *stats : local_stats;
+    st = KnnStats();
+    auto start = high_resolution_clock::now();
+
+    int k = min(params.k, max(0, n - 1));
+    CSR G;
+    G.nrows = n;
+    G.ncols = n;
+    G.indptr.assign(n + 1, 0);
+    G.nnz = 0;
+    if (k == 0) return G;
+
+    NeighborLists nl(n, k);
+    int leaf_size = params.leaf_size > 0 ? params.leaf_size : max(2 * k, 32);
+    size_t evals = 0;
+
+    auto dist = [&](int i, int j) {
+        return squared_l2(Y.data() + static_cast<size_t>(i) * dim, Y.data() + static_cast<size_t>(j) * dim, dim);
+    };
+
+    // Phase 1: RP forest (trees in parallel, then leaf joins tree by tree)
+    int T = max(0, params.rp_trees);
+    vector<vector<int>> perms(T);
+    vector<vector<pair<int, int>>> forest(T);
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int t = 0; t < T; t++) {
+        mt19937 rng(params.seed + 7919u * (t + 1));
+        perms[t].resize(n);
+        for (int i = 0; i < n; i++) perms[t][i] = i;
+        forest[t] = build_rp_tree(Y, dim, perms[t], leaf_size, rng);
+    }
+
+    for (int t = 0; t < T; t++) {
+        const vector<int>& perm = perms[t];
+        const vector<pair<int, int>>& leaves = forest[t];
+        #pragma omp parallel for schedule(dynamic, 16) reduction(+:evals)
+        for (size_t l = 0; l < leaves.size(); l++) {
+            for (int a = leaves[l].first; a < leaves[l].second; a++) {
+                int i = perm[a];
+                for (int b = leaves[l].first; b < leaves[l].second; b++) {
+                    int j = perm[b];
+                    if (j == i || nl.contains(i, j)) continue;
+                    nl.insert(i, j, dist(i, j));
+                    evals++;
+                }
+            }
+        }
+    }
+
+    // Fill remaining empty slots with random points
+    #pragma omp parallel for schedule(static) reduction(+:evals)
+    for (int i = 0; i < n; i++) {
+        minstd_rand rng(params.seed ^ (static_cast<unsigned>(i) * 2654435761u));
+        uniform_int_distribution<int> pick(0, n - 1);
+        int attempts = 0;
+        while (nl.contains(i, -1) && attempts < 8 * k) {
+            int j = pick(rng);
+            attempts++;
+            if (j == i || nl.contains(i, j)) continue;
+            nl.insert(i, j, dist(i, j));
+            evals++;
+        }
+    }
+
+    auto t_forest = high_resolution_clock::now();
+    st.rp_forest_ms = duration_cast<microseconds>(t_forest - start).count() / 1000.0;
+
+    // Phase 2: NN-descent (pull-style: point i only updates its own list)
+    int mc = params.max_candidates > 0 ? params.max_candidates : k;
+    vector<int> new_ids(static_cast<size_t>(n) * mc), old_ids(static_cast<size_t>(n) * k);
+    vector<int> new_cnt(n), old_cnt(n);
+    vector<int> rev_new(static_cast<size_t>(n) * mc), rev_old(static_cast<size_t>(n) * mc);
+    vector<int> rev_new_cnt(n), rev_old_cnt(n);
+
+    for (int iter = 0; iter < params.max_iters; iter++) {
+        // Snapshot new/old lists; sampled new entries become old
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < n; i++) {
+            size_t base = static_cast<size_t>(i) * k;
+            int nc = 0, oc = 0;
+            for (int s = 0; s < k; s++) {
+                int id = nl.ids[base + s];
+                if (id < 0) continue;
+                if (nl.is_new[base + s] && nc < mc) {
+                    new_ids[static_cast<size_t>(i) * mc + nc++] = id;
+                    nl.is_new[base + s] = 0;
+                } else if (!nl.is_new[base + s]) {
+                    old_ids[static_cast<size_t>(i) * k + oc++] = id;
+                }
+            }
+            new_cnt[i] = nc;
+            old_cnt[i] = oc;
+        }
+
+        // Reverse lists (capped at mc per point)
+        fill(rev_new_cnt.begin(), rev_new_cnt.end(), 0);
+        fill(rev_old_cnt.begin(), rev_old_cnt.end(), 0);
+        for (int i = 0; i < n; i++) {
+            for (int s = 0; s < new_cnt[i]; s++) {
+                int j = new_ids[static_cast<size_t>(i) * mc + s];
+                if (rev_new_cnt[j] < mc) rev_new[static_cast<size_t>(j) * mc + rev_new_cnt[j]++] = i;
+            }
+            for (int s = 0; s < old_cnt[i]; s++) {
+                int j = old_ids[static_cast<size_t>(i) * k + s];
+                if (rev_old_cnt[j] < mc) rev_old[static_cast<size_t>(j) * mc + rev_old_cnt[j]++] = i;
+            }
+        }
+
+        size_t updates = 0;
+        #pragma omp parallel reduction(+:updates, evals)
+        {
+            // seen[w] == i + 1: w was already tried for point i in this iteration
+            vector<int> seen(n, 0);
+
+            #pragma omp for schedule(dynamic, 64)
+            for (int i = 0; i < n; i++) {
+                auto try_candidate = [&](int w) {
+                    if (w == i || seen[w] == i + 1) return;
+                    seen[w] = i + 1;
+                    if (nl.contains(i, w)) return;
+                    evals++;
+                    if (nl.insert(i, w, dist(i, w))) updates++;
+                };
+                auto scan = [&](const int* list, int count, bool all_of_u) {
+                    for (int s = 0; s < count; s++) {
+                        int u = list[s];
+                        const int* un = new_ids.data() + static_cast<size_t>(u) * mc;
+                        const int* urn = rev_new.data() + static_cast<size_t>(u) * mc;
+                        for (int t = 0; t < new_cnt[u]; t++) try_candidate(un[t]);
+                        for (int t = 0; t < rev_new_cnt[u]; t++) try_candidate(urn[t]);
+                        if (all_of_u) {
+                            const int* uo = old_ids.data() + static_cast<size_t>(u) * k;
+                            const int* uro = rev_old.data() + static_cast<size_t>(u) * mc;
+                            for (int t = 0; t < old_cnt[u]; t++) try_candidate(uo[t]);
+                            for (int t = 0; t < rev_old_cnt[u]; t++) try_candidate(uro[t]);
+                        }
+                    }
+                };
+                // New edges of i meet everything around u; old edges only meet u's new edges
+                scan(new_ids.data() + static_cast<size_t>(i) * mc, new_cnt[i], true);
+                scan(rev_new.data() + static_cast<size_t>(i) * mc, rev_new_cnt[i], true);
+                scan(old_ids.data() + static_cast<size_t>(i) * k, old_cnt[i], false);
+                scan(rev_old.data() + static_cast<size_t>(i) * mc, rev_old_cnt[i], false);
+            }
+        }
+
+        st.iterations++;
+        st.updates_per_iter.push_back(updates);
+        if (static_cast<double>(updates) < params.delta * n * k) break;
+    }
+
+    auto t_descent = high_resolution_clock::now();
+    st.descent_ms = duration_cast<microseconds>(t_descent - t_forest).count() / 1000.0;
+    st.distance_evals = evals;
+
+    // Emit CSR (neighbors sorted by index, Euclidean distances)
+    for (int i = 0; i < n; i++) {
+        int cnt = 0;
+        for (int s = 0; s < k; s++) cnt += nl.ids[static_cast<size_t>(i) * k + s] >= 0;
+        G.indptr[i + 1] = G.indptr[i] + cnt;
+    }
+    G.nnz = G.indptr[n];
+    G.indices.resize(G.nnz);
+    G.data.resize(G.nnz);
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; i++) {
+        vector<pair<int, float>> row;
+        row.reserve(k);
+        for (int s = 0; s < k; s++) {
+            size_t slot = static_cast<size_t>(i) * k + s;
+            if (nl.ids[slot] >= 0) row.emplace_back(nl.ids[slot], sqrt(nl.dists[slot]));
+        }
+        sort(row.begin(), row.end());
+        int dest = G.indptr[i];
+        for (const auto& e : row) {
+            G.indices[dest] = e.first;
+            G.data[dest] = e.second;
+            dest++;
+        }
+    }
+
+    st.total_ms = duration_cast<microseconds>(high_resolution_clock::now() - start).count() / 1000.0;
+
+    if (!log_annotation.empty()) {
+        stringstream ss;
+        ss << "knn points: " << n << ", dim: " << dim << ", k: " << k
+           << ", threads: " << omp_get_max_threads() << endl;
+        ss << "knn rp trees: " << T << ", leaf size: " << leaf_size << endl;
+        ss << "knn nn-descent iterations: " << st.iterations << ", updates:";
+        for (size_t u : st.updates_per_iter) ss << " " << u;
+        ss << endl;
+        ss << "knn distance evaluations: " << st.distance_evals << " (brute force: "
+           << static_cast<size_t>(n) * (n - 1) << ")" << endl;
+        ss << fixed << setprecision(3);
+        ss << "knn rp forest time: " << st.rp_forest_ms << "ms" << endl;
+        ss << "knn nn-descent time: " << st.descent_ms << "ms" << endl;
+        ss << "knn total time: " << st.total_ms << "ms" << endl;
+        log_to_file_experiment(log_annotation, "knn", ss.str());
+    }
+
+    return G;
+}
+
+CSR exact_knn_graph(const vector<float>& Y, int n, int dim, int k) {
+    k = min(k, max(0, n - 1));
+    CSR G;
+    G.nrows = n;
+    G.ncols = n;
+    G.nnz = static_cast<size_t>(n) * k;
+    G.indptr.resize(n + 1);
+    for (int i = 0; i <= n; i++) G.indptr[i] = i * k;
+    G.indices.resize(G.nnz);
+    G.data.resize(G.nnz);
+
+    #pragma omp parallel
+    {
+        vector<pair<float, int>> all(n);
+
+        #pragma omp for schedule(dynamic, 16)
+        for (int i = 0; i < n; i++) {
+            const float* yi = Y.data() + static_cast<size_t>(i) * dim;
+            for (int j = 0; j < n; j++) {
+                float d = j == i ? numeric_limits<float>::infinity()
+                                 : squared_l2(yi, Y.data() + static_cast<size_t>(j) * dim, dim);
+                all[j] = make_pair(d, j);
+            }
+            partial_sort(all.begin(), all.begin() + k, all.end());
+            vector<pair<int, float>> row(k);
+            for (int s = 0; s < k; s++) row[s] = make_pair(all[s].second, sqrt(all[s].first));
+            sort(row.begin(), row.end());
+            for (int s = 0; s < k; s++) {
+                G.indices[static_cast<size_t>(i) * k + s] = row[s].first;
+                G.data[static_cast<size_t>(i) * k + s] = row[s].second;
+            }
+        }
+    }
+
+    return G;
+}
+
+double knn_recall(const CSR& approx, const CSR& exact) {
+    size_t found = 0;
+    size_t total = 0;
+    for (int i = 0; i < exact.nrows && i < approx.nrows; i++) {
+        int a = approx.indptr[i], a_end = approx.indptr[i + 1];
+        int e = exact.indptr[i], e_end = exact.indptr[i + 1];
+        total += e_end - e;
+        while (a < a_end && e < e_end) {
+            if (approx.indices[a] == exact.indices[e]) { found++; a++; e++; }
+            else if (approx.indices[a] < exact.indices[e]) a++;
+            else e++;
+        }
+    }
+    return total > 0 ? static_cast<double>(found) / total : 1.0;
+}
@@ -1,7 +1,9 @@
 #include "../include/disk_to_memory.hpp"
 #include "../include/spmm.hpp"
 #include "../include/csr.hpp"
+#include "../include/incremental_spmm.hpp"
 #include "../include/logger.hpp"
+#include "../include/y_writer.hpp"
 #include <H5Cpp.h>
 #include <iostream>
 #include <filesystem>
@@ -37,17 +39,6 @@ string generate_log_filename(const string& x_filename) {
     return "../logs/log" + postfix + ".txt";
 }
 
-void silent_save_Y(const vector<float>& Y, int rows, int cols, const string& path) {
-    try {
-        fs::create_directories(fs::path(path).parent_path());
-        H5File file(path, H5F_ACC_TRUNC);
-        hsize_t dims[2] = {static_cast<hsize_t>(rows), static_cast<hsize_t>(cols)};
-        DataSpace dataspace(2, dims);
-        DataSet dataset = file.createDataSet("Y", PredType::NATIVE_FLOAT, dataspace);
-        dataset.write(Y.data(), PredType::NATIVE_FLOAT);
-    } catch (...) {}
-}
-
 /**
  * Baseline run wrapper - times spmm_baseline(), computes performance metrics, and logs.
  * Takes already-loaded matrices. Can be reused by PIM/hybrid implementations for comparison.
@@ -115,7 +106,15 @@ bool baseline_run_from_disk(const string& x_path, const string& w_path, const st
     // Perform SpMM computation
     vector<float> Y = baseline_run(X, W, w_rows, w_cols, log_annotation);
 
-        silent_save_Y(Y, X.nrows, w_cols, y_path);
+        try_save_Y_h5(Y, X.nrows, w_cols, y_path, YWriterConfig(), log_annotation);
+        
+        // Sidecar metadata so later cell batches can be appended incrementally
+        try {
+            save_incremental_meta(make_incremental_meta(X, x_path, Y, W, w_rows, w_cols),
+                                  incremental_meta_path(y_path));
+        } catch (const exception& e) {
+            cerr << "Warning: incremental metadata not written: " << e.what() << endl;
+        }
         
         return true;
     } catch (const exception& e) {
@@ -125,6 +124,28 @@ bool baseline_run_from_disk(const string& x_path, const string& w_path, const st
 }
 
 int main(int argc, char* argv[]) {
+    // Incremental mode: run --append <base_X_file.h5> <delta_X_file.h5> <W_file.h5>
+    // Updates ../dataset/Y/y<base postfix>.h5 in place with the new cells.
+    if (argc == 5 && string(argv[1]) == "--append") {
+        string base_in = argv[2];
+        string postfix = extract_postfix(base_in);
+        string y_path = "../dataset/Y/y" + postfix + ".h5";
+        string delta_path = "../dataset/X/" + string(argv[3]);
+        string w_path = "../dataset/W/" + string(argv[4]);
+        
+        std::cout.setstate(std::ios_base::failbit);
+        bool success = incremental_run_from_disk(y_path, delta_path, w_path, false, postfix);
+        std::cout.clear();
+        
+        if (success) {
+            cout << "spmm done" << endl;
+            return 0;
+        } else {
+            cerr << "spmm failed" << endl;
+            return 1;
+        }
+    }
+    
     if (argc != 3) return 1;
 
     string x_in = argv[1];
@@ -0,0 +1,324 @@
+#include "../include/mtx_reader.hpp"
+#include "../include/logger.hpp"
+#include <omp.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <charconv>
+#include <stdexcept>
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <cctype>
+
+using namespace std;
+
+static double ms_since(chrono::high_resolution_clock::time_point t) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - t).count() / 1000.0;
+}
+
+/* Read-only mapping of the whole file, unmapped on scope exit */
+struct MappedFile {
+    int fd = -1;
+    const char* data = nullptr;
+    size_t size = 0;
+
+    explicit MappedFile(const string& path) {
+        fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw runtime_error("Cannot open " + path + ": " + strerror(errno));
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            throw runtime_error("Cannot stat " + path + ": " + strerror(errno));
+        }
+        size = static_cast<size_t>(st.st_size);
+        if (size > 0) {
+            void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+            if (p == MAP_FAILED) {
+                close(fd);
+                throw runtime_error("Cannot mmap " + path + ": " + strerror(errno));
+            }
+            madvise(p, size, MADV_SEQUENTIAL);
+            madvise(p, size, MADV_WILLNEED);
+            data = static_cast<const char*>(p);
+        }
+    }
+    ~MappedFile() {
+        if (data != nullptr) munmap(const_cast<char*>(data), size);
+        if (fd >= 0) close(fd);
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+};
+
+/* Entries parsed by one thread; counts[r] = entries for output row r */
+struct MtxChunk {
+    vector<int> rows;
+    vector<int> cols;
+    vector<float> vals;
+    vector<int> counts;
+    size_t file_entries = 0;
+    string error;
+};
+
+static const char* next_line(const char* p, const char* end) {
+    const char* nl = static_cast<const char*>(memchr(p, '\n', end - p));
+    return nl ? nl + 1 : end;
+}
+
+static const char* skip_blanks(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    return p;
+}
+
+/* Unsigned decimal index */
+static inline const char* parse_index(const char* s, const char* e, long long& out, bool& ok) {
+    const char* b = s;
+    long long v = 0;
+    while (s < e && static_cast<unsigned>(*s - '0') < 10 && s - b < 18) {
+        v = v * 10 + (*s - '0');
+        s++;
+    }
+    if (s == b || (s < e && static_cast<unsigned>(*s - '0') < 10)) ok = false;
+    out = v;
+    return s;
+}
+
+/* Counts are usually small integers: convert those directly, anything else goes through from_chars */
+static inline const char* parse_value(const char* s, const char* e, float& out, bool& ok) {
+    const char* b = s;
+    bool neg = false;
+    if (s < e && (*s == '-' || *s == '+')) {
+        neg = *s == '-';
+        s++;
+    }
+    const char* digits = s;
+    long long v = 0;
+    while (s < e && static_cast<unsigned>(*s - '0') < 10 && s - digits < 18) {
+        v = v * 10 + (*s - '0');
+        s++;
+    }
+    if (s > digits && (s == e || *s == ' ' || *s == '\t' || *s == '\n' || *s == '\r')) {
+        out = static_cast<float>(neg ? -v : v);
+        return s;
+    }
+    if (b < e && *b == '+') b++;
+    auto res = from_chars(b, e, out);
+    if (res.ec != errc()) ok = false;
+    return res.ptr;
+}
+
+static string lower(string s) {
+    for (auto& ch : s) ch = static_cast<char>(tolower(static_cast<unsigned char>(ch)));
+    return s;
+}
+
+CSR load_mtx_as_csr(const string& mtx_path, const MtxReadOptions& options, MtxReadStats* stats,
+                    const string& log_annotation) {
+    auto start = chrono::high_resolution_clock::now();
+    cout << "[mtx_reader] Loading X from: " << mtx_path << endl;
+
+    MappedFile file(mtx_path);
+    const char* p = file.data;
+    const char* end = file.data + file.size;
+
+    // Banner: %%MatrixMarket matrix coordinate <field> <symmetry>
+    const char* eol = next_line(p, end);
+    vector<string> banner;
+    for (const char* q = p; q < eol;) {
+        while (q < eol && isspace(static_cast<unsigned char>(*q))) q++;
+        const char* w = q;
+        while (q < eol && !isspace(static_cast<unsigned char>(*q))) q++;
+        if (q > w) banner.push_back(lower(string(w, q)));
+    }
+    if (banner.size() != 5 || banner[0] != "%%matrixmarket" || banner[1] != "matrix") {
+        throw runtime_error("Not a MatrixMarket file: " + mtx_path);
+    }
+    const string& field = banner[3];
+    const string& symmetry = banner[4];
+    if (banner[2] != "coordinate" || (field != "real" && field != "integer" && field != "double" && field != "pattern")
+        || (symmetry != "general" && symmetry != "symmetric")) {
+        throw runtime_error("Unsupported MatrixMarket format '" + banner[2] + " " + field + " " + symmetry
+                           + "' in " + mtx_path + " (coordinate real/integer/pattern, general/symmetric)");
+    }
+    const bool pattern = field == "pattern";
+    const bool symmetric = symmetry == "symmetric";
+
+    // Comments, then the size line: M N NNZ
+    p = eol;
+    while (p < end && (*p == '%' || *p == '\n' || *p == '\r')) p = next_line(p, end);
+    long long dims[3] = {0, 0, 0};
+    eol = next_line(p, end);
+    const char* q = p;
+    for (auto& d : dims) {
+        q = skip_blanks(q, eol);
+        auto res = from_chars(q, eol, d);
+        if (res.ec != errc()) {
+            throw runtime_error("Malformed MatrixMarket size line in " + mtx_path);
+        }
+        q = res.ptr;
+    }
+    if (dims[0] < 0 || dims[1] < 0 || dims[0] > INT_MAX || dims[1] > INT_MAX || dims[2] < 0) {
+        throw runtime_error("MatrixMarket size out of range in " + mtx_path);
+    }
+    const int M = static_cast<int>(dims[0]);
+    const int N = static_cast<int>(dims[1]);
+    const size_t nnz_header = static_cast<size_t>(dims[2]);
+    const int out_rows = options.transpose ? N : M;
+    const int out_cols = options.transpose ? M : N;
+    const char* body = eol;
+    double map_ms = ms_since(start);
+
+    // Split the entries at line boundaries; small files stay on one thread
+    auto t_parse = chrono::high_resolution_clock::now();
+    const size_t body_bytes = end - body;
+    const int n_chunks = static_cast<int>(max<size_t>(1, min<size_t>(max(1, options.num_threads), body_bytes / (1 << 20) + 1)));
+    vector<const char*> bounds(n_chunks + 1);
+    bounds[0] = body;
+    bounds[n_chunks] = end;
+    for (int t = 1; t < n_chunks; t++) {
+        const char* b = body + body_bytes * t / n_chunks;
+        bounds[t] = (b > body && b[-1] != '\n') ? next_line(b, end) : b;
+    }
+
+    vector<MtxChunk> chunks(n_chunks);
+    #pragma omp parallel for schedule(static, 1) num_threads(n_chunks)
+    for (int t = 0; t < n_chunks; t++) {
+        MtxChunk& ch = chunks[t];
+        ch.counts.assign(out_rows, 0);
+        // Entry lines are rarely shorter than 8 bytes ("1 2 3\n" plus multi-digit indices)
+        size_t guess = (bounds[t + 1] - bounds[t]) / 8 + 16;
+        ch.rows.reserve(guess);
+        ch.cols.reserve(guess);
+        ch.vals.reserve(guess);
+
+        const char* s = bounds[t];
+        const char* e = bounds[t + 1];
+        while (s < e) {
+            s = skip_blanks(s, e);
+            if (s == e) break;
+            if (*s == '\n' || *s == '\r' || *s == '%') {
+                s = next_line(s, e);
+                continue;
+            }
+            long long i = 0, j = 0;
+            float v = 1.0f;
+            bool ok = true;
+            const char* s2 = parse_index(s, e, i, ok);
+            const char* s3 = parse_index(skip_blanks(s2, e), e, j, ok);
+            if (ok && !pattern) s3 = parse_value(skip_blanks(s3, e), e, v, ok);
+            if (!ok || i < 1 || i > M || j < 1 || j > N) {
+                ch.error = "Malformed MatrixMarket entry at byte " + to_string(s - file.data) + " of " + mtx_path;
+                break;
+            }
+            int r = static_cast<int>(i - 1), c = static_cast<int>(j - 1);
+            if (options.transpose) swap(r, c);
+            ch.rows.push_back(r);
+            ch.cols.push_back(c);
+            ch.vals.push_back(v);
+            ch.counts[r]++;
+            if (symmetric && r != c) {
+                ch.rows.push_back(c);
+                ch.cols.push_back(r);
+                ch.vals.push_back(v);
+                ch.counts[c]++;
+            }
+            ch.file_entries++;
+            s3 = skip_blanks(s3, e);
+            if (s3 < e && *s3 == '\r') s3++;
+            s = (s3 < e && *s3 == '\n') ? s3 + 1 : next_line(s3, e);
+        }
+    }
+    size_t file_entries = 0, total = 0;
+    for (const auto& ch : chunks) {
+        if (!ch.error.empty()) throw runtime_error(ch.error);
+        file_entries += ch.file_entries;
+        total += ch.rows.size();
+    }
+    if (file_entries != nnz_header) {
+        throw runtime_error("MatrixMarket file " + mtx_path + " declares " + to_string(nnz_header)
+                           + " entries but holds " + to_string(file_entries));
+    }
+    if (total > static_cast<size_t>(INT_MAX)) {
+        throw runtime_error("X in " + mtx_path + " has " + to_string(total)
+                           + " nonzeros, more than 32-bit CSR indices can address");
+    }
+    double parse_ms = ms_since(t_parse);
+
+    // Counting sort: per-chunk offsets within each row, then scatter in chunk order
+    auto t_build = chrono::high_resolution_clock::now();
+    CSR X;
+    X.nrows = out_rows;
+    X.ncols = out_cols;
+    X.nnz = total;
+    X.indptr.assign(out_rows + 1, 0);
+    X.indices.resize(total);
+    X.data.resize(total);
+
+    #pragma omp parallel for schedule(static) num_threads(n_chunks)
+    for (int r = 0; r < out_rows; r++) {
+        int running = 0;
+        for (int t = 0; t < n_chunks; t++) {
+            int cnt = chunks[t].counts[r];
+            chunks[t].counts[r] = running;
+            running += cnt;
+        }
+        X.indptr[r + 1] = running;
+    }
+    for (int r = 0; r < out_rows; r++) {
+        X.indptr[r + 1] += X.indptr[r];
+    }
+
+    #pragma omp parallel for schedule(static, 1) num_threads(n_chunks)
+    for (int t = 0; t < n_chunks; t++) {
+        MtxChunk& ch = chunks[t];
+        for (size_t k = 0; k < ch.rows.size(); k++) {
+            int r = ch.rows[k];
+            int dest = X.indptr[r] + ch.counts[r]++;
+            X.indices[dest] = ch.cols[k];
+            X.data[dest] = ch.vals[k];
+        }
+        vector<int>().swap(ch.rows);
+        vector<int>().swap(ch.cols);
+        vector<float>().swap(ch.vals);
+    }
+
+    // Files need not be sorted (and symmetric mirrors never are)
+    #pragma omp parallel for schedule(dynamic, 64) num_threads(n_chunks)
+    for (int r = 0; r < out_rows; r++) {
+        int begin = X.indptr[r], stop = X.indptr[r + 1];
+        if (is_sorted(X.indices.begin() + begin, X.indices.begin() + stop)) continue;
+        vector<pair<int, float>> row(stop - begin);
+        for (int idx = begin; idx < stop; idx++) row[idx - begin] = {X.indices[idx], X.data[idx]};
+        stable_sort(row.begin(), row.end(), [](const pair<int, float>& a, const pair<int, float>& b) { return a.first < b.first; });
+        for (int idx = begin; idx < stop; idx++) {
+            X.indices[idx] = row[idx - begin].first;
+            X.data[idx] = row[idx - begin].second;
+        }
+    }
+    double build_ms = ms_since(t_build);
+    double total_ms = ms_since(start);
+
+    cout << "[mtx_reader] X shape: " << X.nrows << " x " << X.ncols << ", nnz: " << X.nnz << endl;
+
+    if (stats) {
+        stats->file_bytes = file.size;
+        stats->entries = file_entries;
+        stats->threads = n_chunks;
+        stats->map_ms = map_ms;
+        stats->parse_ms = parse_ms;
+        stats->build_ms = build_ms;
+        stats->total_ms = total_ms;
+        stats->parse_gb_per_s = parse_ms > 0.0 ? file.size / (parse_ms * 1e6) : 0.0;
+    }
+    if (!log_annotation.empty()) {
+        log_load_X_metrics(log_annotation, X.nrows, X.ncols, X.nnz, total_ms);
+    }
+    return X;
+}
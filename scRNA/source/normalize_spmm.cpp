@@ -0,0 +1,126 @@
+#include "../include/normalize_spmm.hpp"
+#include "../include/logger.hpp"
+#include <stdexcept>
+#include <cmath>
+#include <omp.h>
+
+using namespace std;
+
+vector<float> cell_scale_factors_from_library_size(const vector<double>& library_size, double target_sum) {
+    vector<float> scale(library_size.size(), 0.0f);
+    for (size_t c = 0; c < library_size.size(); c++) {
+        if (library_size[c] > 0.0) {
+            scale[c] = static_cast<float>(target_sum / library_size[c]);
+        }
+    }
+    return scale;
+}
+
+vector<float> compute_cell_scale_factors(const CSR& X, double target_sum) {
+    vector<double> library_size(X.ncols, 0.0);
+
+    #pragma omp parallel
+    {
+        // Thread-private column sums, reduced once at the end
+        vector<double> local(X.ncols, 0.0);
+
+        #pragma omp for schedule(static)
+        for (int i = 0; i < X.nrows; i++) {
+            for (int idx = X.indptr[i]; idx < X.indptr[i + 1]; idx++) {
+                local[X.indices[idx]] += X.data[idx];
+            }
+        }
+
+        #pragma omp critical
+        {
+            for (int c = 0; c < X.ncols; c++) {
+                library_size[c] += local[c];
+            }
+        }
+    }
+
+    return cell_scale_factors_from_library_size(library_size, target_sum);
+}
+
+vector<float> spmm_normalized(const CSR& X, const vector<float>& W, int W_rows, int W_cols,
+                              const NormalizeParams& params, const vector<float>* cell_scale,
+                              const string& log_annotation) {
+    if (X.ncols != W_rows) {
+        throw runtime_error("Matrix dimension mismatch: X.ncols=" + to_string(X.ncols)
+                           + " != W.nrows=" + to_string(W_rows));
+    }
+
+    if (!log_annotation.empty()) {
+        log_openmp_threads(log_annotation, omp_get_max_threads());
+    }
+
+    vector<float> computed_scale;
+    const float* scale = nullptr;
+    if (params.library_size) {
+        if (cell_scale == nullptr) {
+            computed_scale = compute_cell_scale_factors(X, params.target_sum);
+            cell_scale = &computed_scale;
+        }
+        if (static_cast<int>(cell_scale->size()) != X.ncols) {
+            throw runtime_error("spmm_normalized: cell_scale size mismatch");
+        }
+        scale = cell_scale->data();
+    }
+
+    // Column sums of W for the rank-1 centering correction
+    vector<double> W_colsum;
+    if (params.center) {
+        W_colsum.assign(W_cols, 0.0);
+        for (int c = 0; c < W_rows; c++) {
+            for (int j = 0; j < W_cols; j++) {
+                W_colsum[j] += W[static_cast<size_t>(c) * W_cols + j];
+            }
+        }
+    }
+
+    int Y_cols = W_cols;
+    vector<float> Y(static_cast<size_t>(X.nrows) * Y_cols, 0.0f);
+    bool need_stats = params.center || params.scale;
+    double n_cells = static_cast<double>(X.ncols);
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < X.nrows; i++) {
+        float* y_row = Y.data() + static_cast<size_t>(i) * Y_cols;
+        double s1 = 0.0;
+        double s2 = 0.0;
+
+        for (int idx = X.indptr[i]; idx < X.indptr[i + 1]; idx++) {
+            int k = X.indices[idx];
+            float x_val = X.data[idx];
+            if (scale) x_val *= scale[k];
+            if (params.log1p) x_val = log1pf(x_val);
+
+            if (need_stats) {
+                s1 += x_val;
+                s2 += static_cast<double>(x_val) * x_val;
+            }
+
+            const float* w_row = W.data() + static_cast<size_t>(k) * W_cols;
+            for (int j = 0; j < W_cols; j++) {
+                y_row[j] += x_val * w_row[j];
+            }
+        }
+
+        if (need_stats) {
+            // Implicit zeros count towards the mean and variance
+            double mu = s1 / n_cells;
+            double inv_sd = 1.0;
+            if (params.scale && n_cells > 1.0) {
+                double var = (s2 - n_cells * mu * mu) / (n_cells - 1.0);
+                double sd = var > 0.0 ? sqrt(var) : 0.0;
+                inv_sd = sd > 0.0 ? 1.0 / sd : 1.0;  // constant genes stay unscaled
+            }
+            for (int j = 0; j < W_cols; j++) {
+                double corrected = params.center ? y_row[j] - mu * W_colsum[j] : y_row[j];
+                y_row[j] = static_cast<float>(corrected * inv_sd);
+            }
+        }
+    }
+
+    return Y;
+}
@@ -0,0 +1,344 @@
+#include "../include/numa_spmm.hpp"
+#include "../include/logger.hpp"
+#include <stdexcept>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <omp.h>
+#include <sched.h>
+
+using namespace std;
+using namespace std::chrono;
+
+int NumaTopology::num_cpus() const {
+    int n = 0;
+    for (const auto& cpus : node_cpus) n += static_cast<int>(cpus.size());
+    return n;
+}
+
+/* Parse a sysfs cpulist such as "0-3,8-11" */
+static vector<int> parse_cpulist(const string& list) {
+    vector<int> cpus;
+    stringstream ss(list);
+    string range;
+    while (getline(ss, range, ',')) {
+        if (range.empty() || range == "\n") continue;
+        size_t dash = range.find('-');
+        int lo = stoi(range.substr(0, dash));
+        int hi = dash == string::npos ? lo : stoi(range.substr(dash + 1));
+        for (int c = lo; c <= hi; c++) cpus.push_back(c);
+    }
+    return cpus;
+}
+
+NumaTopology detect_numa_topology() {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        for (int c = 0; c < CPU_SETSIZE; c++) CPU_SET(c, &allowed);
+    }
+
+    NumaTopology topo;
+    const filesystem::path node_root = "/sys/devices/system/node";
+    error_code ec;
+    if (filesystem::is_directory(node_root, ec)) {
+        vector<pair<int, vector<int>>> nodes;
+        for (const auto& entry : filesystem::directory_iterator(node_root, ec)) {
+            string name = entry.path().filename().string();
+            if (name.rfind("node", 0) != 0 || name.size() <= 4 ||
+                !all_of(name.begin() + 4, name.end(), ::isdigit)) {
+                continue;
+            }
+            ifstream in(entry.path() / "cpulist");
+            string list;
+            if (!in || !getline(in, list)) continue;
+
+            vector<int> cpus;
+            for (int c : parse_cpulist(list)) {
+                if (c < CPU_SETSIZE && CPU_ISSET(c, &allowed)) cpus.push_back(c);
+            }
+            // Memory-only nodes (or nodes outside our cpuset) get no threads
+            if (!cpus.empty()) nodes.emplace_back(stoi(name.substr(4)), cpus);
+        }
+        sort(nodes.begin(), nodes.end());
+        for (auto& node : nodes) topo.node_cpus.push_back(std::move(node.second));
+    }
+
+    if (topo.node_cpus.empty()) {
+        vector<int> cpus;
+        for (int c = 0; c < CPU_SETSIZE; c++) {
+            if (CPU_ISSET(c, &allowed)) cpus.push_back(c);
+        }
+        topo.node_cpus.push_back(cpus);
+    }
+    return topo;
+}
+
+/*
+ * Pins the calling thread to one CPU for the lifetime of the object and restores the
+ * thread's previous mask on destruction, so OpenMP pool threads (and the caller, which is
+ * thread 0 of the team) leave a pinned region with the affinity they entered it with.
+ */
+class ScopedThreadPin {
+public:
+    explicit ScopedThreadPin(int cpu) {
+        if (cpu < 0 || sched_getaffinity(0, sizeof(saved_), &saved_) != 0) return;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pinned_ = sched_setaffinity(0, sizeof(set), &set) == 0;
+    }
+    ~ScopedThreadPin() {
+        if (pinned_) sched_setaffinity(0, sizeof(saved_), &saved_);
+    }
+    ScopedThreadPin(const ScopedThreadPin&) = delete;
+    ScopedThreadPin& operator=(const ScopedThreadPin&) = delete;
+
+    bool pinned() const { return pinned_; }
+
+private:
+    cpu_set_t saved_;
+    bool pinned_ = false;
+};
+
+/*
+ * Split rows [row_begin, row_end) into parts with weights[p] share of the cost,
+ * cost(row) = nnz + 1 (the +1 accounts for writing the Y row). Returns parts + 1 boundaries.
+ */
+static vector<int> split_rows(const huge_vector<int>& indptr, int row_begin, int row_end, const vector<int>& weights) {
+    auto cost = [&](int r) -> double { return static_cast<double>(indptr[r] - indptr[row_begin]) + (r - row_begin); };
+    double total = cost(row_end);
+    double total_weight = 0.0;
+    for (int w : weights) total_weight += w;
+
+    vector<int> bounds(weights.size() + 1, row_begin);
+    bounds.back() = row_end;
+    double acc = 0.0;
+    for (size_t p = 0; p + 1 < weights.size(); p++) {
+        acc += weights[p];
+        double target = total * acc / total_weight;
+        int lo = bounds[p], hi = row_end;
+        while (lo < hi) {
+            int mid = lo + (hi - lo) / 2;
+            if (cost(mid) < target) lo = mid + 1; else hi = mid;
+        }
+        bounds[p + 1] = lo;
+    }
+    return bounds;
+}
+
+/* Local index of each thread within its panel, and thread count per panel */
+static void panel_ranks(const NumaCSR& X, vector<int>& rank, vector<int>& count) {
+    rank.assign(X.thread_panel.size(), 0);
+    count.assign(X.panels.size(), 0);
+    for (size_t t = 0; t < X.thread_panel.size(); t++) {
+        rank[t] = count[X.thread_panel[t]]++;
+    }
+}
+
+NumaCSR numa_place_csr(const CSR& X, const NumaConfig& cfg, const string& log_annotation) {
+    if (cfg.num_threads <= 0) {
+        throw runtime_error("NUMA mode needs num_threads > 0, got " + to_string(cfg.num_threads));
+    }
+    auto start = high_resolution_clock::now();
+
+    NumaCSR out;
+    out.nrows = X.nrows;
+    out.ncols = X.ncols;
+    out.nnz = X.nnz;
+    out.cfg = cfg;
+    out.topology = detect_numa_topology();
+
+    // Threads per node, proportional to the node's CPU count
+    const NumaTopology& topo = out.topology;
+    int T = cfg.num_threads;
+    int total_cpus = max(1, topo.num_cpus());
+    vector<int> node_threads(topo.num_nodes(), 0);
+    int assigned = 0;
+    for (int n = 0; n < topo.num_nodes(); n++) {
+        node_threads[n] = static_cast<int>(static_cast<long long>(T) * topo.node_cpus[n].size() / total_cpus);
+        assigned += node_threads[n];
+    }
+    for (int n = 0; assigned < T; n = (n + 1) % topo.num_nodes()) {
+        node_threads[n]++;
+        assigned++;
+    }
+
+    // One panel per node with threads; panels balanced by (nnz + rows) in proportion to thread counts
+    vector<int> panel_node, panel_weights;
+    for (int n = 0; n < topo.num_nodes(); n++) {
+        if (node_threads[n] > 0) {
+            panel_node.push_back(n);
+            panel_weights.push_back(node_threads[n]);
+        }
+    }
+    vector<int> panel_bounds = split_rows(X.indptr, 0, X.nrows, panel_weights);
+
+    out.panels.resize(panel_node.size());
+    for (size_t p = 0; p < panel_node.size(); p++) {
+        NumaPanel& panel = out.panels[p];
+        panel.node = panel_node[p];
+        panel.row_begin = panel_bounds[p];
+        panel.row_end = panel_bounds[p + 1];
+        panel.nnz = static_cast<size_t>(X.indptr[panel.row_end] - X.indptr[panel.row_begin]);
+        panel.indptr.allocate(panel.row_end - panel.row_begin + 1);
+        panel.indices.allocate(panel.nnz);
+        panel.data.allocate(panel.nnz);
+
+        vector<int> thread_bounds = split_rows(X.indptr, panel.row_begin, panel.row_end,
+                                               vector<int>(panel_weights[p], 1));
+        const vector<int>& cpus = topo.node_cpus[panel.node];
+        for (int l = 0; l < panel_weights[p]; l++) {
+            out.thread_panel.push_back(static_cast<int>(p));
+            out.thread_cpu.push_back(cfg.pin_threads ? cpus[l % cpus.size()] : -1);
+            out.thread_row_begin.push_back(thread_bounds[l]);
+            out.thread_row_end.push_back(thread_bounds[l + 1]);
+        }
+    }
+
+    // First touch: every thread copies exactly the rows it will compute
+    int pinned_count = 0;
+    #pragma omp parallel for schedule(static, 1) num_threads(T) reduction(+:pinned_count)
+    for (int tid = 0; tid < T; tid++) {
+        ScopedThreadPin pin(out.thread_cpu[tid]);
+        if (pin.pinned()) pinned_count++;
+
+        NumaPanel& panel = out.panels[out.thread_panel[tid]];
+        int rb = out.thread_row_begin[tid];
+        int re = out.thread_row_end[tid];
+        int base = X.indptr[panel.row_begin];
+        for (int i = rb; i < re; i++) {
+            panel.indptr[i - panel.row_begin] = X.indptr[i] - base;
+        }
+        if (re == panel.row_end) {
+            panel.indptr[re - panel.row_begin] = X.indptr[re] - base;
+        }
+        int nb = X.indptr[rb], ne = X.indptr[re];
+        copy(X.indices.begin() + nb, X.indices.begin() + ne, panel.indices.data() + (nb - base));
+        copy(X.data.begin() + nb, X.data.begin() + ne, panel.data.data() + (nb - base));
+    }
+    out.pinned = cfg.pin_threads && pinned_count == T;
+
+    out.placement_ms = duration_cast<microseconds>(high_resolution_clock::now() - start).count() / 1000.0;
+
+    if (!log_annotation.empty()) {
+        stringstream ss;
+        ss << fixed << setprecision(3);
+        ss << "numa placement: nodes: " << topo.num_nodes() << ", panels: " << out.panels.size()
+           << ", threads: " << T << ", pinned: " << (out.pinned ? "yes" : "no")
+           << ", time: " << out.placement_ms << "ms" << endl;
+        for (const NumaPanel& panel : out.panels) {
+            ss << "  node " << panel.node << ": rows [" << panel.row_begin << ", " << panel.row_end
+               << "), nnz: " << panel.nnz << endl;
+        }
+        log_to_file_experiment(log_annotation, "numa", ss.str());
+    }
+    return out;
+}
+
+void spmm_numa_into(const NumaCSR& X, const vector<float>& W, int W_rows, int W_cols, Span<float> Y,
+                    NumaSpmmStats* stats, const string& log_annotation) {
+    if (X.ncols != W_rows) {
+        throw runtime_error("Matrix dimension mismatch: X.ncols=" + to_string(X.ncols)
+                           + " != W.nrows=" + to_string(W_rows));
+    }
+    require_span_size(Y, static_cast<size_t>(X.nrows) * W_cols, "Y");
+
+    const int T = static_cast<int>(X.thread_panel.size());
+    const size_t P = X.panels.size();
+    vector<int> rank, count;
+    panel_ranks(X, rank, count);
+
+    vector<NumaBuffer<float>> W_local(X.cfg.replicate_W ? P : 0);
+    for (auto& replica : W_local) replica.allocate(W.size());
+
+    vector<double> thread_ms(T, 0.0);
+    auto t_start = high_resolution_clock::now();
+
+    // Replicate W: the node's threads each first-touch a slice of its copy.
+    // schedule(static, 1) keeps loop index == thread id, matching the placement
+    if (X.cfg.replicate_W) {
+        #pragma omp parallel for schedule(static, 1) num_threads(T)
+        for (int tid = 0; tid < T; tid++) {
+            ScopedThreadPin pin(X.thread_cpu[tid]);
+            int p = X.thread_panel[tid];
+            size_t rows_per = (static_cast<size_t>(W_rows) + count[p] - 1) / count[p];
+            size_t r0 = min(static_cast<size_t>(W_rows), rows_per * rank[tid]);
+            size_t r1 = min(static_cast<size_t>(W_rows), r0 + rows_per);
+            copy(W.begin() + r0 * W_cols, W.begin() + r1 * W_cols, W_local[p].data() + r0 * W_cols);
+        }
+    }
+    auto t_replicated = high_resolution_clock::now();
+
+    #pragma omp parallel for schedule(static, 1) num_threads(T)
+    for (int tid = 0; tid < T; tid++) {
+        auto t0 = high_resolution_clock::now();
+        ScopedThreadPin pin(X.thread_cpu[tid]);
+        int p = X.thread_panel[tid];
+        const NumaPanel& panel = X.panels[p];
+        const float* Wp = X.cfg.replicate_W ? W_local[p].data() : W.data();
+        const int* indptr = panel.indptr.data();
+        const int* indices = panel.indices.data();
+        const float* data = panel.data.data();
+
+        // Each thread zeroes (first-touches) and writes only its own rows of Y
+        for (int g = X.thread_row_begin[tid]; g < X.thread_row_end[tid]; g++) {
+            int i = g - panel.row_begin;
+            float* y = Y.data + static_cast<size_t>(g) * W_cols;
+            for (int j = 0; j < W_cols; j++) y[j] = 0.0f;
+
+            for (int idx = indptr[i]; idx < indptr[i + 1]; idx++) {
+                int k = indices[idx];
+                float x_val = data[idx];
+                const float* w = Wp + static_cast<size_t>(k) * W_cols;
+                for (int j = 0; j < W_cols; j++) {
+                    y[j] += x_val * w[j];
+                }
+            }
+        }
+        thread_ms[tid] = duration_cast<nanoseconds>(high_resolution_clock::now() - t0).count() / 1e6;
+    }
+    auto t_computed = high_resolution_clock::now();
+
+    NumaSpmmStats local;
+    NumaSpmmStats& s = stats ? *stats : local;
+    s.node_ms.assign(P, 0.0);
+    s.node_bytes.assign(P, 0.0);
+    s.node_gbps.assign(P, 0.0);
+    for (int t = 0; t < T; t++) {
+        s.node_ms[X.thread_panel[t]] = max(s.node_ms[X.thread_panel[t]], thread_ms[t]);
+    }
+    for (size_t p = 0; p < P; p++) {
+        const NumaPanel& panel = X.panels[p];
+        size_t rows = panel.row_end - panel.row_begin;
+        s.node_bytes[p] = static_cast<double>((rows + 1) * sizeof(int) + panel.nnz * (sizeof(int) + sizeof(float))
+                                              + W.size() * sizeof(float) + rows * W_cols * sizeof(float));
+        s.node_gbps[p] = s.node_ms[p] > 0.0 ? s.node_bytes[p] / (s.node_ms[p] * 1e6) : 0.0;
+    }
+    s.replicate_ms = duration_cast<microseconds>(t_replicated - t_start).count() / 1000.0;
+    s.compute_ms = duration_cast<microseconds>(t_computed - t_replicated).count() / 1000.0;
+
+    if (!log_annotation.empty()) {
+        stringstream ss;
+        ss << fixed << setprecision(3);
+        ss << "spmm_numa: K: " << W_cols << ", W replicas: " << W_local.size()
+           << ", replicate: " << s.replicate_ms << "ms, compute: " << s.compute_ms << "ms" << endl;
+        for (size_t p = 0; p < P; p++) {
+            ss << "  node " << X.panels[p].node << ": " << s.node_ms[p] << "ms, "
+               << s.node_bytes[p] / 1e6 << " MB, " << s.node_gbps[p] << " GB/s" << endl;
+        }
+        log_to_file_experiment(log_annotation, "numa", ss.str());
+    }
+}
+
+NumaBuffer<float> spmm_numa(const NumaCSR& X, const vector<float>& W, int W_rows, int W_cols,
+                            NumaSpmmStats* stats, const string& log_annotation) {
+    // Uninitialised: the computing threads first-touch their rows
+    NumaBuffer<float> Y(static_cast<size_t>(X.nrows) * W_cols);
+    spmm_numa_into(X, W, W_rows, W_cols, Span<float>(Y.data(), Y.size()), stats, log_annotation);
+    return Y;
+}
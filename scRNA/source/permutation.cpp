@@ -61,7 +61,7 @@ CSR permute_csr_rows(const CSR& X, const vector<int>& row_new2old) {
     }
     
     // Second pass: copy rows
-    vector<int> write_ptr = Xp.indptr; 
+    vector<int> write_ptr(Xp.indptr.begin(), Xp.indptr.end());
     for (int i_new = 0; i_new < Xp.nrows; ++i_new) {
         int i_old = row_new2old[i_new];
         int row_start = X.indptr[i_old];
@@ -157,7 +157,7 @@ CSR unpermute_csr_rows(const CSR& X_permuted, const vector<int>& row_new2old) {
     }
     
     // Second pass: copy rows to original positions
-    vector<int> write_ptr = X.indptr;
+    vector<int> write_ptr(X.indptr.begin(), X.indptr.end());
     for (int i_new = 0; i_new < X_permuted.nrows; ++i_new) {
         int i_old = row_new2old[i_new];
         int row_start = X_permuted.indptr[i_new];
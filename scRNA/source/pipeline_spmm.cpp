@@ -0,0 +1,415 @@
+#include "../include/pipeline_spmm.hpp"
+#include "../include/spsc_queue.hpp"
+#include "../include/logger.hpp"
+#include "../include/y_writer.hpp"
+#include <H5Cpp.h>
+#include <stdexcept>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <exception>
+#include <cmath>
+
+using namespace std;
+using namespace std::chrono;
+using namespace H5;
+
+/* The HDF5 library is not thread-safe unless built so: load and store take this lock */
+static mutex hdf5_mutex;
+
+/* One cell panel as it moves down the pipeline */
+struct PipelinePanel {
+    int c0 = 0;                       // Cell range [c0, c1)
+    int c1 = 0;
+    vector<int> col_ptr;              // CSC of the panel (rebased to 0)
+    vector<int> rows;
+    vector<float> vals;
+    vector<float> W;                  // W rows [c0, c1), row-major
+    CSR csr;                          // genes x (c1 - c0), filled by the tile stage
+};
+
+using PanelPtr = unique_ptr<PipelinePanel>;
+
+struct YBlock {
+    int r0 = 0;
+    int r1 = 0;
+};
+
+static double ms_since(high_resolution_clock::time_point t) {
+    return duration_cast<nanoseconds>(high_resolution_clock::now() - t).count() / 1e6;
+}
+
+/* Yield first, then sleep: on an oversubscribed host spinning would starve the other stages */
+static void backoff(int& spins) {
+    if (spins++ < 64) {
+        this_thread::yield();
+    } else {
+        this_thread::sleep_for(microseconds(50));
+    }
+}
+
+template <typename T>
+static bool push_blocking(SpscQueue<T>& q, T& item, const atomic<bool>& failed, double& wait_ms) {
+    if (q.try_push(item)) return true;
+    auto start = high_resolution_clock::now();
+    int spins = 0;
+    while (!q.try_push(item)) {
+        if (failed) return false;
+        backoff(spins);
+    }
+    wait_ms += ms_since(start);
+    return true;
+}
+
+/* Returns false once the producer has closed the queue and it is empty (or on failure) */
+template <typename T>
+static bool pop_blocking(SpscQueue<T>& q, T& item, const atomic<bool>& failed, double& wait_ms) {
+    if (q.try_pop(item)) return true;
+    auto start = high_resolution_clock::now();
+    int spins = 0;
+    while (!q.try_pop(item)) {
+        if (failed || q.drained()) {
+            wait_ms += ms_since(start);
+            return q.try_pop(item);
+        }
+        backoff(spins);
+    }
+    wait_ms += ms_since(start);
+    return true;
+}
+
+template <typename T>
+static void read_slab_1d(DataSet& ds, T* out, hsize_t offset, hsize_t count, const PredType& type) {
+    if (count == 0) return;
+    DataSpace file_space = ds.getSpace();
+    file_space.selectHyperslab(H5S_SELECT_SET, &count, &offset);
+    DataSpace mem_space(1, &count);
+    ds.read(out, type, mem_space, file_space);
+}
+
+vector<float> pipelined_spmm_from_disk(const string& x_h5_path, const string& w_h5_path,
+                                       const PipelineConfig& cfg, PipelineStats* stats,
+                                       const string& log_annotation) {
+    if (cfg.panel_cells <= 0 || cfg.queue_depth <= 0 || cfg.store_rows <= 0) {
+        throw runtime_error("pipeline: panel_cells, queue_depth and store_rows must be positive");
+    }
+    auto start = high_resolution_clock::now();
+
+    // Shapes up front, so every stage knows genes / cells / K
+    int n_genes = 0, n_cells = 0, W_rows = 0, K = 0;
+    {
+        lock_guard<mutex> lock(hdf5_mutex);
+        H5File xf(x_h5_path, H5F_ACC_RDONLY);
+        DataSet shape_ds = xf.openGroup("matrix").openDataSet("shape");
+        long long shape[2];
+        shape_ds.read(shape, PredType::NATIVE_INT64);
+        n_genes = static_cast<int>(shape[0]);
+        n_cells = static_cast<int>(shape[1]);
+
+        H5File wf(w_h5_path, H5F_ACC_RDONLY);
+        hsize_t dims[2];
+        wf.openDataSet("W").getSpace().getSimpleExtentDims(dims);
+        W_rows = static_cast<int>(dims[0]);
+        K = static_cast<int>(dims[1]);
+    }
+    if (n_cells != W_rows) {
+        throw runtime_error("Matrix dimension mismatch: X.ncols=" + to_string(n_cells)
+                           + " != W.nrows=" + to_string(W_rows));
+    }
+
+    vector<float> Y(static_cast<size_t>(n_genes) * K, 0.0f);
+    const bool store = !cfg.y_path.empty();
+
+    SpscQueue<PanelPtr> q_loaded(cfg.queue_depth), q_filtered(cfg.queue_depth), q_tiled(cfg.queue_depth);
+    SpscQueue<YBlock> q_store(cfg.queue_depth);
+
+    vector<PipelineStageStats> st(store ? 5 : 4);
+    const char* names[] = {"load", "filter", "tile", "compute", "store"};
+    for (size_t s = 0; s < st.size(); s++) st[s].name = names[s];
+
+    YWriteStats y_write;
+    atomic<bool> failed{false};
+    vector<exception_ptr> errors(st.size());
+    auto guarded = [&](int s, auto&& body, auto&& on_exit) {
+        try {
+            body();
+        } catch (...) {
+            errors[s] = current_exception();
+            failed = true;
+        }
+        on_exit();
+    };
+
+    // Stage 1: load cell panels of X (and the matching W rows) with hyperslab reads
+    thread t_load([&] {
+        // Outside the body so that on_exit can release them under hdf5_mutex
+        unique_ptr<H5File> xf, wf;
+        unique_ptr<DataSet> data_ds, indices_ds, w_ds;
+        guarded(0, [&] {
+            PipelineStageStats& s = st[0];
+            auto t0 = high_resolution_clock::now();
+            vector<int> indptr;
+            {
+                lock_guard<mutex> lock(hdf5_mutex);
+                xf = make_unique<H5File>(x_h5_path, H5F_ACC_RDONLY);
+                wf = make_unique<H5File>(w_h5_path, H5F_ACC_RDONLY);
+                Group g = xf->openGroup("matrix");
+                data_ds = make_unique<DataSet>(g.openDataSet("data"));
+                indices_ds = make_unique<DataSet>(g.openDataSet("indices"));
+                DataSet indptr_ds = g.openDataSet("indptr");
+                indptr.resize(n_cells + 1);
+                indptr_ds.read(indptr.data(), PredType::NATIVE_INT32);
+                w_ds = make_unique<DataSet>(wf->openDataSet("W"));
+            }
+            s.busy_ms += ms_since(t0);
+
+            for (int c0 = 0; c0 < n_cells && !failed; c0 += cfg.panel_cells) {
+                t0 = high_resolution_clock::now();
+                auto panel = make_unique<PipelinePanel>();
+                panel->c0 = c0;
+                panel->c1 = min(n_cells, c0 + cfg.panel_cells);
+                int cells = panel->c1 - c0;
+                size_t nnz_begin = static_cast<size_t>(indptr[c0]);
+                size_t nnz = static_cast<size_t>(indptr[panel->c1]) - nnz_begin;
+
+                panel->col_ptr.resize(cells + 1);
+                for (int c = 0; c <= cells; c++) panel->col_ptr[c] = indptr[c0 + c] - indptr[c0];
+                panel->rows.resize(nnz);
+                panel->vals.resize(nnz);
+                panel->W.resize(static_cast<size_t>(cells) * K);
+                {
+                    lock_guard<mutex> lock(hdf5_mutex);
+                    read_slab_1d(*indices_ds, panel->rows.data(), nnz_begin, nnz, PredType::NATIVE_INT32);
+                    read_slab_1d(*data_ds, panel->vals.data(), nnz_begin, nnz, PredType::NATIVE_FLOAT);
+
+                    hsize_t offset[2] = {static_cast<hsize_t>(c0), 0};
+                    hsize_t count[2] = {static_cast<hsize_t>(cells), static_cast<hsize_t>(K)};
+                    DataSpace file_space = w_ds->getSpace();
+                    file_space.selectHyperslab(H5S_SELECT_SET, count, offset);
+                    DataSpace mem_space(2, count);
+                    w_ds->read(panel->W.data(), PredType::NATIVE_FLOAT, mem_space, file_space);
+                }
+                s.items++;
+                s.nnz += nnz;
+                s.busy_ms += ms_since(t0);
+                if (!push_blocking(q_loaded, panel, failed, s.wait_out_ms)) break;
+            }
+        }, [&] {
+            q_loaded.close();
+            // Also on failure: closing the handles touches HDF5
+            lock_guard<mutex> lock(hdf5_mutex);
+            w_ds.reset();
+            indices_ds.reset();
+            data_ds.reset();
+            wf.reset();
+            xf.reset();
+        });
+    });
+
+    // Stage 2: value-threshold filter, compacted in place per cell
+    thread t_filter([&] {
+        guarded(1, [&] {
+            PipelineStageStats& s = st[1];
+            PanelPtr panel;
+            while (pop_blocking(q_loaded, panel, failed, s.wait_in_ms)) {
+                auto t0 = high_resolution_clock::now();
+                if (cfg.filter_threshold > 0.0) {
+                    int cells = panel->c1 - panel->c0;
+                    int write = 0;
+                    int read_begin = 0;
+                    for (int c = 0; c < cells; c++) {
+                        int read_end = panel->col_ptr[c + 1];
+                        for (int idx = read_begin; idx < read_end; idx++) {
+                            if (fabs(panel->vals[idx]) >= cfg.filter_threshold) {
+                                panel->rows[write] = panel->rows[idx];
+                                panel->vals[write] = panel->vals[idx];
+                                write++;
+                            }
+                        }
+                        read_begin = read_end;
+                        panel->col_ptr[c + 1] = write;
+                    }
+                    panel->rows.resize(write);
+                    panel->vals.resize(write);
+                }
+                s.items++;
+                s.nnz += panel->rows.size();
+                s.busy_ms += ms_since(t0);
+                if (!push_blocking(q_filtered, panel, failed, s.wait_out_ms)) break;
+            }
+        }, [&] { q_filtered.close(); });
+    });
+
+    // Stage 3: bin nonzeros by gene (CSC panel -> CSR panel, columns stay ascending)
+    thread t_tile([&] {
+        guarded(2, [&] {
+            PipelineStageStats& s = st[2];
+            PanelPtr panel;
+            vector<int> next;
+            while (pop_blocking(q_filtered, panel, failed, s.wait_in_ms)) {
+                auto t0 = high_resolution_clock::now();
+                int cells = panel->c1 - panel->c0;
+                size_t nnz = panel->rows.size();
+                CSR& P = panel->csr;
+                P.nrows = n_genes;
+                P.ncols = cells;
+                P.nnz = nnz;
+                P.indptr.assign(n_genes + 1, 0);
+                P.indices.resize(nnz);
+                P.data.resize(nnz);
+                for (size_t idx = 0; idx < nnz; idx++) P.indptr[panel->rows[idx] + 1]++;
+                for (int i = 0; i < n_genes; i++) P.indptr[i + 1] += P.indptr[i];
+                next.assign(P.indptr.begin(), P.indptr.end() - 1);
+                for (int c = 0; c < cells; c++) {
+                    for (int idx = panel->col_ptr[c]; idx < panel->col_ptr[c + 1]; idx++) {
+                        int dest = next[panel->rows[idx]]++;
+                        P.indices[dest] = c;
+                        P.data[dest] = panel->vals[idx];
+                    }
+                }
+                // CSC arrays are no longer needed downstream
+                vector<int>().swap(panel->rows);
+                vector<float>().swap(panel->vals);
+                s.items++;
+                s.nnz += nnz;
+                s.busy_ms += ms_since(t0);
+                if (!push_blocking(q_tiled, panel, failed, s.wait_out_ms)) break;
+            }
+        }, [&] { q_tiled.close(); });
+    });
+
+    // Stage 4: Y += X_panel * W_panel, then hand Y to the store stage in row blocks
+    thread t_compute([&] {
+        guarded(3, [&] {
+            PipelineStageStats& s = st[3];
+            PanelPtr panel;
+            while (pop_blocking(q_tiled, panel, failed, s.wait_in_ms)) {
+                auto t0 = high_resolution_clock::now();
+                const CSR& P = panel->csr;
+                const float* Wp = panel->W.data();
+                float* Yp = Y.data();
+                #pragma omp parallel for schedule(static)
+                for (int i = 0; i < n_genes; i++) {
+                    for (int idx = P.indptr[i]; idx < P.indptr[i + 1]; idx++) {
+                        int k = P.indices[idx];
+                        float x_val = P.data[idx];
+                        for (int j = 0; j < K; j++) {
+                            Yp[static_cast<size_t>(i) * K + j] += x_val * Wp[static_cast<size_t>(k) * K + j];
+                        }
+                    }
+                }
+                s.items++;
+                s.nnz += P.nnz;
+                s.busy_ms += ms_since(t0);
+                panel.reset();
+            }
+            if (store && !failed) {
+                for (int r0 = 0; r0 < n_genes; r0 += cfg.store_rows) {
+                    YBlock block{r0, min(n_genes, r0 + cfg.store_rows)};
+                    if (!push_blocking(q_store, block, failed, s.wait_out_ms)) break;
+                }
+            }
+        }, [&] { q_store.close(); });
+    });
+
+    // Stage 5: write Y row blocks into the "Y" dataset
+    thread t_store;
+    if (store) {
+        t_store = thread([&] {
+            unique_ptr<YWriter> writer;
+            guarded(4, [&] {
+                PipelineStageStats& s = st[4];
+                {
+                    lock_guard<mutex> lock(hdf5_mutex);
+                    writer = make_unique<YWriter>(cfg.y_path, n_genes, K, cfg.y_writer);
+                }
+                YBlock block;
+                while (pop_blocking(q_store, block, failed, s.wait_in_ms)) {
+                    auto t0 = high_resolution_clock::now();
+                    {
+                        lock_guard<mutex> lock(hdf5_mutex);
+                        writer->write_rows(block.r0, block.r1 - block.r0, Y.data() + static_cast<size_t>(block.r0) * K);
+                    }
+                    s.items++;
+                    s.busy_ms += ms_since(t0);
+                }
+                lock_guard<mutex> lock(hdf5_mutex);
+                writer->close();
+                y_write = writer->stats();
+            }, [&] {
+                // Also on failure: the writer's destructor touches HDF5
+                lock_guard<mutex> lock(hdf5_mutex);
+                writer.reset();
+            });
+        });
+    }
+
+    t_load.join();
+    t_filter.join();
+    t_tile.join();
+    t_compute.join();
+    if (t_store.joinable()) t_store.join();
+
+    for (auto& e : errors) {
+        if (e) rethrow_exception(e);
+    }
+
+    // Queue statistics belong to the producing stage
+    const SpscQueue<PanelPtr>* panel_queues[] = {&q_loaded, &q_filtered, &q_tiled};
+    for (int s = 0; s < 3; s++) {
+        st[s].out_mean_occupancy = panel_queues[s]->mean_occupancy();
+        st[s].out_full_fraction = panel_queues[s]->full_fraction();
+        st[s].out_capacity = static_cast<int>(panel_queues[s]->capacity());
+    }
+    if (store) {
+        st[3].out_mean_occupancy = q_store.mean_occupancy();
+        st[3].out_full_fraction = q_store.full_fraction();
+        st[3].out_capacity = static_cast<int>(q_store.capacity());
+    }
+
+    PipelineStats local;
+    PipelineStats& out = stats ? *stats : local;
+    out.stages = st;
+    out.total_ms = ms_since(start);
+    out.nnz_in = st[0].nnz;
+    out.nnz_kept = st[1].nnz;
+    out.y_write = y_write;
+    out.bottleneck = st[0].name;
+    double worst = -1.0;
+    for (const auto& s : st) {
+        if (s.busy_ms > worst) {
+            worst = s.busy_ms;
+            out.bottleneck = s.name;
+        }
+    }
+
+    if (!log_annotation.empty()) {
+        stringstream ss;
+        ss << fixed << setprecision(3);
+        ss << "pipeline: genes: " << n_genes << ", cells: " << n_cells << ", K: " << K
+           << ", panel_cells: " << cfg.panel_cells << ", queue_depth: " << cfg.queue_depth
+           << ", nnz in/kept: " << out.nnz_in << "/" << out.nnz_kept
+           << ", total: " << out.total_ms << "ms, bottleneck: " << out.bottleneck << endl;
+        for (const auto& s : out.stages) {
+            ss << "  " << s.name << ": items " << s.items << ", busy " << s.busy_ms << "ms";
+            if (s.busy_ms > 0.0 && s.nnz > 0) ss << " (" << s.nnz / (s.busy_ms * 1e3) << " Mnnz/s)";
+            ss << ", wait in " << s.wait_in_ms << "ms, wait out " << s.wait_out_ms << "ms";
+            if (s.out_capacity > 0) {
+                ss << ", out queue " << s.out_mean_occupancy << "/" << s.out_capacity
+                   << " (full " << 100.0 * s.out_full_fraction << "%)";
+            }
+            ss << endl;
+        }
+        if (store) {
+            ss << "  Y write: " << out.y_write.layout << ", compression: " << out.y_write.compression
+               << ", stored " << out.y_write.stored_bytes / 1e6 << " MB of " << out.y_write.raw_bytes / 1e6
+               << " MB, " << out.y_write.mb_per_s << " MB/s" << endl;
+        }
+        log_to_file_experiment(log_annotation, "pipeline", ss.str());
+    }
+    return Y;
+}
@@ -0,0 +1,297 @@
+#include "../include/rsvd.hpp"
+#include "../include/spmm.hpp"
+#include "../include/spmm_transpose.hpp"
+#include "../include/logger.hpp"
+#include <stdexcept>
+#include <cmath>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+#include <iomanip>
+#include <omp.h>
+
+using namespace std;
+using namespace std::chrono;
+
+void orthonormalize_columns(vector<float>& M, int rows, int cols) {
+    // Column-major double copy so each column is contiguous
+    vector<double> C(static_cast<size_t>(rows) * cols);
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            C[static_cast<size_t>(j) * rows + i] = M[static_cast<size_t>(i) * cols + j];
+        }
+    }
+
+    for (int j = 0; j < cols; j++) {
+        double* cj = C.data() + static_cast<size_t>(j) * rows;
+
+        double norm_before = 0.0;
+        #pragma omp parallel for reduction(+:norm_before) schedule(static)
+        for (int i = 0; i < rows; i++) norm_before += cj[i] * cj[i];
+        norm_before = sqrt(norm_before);
+
+        // Two passes of modified Gram-Schmidt ("twice is enough")
+        for (int pass = 0; pass < 2; pass++) {
+            for (int p = 0; p < j; p++) {
+                const double* cp = C.data() + static_cast<size_t>(p) * rows;
+                double r = 0.0;
+                #pragma omp parallel for reduction(+:r) schedule(static)
+                for (int i = 0; i < rows; i++) r += cp[i] * cj[i];
+                #pragma omp parallel for schedule(static)
+                for (int i = 0; i < rows; i++) cj[i] -= r * cp[i];
+            }
+        }
+
+        double norm = 0.0;
+        #pragma omp parallel for reduction(+:norm) schedule(static)
+        for (int i = 0; i < rows; i++) norm += cj[i] * cj[i];
+        norm = sqrt(norm);
+
+        // Rank-deficient column: drop it rather than amplify rounding noise
+        double scale = (norm > 1e-10 * max(norm_before, 1e-300)) ? 1.0 / norm : 0.0;
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < rows; i++) cj[i] *= scale;
+    }
+
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            M[static_cast<size_t>(i) * cols + j] = static_cast<float>(C[static_cast<size_t>(j) * rows + i]);
+        }
+    }
+}
+
+void symmetric_eigen_jacobi(const vector<double>& A_in, int n, vector<double>& evals, vector<double>& evecs) {
+    vector<double> A = A_in;
+    vector<double> V(static_cast<size_t>(n) * n, 0.0);
+    for (int i = 0; i < n; i++) V[static_cast<size_t>(i) * n + i] = 1.0;
+
+    auto a = [&](int i, int j) -> double& { return A[static_cast<size_t>(i) * n + j]; };
+
+    for (int sweep = 0; sweep < 100; sweep++) {
+        double off = 0.0;
+        double diag = 0.0;
+        for (int i = 0; i < n; i++) {
+            diag += a(i, i) * a(i, i);
+            for (int j = i + 1; j < n; j++) off += a(i, j) * a(i, j);
+        }
+        if (off <= 1e-30 * diag || off == 0.0) break;
+
+        for (int p = 0; p < n; p++) {
+            for (int q = p + 1; q < n; q++) {
+                double apq = a(p, q);
+                if (fabs(apq) < 1e-300) continue;
+                double theta = (a(q, q) - a(p, p)) / (2.0 * apq);
+                double t = (theta >= 0 ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta * theta + 1.0));
+                double c = 1.0 / sqrt(t * t + 1.0);
+                double s = t * c;
+
+                for (int k = 0; k < n; k++) {
+                    double akp = a(k, p);
+                    double akq = a(k, q);
+                    a(k, p) = c * akp - s * akq;
+                    a(k, q) = s * akp + c * akq;
+                }
+                for (int k = 0; k < n; k++) {
+                    double apk = a(p, k);
+                    double aqk = a(q, k);
+                    a(p, k) = c * apk - s * aqk;
+                    a(q, k) = s * apk + c * aqk;
+                }
+                for (int k = 0; k < n; k++) {
+                    double vkp = V[static_cast<size_t>(k) * n + p];
+                    double vkq = V[static_cast<size_t>(k) * n + q];
+                    V[static_cast<size_t>(k) * n + p] = c * vkp - s * vkq;
+                    V[static_cast<size_t>(k) * n + q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+
+    // Sort eigenpairs by descending eigenvalue
+    vector<int> order(n);
+    iota(order.begin(), order.end(), 0);
+    sort(order.begin(), order.end(), [&](int x, int y) { return a(x, x) > a(y, y); });
+
+    evals.assign(n, 0.0);
+    evecs.assign(static_cast<size_t>(n) * n, 0.0);
+    for (int j = 0; j < n; j++) {
+        evals[j] = a(order[j], order[j]);
+        for (int i = 0; i < n; i++) {
+            evecs[static_cast<size_t>(i) * n + j] = V[static_cast<size_t>(i) * n + order[j]];
+        }
+    }
+}
+
+RsvdResult randomized_svd(const CSR& X, const RsvdParams& params, const string& log_annotation) {
+    int m = X.nrows;
+    int n = X.ncols;
+    int k = params.k;
+    int l = min(k + params.oversample, min(m, n));
+    if (k <= 0 || k > l) {
+        throw runtime_error("randomized_svd: invalid rank k=" + to_string(k) + " for "
+                           + to_string(m) + " x " + to_string(n) + " matrix");
+    }
+
+    RsvdResult res;
+    res.k = k;
+    res.nrows = m;
+    res.ncols = n;
+
+    auto t_total = high_resolution_clock::now();
+    auto elapsed_ms = [](high_resolution_clock::time_point t0) {
+        return duration_cast<microseconds>(high_resolution_clock::now() - t0).count() / 1000.0;
+    };
+
+    // Per-gene means (over all cells, implicit zeros included)
+    vector<double> mu(m, 0.0);
+    double sum_sq = 0.0;
+    #pragma omp parallel for reduction(+:sum_sq) schedule(static)
+    for (int i = 0; i < m; i++) {
+        double s = 0.0;
+        for (int idx = X.indptr[i]; idx < X.indptr[i + 1]; idx++) {
+            s += X.data[idx];
+            sum_sq += static_cast<double>(X.data[idx]) * X.data[idx];
+        }
+        mu[i] = params.center ? s / n : 0.0;
+    }
+    double mu_sq = 0.0;
+    for (int i = 0; i < m; i++) mu_sq += mu[i] * mu[i];
+    res.total_variance = (n > 1) ? (sum_sq - n * mu_sq) / (n - 1) : 0.0;
+
+    // A * M = X * M - mu * (1^T M)
+    auto apply_A = [&](const vector<float>& M) {
+        auto t0 = high_resolution_clock::now();
+        vector<float> Y = spmm_baseline(X, M, n, l);
+        if (params.center) {
+            vector<double> colsum(l, 0.0);
+            for (int c = 0; c < n; c++) {
+                for (int j = 0; j < l; j++) colsum[j] += M[static_cast<size_t>(c) * l + j];
+            }
+            #pragma omp parallel for schedule(static)
+            for (int i = 0; i < m; i++) {
+                for (int j = 0; j < l; j++) {
+                    Y[static_cast<size_t>(i) * l + j] -= static_cast<float>(mu[i] * colsum[j]);
+                }
+            }
+        }
+        res.spmm_ms += elapsed_ms(t0);
+        return Y;
+    };
+
+    // A^T * M = X^T * M - 1 * (mu^T M); the cache keeps X^T across power iterations if Auto picks it
+    TransposeCache xt_cache;
+    auto apply_At = [&](const vector<float>& M) {
+        auto t0 = high_resolution_clock::now();
+        vector<float> Z = spmm_transpose(X, M, m, l, TransposeStrategy::Auto, &xt_cache);
+        if (params.center) {
+            vector<double> proj(l, 0.0);
+            for (int i = 0; i < m; i++) {
+                for (int j = 0; j < l; j++) proj[j] += mu[i] * M[static_cast<size_t>(i) * l + j];
+            }
+            #pragma omp parallel for schedule(static)
+            for (int c = 0; c < n; c++) {
+                for (int j = 0; j < l; j++) {
+                    Z[static_cast<size_t>(c) * l + j] -= static_cast<float>(proj[j]);
+                }
+            }
+        }
+        res.spmm_t_ms += elapsed_ms(t0);
+        return Z;
+    };
+
+    auto qr = [&](vector<float>& M, int rows) {
+        auto t0 = high_resolution_clock::now();
+        orthonormalize_columns(M, rows, l);
+        res.qr_ms += elapsed_ms(t0);
+    };
+
+    // Range finder
+    vector<float> Omega(static_cast<size_t>(n) * l);
+    mt19937 rng(params.seed);
+    normal_distribution<float> gauss(0.0f, 1.0f);
+    for (auto& v : Omega) v = gauss(rng);
+
+    vector<float> Q = apply_A(Omega);
+    qr(Q, m);
+
+    for (int it = 0; it < params.power_iters; it++) {
+        vector<float> Z = apply_At(Q);
+        qr(Z, n);
+        Q = apply_A(Z);
+        qr(Q, m);
+    }
+
+    // B^T = A^T Q (n x l); B B^T = (B^T)^T B^T is l x l
+    vector<float> Bt = apply_At(Q);
+
+    auto t_svd = high_resolution_clock::now();
+    vector<double> G(static_cast<size_t>(l) * l, 0.0);
+    #pragma omp parallel
+    {
+        vector<double> local(static_cast<size_t>(l) * l, 0.0);
+        #pragma omp for schedule(static)
+        for (int c = 0; c < n; c++) {
+            const float* b = Bt.data() + static_cast<size_t>(c) * l;
+            for (int a = 0; a < l; a++) {
+                for (int d = a; d < l; d++) {
+                    local[static_cast<size_t>(a) * l + d] += static_cast<double>(b[a]) * b[d];
+                }
+            }
+        }
+        #pragma omp critical
+        {
+            for (size_t t = 0; t < G.size(); t++) G[t] += local[t];
+        }
+    }
+    for (int a = 0; a < l; a++) {
+        for (int d = 0; d < a; d++) G[static_cast<size_t>(a) * l + d] = G[static_cast<size_t>(d) * l + a];
+    }
+
+    vector<double> evals, Ub;
+    symmetric_eigen_jacobi(G, l, evals, Ub);
+
+    res.S.resize(k);
+    for (int j = 0; j < k; j++) res.S[j] = static_cast<float>(sqrt(max(evals[j], 0.0)));
+
+    // U = Q * Ub[:, :k]
+    res.U.assign(static_cast<size_t>(m) * k, 0.0f);
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < k; j++) {
+            double s = 0.0;
+            for (int a = 0; a < l; a++) s += Q[static_cast<size_t>(i) * l + a] * Ub[static_cast<size_t>(a) * l + j];
+            res.U[static_cast<size_t>(i) * k + j] = static_cast<float>(s);
+        }
+    }
+
+    // V = B^T * Ub[:, :k] / S
+    res.V.assign(static_cast<size_t>(n) * k, 0.0f);
+    #pragma omp parallel for schedule(static)
+    for (int c = 0; c < n; c++) {
+        for (int j = 0; j < k; j++) {
+            double s = 0.0;
+            for (int a = 0; a < l; a++) s += Bt[static_cast<size_t>(c) * l + a] * Ub[static_cast<size_t>(a) * l + j];
+            res.V[static_cast<size_t>(c) * k + j] = res.S[j] > 0.0f ? static_cast<float>(s / res.S[j]) : 0.0f;
+        }
+    }
+    res.small_svd_ms = elapsed_ms(t_svd);
+    res.total_ms = elapsed_ms(t_total);
+
+    if (!log_annotation.empty()) {
+        stringstream ss;
+        ss << "rsvd k: " << k << ", l: " << l << ", power_iters: " << params.power_iters
+           << ", center: " << (params.center ? "yes" : "no") << endl;
+        ss << "OpenMP threads: " << omp_get_max_threads() << endl;
+        ss << fixed << setprecision(3);
+        ss << "rsvd X*M time: " << res.spmm_ms << "ms" << endl;
+        ss << "rsvd X^T*M time: " << res.spmm_t_ms << "ms" << endl;
+        ss << "rsvd qr time: " << res.qr_ms << "ms" << endl;
+        ss << "rsvd small svd time: " << res.small_svd_ms << "ms" << endl;
+        ss << "rsvd total time: " << res.total_ms << "ms" << endl;
+        log_to_file_experiment(log_annotation, "rsvd", ss.str());
+    }
+
+    return res;
+}
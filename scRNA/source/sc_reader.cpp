@@ -0,0 +1,451 @@
+#include "../include/sc_reader.hpp"
+#include "../include/spmm_transpose.hpp"
+#include "../include/logger.hpp"
+#include <H5Cpp.h>
+#include <stdexcept>
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <climits>
+#include <cstring>
+
+using namespace std;
+using namespace H5;
+
+const char* sc_format_name(ScFormat format) {
+    switch (format) {
+        case ScFormat::TenXV3: return "10x HDF5 v3";
+        case ScFormat::TenXV2: return "10x HDF5 v2";
+        case ScFormat::H5adCSR: return "h5ad (CSR X)";
+        case ScFormat::H5adCSC: return "h5ad (CSC X)";
+        case ScFormat::H5adDense: return "h5ad (dense X)";
+    }
+    return "?";
+}
+
+/* Fixed-length (10x) and variable-length (AnnData) string datasets */
+static vector<string> read_strings(const DataSet& ds) {
+    hsize_t n = 0;
+    ds.getSpace().getSimpleExtentDims(&n);
+    StrType type = ds.getStrType();
+    vector<string> out(n);
+    if (type.isVariableStr()) {
+        StrType mem_type(PredType::C_S1, H5T_VARIABLE);
+        mem_type.setCset(type.getCset());
+        vector<char*> buf(n, nullptr);
+        ds.read(buf.data(), mem_type);
+        for (size_t i = 0; i < n; i++) {
+            if (buf[i] != nullptr) out[i] = buf[i];
+        }
+        DataSet::vlenReclaim(buf.data(), mem_type, ds.getSpace());
+    } else {
+        size_t len = type.getSize();
+        vector<char> buf(n * len);
+        ds.read(buf.data(), type);
+        for (size_t i = 0; i < n; i++) {
+            const char* s = buf.data() + i * len;
+            out[i].assign(s, strnlen(s, len));
+        }
+    }
+    return out;
+}
+
+static bool read_string_attr(const H5Object& obj, const string& name, string& value) {
+    if (!obj.attrExists(name)) return false;
+    Attribute attr = obj.openAttribute(name);
+    attr.read(attr.getStrType(), value);
+    return true;
+}
+
+static hsize_t dataset_length(const Group& g, const string& name) {
+    hsize_t n = 0;
+    g.openDataSet(name).getSpace().getSimpleExtentDims(&n);
+    return n;
+}
+
+/* One AnnData obs/var column: a string dataset, or a categorical group (categories + codes) */
+static vector<string> read_frame_column(const Group& frame, const string& column) {
+    if (frame.childObjType(column) == H5O_TYPE_DATASET) {
+        return read_strings(frame.openDataSet(column));
+    }
+    Group cat = frame.openGroup(column);
+    vector<string> categories = read_strings(cat.openDataSet("categories"));
+    DataSet codes_ds = cat.openDataSet("codes");
+    hsize_t n = 0;
+    codes_ds.getSpace().getSimpleExtentDims(&n);
+    vector<int> codes(n);
+    codes_ds.read(codes.data(), PredType::NATIVE_INT);
+    vector<string> out(n);
+    for (size_t i = 0; i < n; i++) {
+        if (codes[i] >= 0 && codes[i] < static_cast<int>(categories.size())) out[i] = categories[codes[i]];
+    }
+    return out;
+}
+
+/* "0", "1", ... as pandas uses for a default index */
+static vector<string> index_names(int n) {
+    vector<string> names(n);
+    for (int i = 0; i < n; i++) names[i] = to_string(i);
+    return names;
+}
+
+static string frame_index_column(const Group& frame) {
+    string index = "_index";
+    read_string_attr(frame, "_index", index);
+    return index;
+}
+
+/* Rows of a CSR in the given order */
+static CSR select_csr_rows(const CSR& X, const vector<int>& rows) {
+    CSR out;
+    out.nrows = static_cast<int>(rows.size());
+    out.ncols = X.ncols;
+    out.indptr.assign(rows.size() + 1, 0);
+    for (size_t r = 0; r < rows.size(); r++) {
+        out.indptr[r + 1] = out.indptr[r] + (X.indptr[rows[r] + 1] - X.indptr[rows[r]]);
+    }
+    out.nnz = out.indptr[rows.size()];
+    out.indices.resize(out.nnz);
+    out.data.resize(out.nnz);
+    #pragma omp parallel for schedule(static)
+    for (int r = 0; r < out.nrows; r++) {
+        int src = X.indptr[rows[r]];
+        int len = out.indptr[r + 1] - out.indptr[r];
+        copy(X.indices.begin() + src, X.indices.begin() + src + len, out.indices.begin() + out.indptr[r]);
+        copy(X.data.begin() + src, X.data.begin() + src + len, out.data.begin() + out.indptr[r]);
+    }
+    return out;
+}
+
+/* indptr / indices / data of a compressed sparse group into a CSR with the given shape */
+static CSR read_compressed(const Group& g, int nrows, int ncols, const string& path) {
+    CSR M;
+    M.nrows = nrows;
+    M.ncols = ncols;
+
+    if (dataset_length(g, "indptr") != static_cast<hsize_t>(nrows) + 1) {
+        throw runtime_error("Malformed sparse matrix in " + path + ": indptr length does not match shape");
+    }
+    vector<long long> indptr(nrows + 1);
+    g.openDataSet("indptr").read(indptr.data(), PredType::NATIVE_INT64);
+    if (indptr[nrows] > INT_MAX) {
+        throw runtime_error("X in " + path + " has " + to_string(indptr[nrows])
+                           + " nonzeros, more than 32-bit CSR indices can address");
+    }
+    M.nnz = static_cast<size_t>(indptr[nrows]);
+    if (dataset_length(g, "indices") < M.nnz || dataset_length(g, "data") < M.nnz) {
+        throw runtime_error("Malformed sparse matrix in " + path + ": indices/data shorter than indptr");
+    }
+    M.indptr.assign(indptr.begin(), indptr.end());
+
+    // Read exactly nnz entries (files may carry slack at the end)
+    hsize_t count = M.nnz, offset = 0;
+    M.indices.resize(M.nnz);
+    M.data.resize(M.nnz);
+    if (count > 0) {
+        DataSpace mem_space(1, &count);
+        DataSet indices_ds = g.openDataSet("indices");
+        DataSpace file_space = indices_ds.getSpace();
+        file_space.selectHyperslab(H5S_SELECT_SET, &count, &offset);
+        indices_ds.read(M.indices.data(), PredType::NATIVE_INT32, mem_space, file_space);
+        DataSet data_ds = g.openDataSet("data");
+        file_space = data_ds.getSpace();
+        file_space.selectHyperslab(H5S_SELECT_SET, &count, &offset);
+        data_ds.read(M.data.data(), PredType::NATIVE_FLOAT, mem_space, file_space);
+    }
+
+    bool bad = false;
+    #pragma omp parallel for schedule(static) reduction(||:bad)
+    for (long long i = 0; i < static_cast<long long>(M.nnz); i++) {
+        if (M.indices[i] < 0 || M.indices[i] >= ncols) bad = true;
+    }
+    if (bad) {
+        throw runtime_error("Malformed sparse matrix in " + path + ": index out of range");
+    }
+    return M;
+}
+
+ScDataset::ScDataset(const string& path, const ScReadOptions& options)
+    : path_(path), options_(options) {
+    try {
+        file_ = make_unique<H5File>(path, H5F_ACC_RDONLY);
+
+        if (file_->nameExists("X")) {
+            group_ = "X";
+            if (file_->childObjType("X") == H5O_TYPE_DATASET) {
+                format_ = ScFormat::H5adDense;
+                hsize_t dims[2] = {0, 0};
+                DataSet x = file_->openDataSet("X");
+                if (x.getSpace().getSimpleExtentNdims() != 2) {
+                    throw runtime_error("Dense X in " + path + " is not 2-D");
+                }
+                x.getSpace().getSimpleExtentDims(dims);
+                n_cells_ = static_cast<int>(dims[0]);
+                n_genes_file_ = static_cast<int>(dims[1]);
+            } else {
+                Group x = file_->openGroup("X");
+                string encoding;
+                if (!read_string_attr(x, "encoding-type", encoding)) {
+                    read_string_attr(x, "h5sparse_format", encoding);   // anndata < 0.7
+                }
+                if (encoding == "csr_matrix" || encoding == "csr") {
+                    format_ = ScFormat::H5adCSR;
+                } else if (encoding == "csc_matrix" || encoding == "csc") {
+                    format_ = ScFormat::H5adCSC;
+                } else {
+                    throw runtime_error("Unsupported X encoding '" + encoding + "' in " + path);
+                }
+                const char* shape_attr = x.attrExists("shape") ? "shape" : "h5sparse_shape";
+                long long shape[2] = {0, 0};
+                x.openAttribute(shape_attr).read(PredType::NATIVE_INT64, shape);
+                n_cells_ = static_cast<int>(shape[0]);
+                n_genes_file_ = static_cast<int>(shape[1]);
+                nnz_stored_ = dataset_length(x, "data");
+            }
+        } else {
+            if (file_->nameExists("matrix")) {
+                group_ = "matrix";
+                format_ = ScFormat::TenXV3;
+            } else {
+                // v2: one group per genome, holding genes / gene_names
+                for (hsize_t i = 0; i < file_->getNumObjs(); i++) {
+                    string name = file_->getObjnameByIdx(i);
+                    if (file_->childObjType(name) == H5O_TYPE_GROUP && file_->openGroup(name).nameExists("genes")) {
+                        group_ = name;
+                        break;
+                    }
+                }
+                if (group_.empty()) {
+                    throw runtime_error("Neither a 10x HDF5 nor an .h5ad layout: " + path);
+                }
+                format_ = ScFormat::TenXV2;
+            }
+            Group g = file_->openGroup(group_);
+            long long shape[2] = {0, 0};
+            g.openDataSet("shape").read(shape, PredType::NATIVE_INT64);
+            n_genes_file_ = static_cast<int>(shape[0]);
+            n_cells_ = static_cast<int>(shape[1]);
+            nnz_stored_ = dataset_length(g, "data");
+        }
+
+        if (!options_.feature_type.empty()) {
+            const vector<string> types = read_gene_column("feature_type");
+            if (static_cast<int>(types.size()) != n_genes_file_) {
+                throw runtime_error("Gene annotation length " + to_string(types.size()) + " != "
+                                   + to_string(n_genes_file_) + " genes in " + path);
+            }
+            for (int i = 0; i < n_genes_file_; i++) {
+                if (types[i] == options_.feature_type) kept_rows_.push_back(i);
+            }
+            if (kept_rows_.empty()) {
+                throw runtime_error("No features of type '" + options_.feature_type + "' in " + path);
+            }
+            if (static_cast<int>(kept_rows_.size()) == n_genes_file_) kept_rows_.clear();
+        }
+    } catch (Exception& e) {
+        throw runtime_error("HDF5 error opening " + path + ": " + e.getDetailMsg());
+    }
+}
+
+ScDataset::~ScDataset() = default;
+
+CSR ScDataset::load_X(const string& log_annotation) {
+    auto start = chrono::high_resolution_clock::now();
+    cout << "[sc_reader] Loading X from: " << path_ << " (" << sc_format_name(format_) << ")" << endl;
+
+    CSR X;
+    try {
+        switch (format_) {
+            case ScFormat::TenXV3:
+            case ScFormat::TenXV2:
+            case ScFormat::H5adCSR:
+                X = load_cell_major();
+                break;
+            case ScFormat::H5adCSC:
+                X = load_gene_major();
+                break;
+            case ScFormat::H5adDense:
+                X = load_dense();
+                break;
+        }
+    } catch (Exception& e) {
+        throw runtime_error("HDF5 error reading X from " + path_ + ": " + e.getDetailMsg());
+    }
+    if (!kept_rows_.empty()) {
+        X = select_csr_rows(X, kept_rows_);
+    }
+    cout << "[sc_reader] X shape: " << X.nrows << " x " << X.ncols << ", nnz: " << X.nnz << endl;
+
+    double duration_ms = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count() / 1000.0;
+    if (!log_annotation.empty()) {
+        log_load_X_metrics(log_annotation, X.nrows, X.ncols, X.nnz, duration_ms);
+    }
+    return X;
+}
+
+CSR ScDataset::load_cell_major() {
+    // Stored by cell: read as cells x genes CSR, then transpose in parallel
+    CSR by_cell = read_compressed(file_->openGroup(group_), n_cells_, n_genes_file_, path_);
+    return transpose_csr(by_cell);
+}
+
+CSR ScDataset::load_gene_major() {
+    // h5ad CSC of cells x genes is genes x cells CSR; scipy does not guarantee sorted indices
+    CSR X = read_compressed(file_->openGroup(group_), n_genes_file_, n_cells_, path_);
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (int i = 0; i < X.nrows; i++) {
+        int begin = X.indptr[i], end = X.indptr[i + 1];
+        if (is_sorted(X.indices.begin() + begin, X.indices.begin() + end)) continue;
+        vector<pair<int, float>> row(end - begin);
+        for (int idx = begin; idx < end; idx++) row[idx - begin] = {X.indices[idx], X.data[idx]};
+        sort(row.begin(), row.end(), [](const pair<int, float>& a, const pair<int, float>& b) { return a.first < b.first; });
+        for (int idx = begin; idx < end; idx++) {
+            X.indices[idx] = row[idx - begin].first;
+            X.data[idx] = row[idx - begin].second;
+        }
+    }
+    return X;
+}
+
+CSR ScDataset::load_dense() {
+    // Stream blocks of cells, keep the nonzeros, then transpose
+    DataSet ds = file_->openDataSet("X");
+    const int block = max(1, options_.dense_block_cells);
+    CSR by_cell;
+    by_cell.nrows = n_cells_;
+    by_cell.ncols = n_genes_file_;
+    by_cell.indptr.assign(n_cells_ + 1, 0);
+    vector<float> buf(static_cast<size_t>(block) * n_genes_file_);
+    for (int c0 = 0; c0 < n_cells_; c0 += block) {
+        int cells = min(block, n_cells_ - c0);
+        hsize_t offset[2] = {static_cast<hsize_t>(c0), 0};
+        hsize_t count[2] = {static_cast<hsize_t>(cells), static_cast<hsize_t>(n_genes_file_)};
+        DataSpace file_space = ds.getSpace();
+        file_space.selectHyperslab(H5S_SELECT_SET, count, offset);
+        DataSpace mem_space(2, count);
+        ds.read(buf.data(), PredType::NATIVE_FLOAT, mem_space, file_space);
+        for (int c = 0; c < cells; c++) {
+            const float* row = buf.data() + static_cast<size_t>(c) * n_genes_file_;
+            for (int g = 0; g < n_genes_file_; g++) {
+                if (row[g] != 0.0f) {
+                    by_cell.indices.push_back(g);
+                    by_cell.data.push_back(row[g]);
+                }
+            }
+            if (by_cell.indices.size() > static_cast<size_t>(INT_MAX)) {
+                throw runtime_error("X in " + path_ + " has more nonzeros than 32-bit CSR indices can address");
+            }
+            by_cell.indptr[c0 + c + 1] = static_cast<int>(by_cell.indices.size());
+        }
+    }
+    by_cell.nnz = by_cell.indices.size();
+    return transpose_csr(by_cell);
+}
+
+/* column: "name", "id" or "feature_type"; barcodes are read separately */
+vector<string> ScDataset::read_gene_column(const string& column) {
+    try {
+        if (format_ == ScFormat::TenXV3 || format_ == ScFormat::TenXV2) {
+            Group matrix = file_->openGroup(group_);
+            bool v3_features = format_ == ScFormat::TenXV3 && matrix.nameExists("features");
+            Group g = v3_features ? matrix.openGroup("features") : matrix;
+            // v2 stores ids in "genes" and symbols in "gene_names"; it has no feature types
+            string field = v3_features ? column : column == "id" ? "genes" : column == "name" ? "gene_names" : "";
+            if (!field.empty() && g.nameExists(field)) return read_strings(g.openDataSet(field));
+            // Matrices written by our own tools carry no annotations
+            return column == "feature_type" ? vector<string>(n_genes_file_, "Gene Expression")
+                                            : index_names(n_genes_file_);
+        }
+        Group var = file_->openGroup("var");
+        string index = frame_index_column(var);
+        if (column == "name") return read_frame_column(var, index);
+        string field = column == "id" ? "gene_ids" : "feature_types";
+        if (var.nameExists(field)) return read_frame_column(var, field);
+        if (column == "id") return read_frame_column(var, index);
+        return vector<string>(n_genes_file_, "Gene Expression");
+    } catch (Exception& e) {
+        throw runtime_error("HDF5 error reading gene " + column + " from " + path_ + ": " + e.getDetailMsg());
+    }
+}
+
+vector<string> ScDataset::select_rows(vector<string> all) const {
+    if (static_cast<int>(all.size()) != n_genes_file_) {
+        throw runtime_error("Gene annotation length " + to_string(all.size()) + " != "
+                           + to_string(n_genes_file_) + " genes in " + path_);
+    }
+    if (kept_rows_.empty()) return all;
+    vector<string> out(kept_rows_.size());
+    for (size_t r = 0; r < kept_rows_.size(); r++) out[r] = std::move(all[kept_rows_[r]]);
+    return out;
+}
+
+const vector<string>& ScDataset::gene_names() {
+    if (!have_gene_names_) {
+        gene_names_ = select_rows(read_gene_column("name"));
+        if (options_.unique_gene_names) make_names_unique(gene_names_);
+        have_gene_names_ = true;
+    }
+    return gene_names_;
+}
+
+const vector<string>& ScDataset::gene_ids() {
+    if (!have_gene_ids_) {
+        gene_ids_ = select_rows(read_gene_column("id"));
+        have_gene_ids_ = true;
+    }
+    return gene_ids_;
+}
+
+const vector<string>& ScDataset::feature_types() {
+    if (!have_feature_types_) {
+        feature_types_ = select_rows(read_gene_column("feature_type"));
+        have_feature_types_ = true;
+    }
+    return feature_types_;
+}
+
+const vector<string>& ScDataset::barcodes() {
+    if (!have_barcodes_) {
+        try {
+            if (format_ == ScFormat::TenXV3 || format_ == ScFormat::TenXV2) {
+                Group g = file_->openGroup(group_);
+                barcodes_ = g.nameExists("barcodes") ? read_strings(g.openDataSet("barcodes")) : index_names(n_cells_);
+            } else {
+                Group obs = file_->openGroup("obs");
+                barcodes_ = read_frame_column(obs, frame_index_column(obs));
+            }
+        } catch (Exception& e) {
+            throw runtime_error("HDF5 error reading barcodes from " + path_ + ": " + e.getDetailMsg());
+        }
+        if (static_cast<int>(barcodes_.size()) != n_cells_) {
+            throw runtime_error("Barcode count " + to_string(barcodes_.size()) + " != "
+                               + to_string(n_cells_) + " cells in " + path_);
+        }
+        have_barcodes_ = true;
+    }
+    return barcodes_;
+}
+
+CSR load_sc_h5_as_csr(const string& path, const string& log_annotation) {
+    ScDataset dataset(path);
+    return dataset.load_X(log_annotation);
+}
+
+void make_names_unique(vector<string>& names) {
+    unordered_set<string> used(names.begin(), names.end());
+    unordered_set<string> first_seen;
+    unordered_map<string, int> next_suffix;
+    for (auto& n : names) {
+        if (first_seen.insert(n).second) continue;
+        // Skip suffixes that collide with names already present
+        int& k = next_suffix[n];
+        string candidate;
+        do {
+            candidate = n + "-" + to_string(++k);
+        } while (used.count(candidate));
+        used.insert(candidate);
+        n = candidate;
+    }
+}
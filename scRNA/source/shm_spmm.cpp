@@ -0,0 +1,318 @@
+#include "../include/shm_spmm.hpp"
+#include "../include/logger.hpp"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <stdexcept>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#include <sstream>
+#include <iomanip>
+
+using namespace std;
+
+static const uint64_t SHM_SPMM_MAGIC = 0x5343524e41534d31ULL;   // "SCRNASM1"
+
+/* Segment header; all offsets are from the segment base */
+struct ShmHeader {
+    uint64_t magic;
+    uint64_t bytes;
+    int32_t nrows;
+    int32_t ncols;
+    int32_t K;
+    int32_t num_workers;
+    int32_t mode;
+    uint64_t nnz;
+    uint64_t off_bounds;     // int64 [num_workers + 1]: row or column boundaries
+    uint64_t off_results;    // ShmWorkerResult [num_workers]
+    uint64_t off_indptr;
+    uint64_t off_indices;
+    uint64_t off_data;
+    uint64_t off_W;
+    uint64_t off_Y;
+};
+
+/* Written by each worker before it exits */
+struct ShmWorkerResult {
+    double ms;
+    uint64_t nnz;
+    int32_t done;
+};
+
+static size_t align64(size_t n) {
+    return (n + 63) / 64 * 64;
+}
+
+static double ms_since(chrono::high_resolution_clock::time_point t) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - t).count() / 1000.0;
+}
+
+template <typename T>
+static T* at(void* base, uint64_t offset) {
+    return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+}
+
+ShmSpmm::ShmSpmm(const CSR& X, const vector<float>& W, int W_rows, int W_cols, const ShmSpmmConfig& cfg)
+    : cfg_(cfg) {
+    if (X.ncols != W_rows) {
+        throw runtime_error("Matrix dimension mismatch: X.ncols=" + to_string(X.ncols)
+                           + " != W.nrows=" + to_string(W_rows));
+    }
+    if (cfg.num_workers < 1) {
+        throw runtime_error("shm spmm: num_workers must be at least 1");
+    }
+    auto start = chrono::high_resolution_clock::now();
+    const int P = cfg.num_workers;
+    const size_t y_elems = static_cast<size_t>(X.nrows) * W_cols * (cfg.mode == ShmShardMode::CellRanges ? P : 1);
+
+    ShmHeader h;
+    memset(&h, 0, sizeof(h));
+    h.magic = SHM_SPMM_MAGIC;
+    h.nrows = X.nrows;
+    h.ncols = X.ncols;
+    h.K = W_cols;
+    h.num_workers = P;
+    h.mode = static_cast<int32_t>(cfg.mode);
+    h.nnz = X.nnz;
+    size_t off = align64(sizeof(ShmHeader));
+    h.off_bounds = off;   off += align64(sizeof(int64_t) * (P + 1));
+    h.off_results = off;  off += align64(sizeof(ShmWorkerResult) * P);
+    h.off_indptr = off;   off += align64(sizeof(int) * (X.nrows + 1));
+    h.off_indices = off;  off += align64(sizeof(int) * X.nnz);
+    h.off_data = off;     off += align64(sizeof(float) * X.nnz);
+    h.off_W = off;        off += align64(sizeof(float) * W.size());
+    h.off_Y = off;        off += align64(sizeof(float) * y_elems);
+    h.bytes = off;
+    bytes_ = off;
+
+    static atomic<int> counter{0};
+    name_ = "/scrna_spmm_" + to_string(getpid()) + "_" + to_string(counter++);
+    int fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        throw runtime_error("shm_open(" + name_ + ") failed: " + strerror(errno));
+    }
+    if (ftruncate(fd, static_cast<off_t>(bytes_)) != 0) {
+        int err = errno;
+        close(fd);
+        shm_unlink(name_.c_str());
+        throw runtime_error("Cannot size shared memory " + name_ + ": " + strerror(err));
+    }
+    base_ = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base_ == MAP_FAILED) {
+        base_ = nullptr;
+        shm_unlink(name_.c_str());
+        throw runtime_error("Cannot map shared memory " + name_ + ": " + strerror(errno));
+    }
+
+    memcpy(base_, &h, sizeof(h));
+    memcpy(at<int>(base_, h.off_indptr), X.indptr.data(), sizeof(int) * (X.nrows + 1));
+    memcpy(at<int>(base_, h.off_indices), X.indices.data(), sizeof(int) * X.nnz);
+    memcpy(at<float>(base_, h.off_data), X.data.data(), sizeof(float) * X.nnz);
+    memcpy(at<float>(base_, h.off_W), W.data(), sizeof(float) * W.size());
+
+    // Shards balanced by nnz
+    int64_t* bounds = at<int64_t>(base_, h.off_bounds);
+    if (cfg.mode == ShmShardMode::GenePanels) {
+        bounds[0] = 0;
+        for (int w = 1; w < P; w++) {
+            long long target = static_cast<long long>(X.nnz) * w / P;
+            bounds[w] = lower_bound(X.indptr.begin(), X.indptr.end(), target) - X.indptr.begin();
+            bounds[w] = max(bounds[w - 1], min<int64_t>(bounds[w], X.nrows));
+        }
+        bounds[P] = X.nrows;
+    } else {
+        vector<long long> col_prefix(X.ncols + 1, 0);
+        for (size_t idx = 0; idx < X.nnz; idx++) col_prefix[X.indices[idx] + 1]++;
+        for (int c = 0; c < X.ncols; c++) col_prefix[c + 1] += col_prefix[c];
+        bounds[0] = 0;
+        for (int w = 1; w < P; w++) {
+            long long target = static_cast<long long>(X.nnz) * w / P;
+            bounds[w] = lower_bound(col_prefix.begin(), col_prefix.end(), target) - col_prefix.begin();
+            bounds[w] = max(bounds[w - 1], min<int64_t>(bounds[w], X.ncols));
+        }
+        bounds[P] = X.ncols;
+    }
+    setup_ms_ = ms_since(start);
+}
+
+ShmSpmm::~ShmSpmm() {
+    if (base_ != nullptr) munmap(base_, bytes_);
+    shm_unlink(name_.c_str());
+}
+
+vector<float> ShmSpmm::run(ShmSpmmStats* stats, const string& log_annotation) {
+    auto start = chrono::high_resolution_clock::now();
+    const ShmHeader& h = *static_cast<const ShmHeader*>(base_);
+    const int P = h.num_workers;
+    ShmWorkerResult* results = at<ShmWorkerResult>(base_, h.off_results);
+    memset(results, 0, sizeof(ShmWorkerResult) * P);
+
+    // Flush stdio so forked children do not repeat buffered output
+    fflush(nullptr);
+    vector<pid_t> pids;
+    string launch_error;
+    for (int w = 0; w < P; w++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            _exit(shm_spmm_worker(name_, w));
+        }
+        if (pid < 0) {
+            launch_error = "fork failed for worker " + to_string(w) + ": " + strerror(errno);
+            for (pid_t p : pids) kill(p, SIGTERM);
+            break;
+        }
+        pids.push_back(pid);
+    }
+    double launch_ms = ms_since(start);
+
+    string worker_error;
+    for (size_t w = 0; w < pids.size(); w++) {
+        int status = 0;
+        while (waitpid(pids[w], &status, 0) < 0 && errno == EINTR) {
+        }
+        if (!launch_error.empty()) continue;
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || !results[w].done) {
+            if (worker_error.empty()) {
+                worker_error = "shm spmm worker " + to_string(w) + " failed ("
+                             + (WIFSIGNALED(status) ? "signal " + to_string(WTERMSIG(status))
+                                                    : "exit " + to_string(WEXITSTATUS(status))) + ")";
+            }
+        }
+    }
+    if (!launch_error.empty()) throw runtime_error(launch_error);
+    if (!worker_error.empty()) throw runtime_error(worker_error);
+    double compute_ms = ms_since(start);
+
+    const size_t y_elems = static_cast<size_t>(h.nrows) * h.K;
+    vector<float> Y = make_huge_page_vector<float>(y_elems);
+    const float* Y_shm = at<float>(base_, h.off_Y);
+    double reduce_ms = 0.0, copy_out_ms = 0.0;
+    auto t_out = chrono::high_resolution_clock::now();
+    if (h.mode == static_cast<int32_t>(ShmShardMode::CellRanges)) {
+        // Partials summed in worker order: deterministic for a fixed worker count
+        #pragma omp parallel for schedule(static)
+        for (long long e = 0; e < static_cast<long long>(y_elems); e++) {
+            float sum = 0.0f;
+            for (int w = 0; w < P; w++) sum += Y_shm[static_cast<size_t>(w) * y_elems + e];
+            Y[e] = sum;
+        }
+        reduce_ms = ms_since(t_out);
+    } else {
+        memcpy(Y.data(), Y_shm, sizeof(float) * y_elems);
+        copy_out_ms = ms_since(t_out);
+    }
+
+    ShmSpmmStats local;
+    ShmSpmmStats& st = stats ? *stats : local;
+    st.shm_bytes = bytes_;
+    st.setup_ms = setup_ms_;
+    st.launch_ms = launch_ms;
+    st.compute_ms = compute_ms;
+    st.reduce_ms = reduce_ms;
+    st.copy_out_ms = copy_out_ms;
+    st.total_ms = ms_since(start);
+    st.worker_ms.assign(P, 0.0);
+    st.worker_nnz.assign(P, 0);
+    for (int w = 0; w < P; w++) {
+        st.worker_ms[w] = results[w].ms;
+        st.worker_nnz[w] = results[w].nnz;
+    }
+
+    if (!log_annotation.empty()) {
+        stringstream ss;
+        ss << fixed << setprecision(3);
+        ss << "shm spmm: " << P << " workers, "
+           << (h.mode == static_cast<int32_t>(ShmShardMode::CellRanges) ? "cell ranges" : "gene panels")
+           << ", segment " << st.shm_bytes / 1e6 << " MB, setup " << st.setup_ms << "ms, launch "
+           << st.launch_ms << "ms, compute " << st.compute_ms << "ms, reduce " << st.reduce_ms
+           << "ms, total " << st.total_ms << "ms" << endl;
+        for (int w = 0; w < P; w++) {
+            ss << "  worker " << w << ": nnz " << st.worker_nnz[w] << ", " << st.worker_ms[w] << "ms" << endl;
+        }
+        log_to_file_experiment(log_annotation, "shm", ss.str());
+    }
+    return Y;
+}
+
+vector<float> spmm_shm(const CSR& X, const vector<float>& W, int W_rows, int W_cols,
+                       const ShmSpmmConfig& cfg, ShmSpmmStats* stats, const string& log_annotation) {
+    ShmSpmm session(X, W, W_rows, W_cols, cfg);
+    return session.run(stats, log_annotation);
+}
+
+int shm_spmm_worker(const string& shm_name, int worker) {
+    auto start = chrono::high_resolution_clock::now();
+    int fd = shm_open(shm_name.c_str(), O_RDWR, 0);
+    if (fd < 0) return 2;
+    struct stat sb;
+    if (fstat(fd, &sb) != 0 || static_cast<size_t>(sb.st_size) < sizeof(ShmHeader)) {
+        close(fd);
+        return 3;
+    }
+    void* base = mmap(nullptr, sb.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return 4;
+
+    const ShmHeader& h = *static_cast<const ShmHeader*>(base);
+    if (h.magic != SHM_SPMM_MAGIC || h.bytes != static_cast<uint64_t>(sb.st_size)
+        || worker < 0 || worker >= h.num_workers) {
+        munmap(base, sb.st_size);
+        return 5;
+    }
+    const int64_t* bounds = at<int64_t>(base, h.off_bounds);
+    const int* indptr = at<int>(base, h.off_indptr);
+    const int* indices = at<int>(base, h.off_indices);
+    const float* data = at<float>(base, h.off_data);
+    const float* W = at<float>(base, h.off_W);
+    const int K = h.K;
+    uint64_t nnz = 0;
+
+    if (h.mode == static_cast<int32_t>(ShmShardMode::GenePanels)) {
+        // Same loop as spmm_baseline over this worker's rows
+        float* Y = at<float>(base, h.off_Y);
+        for (int64_t i = bounds[worker]; i < bounds[worker + 1]; i++) {
+            float* y = Y + static_cast<size_t>(i) * K;
+            for (int j = 0; j < K; j++) y[j] = 0.0f;
+            for (int idx = indptr[i]; idx < indptr[i + 1]; idx++) {
+                int k = indices[idx];
+                float x_val = data[idx];
+                for (int j = 0; j < K; j++) {
+                    y[j] += x_val * W[static_cast<size_t>(k) * K + j];
+                }
+            }
+            nnz += indptr[i + 1] - indptr[i];
+        }
+    } else {
+        // Every row, restricted to this worker's columns (indices are sorted per row)
+        const int c0 = static_cast<int>(bounds[worker]);
+        const int c1 = static_cast<int>(bounds[worker + 1]);
+        float* Y = at<float>(base, h.off_Y) + static_cast<size_t>(worker) * h.nrows * K;
+        for (int i = 0; i < h.nrows; i++) {
+            float* y = Y + static_cast<size_t>(i) * K;
+            for (int j = 0; j < K; j++) y[j] = 0.0f;
+            int idx = static_cast<int>(lower_bound(indices + indptr[i], indices + indptr[i + 1], c0) - indices);
+            for (; idx < indptr[i + 1] && indices[idx] < c1; idx++) {
+                int k = indices[idx];
+                float x_val = data[idx];
+                for (int j = 0; j < K; j++) {
+                    y[j] += x_val * W[static_cast<size_t>(k) * K + j];
+                }
+                nnz++;
+            }
+        }
+    }
+
+    ShmWorkerResult& result = at<ShmWorkerResult>(base, h.off_results)[worker];
+    result.nnz = nnz;
+    result.ms = ms_since(start);
+    result.done = 1;
+    munmap(base, sb.st_size);
+    return 0;
+}
@@ -0,0 +1,192 @@
+#include "../include/sim_accelerator.hpp"
+#include <stdexcept>
+#include <algorithm>
+#include <sstream>
+
+using namespace std;
+
+SimulatedAccelerator::SimulatedAccelerator(const SimAccelConfig& cfg) : cfg_(cfg) {
+    if (cfg.streams < 1) {
+        throw runtime_error("SimulatedAccelerator: streams must be at least 1");
+    }
+    if (cfg.h2d_gbps <= 0.0 || cfg.d2h_gbps <= 0.0 || cfg.gflops <= 0.0) {
+        throw runtime_error("SimulatedAccelerator: bandwidths and FLOP rate must be positive");
+    }
+    stream_free_us_.assign(cfg.streams, 0.0);
+    for (int s = 0; s < cfg.streams; s++) {
+        workers_.emplace_back(&SimulatedAccelerator::worker_loop, this);
+    }
+}
+
+SimulatedAccelerator::~SimulatedAccelerator() {
+    {
+        lock_guard<mutex> lock(m_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& t : workers_) t.join();
+}
+
+string SimulatedAccelerator::name() const {
+    stringstream ss;
+    ss << "simulated accelerator (" << cfg_.streams << " streams, " << cfg_.h2d_gbps << "/" << cfg_.d2h_gbps
+       << " GB/s, " << cfg_.gflops << " GFLOP/s)";
+    return ss.str();
+}
+
+/* GB/s is bytes per nanosecond, so bytes / (GB/s) is ns */
+double SimulatedAccelerator::h2d_us(size_t bytes) const {
+    return cfg_.transfer_latency_us + static_cast<double>(bytes) / cfg_.h2d_gbps / 1000.0;
+}
+
+double SimulatedAccelerator::d2h_us(size_t bytes) const {
+    return cfg_.transfer_latency_us + static_cast<double>(bytes) / cfg_.d2h_gbps / 1000.0;
+}
+
+double SimulatedAccelerator::kernel_us(int M, int K, int N) const {
+    double flops = 2.0 * M * K * N;
+    return cfg_.launch_us + flops / cfg_.gflops / 1000.0;
+}
+
+double SimulatedAccelerator::model_job_ms(int M, int K, int N) const {
+    size_t in_bytes = (static_cast<size_t>(M) * K + static_cast<size_t>(K) * N) * sizeof(float);
+    size_t out_bytes = static_cast<size_t>(M) * N * sizeof(float);
+    return (h2d_us(in_bytes) + kernel_us(M, K, N) + d2h_us(out_bytes)) / 1000.0;
+}
+
+AccelTicket SimulatedAccelerator::submit_gemm(const float* X, const float* W, float* Y, int M, int K, int N) {
+    if (M < 0 || K < 0 || N < 0) {
+        throw runtime_error("SimulatedAccelerator: negative GEMM dimension");
+    }
+    size_t in_bytes = (static_cast<size_t>(M) * K + static_cast<size_t>(K) * N) * sizeof(float);
+    size_t out_bytes = static_cast<size_t>(M) * N * sizeof(float);
+
+    Job job;
+    job.X = X;
+    job.W = W;
+    job.Y = Y;
+    job.M = M;
+    job.K = K;
+    job.N = N;
+    {
+        lock_guard<mutex> lock(m_);
+        if (!started_) {
+            epoch_ = Clock::now();
+            started_ = true;
+        }
+        double now_us = chrono::duration<double, micro>(Clock::now() - epoch_).count();
+        if (stats_.jobs == 0) first_submit_us_ = now_us;
+
+        // Copy in, kernel on the earliest free stream, copy out
+        double h2d_end = max(now_us, h2d_free_us_) + h2d_us(in_bytes);
+        h2d_free_us_ = h2d_end;
+        auto stream = min_element(stream_free_us_.begin(), stream_free_us_.end());
+        double kernel_end = max(h2d_end, *stream) + kernel_us(M, K, N);
+        *stream = kernel_end;
+        double d2h_end = max(kernel_end, d2h_free_us_) + d2h_us(out_bytes);
+        d2h_free_us_ = d2h_end;
+        job.done_us = d2h_end;
+        last_done_us_ = max(last_done_us_, d2h_end);
+
+        stats_.jobs++;
+        stats_.bytes_h2d += in_bytes;
+        stats_.bytes_d2h += out_bytes;
+        stats_.flops += 2.0 * M * K * N;
+        stats_.h2d_ms += h2d_us(in_bytes) / 1000.0;
+        stats_.compute_ms += kernel_us(M, K, N) / 1000.0;
+        stats_.d2h_ms += d2h_us(out_bytes) / 1000.0;
+        stats_.makespan_ms = (last_done_us_ - first_submit_us_) / 1000.0;
+
+        job.ticket = next_ticket_++;
+        done_.push_back(0);
+        in_flight_++;
+        queue_.push_back(job);
+    }
+    work_cv_.notify_one();
+    return job.ticket;
+}
+
+void SimulatedAccelerator::worker_loop() {
+    for (;;) {
+        Job job;
+        Clock::time_point epoch;
+        {
+            unique_lock<mutex> lock(m_);
+            work_cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (queue_.empty()) return;
+            job = queue_.front();
+            queue_.pop_front();
+            epoch = epoch_;
+        }
+
+        // Same loop as dense_spmm_cpu_tile_into, serial: this thread is one device stream
+        auto start = Clock::now();
+        for (int i = 0; i < job.M; i++) {
+            for (int j = 0; j < job.N; j++) {
+                float sum = 0.0f;
+                for (int k = 0; k < job.K; k++) {
+                    sum += job.X[static_cast<size_t>(i) * job.K + k] * job.W[static_cast<size_t>(k) * job.N + j];
+                }
+                job.Y[static_cast<size_t>(i) * job.N + j] = sum;
+            }
+        }
+        auto finish = Clock::now();
+        auto modelled = epoch + chrono::duration_cast<Clock::duration>(chrono::duration<double, micro>(job.done_us));
+        bool late = finish > modelled;
+        if (cfg_.pace && !late) this_thread::sleep_until(modelled);
+
+        {
+            lock_guard<mutex> lock(m_);
+            done_[job.ticket - done_base_] = 1;
+            while (!done_.empty() && done_.front() != 0) {
+                done_.pop_front();
+                done_base_++;
+            }
+            in_flight_--;
+            stats_.host_compute_ms += chrono::duration<double, milli>(finish - start).count();
+            if (late) stats_.late_jobs++;
+        }
+        done_cv_.notify_all();
+    }
+}
+
+/* Caller holds m_ */
+bool SimulatedAccelerator::ticket_done(AccelTicket ticket) const {
+    if (ticket >= next_ticket_) {
+        throw runtime_error("SimulatedAccelerator: unknown ticket " + to_string(ticket));
+    }
+    return ticket < done_base_ || done_[ticket - done_base_] != 0;
+}
+
+bool SimulatedAccelerator::poll(AccelTicket ticket) {
+    lock_guard<mutex> lock(m_);
+    return ticket_done(ticket);
+}
+
+void SimulatedAccelerator::wait(AccelTicket ticket) {
+    unique_lock<mutex> lock(m_);
+    ticket_done(ticket);
+    done_cv_.wait(lock, [this, ticket] { return ticket_done(ticket); });
+}
+
+void SimulatedAccelerator::synchronize() {
+    unique_lock<mutex> lock(m_);
+    done_cv_.wait(lock, [this] { return in_flight_ == 0; });
+}
+
+AccelStats SimulatedAccelerator::stats() const {
+    lock_guard<mutex> lock(m_);
+    return stats_;
+}
+
+void SimulatedAccelerator::reset_stats() {
+    unique_lock<mutex> lock(m_);
+    done_cv_.wait(lock, [this] { return in_flight_ == 0; });
+    stats_ = AccelStats();
+    started_ = false;
+    h2d_free_us_ = 0.0;
+    d2h_free_us_ = 0.0;
+    fill(stream_free_us_.begin(), stream_free_us_.end(), 0.0);
+    first_submit_us_ = 0.0;
+    last_done_us_ = 0.0;
+}
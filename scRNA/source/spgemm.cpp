@@ -0,0 +1,354 @@
+#include "../include/spgemm.hpp"
+#include "../include/spmm_transpose.hpp"
+#include "../include/tiler.hpp"
+#include "../include/logger.hpp"
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <iomanip>
+#include <cstdint>
+#include <omp.h>
+
+using namespace std;
+using namespace std::chrono;
+
+/*
+  B split into column panels. With a single panel B is used in place.
+ */
+struct ColumnPanels {
+    vector<CSR> owned;
+    vector<const CSR*> panels;
+    vector<int> col_start;
+};
+
+static ColumnPanels split_column_panels(const CSR& B, int panel_cols) {
+    ColumnPanels cp;
+
+    // Column panels are 2D tiles spanning all rows of B
+    TilingConfig cfg(max(1, B.nrows), panel_cols);
+    vector<Tile> tiles = make_2d_tiles(B, cfg);
+    int P = static_cast<int>(tiles.size());
+
+    if (P <= 1) {
+        cp.panels.push_back(&B);
+        cp.col_start.push_back(0);
+        return cp;
+    }
+
+    cp.owned.resize(P);
+    for (int p = 0; p < P; p++) {
+        CSR& Bp = cp.owned[p];
+        Bp.nrows = B.nrows;
+        Bp.ncols = tiles[p].col_end - tiles[p].col_start;
+        Bp.nnz = tiles[p].nnz;
+        Bp.indptr.assign(B.nrows + 1, 0);
+        Bp.indices.resize(Bp.nnz);
+        Bp.data.resize(Bp.nnz);
+        cp.col_start.push_back(tiles[p].col_start);
+    }
+
+    // Count per (panel, row)
+    #pragma omp parallel for schedule(static)
+    for (int r = 0; r < B.nrows; r++) {
+        for (int idx = B.indptr[r]; idx < B.indptr[r + 1]; idx++) {
+            cp.owned[B.indices[idx] / panel_cols].indptr[r + 1]++;
+        }
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (int p = 0; p < P; p++) {
+        huge_vector<int>& ptr = cp.owned[p].indptr;
+        for (int r = 0; r < B.nrows; r++) ptr[r + 1] += ptr[r];
+    }
+
+    // Scatter: one cursor per panel, so rows with unsorted columns keep their entry order
+    #pragma omp parallel
+    {
+        vector<int> next(P);
+        #pragma omp for schedule(static)
+        for (int r = 0; r < B.nrows; r++) {
+            for (int p = 0; p < P; p++) next[p] = cp.owned[p].indptr[r];
+            for (int idx = B.indptr[r]; idx < B.indptr[r + 1]; idx++) {
+                int c = B.indices[idx];
+                int p = c / panel_cols;
+                int dest = next[p]++;
+                cp.owned[p].indices[dest] = c - cp.col_start[p];
+                cp.owned[p].data[dest] = B.data[idx];
+            }
+        }
+    }
+
+    for (int p = 0; p < P; p++) cp.panels.push_back(&cp.owned[p]);
+    return cp;
+}
+
+/*
+  Per-thread accumulator: a dense array of one panel width (with a touched list so
+  it is cleared in O(touched)) and an open-addressing hash table for short rows.
+ */
+struct RowAccumulator {
+    vector<float> dense_vals;
+    vector<char> dense_mark;
+    vector<int> touched;
+    vector<int> hash_keys;
+    vector<float> hash_vals;
+    vector<pair<int, float>> entries;   // Output of one (row, panel), sorted by column
+
+    explicit RowAccumulator(int panel_width)
+        : dense_vals(panel_width, 0.0f), dense_mark(panel_width, 0) {}
+};
+
+static inline size_t row_panel_products(const CSR& A, int i, const CSR& Bp) {
+    size_t products = 0;
+    for (int idx = A.indptr[i]; idx < A.indptr[i + 1]; idx++) {
+        int k = A.indices[idx];
+        products += Bp.indptr[k + 1] - Bp.indptr[k];
+    }
+    return products;
+}
+
+static inline bool use_dense(SpgemmAccumulator mode, size_t products, int panel_width) {
+    if (mode == SpgemmAccumulator::Dense) return true;
+    if (mode == SpgemmAccumulator::Hash) return false;
+    // Hash table (2x products) stays well below the dense array
+    return products * 16 >= static_cast<size_t>(panel_width);
+}
+
+/*
+  Accumulate row i of A against panel Bp. NUMERIC = false only counts distinct columns.
+  Returns the distinct column count; in numeric mode acc.entries holds the sorted row.
+  If probe >= 0, *probe_hit reports whether that (panel-local) column is present.
+ */
+template <bool NUMERIC>
+static int accumulate_row_panel(const CSR& A, int i, const CSR& Bp, bool dense,
+                                size_t products, RowAccumulator& acc,
+                                int probe = -1, bool* probe_hit = nullptr) {
+    if (NUMERIC) acc.entries.clear();
+    if (probe_hit) *probe_hit = false;
+    if (products == 0) return 0;
+
+    if (dense) {
+        acc.touched.clear();
+        for (int idx = A.indptr[i]; idx < A.indptr[i + 1]; idx++) {
+            int k = A.indices[idx];
+            float a_val = A.data[idx];
+            for (int jdx = Bp.indptr[k]; jdx < Bp.indptr[k + 1]; jdx++) {
+                int c = Bp.indices[jdx];
+                if (!acc.dense_mark[c]) {
+                    acc.dense_mark[c] = 1;
+                    acc.touched.push_back(c);
+                    if (NUMERIC) acc.dense_vals[c] = a_val * Bp.data[jdx];
+                } else if (NUMERIC) {
+                    acc.dense_vals[c] += a_val * Bp.data[jdx];
+                }
+            }
+        }
+        int count = static_cast<int>(acc.touched.size());
+        if (NUMERIC) {
+            sort(acc.touched.begin(), acc.touched.end());
+            acc.entries.reserve(count);
+            for (int c : acc.touched) acc.entries.emplace_back(c, acc.dense_vals[c]);
+        }
+        if (probe >= 0 && probe_hit) *probe_hit = acc.dense_mark[probe] != 0;
+        for (int c : acc.touched) acc.dense_mark[c] = 0;
+        return count;
+    }
+
+    size_t capacity = 16;
+    while (capacity < 2 * products) capacity <<= 1;
+    size_t mask = capacity - 1;
+    if (acc.hash_keys.size() < capacity) {
+        acc.hash_keys.resize(capacity);
+        acc.hash_vals.resize(capacity);
+    }
+    fill(acc.hash_keys.begin(), acc.hash_keys.begin() + capacity, -1);
+
+    int count = 0;
+    for (int idx = A.indptr[i]; idx < A.indptr[i + 1]; idx++) {
+        int k = A.indices[idx];
+        float a_val = A.data[idx];
+        for (int jdx = Bp.indptr[k]; jdx < Bp.indptr[k + 1]; jdx++) {
+            int c = Bp.indices[jdx];
+            size_t h = (static_cast<uint32_t>(c) * 2654435761u) & mask;
+            while (acc.hash_keys[h] != -1 && acc.hash_keys[h] != c) h = (h + 1) & mask;
+            if (acc.hash_keys[h] == -1) {
+                acc.hash_keys[h] = c;
+                count++;
+                if (NUMERIC) acc.hash_vals[h] = a_val * Bp.data[jdx];
+            } else if (NUMERIC) {
+                acc.hash_vals[h] += a_val * Bp.data[jdx];
+            }
+        }
+    }
+    if (probe >= 0 && probe_hit) {
+        size_t h = (static_cast<uint32_t>(probe) * 2654435761u) & mask;
+        while (acc.hash_keys[h] != -1 && acc.hash_keys[h] != probe) h = (h + 1) & mask;
+        *probe_hit = acc.hash_keys[h] == probe;
+    }
+    if (NUMERIC) {
+        acc.entries.reserve(count);
+        for (size_t h = 0; h < capacity; h++) {
+            if (acc.hash_keys[h] != -1) acc.entries.emplace_back(acc.hash_keys[h], acc.hash_vals[h]);
+        }
+        sort(acc.entries.begin(), acc.entries.end(),
+             [](const pair<int, float>& a, const pair<int, float>& b) { return a.first < b.first; });
+    }
+    return count;
+}
+
+CSR spgemm(const CSR& A, const CSR& B, const SpgemmParams& params,
+           SpgemmStats* stats, const string& log_annotation) {
+    if (A.ncols != B.nrows) {
+        throw runtime_error("Matrix dimension mismatch: A.ncols=" + to_string(A.ncols)
+                           + " != B.nrows=" + to_string(B.nrows));
+    }
+    if (params.panel_cols <= 0) {
+        throw runtime_error("SpGEMM panel_cols must be positive");
+    }
+
+    SpgemmStats local_stats;
+    SpgemmStats& st = stats ? *stats : local_stats;
+    st = SpgemmStats();
+    auto start = high_resolution_clock::now();
+
+    ColumnPanels cp = split_column_panels(B, params.panel_cols);
+    int P = static_cast<int>(cp.panels.size());
+    int max_panel_width = 0;
+    for (const CSR* Bp : cp.panels) max_panel_width = max(max_panel_width, Bp->ncols);
+    st.num_panels = P;
+    auto t_panel = high_resolution_clock::now();
+    st.panel_ms = duration_cast<microseconds>(t_panel - start).count() / 1000.0;
+
+    CSR C;
+    C.nrows = A.nrows;
+    C.ncols = B.ncols;
+    C.indptr.assign(A.nrows + 1, 0);
+
+    // Symbolic phase: distinct columns per row (after diagonal removal and top-k)
+    size_t products = 0, nnz_unpruned = 0, dense_rows = 0, hash_rows = 0;
+    #pragma omp parallel reduction(+:products, nnz_unpruned, dense_rows, hash_rows)
+    {
+        RowAccumulator acc(max_panel_width);
+
+        #pragma omp for schedule(dynamic, 64)
+        for (int i = 0; i < A.nrows; i++) {
+            int row_nnz = 0;
+            for (int p = 0; p < P; p++) {
+                const CSR& Bp = *cp.panels[p];
+                size_t prod = row_panel_products(A, i, Bp);
+                bool dense = use_dense(params.accumulator, prod, Bp.ncols);
+                products += prod;
+                if (prod > 0) (dense ? dense_rows : hash_rows)++;
+
+                // Probe for (i, i) in the panel that holds column i
+                int probe = -1;
+                if (params.exclude_diagonal && i >= cp.col_start[p] && i < cp.col_start[p] + Bp.ncols) {
+                    probe = i - cp.col_start[p];
+                }
+                bool has_diagonal = false;
+                int cnt = accumulate_row_panel<false>(A, i, Bp, dense, prod, acc, probe, &has_diagonal);
+                nnz_unpruned += cnt;
+                row_nnz += has_diagonal ? cnt - 1 : cnt;
+            }
+            if (params.top_k > 0) row_nnz = min(row_nnz, params.top_k);
+            C.indptr[i + 1] = row_nnz;
+        }
+    }
+    st.products = products;
+    st.nnz_unpruned = nnz_unpruned;
+    st.dense_rows = dense_rows;
+    st.hash_rows = hash_rows;
+
+    for (int i = 0; i < A.nrows; i++) C.indptr[i + 1] += C.indptr[i];
+    C.nnz = C.indptr[A.nrows];
+    C.indices.resize(C.nnz);
+    C.data.resize(C.nnz);
+    auto t_symbolic = high_resolution_clock::now();
+    st.symbolic_ms = duration_cast<microseconds>(t_symbolic - t_panel).count() / 1000.0;
+
+    // Numeric phase
+    #pragma omp parallel
+    {
+        RowAccumulator acc(max_panel_width);
+        vector<pair<int, float>> row;   // Whole row across panels, for top-k
+
+        #pragma omp for schedule(dynamic, 64)
+        for (int i = 0; i < A.nrows; i++) {
+            int dest = C.indptr[i];
+            row.clear();
+            for (int p = 0; p < P; p++) {
+                const CSR& Bp = *cp.panels[p];
+                size_t prod = row_panel_products(A, i, Bp);
+                bool dense = use_dense(params.accumulator, prod, Bp.ncols);
+                accumulate_row_panel<true>(A, i, Bp, dense, prod, acc);
+
+                for (const auto& e : acc.entries) {
+                    int c = e.first + cp.col_start[p];
+                    if (params.exclude_diagonal && c == i) continue;
+                    if (params.top_k > 0) {
+                        row.emplace_back(c, e.second);
+                    } else {
+                        C.indices[dest] = c;
+                        C.data[dest] = e.second;
+                        dest++;
+                    }
+                }
+            }
+
+            if (params.top_k > 0) {
+                if (static_cast<int>(row.size()) > params.top_k) {
+                    nth_element(row.begin(), row.begin() + params.top_k, row.end(),
+                                [](const pair<int, float>& a, const pair<int, float>& b) {
+                                    return fabs(a.second) > fabs(b.second);
+                                });
+                    row.resize(params.top_k);
+                    sort(row.begin(), row.end(),
+                         [](const pair<int, float>& a, const pair<int, float>& b) { return a.first < b.first; });
+                }
+                for (const auto& e : row) {
+                    C.indices[dest] = e.first;
+                    C.data[dest] = e.second;
+                    dest++;
+                }
+            }
+        }
+    }
+
+    auto end = high_resolution_clock::now();
+    st.numeric_ms = duration_cast<microseconds>(end - t_symbolic).count() / 1000.0;
+    st.total_ms = duration_cast<microseconds>(end - start).count() / 1000.0;
+    st.nnz_out = C.nnz;
+
+    if (!log_annotation.empty()) {
+        stringstream ss;
+        ss << "spgemm A: " << A.nrows << " x " << A.ncols << " (nnz " << A.nnz << "), B: "
+           << B.nrows << " x " << B.ncols << " (nnz " << B.nnz << ")" << endl;
+        ss << "spgemm threads: " << omp_get_max_threads() << ", panels: " << st.num_panels
+           << ", top_k: " << params.top_k << endl;
+        ss << "spgemm products: " << st.products << ", nnz unpruned: " << st.nnz_unpruned
+           << ", nnz out: " << st.nnz_out << endl;
+        ss << "spgemm dense/hash row-panels: " << st.dense_rows << " / " << st.hash_rows << endl;
+        ss << fixed << setprecision(3);
+        ss << "spgemm panel time: " << st.panel_ms << "ms" << endl;
+        ss << "spgemm symbolic time: " << st.symbolic_ms << "ms" << endl;
+        ss << "spgemm numeric time: " << st.numeric_ms << "ms" << endl;
+        ss << "spgemm total time: " << st.total_ms << "ms" << endl;
+        log_to_file_experiment(log_annotation, "spgemm", ss.str());
+    }
+
+    return C;
+}
+
+CSR gene_coexpression(const CSR& X, const SpgemmParams& params,
+                      SpgemmStats* stats, const string& log_annotation) {
+    CSR XT = transpose_csr(X);
+    return spgemm(X, XT, params, stats, log_annotation);
+}
+
+CSR cell_similarity(const CSR& X, const SpgemmParams& params,
+                    SpgemmStats* stats, const string& log_annotation) {
+    CSR XT = transpose_csr(X);
+    return spgemm(XT, X, params, stats, log_annotation);
+}
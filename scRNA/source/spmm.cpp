@@ -1,11 +1,33 @@
 #include "../include/spmm.hpp"
 #include "../include/tiler.hpp"
 #include "../include/dense_spmm.hpp"
+#include "../include/static_tiling.hpp"
 #include "../include/logger.hpp"
 #include <stdexcept>
+#include <algorithm>
 
 using namespace std;
 
+/*
+  Add the nonzeros of one tile to the statistics sink (tiles are disjoint, so each
+  nonzero is counted once). Used for dense tiles, whose kernel does not expose the loop.
+ */
+static void accumulate_tile_stats(const CSR& X, const Tile& tile, SpmmStats& stats) {
+    for (int i = tile.row_start; i < tile.row_end; i++) {
+        for (int idx = X.indptr[i]; idx < X.indptr[i + 1]; idx++) {
+            int k = X.indices[idx];
+            if (k >= tile.col_start && k < tile.col_end) {
+                double x_val = X.data[idx];
+                stats.row_nnz[i]++;
+                stats.row_sum[i] += x_val;
+                stats.row_sumsq[i] += x_val * x_val;
+                stats.col_nnz[k]++;
+                stats.col_sum[k] += x_val;
+            }
+        }
+    }
+}
+
 /*
   Tiled SpMM: Y = X * W using 2D tiling
   Processes matrix tile by tile (PIM OFF)
@@ -18,18 +40,38 @@ using namespace std;
   @param W_cols Number of columns in W
   @param cfg Tiling configuration
   @param log_annotation Optional log file annotation (e.g., "0" for log0.txt). If empty, no logging is performed.
+  @param stats Optional statistics sink (per-gene/per-cell QC stats), accumulated tile by tile
   @return Pair of (result vector Y, number of tiles used)
  */
 pair<vector<float>, size_t> spmm_tiled(const CSR& X, const vector<float>& W, int W_rows, int W_cols, 
-                                       const TilingConfig& cfg, const string& log_annotation) {
+                                       const TilingConfig& cfg, const string& log_annotation,
+                                       SpmmStats* stats) {
+    vector<float> Y = make_huge_page_vector<float>(static_cast<size_t>(X.nrows) * W_cols);
+    size_t num_tiles = spmm_tiled_into(X, W, W_rows, W_cols, cfg, Y, false, log_annotation, stats);
+    return make_pair(std::move(Y), num_tiles);
+}
+
+/*
+  Tiled SpMM into caller storage. Y is zeroed first unless zero_Y is false
+  (already zeroed, or accumulating Y += X * W).
+ */
+size_t spmm_tiled_into(const CSR& X, const vector<float>& W, int W_rows, int W_cols,
+                       const TilingConfig& cfg, Span<float> Y, bool zero_Y,
+                       const string& log_annotation, SpmmStats* stats) {
     if (X.ncols != W_rows) {
         throw runtime_error("Matrix dimension mismatch: X.ncols=" + to_string(X.ncols) 
                            + " != W.nrows=" + to_string(W_rows));
     }
     
-    int Y_rows = X.nrows;
     int Y_cols = W_cols;
-    vector<float> Y(Y_rows * Y_cols, 0.0f);
+    require_span_size(Y, static_cast<size_t>(X.nrows) * Y_cols, "Y");
+    if (zero_Y) {
+        fill(Y.begin(), Y.begin() + static_cast<size_t>(X.nrows) * Y_cols, 0.0f);
+    }
+    
+    if (stats != nullptr) {
+        reset_spmm_stats(*stats, X.nrows, X.ncols);
+    }
     
     // Create tiles 
     vector<Tile> tiles = make_2d_tiles(X, cfg, log_annotation);
@@ -52,11 +94,22 @@ pair<vector<float>, size_t> spmm_tiled(const CSR& X, const vector<float>& W, int
         log_matrix_density(log_annotation, matrix_density);
     }
     
+    // Dense and sparse tiles run the same accumulation, so the compile-time engine covers
+    // both in one pass per row band
+    const StaticTilingKernels* st = stats == nullptr ? find_static_tiling(cfg) : nullptr;
+    if (st != nullptr && csr_rows_sorted(X)) {
+        st->spmm(X, W, W_cols, Y);
+        return num_tiles;
+    }
+    
     // Process each tile: route based on density classification
     for (const auto& tile : tiles) {
         if (tile.is_dense) {
             // Dense tile: route to dense_spmm_tile function
             dense_spmm_tile(X, W, W_cols, tile, Y, Y_cols);
+            if (stats != nullptr) {
+                accumulate_tile_stats(X, tile, *stats);
+            }
         } else {
             // Sparse tile: 
             for (int i = tile.row_start; i < tile.row_end; i++) {
@@ -75,12 +128,20 @@ pair<vector<float>, size_t> spmm_tiled(const CSR& X, const vector<float>& W, int
                         for (int j = 0; j < W_cols; j++) {
                             Y[i * Y_cols + j] += x_val * W[k * W_cols + j];
                         }
+                        
+                        if (stats != nullptr) {
+                            stats->row_nnz[i]++;
+                            stats->row_sum[i] += x_val;
+                            stats->row_sumsq[i] += static_cast<double>(x_val) * x_val;
+                            stats->col_nnz[k]++;
+                            stats->col_sum[k] += x_val;
+                        }
                     }
                 }
             }
         }
     }
     
-    return make_pair(Y, num_tiles);
+    return num_tiles;
 }
 
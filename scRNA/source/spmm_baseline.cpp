@@ -9,7 +9,20 @@ using namespace std;
  Sparse-Dense Matrix Multiplication (Baseline): Y = X * W
  Pure computation function - no timing or logging.
  */
-vector<float> spmm_baseline(const CSR& X, const vector<float>& W, int W_rows, int W_cols, const string& log_annotation) {
+vector<float> spmm_baseline(const CSR& X, const vector<float>& W, int W_rows, int W_cols, const string& log_annotation,
+                            SpmmStats* stats) {
+    // Zero-initialised (pages advised for huge pages first), so the kernel can skip its own zeroing
+    vector<float> Y = make_huge_page_vector<float>(static_cast<size_t>(X.nrows) * W_cols);
+    spmm_baseline_into(X, W, W_rows, W_cols, Y, false, log_annotation, stats);
+    return Y;
+}
+
+/**
+ Sparse-Dense Matrix Multiplication (Baseline) into caller storage: Y = X * W, or Y += X * W
+ when zero_Y is false. Rows are zeroed inside the parallel loop, by the thread that computes them.
+ */
+void spmm_baseline_into(const CSR& X, const vector<float>& W, int W_rows, int W_cols, Span<float> Y,
+                        bool zero_Y, const string& log_annotation, SpmmStats* stats) {
     if (X.ncols != W_rows) {
         throw runtime_error("Matrix dimension mismatch: X.ncols=" + to_string(X.ncols) 
                            + " != W.nrows=" + to_string(W_rows));
@@ -21,14 +34,66 @@ vector<float> spmm_baseline(const CSR& X, const vector<float>& W, int W_rows, in
         log_openmp_threads(log_annotation, max_threads);
     }
     
-    int Y_rows = X.nrows;
     int Y_cols = W_cols;
-    vector<float> Y(Y_rows * Y_cols, 0.0f);
+    require_span_size(Y, static_cast<size_t>(X.nrows) * Y_cols, "Y");
+    
+    if (stats != nullptr) {
+        // Same loop with the statistics sink fused in
+        reset_spmm_stats(*stats, X.nrows, X.ncols);
+        SpmmStatsColumnBuffers col_buffers(X.ncols, omp_get_max_threads());
+        
+        #pragma omp parallel
+        {
+            int tid = omp_get_thread_num();
+            int* col_nnz = col_buffers.nnz_for(tid);
+            double* col_sum = col_buffers.sum_for(tid);
+            
+            #pragma omp for schedule(static)
+            for (int i = 0; i < X.nrows; i++) {
+                int row_start = X.indptr[i];
+                int row_end = X.indptr[i + 1];
+                if (zero_Y) {
+                    for (int j = 0; j < Y_cols; j++) Y[i * Y_cols + j] = 0.0f;
+                }
+                
+                for (int idx = row_start; idx < row_end; idx++) {
+                    int k = X.indices[idx];
+                    float x_val = X.data[idx];
+                    
+                    for (int j = 0; j < W_cols; j++) {
+                        Y[i * Y_cols + j] += x_val * W[k * W_cols + j];
+                    }
+                }
+                
+                // Row is still in L1: a second sweep keeps the SpMM inner loop untouched
+                double row_sum = 0.0;
+                double row_sumsq = 0.0;
+                for (int idx = row_start; idx < row_end; idx++) {
+                    int k = X.indices[idx];
+                    double x_val = X.data[idx];
+                    row_sum += x_val;
+                    row_sumsq += x_val * x_val;
+                    col_nnz[k]++;
+                    col_sum[k] += x_val;
+                }
+                
+                stats->row_nnz[i] = row_end - row_start;
+                stats->row_sum[i] = row_sum;
+                stats->row_sumsq[i] = row_sumsq;
+            }
+        }
+        
+        col_buffers.reduce_into(*stats);
+        return;
+    }
     
     #pragma omp parallel for schedule(static)
     for (int i = 0; i < X.nrows; i++) {
         int row_start = X.indptr[i];
         int row_end = X.indptr[i + 1];
+        if (zero_Y) {
+            for (int j = 0; j < Y_cols; j++) Y[i * Y_cols + j] = 0.0f;
+        }
         
         for (int idx = row_start; idx < row_end; idx++) {
             int k = X.indices[idx];
@@ -39,7 +104,4 @@ vector<float> spmm_baseline(const CSR& X, const vector<float>& W, int W_rows, in
             }
         }
     }
-    
-    return Y;
 }
-
@@ -0,0 +1,134 @@
+#include "../include/spmm_client.hpp"
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <sstream>
+#include <cstring>
+#include <cerrno>
+#include <cstdlib>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace std::chrono;
+
+SpmmClient::SpmmClient(const string& socket_path) {
+    fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd_ < 0) {
+        throw runtime_error(string("socket() failed: ") + strerror(errno));
+    }
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(addr.sun_path)) {
+        throw runtime_error("Socket path too long: " + socket_path);
+    }
+    strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+    if (connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        int err = errno;
+        close(fd_);
+        fd_ = -1;
+        throw runtime_error("connect(" + socket_path + ") failed: " + strerror(err));
+    }
+}
+
+SpmmClient::~SpmmClient() {
+    if (fd_ >= 0) close(fd_);
+}
+
+string SpmmClient::request(const string& line) {
+    string msg = line + "\n";
+    size_t sent = 0;
+    while (sent < msg.size()) {
+        ssize_t n = write(fd_, msg.data() + sent, msg.size() - sent);
+        if (n <= 0) throw runtime_error("connection closed while sending");
+        sent += n;
+    }
+
+    size_t pos;
+    char chunk[4096];
+    while ((pos = buffer_.find('\n')) == string::npos) {
+        ssize_t n = read(fd_, chunk, sizeof(chunk));
+        if (n <= 0) throw runtime_error("connection closed while waiting for response");
+        buffer_.append(chunk, n);
+    }
+    string reply = buffer_.substr(0, pos);
+    buffer_.erase(0, pos + 1);
+    return reply;
+}
+
+ServiceBenchResult bench_service(const string& socket_path, const string& w_spec, const string& output_path,
+                                 int requests, int concurrency) {
+    ServiceBenchResult res;
+    res.requests = requests;
+    res.concurrency = max(1, concurrency);
+
+    vector<double> latencies(requests, 0.0);
+    vector<int> batch_sizes(requests, 0);
+    vector<char> failed(requests, 0);
+
+    // Procedural specs get a distinct seed per request so no two W are identical
+    auto spec_for = [&](int r) {
+        if (w_spec.rfind("seed:", 0) != 0) return w_spec;
+        size_t colon = w_spec.find(':', 5);
+        unsigned seed = static_cast<unsigned>(stoul(w_spec.substr(5, colon - 5))) + r;
+        return "seed:" + to_string(seed) + w_spec.substr(colon);
+    };
+
+    auto start = high_resolution_clock::now();
+    vector<thread> workers;
+    for (int t = 0; t < res.concurrency; t++) {
+        workers.emplace_back([&, t] {
+            try {
+                SpmmClient client(socket_path);
+                for (int r = t; r < requests; r += res.concurrency) {
+                    auto t0 = high_resolution_clock::now();
+                    string reply = client.request("PROJECT " + spec_for(r) + " " + output_path);
+                    latencies[r] = duration_cast<microseconds>(high_resolution_clock::now() - t0).count() / 1000.0;
+                    if (reply.rfind("OK", 0) != 0) {
+                        failed[r] = 1;
+                        continue;
+                    }
+                    istringstream in(reply.substr(2));
+                    double queue_ms, compute_ms;
+                    in >> queue_ms >> compute_ms >> batch_sizes[r];
+                }
+            } catch (const exception&) {
+                for (int r = t; r < requests; r += res.concurrency) failed[r] = 1;
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+    res.wall_ms = duration_cast<microseconds>(high_resolution_clock::now() - start).count() / 1000.0;
+
+    vector<double> ok_lat;
+    double batch_sum = 0.0;
+    for (int r = 0; r < requests; r++) {
+        if (failed[r]) {
+            res.failures++;
+            continue;
+        }
+        ok_lat.push_back(latencies[r]);
+        batch_sum += batch_sizes[r];
+    }
+    if (!ok_lat.empty()) {
+        sort(ok_lat.begin(), ok_lat.end());
+        res.latency_p50_ms = ok_lat[ok_lat.size() / 2];
+        res.latency_p95_ms = ok_lat[min(ok_lat.size() - 1, static_cast<size_t>(ok_lat.size() * 0.95))];
+        res.latency_max_ms = ok_lat.back();
+        res.avg_batch = batch_sum / ok_lat.size();
+    }
+    res.throughput_rps = res.wall_ms > 0.0 ? (requests - res.failures) * 1000.0 / res.wall_ms : 0.0;
+    return res;
+}
+
+double bench_one_shot(const string& command, int runs) {
+    auto start = high_resolution_clock::now();
+    for (int r = 0; r < runs; r++) {
+        if (system(command.c_str()) != 0) return -1.0;
+    }
+    double total_ms = duration_cast<microseconds>(high_resolution_clock::now() - start).count() / 1000.0;
+    return runs > 0 ? total_ms / runs : 0.0;
+}
@@ -0,0 +1,81 @@
+#include "../include/spmm_client.hpp"
+#include <iostream>
+#include <string>
+#include <iomanip>
+
+using namespace std;
+
+void print_usage(const char* prog) {
+    cerr << "Usage: " << prog << " <socket_path> ping|stats|shutdown" << endl;
+    cerr << "       " << prog << " <socket_path> project <file:W.h5|seed:<seed>:<K>> <output_path|none>" << endl;
+    cerr << "       " << prog << " <socket_path> bench <w_spec> <requests> <concurrency> [one_shot_command]" << endl;
+    cerr << "Example: " << prog << " /tmp/scrna_spmm.sock project file:../dataset/W/w4.h5 ../dataset/Y/y4.h5" << endl;
+    cerr << "Example: " << prog << " /tmp/scrna_spmm.sock bench seed:1:32 200 4 \"../build/run4.exe d4.h5 w4.h5\"" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    string socket_path = argv[1];
+    string cmd = argv[2];
+
+    try {
+        if (cmd == "ping" || cmd == "stats" || cmd == "shutdown") {
+            string verb = cmd == "ping" ? "PING" : (cmd == "stats" ? "STATS" : "SHUTDOWN");
+            SpmmClient client(socket_path);
+            string reply = client.request(verb);
+            cout << reply << endl;
+            return reply.rfind("OK", 0) == 0 ? 0 : 1;
+        }
+
+        if (cmd == "project" && argc == 5) {
+            SpmmClient client(socket_path);
+            string reply = client.request("PROJECT " + string(argv[3]) + " " + argv[4]);
+            cout << reply << endl;
+            if (reply.rfind("OK", 0) != 0) return 1;
+            cout << "spmm done" << endl;
+            return 0;
+        }
+
+        if (cmd == "bench" && (argc == 6 || argc == 7)) {
+            string w_spec = argv[3];
+            int requests = stoi(argv[4]);
+            int concurrency = stoi(argv[5]);
+
+            // Sequential latency first, then the concurrent (batched) run
+            ServiceBenchResult seq = bench_service(socket_path, w_spec, "none", requests, 1);
+            ServiceBenchResult par = bench_service(socket_path, w_spec, "none", requests, concurrency);
+
+            cout << fixed << setprecision(3);
+            for (const auto* r : {&seq, &par}) {
+                cout << "service concurrency " << r->concurrency << ": " << r->requests << " requests, "
+                     << r->failures << " failed, throughput " << r->throughput_rps << " req/s" << endl;
+                cout << "  latency p50/p95/max: " << r->latency_p50_ms << " / " << r->latency_p95_ms
+                     << " / " << r->latency_max_ms << " ms, avg batch: " << r->avg_batch << endl;
+            }
+
+            if (argc == 7) {
+                int runs = min(requests, 10);
+                double one_shot_ms = bench_one_shot(argv[6], runs);
+                if (one_shot_ms < 0.0) {
+                    cerr << "one-shot command failed: " << argv[6] << endl;
+                    return 1;
+                }
+                cout << "one-shot binary: " << one_shot_ms << " ms per run (" << runs << " runs), "
+                     << 1000.0 / one_shot_ms << " runs/s" << endl;
+                cout << "service speedup (sequential latency p50): " << one_shot_ms / seq.latency_p50_ms << "x" << endl;
+                cout << "service speedup (concurrent throughput): " << par.throughput_rps * one_shot_ms / 1000.0 << "x" << endl;
+            }
+            return (seq.failures + par.failures) == 0 ? 0 : 1;
+        }
+
+        print_usage(argv[0]);
+        return 1;
+
+    } catch (const exception& e) {
+        cerr << "  ✗ Error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,224 @@
+#include "../include/spmm_plan.hpp"
+#include "../include/logger.hpp"
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <iomanip>
+#include <omp.h>
+
+using namespace std;
+
+static double ms_since(chrono::high_resolution_clock::time_point t) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - t).count() / 1000.0;
+}
+
+SpmmPlan::SpmmPlan(const CSR& X, const SpmmPlanConfig& cfg, const string& log_annotation)
+    : nrows_(X.nrows), ncols_(X.ncols), cfg_(cfg) {
+    if (cfg.tiling.tile_rows < 1 || cfg.tiling.tile_cols < 1) {
+        throw runtime_error("SpmmPlan: tile sizes must be positive");
+    }
+    if (cfg.panels_per_thread < 1) {
+        throw runtime_error("SpmmPlan: panels_per_thread must be at least 1");
+    }
+
+    // 1. Heavy rows. The nnz-balanced panels already balance any row up to one panel's
+    // share of nnz, and the dense block costs more per nonzero than CSR, so only rows
+    // above that share are split off
+    auto start = chrono::high_resolution_clock::now();
+    const int num_panels = max(1, min(nrows_, cfg.panels_per_thread * omp_get_max_threads()));
+    double panel_fraction = X.ncols > 0 ? static_cast<double>(X.nnz) / num_panels / X.ncols : 0.0;
+    heavy_ = split_heavy_rows(X, max(cfg.heavy_fraction, panel_fraction));
+    const CSR& L = heavy_.light;
+    info_.heavy_ms = ms_since(start);
+
+    // 2. Tiling and routing
+    start = chrono::high_resolution_clock::now();
+    vector<Tile> tiles = make_2d_tiles(L, cfg.tiling);
+    if (cfg.dense_tiles) predict_tile_density(tiles, cfg.dense_threshold);
+    info_.tiling_ms = ms_since(start);
+
+    // 3. Conversion: candidate tiles that are cheaper dense than CSR are materialised, the
+    // rest goes into the sparse remainder. Both paths do nnz * K multiply-adds on the same
+    // rows of W, so K cancels: a dense tile scans rows * cols cells, CSR loads nnz indices
+    start = chrono::high_resolution_clock::now();
+    const int T_R = cfg.tiling.tile_rows;
+    const int T_C = cfg.tiling.tile_cols;
+    const int num_row_tiles = (nrows_ + T_R - 1) / T_R;
+    const int num_col_tiles = (ncols_ + T_C - 1) / T_C;
+    vector<int> tile_slot(tiles.size(), -1);
+    band_bounds_.assign(num_row_tiles + 1, 0);
+    size_t dense_floats = 0;
+    for (size_t t = 0; t < tiles.size(); t++) {
+        const Tile& tile = tiles[t];
+        double cells = static_cast<double>(tile.row_end - tile.row_start) * (tile.col_end - tile.col_start);
+        if (!tile.is_dense || cells * cfg.dense_cell_cost >= static_cast<double>(tile.nnz)) continue;
+        PlanDenseTile d;
+        d.row_start = tile.row_start;
+        d.col_start = tile.col_start;
+        d.rows = tile.row_end - tile.row_start;
+        d.cols = tile.col_end - tile.col_start;
+        d.offset = dense_floats;
+        dense_floats += static_cast<size_t>(d.rows) * d.cols;
+        tile_slot[t] = static_cast<int>(dense_tiles_.size());
+        band_bounds_[tile.row_start / T_R + 1]++;
+        dense_tiles_.push_back(std::move(d));
+        info_.dense_nnz += tile.nnz;
+    }
+    for (int b = 0; b < num_row_tiles; b++) band_bounds_[b + 1] += band_bounds_[b];
+    dense_values_ = make_huge_page_vector<float>(dense_floats);
+
+    sparse_.nrows = nrows_;
+    sparse_.ncols = ncols_;
+    sparse_.indptr.assign(nrows_ + 1, 0);
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (int i = 0; i < nrows_; i++) {
+        const int* slots = tile_slot.data() + static_cast<size_t>(i / T_R) * num_col_tiles;
+        int kept = 0;
+        for (int idx = L.indptr[i]; idx < L.indptr[i + 1]; idx++) {
+            int c = L.indices[idx];
+            int slot = slots[c / T_C];
+            if (slot < 0) {
+                kept++;
+                continue;
+            }
+            const PlanDenseTile& d = dense_tiles_[slot];
+            dense_values_[d.offset + static_cast<size_t>(i - d.row_start) * d.cols + (c - d.col_start)] = L.data[idx];
+        }
+        sparse_.indptr[i + 1] = kept;
+    }
+    for (int i = 0; i < nrows_; i++) sparse_.indptr[i + 1] += sparse_.indptr[i];
+    sparse_.nnz = sparse_.indptr[nrows_];
+    sparse_.indices.resize(sparse_.nnz);
+    sparse_.data.resize(sparse_.nnz);
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (int i = 0; i < nrows_; i++) {
+        const int* slots = tile_slot.data() + static_cast<size_t>(i / T_R) * num_col_tiles;
+        int out = sparse_.indptr[i];
+        for (int idx = L.indptr[i]; idx < L.indptr[i + 1]; idx++) {
+            int c = L.indices[idx];
+            if (slots[c / T_C] >= 0) continue;
+            sparse_.indices[out] = c;
+            sparse_.data[out] = L.data[idx];
+            out++;
+        }
+    }
+    info_.convert_ms = ms_since(start);
+
+    // 4. Sparse row panels balanced by nnz
+    start = chrono::high_resolution_clock::now();
+    panel_bounds_.assign(num_panels + 1, 0);
+    for (int p = 1; p < num_panels; p++) {
+        long long target = static_cast<long long>(sparse_.nnz) * p / num_panels;
+        int b = static_cast<int>(lower_bound(sparse_.indptr.begin(), sparse_.indptr.end(), target) - sparse_.indptr.begin());
+        panel_bounds_[p] = max(panel_bounds_[p - 1], min(b, nrows_));
+    }
+    panel_bounds_[num_panels] = nrows_;
+    info_.partition_ms = ms_since(start);
+
+    // The heavy-row kernel only needs the dense block and the shape
+    heavy_.light.indptr = huge_vector<int>();
+    heavy_.light.indices = huge_vector<int>();
+    heavy_.light.data = huge_vector<float>();
+
+    info_.inspect_ms = info_.heavy_ms + info_.tiling_ms + info_.convert_ms + info_.partition_ms;
+    info_.heavy_rows = heavy_.heavy_rows.size();
+    info_.heavy_nnz = heavy_.heavy_nnz;
+    info_.num_tiles = tiles.size();
+    info_.dense_tiles = dense_tiles_.size();
+    info_.sparse_nnz = sparse_.nnz;
+    info_.sparse_panels = num_panels;
+    info_.plan_bytes = sparse_.indptr.size() * sizeof(int) + sparse_.nnz * (sizeof(int) + sizeof(float))
+                     + dense_values_.size() * sizeof(float) + heavy_.dense.size() * sizeof(float);
+
+    if (!log_annotation.empty()) {
+        stringstream ss;
+        ss << fixed << setprecision(3);
+        ss << "spmm plan: inspect " << info_.inspect_ms << "ms (heavy rows " << info_.heavy_ms << "ms, tiling "
+           << info_.tiling_ms << "ms, conversion " << info_.convert_ms << "ms, partition "
+           << info_.partition_ms << "ms), plan " << info_.plan_bytes / 1e6 << " MB" << endl;
+        ss << "  heavy rows: " << info_.heavy_rows << " (" << info_.heavy_nnz << " nnz), dense tiles: "
+           << info_.dense_tiles << " of " << info_.num_tiles << " (" << info_.dense_nnz << " nnz), sparse: "
+           << info_.sparse_nnz << " nnz in " << info_.sparse_panels << " panels" << endl;
+        log_to_file_experiment(log_annotation, "plan", ss.str());
+    }
+}
+
+void SpmmPlan::execute_into(const vector<float>& W, int W_rows, int W_cols, Span<float> Y,
+                            SpmmPlanExecStats* stats) const {
+    if (ncols_ != W_rows) {
+        throw runtime_error("Matrix dimension mismatch: X.ncols=" + to_string(ncols_)
+                           + " != W.nrows=" + to_string(W_rows));
+    }
+    const int K = W_cols;
+    require_span_size(Y, static_cast<size_t>(nrows_) * K, "Y");
+    auto start = chrono::high_resolution_clock::now();
+
+    // Sparse remainder: spmm_baseline's loop over nnz-balanced panels
+    const int num_panels = static_cast<int>(panel_bounds_.size()) - 1;
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int p = 0; p < num_panels; p++) {
+        for (int i = panel_bounds_[p]; i < panel_bounds_[p + 1]; i++) {
+            float* y = Y.data + static_cast<size_t>(i) * K;
+            for (int j = 0; j < K; j++) y[j] = 0.0f;
+            for (int idx = sparse_.indptr[i]; idx < sparse_.indptr[i + 1]; idx++) {
+                int k = sparse_.indices[idx];
+                float x_val = sparse_.data[idx];
+                for (int j = 0; j < K; j++) {
+                    y[j] += x_val * W[static_cast<size_t>(k) * K + j];
+                }
+            }
+        }
+    }
+    double sparse_ms = ms_since(start);
+
+    // Dense tiles: one band (tile row) per task, so no two threads add into the same Y rows
+    auto t_dense = chrono::high_resolution_clock::now();
+    const int num_bands = static_cast<int>(band_bounds_.size()) - 1;
+    if (!dense_tiles_.empty()) {
+        // Tiles keep their column order, so their rows of W are contiguous in W (no gather)
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int b = 0; b < num_bands; b++) {
+            for (int t = band_bounds_[b]; t < band_bounds_[b + 1]; t++) {
+                const PlanDenseTile& d = dense_tiles_[t];
+                const float* block = dense_values_.data() + d.offset;
+                const float* W_tile = W.data() + static_cast<size_t>(d.col_start) * K;
+                for (int i = 0; i < d.rows; i++) {
+                    float* y = Y.data + static_cast<size_t>(d.row_start + i) * K;
+                    for (int k = 0; k < d.cols; k++) {
+                        float x_val = block[static_cast<size_t>(i) * d.cols + k];
+                        if (x_val == 0.0f) continue;
+                        const float* w = W_tile + static_cast<size_t>(k) * K;
+                        for (int j = 0; j < K; j++) y[j] += x_val * w[j];
+                    }
+                }
+            }
+        }
+    }
+    double dense_ms = ms_since(t_dense);
+
+    auto t_heavy = chrono::high_resolution_clock::now();
+    spmm_heavy_rows_into(heavy_, W, W_cols, Y);
+    double heavy_ms = ms_since(t_heavy);
+
+    if (stats != nullptr) {
+        stats->sparse_ms = sparse_ms;
+        stats->dense_ms = dense_ms;
+        stats->heavy_ms = heavy_ms;
+        stats->total_ms = ms_since(start);
+    }
+}
+
+vector<float> SpmmPlan::execute(const vector<float>& W, int W_rows, int W_cols, SpmmPlanExecStats* stats) const {
+    vector<float> Y = make_huge_page_vector<float>(static_cast<size_t>(nrows_) * W_cols);
+    execute_into(W, W_rows, W_cols, Y, stats);
+    return Y;
+}
+
+double SpmmPlan::break_even_runs(double unplanned_ms, double planned_ms) const {
+    double saving = unplanned_ms - planned_ms;
+    if (saving <= 0.0) return numeric_limits<double>::infinity();
+    return info_.inspect_ms / saving;
+}
@@ -0,0 +1,302 @@
+#include "../include/spmm_server.hpp"
+#include "../include/spmm.hpp"
+#include "../include/disk_to_memory.hpp"
+#include "../include/incremental_spmm.hpp"
+#include "../include/logger.hpp"
+#include <stdexcept>
+#include <random>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace std::chrono;
+
+vector<float> procedural_W(int rows, int K, unsigned seed) {
+    vector<float> W(static_cast<size_t>(rows) * K);
+    mt19937 rng(seed);
+    normal_distribution<float> dist(0.0f, 1.0f);
+    for (auto& w : W) w = dist(rng);
+    return W;
+}
+
+static double ms_between(high_resolution_clock::time_point a, high_resolution_clock::time_point b) {
+    return duration_cast<microseconds>(b - a).count() / 1000.0;
+}
+
+SpmmServer::SpmmServer(CSR X, const SpmmServerConfig& cfg)
+    : X_(std::move(X)), cfg_(cfg) {}
+
+SpmmServer::~SpmmServer() {
+    if (listen_fd_ >= 0) close(listen_fd_);
+}
+
+void SpmmServer::run() {
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        throw runtime_error(string("socket() failed: ") + strerror(errno));
+    }
+
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (cfg_.socket_path.size() >= sizeof(addr.sun_path)) {
+        throw runtime_error("Socket path too long: " + cfg_.socket_path);
+    }
+    strncpy(addr.sun_path, cfg_.socket_path.c_str(), sizeof(addr.sun_path) - 1);
+    unlink(cfg_.socket_path.c_str());
+
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        throw runtime_error("bind(" + cfg_.socket_path + ") failed: " + strerror(errno));
+    }
+    if (listen(listen_fd_, 64) < 0) {
+        throw runtime_error(string("listen() failed: ") + strerror(errno));
+    }
+
+    thread batcher(&SpmmServer::batch_loop, this);
+
+    while (!stopping_) {
+        int fd = accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) {
+            if (stopping_) break;
+            if (errno == EINTR) continue;
+            cerr << "[spmm_server] accept() failed: " << strerror(errno) << endl;
+            break;
+        }
+        lock_guard<mutex> lock(clients_mutex_);
+        client_fds_.insert(fd);
+        active_handlers_++;
+        thread(&SpmmServer::handle_connection, this, fd).detach();
+    }
+
+    // Wake the batcher and unblock handlers still reading from open connections.
+    // Set under queue_mutex_ so the batcher cannot miss the wakeup
+    {
+        lock_guard<mutex> lock(queue_mutex_);
+        stopping_ = true;
+    }
+    queue_cv_.notify_all();
+    batcher.join();
+    {
+        unique_lock<mutex> lock(clients_mutex_);
+        for (int fd : client_fds_) shutdown(fd, SHUT_RDWR);
+        handlers_cv_.wait(lock, [&] { return active_handlers_ == 0; });
+    }
+
+    close(listen_fd_);
+    listen_fd_ = -1;
+    unlink(cfg_.socket_path.c_str());
+}
+
+void SpmmServer::handle_connection(int fd) {
+    string buffer;
+    char chunk[4096];
+    bool open = true;
+
+    while (open) {
+        ssize_t n = read(fd, chunk, sizeof(chunk));
+        if (n <= 0) break;
+        buffer.append(chunk, n);
+
+        size_t pos;
+        while ((pos = buffer.find('\n')) != string::npos) {
+            string line = buffer.substr(0, pos);
+            buffer.erase(0, pos + 1);
+            string reply = handle_request(line) + "\n";
+            if (write(fd, reply.data(), reply.size()) != static_cast<ssize_t>(reply.size())) {
+                open = false;
+                break;
+            }
+            if (line == "SHUTDOWN") {
+                // Stop accepting: closing the listening socket breaks accept()
+                stopping_ = true;
+                shutdown(listen_fd_, SHUT_RDWR);
+                open = false;
+                break;
+            }
+        }
+    }
+
+    close(fd);
+    // Last touch of the server: run() may return as soon as the count reaches zero
+    lock_guard<mutex> lock(clients_mutex_);
+    client_fds_.erase(fd);
+    active_handlers_--;
+    handlers_cv_.notify_all();
+}
+
+string SpmmServer::handle_request(const string& line) {
+    istringstream in(line);
+    string cmd;
+    in >> cmd;
+
+    if (cmd == "PING") return "OK pong";
+    if (cmd == "SHUTDOWN") return "OK bye";
+    if (cmd == "STATS") {
+        lock_guard<mutex> lock(queue_mutex_);
+        ostringstream out;
+        out << fixed << setprecision(3) << "OK requests=" << total_requests_ << " batches=" << total_batches_
+            << " avg_batch=" << (total_batches_ ? static_cast<double>(total_requests_) / total_batches_ : 0.0)
+            << " compute_ms=" << total_compute_ms_;
+        return out.str();
+    }
+    if (cmd != "PROJECT") return "ERR unknown command '" + cmd + "'";
+
+    auto job = make_unique<Job>();
+    if (!(in >> job->w_spec >> job->output_path)) {
+        return "ERR usage: PROJECT <file:W.h5|seed:<seed>:<K>> <output_path|none>";
+    }
+    job->enqueued = high_resolution_clock::now();
+    future<string> result = job->response.get_future();
+    {
+        // Checked under the lock: once the batcher has seen stopping_ here, nothing more is queued
+        lock_guard<mutex> lock(queue_mutex_);
+        if (stopping_) return "ERR server shutting down";
+        queue_.push_back(std::move(job));
+    }
+    queue_cv_.notify_one();
+    return result.get();
+}
+
+void SpmmServer::batch_loop() {
+    while (true) {
+        vector<unique_ptr<Job>> batch;
+        {
+            unique_lock<mutex> lock(queue_mutex_);
+            queue_cv_.wait(lock, [&] { return stopping_ || !queue_.empty(); });
+            if (stopping_) break;
+
+            // Give concurrent requests a short window to join this pass
+            auto deadline = queue_.front()->enqueued + microseconds(static_cast<long long>(cfg_.batch_window_ms * 1000));
+            queue_cv_.wait_until(lock, deadline, [&] {
+                return stopping_ || static_cast<int>(queue_.size()) >= cfg_.max_batch;
+            });
+            if (stopping_) break;
+
+            while (!queue_.empty() && static_cast<int>(batch.size()) < cfg_.max_batch) {
+                batch.push_back(std::move(queue_.front()));
+                queue_.pop_front();
+            }
+        }
+        process_batch(batch);
+    }
+
+    // Fail everything still queued; handle_request queues nothing once stopping_ is set
+    lock_guard<mutex> lock(queue_mutex_);
+    for (auto& job : queue_) job->response.set_value("ERR server shutting down");
+    queue_.clear();
+}
+
+void SpmmServer::process_batch(vector<unique_ptr<Job>>& batch) {
+    auto start = high_resolution_clock::now();
+
+    // Resolve W for each job (HDF5 I/O stays on this thread)
+    vector<vector<float>> Ws(batch.size());
+    vector<int> Ks(batch.size(), 0);
+    vector<string> errors(batch.size());
+    for (size_t b = 0; b < batch.size(); b++) {
+        try {
+            const string& spec = batch[b]->w_spec;
+            if (spec.rfind("file:", 0) == 0) {
+                int rows, K;
+                Ws[b] = load_W_h5(spec.substr(5), rows, K, "");
+                if (rows != X_.ncols) {
+                    throw runtime_error("Matrix dimension mismatch: X.ncols=" + to_string(X_.ncols)
+                                       + " != W.nrows=" + to_string(rows));
+                }
+                Ks[b] = K;
+            } else if (spec.rfind("seed:", 0) == 0) {
+                size_t colon = spec.find(':', 5);
+                if (colon == string::npos) throw runtime_error("bad w_spec '" + spec + "'");
+                unsigned seed = static_cast<unsigned>(stoul(spec.substr(5, colon - 5)));
+                int K = stoi(spec.substr(colon + 1));
+                if (K <= 0) throw runtime_error("K must be positive");
+                Ws[b] = procedural_W(X_.ncols, K, seed);
+                Ks[b] = K;
+            } else {
+                throw runtime_error("bad w_spec '" + spec + "' (expected file:<path> or seed:<seed>:<K>)");
+            }
+        } catch (const exception& e) {
+            errors[b] = e.what();
+            Ks[b] = 0;
+        }
+    }
+
+    // Concatenate valid W column-wise: W_cat = [W_1 | W_2 | ...]
+    vector<int> offsets(batch.size(), 0);
+    int total_K = 0;
+    for (size_t b = 0; b < batch.size(); b++) {
+        offsets[b] = total_K;
+        total_K += Ks[b];
+    }
+
+    // W_cat / Y_cat are members: they only reallocate when a batch is wider than any before
+    auto t_loaded = high_resolution_clock::now();
+    vector<float>& W_cat = batch_W_;
+    vector<float>& Y_cat = batch_Y_;
+    if (total_K > 0) {
+        W_cat.resize(static_cast<size_t>(X_.ncols) * total_K);
+        #pragma omp parallel for schedule(static)
+        for (int r = 0; r < X_.ncols; r++) {
+            for (size_t b = 0; b < batch.size(); b++) {
+                if (Ks[b] == 0) continue;
+                copy(Ws[b].begin() + static_cast<size_t>(r) * Ks[b],
+                     Ws[b].begin() + static_cast<size_t>(r + 1) * Ks[b],
+                     W_cat.begin() + static_cast<size_t>(r) * total_K + offsets[b]);
+            }
+        }
+        size_t y_size = static_cast<size_t>(X_.nrows) * total_K;
+        if (Y_cat.size() < y_size) Y_cat.resize(y_size);
+        spmm_baseline_into(X_, W_cat, X_.ncols, total_K, Span<float>(Y_cat.data(), y_size));
+    }
+    auto t_computed = high_resolution_clock::now();
+    double compute_ms = ms_between(t_loaded, t_computed);
+
+    // Split Y per request, store, respond
+    for (size_t b = 0; b < batch.size(); b++) {
+        Job& job = *batch[b];
+        if (!errors[b].empty()) {
+            job.response.set_value("ERR " + errors[b]);
+            continue;
+        }
+        try {
+            if (job.output_path != "none") {
+                vector<float> Y(static_cast<size_t>(X_.nrows) * Ks[b]);
+                for (int i = 0; i < X_.nrows; i++) {
+                    copy(Y_cat.begin() + static_cast<size_t>(i) * total_K + offsets[b],
+                         Y_cat.begin() + static_cast<size_t>(i) * total_K + offsets[b] + Ks[b],
+                         Y.begin() + static_cast<size_t>(i) * Ks[b]);
+                }
+                write_Y_h5(Y, X_.nrows, Ks[b], job.output_path);
+            }
+            ostringstream out;
+            out << fixed << setprecision(3) << "OK " << ms_between(job.enqueued, start) << " "
+                << compute_ms << " " << batch.size();
+            job.response.set_value(out.str());
+        } catch (const exception& e) {
+            job.response.set_value(string("ERR ") + e.what());
+        }
+    }
+    auto end = high_resolution_clock::now();
+
+    {
+        lock_guard<mutex> lock(queue_mutex_);
+        total_requests_ += batch.size();
+        total_batches_++;
+        total_compute_ms_ += compute_ms;
+    }
+
+    if (!cfg_.log_annotation.empty()) {
+        stringstream ss;
+        ss << fixed << setprecision(3);
+        ss << "service batch: " << batch.size() << " requests, total K: " << total_K
+           << ", W load: " << ms_between(start, t_loaded) << "ms, compute: " << compute_ms
+           << "ms, store: " << ms_between(t_computed, end) << "ms" << endl;
+        log_to_file_experiment(cfg_.log_annotation, "service", ss.str());
+    }
+}
@@ -0,0 +1,73 @@
+#include "../include/disk_to_memory.hpp"
+#include "../include/spmm_server.hpp"
+#include "../include/csr.hpp"
+#include "../include/logger.hpp"
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+
+using namespace std;
+
+/**
+ * Extract postfix from filename (e.g., "d0.h5" -> "0")
+ */
+string extract_postfix(const string& filename) {
+    string name = filename;
+    size_t dot_pos = name.find_last_of('.');
+    if (dot_pos != string::npos) {
+        name = name.substr(0, dot_pos);
+    }
+    if (name.length() > 1) {
+        return name.substr(1);
+    }
+    return "0";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 5) {
+        cerr << "Usage: " << argv[0] << " <X_file.h5> [socket_path] [max_batch] [batch_window_ms]" << endl;
+        cerr << "Example: " << argv[0] << " d4.h5 /tmp/scrna_spmm.sock 8 2" << endl;
+        return 1;
+    }
+    string x_filename = argv[1];
+
+    try {
+        string x_path = "../dataset/X/" + x_filename;
+        string postfix = extract_postfix(x_filename);
+        const string experiment = "service";
+
+        SpmmServerConfig cfg;
+        if (argc >= 3) cfg.socket_path = argv[2];
+        if (argc >= 4) cfg.max_batch = stoi(argv[3]);
+        if (argc >= 5) cfg.batch_window_ms = stod(argv[4]);
+        cfg.log_annotation = postfix;
+
+        reset_log_experiment(postfix, experiment);
+
+        // X is loaded (and transposed to CSR) once for the lifetime of the server
+        auto start = chrono::high_resolution_clock::now();
+        CSR X = load_X_h5_as_csr(x_path, "");
+        auto end = chrono::high_resolution_clock::now();
+        double load_ms = chrono::duration_cast<chrono::microseconds>(end - start).count() / 1000.0;
+
+        stringstream ss;
+        ss << "rows_X: " << X.nrows << ", cols_X: " << X.ncols << ", nnz_X: " << X.nnz << endl;
+        ss << fixed << setprecision(3) << "service X load time: " << load_ms << "ms" << endl;
+        ss << "service socket: " << cfg.socket_path << ", max batch: " << cfg.max_batch
+           << ", batch window: " << cfg.batch_window_ms << "ms" << endl;
+        log_to_file_experiment(postfix, experiment, ss.str());
+
+        SpmmServer server(std::move(X), cfg);
+        cout << "[spmm_server] listening on " << cfg.socket_path << endl;
+        server.run();
+        cout << "[spmm_server] stopped" << endl;
+
+        return 0;
+
+    } catch (const exception& e) {
+        cerr << "  ✗ Error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,245 @@
+#include "../include/spmm_transpose.hpp"
+#include "../include/spmm.hpp"
+#include "../include/logger.hpp"
+#include "../config/hw_config.h"
+#include <stdexcept>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <omp.h>
+
+using namespace std;
+using namespace std::chrono;
+
+CSR transpose_csr(const CSR& X) {
+    CSR XT;
+    XT.nrows = X.ncols;
+    XT.ncols = X.nrows;
+    XT.nnz = X.nnz;
+    XT.indptr.assign(XT.nrows + 1, 0);
+    XT.indices.resize(X.nnz);
+    XT.data.resize(X.nnz);
+
+    int max_threads = omp_get_max_threads();
+    // offsets[t * ncols + c]: thread t's count (later: write offset) for output row c
+    vector<int> offsets(static_cast<size_t>(max_threads) * X.ncols, 0);
+
+    #pragma omp parallel
+    {
+        int tid = omp_get_thread_num();
+        int nt = omp_get_num_threads();
+
+        // Contiguous row ranges in thread order keep each output row sorted
+        int r0 = static_cast<int>(static_cast<long long>(X.nrows) * tid / nt);
+        int r1 = static_cast<int>(static_cast<long long>(X.nrows) * (tid + 1) / nt);
+        int* my = offsets.data() + static_cast<size_t>(tid) * X.ncols;
+
+        // Phase 1: per-thread histogram of column indices
+        for (int i = r0; i < r1; i++) {
+            for (int idx = X.indptr[i]; idx < X.indptr[i + 1]; idx++) {
+                my[X.indices[idx]]++;
+            }
+        }
+        #pragma omp barrier
+
+        // Phase 2: exclusive scan across threads per column
+        #pragma omp for schedule(static)
+        for (int c = 0; c < X.ncols; c++) {
+            int running = 0;
+            for (int t = 0; t < nt; t++) {
+                int cnt = offsets[static_cast<size_t>(t) * X.ncols + c];
+                offsets[static_cast<size_t>(t) * X.ncols + c] = running;
+                running += cnt;
+            }
+            XT.indptr[c + 1] = running;
+        }
+
+        #pragma omp single
+        {
+            for (int c = 0; c < X.ncols; c++) {
+                XT.indptr[c + 1] += XT.indptr[c];
+            }
+        }
+
+        // Phase 3: scatter
+        for (int i = r0; i < r1; i++) {
+            for (int idx = X.indptr[i]; idx < X.indptr[i + 1]; idx++) {
+                int c = X.indices[idx];
+                int dest = XT.indptr[c] + my[c]++;
+                XT.indices[dest] = i;
+                XT.data[dest] = X.data[idx];
+            }
+        }
+    }
+
+    return XT;
+}
+
+uint64_t csr_content_checksum(const CSR& X) {
+    // FNV-1a over 32-bit words, per fixed-size chunk of nonzeros so the chunks hash in
+    // parallel and the result does not depend on the thread count
+    const uint64_t prime = 0x100000001b3ULL;
+    const uint64_t basis = 0xcbf29ce484222325ULL;
+    const size_t chunk = size_t(1) << 16;
+    const long long num_chunks = static_cast<long long>((X.nnz + chunk - 1) / chunk);
+    vector<uint64_t> chunk_h(num_chunks);
+    #pragma omp parallel for schedule(static)
+    for (long long c = 0; c < num_chunks; c++) {
+        uint64_t h = basis;
+        size_t end = min(X.nnz, static_cast<size_t>(c + 1) * chunk);
+        for (size_t idx = static_cast<size_t>(c) * chunk; idx < end; idx++) {
+            uint32_t bits;
+            memcpy(&bits, &X.data[idx], sizeof(bits));
+            h = (h ^ static_cast<uint32_t>(X.indices[idx])) * prime;
+            h = (h ^ bits) * prime;
+        }
+        chunk_h[c] = h;
+    }
+
+    uint64_t h = basis;
+    h = (h ^ static_cast<uint32_t>(X.nrows)) * prime;
+    h = (h ^ static_cast<uint32_t>(X.ncols)) * prime;
+    h = (h ^ static_cast<uint64_t>(X.nnz)) * prime;
+    for (int i = 0; i <= X.nrows; i++) h = (h ^ static_cast<uint32_t>(X.indptr[i])) * prime;
+    for (uint64_t ch : chunk_h) h = (h ^ ch) * prime;
+    return h;
+}
+
+bool transpose_cache_matches(const TransposeCache& cache, const CSR& X) {
+    return cache.built && cache.source_nrows == X.nrows && cache.source_ncols == X.ncols
+        && cache.source_nnz == X.nnz && cache.source_checksum == csr_content_checksum(X);
+}
+
+TransposeStrategy select_transpose_strategy(const CSR& X, int M_cols, int num_threads,
+                                            const TransposeCache* cache) {
+    if (cache != nullptr && transpose_cache_matches(*cache, X)) {
+        return TransposeStrategy::CachedTranspose;
+    }
+    if (num_threads <= 1) {
+        return TransposeStrategy::PrivateBuffers;  // single buffer is the output, no reduction
+    }
+
+    size_t private_bytes = static_cast<size_t>(num_threads) * X.ncols * M_cols * sizeof(float);
+    if (private_bytes > hw_config::TRANSPOSE_PRIVATE_BUFFER_BYTES) {
+        return TransposeStrategy::CachedTranspose;
+    }
+
+    // The reduction touches threads * ncols rows, the scatter touches nnz rows
+    if (static_cast<size_t>(num_threads) * X.ncols > X.nnz / 2) {
+        return TransposeStrategy::CachedTranspose;
+    }
+
+    return TransposeStrategy::PrivateBuffers;
+}
+
+/*
+  Thread-private scatter into ncols x M_cols buffers, then a parallel reduction
+  over the output (each thread sums one slice across all buffers).
+ */
+static vector<float> spmm_transpose_private(const CSR& X, const vector<float>& M, int M_cols) {
+    size_t out_size = static_cast<size_t>(X.ncols) * M_cols;
+    vector<float> Z(out_size, 0.0f);
+
+    int max_threads = omp_get_max_threads();
+    if (max_threads == 1) {
+        for (int i = 0; i < X.nrows; i++) {
+            const float* m_row = M.data() + static_cast<size_t>(i) * M_cols;
+            for (int idx = X.indptr[i]; idx < X.indptr[i + 1]; idx++) {
+                float x_val = X.data[idx];
+                float* z_row = Z.data() + static_cast<size_t>(X.indices[idx]) * M_cols;
+                for (int j = 0; j < M_cols; j++) {
+                    z_row[j] += x_val * m_row[j];
+                }
+            }
+        }
+        return Z;
+    }
+
+    vector<float> buffers(static_cast<size_t>(max_threads) * out_size);
+
+    #pragma omp parallel
+    {
+        int tid = omp_get_thread_num();
+        int nt = omp_get_num_threads();
+        float* local = buffers.data() + static_cast<size_t>(tid) * out_size;
+        fill(local, local + out_size, 0.0f);
+
+        #pragma omp for schedule(static)
+        for (int i = 0; i < X.nrows; i++) {
+            const float* m_row = M.data() + static_cast<size_t>(i) * M_cols;
+            for (int idx = X.indptr[i]; idx < X.indptr[i + 1]; idx++) {
+                float x_val = X.data[idx];
+                float* z_row = local + static_cast<size_t>(X.indices[idx]) * M_cols;
+                for (int j = 0; j < M_cols; j++) {
+                    z_row[j] += x_val * m_row[j];
+                }
+            }
+        }
+
+        #pragma omp for schedule(static)
+        for (long long t = 0; t < static_cast<long long>(out_size); t++) {
+            float s = 0.0f;
+            for (int b = 0; b < nt; b++) {
+                s += buffers[static_cast<size_t>(b) * out_size + t];
+            }
+            Z[t] = s;
+        }
+    }
+
+    return Z;
+}
+
+vector<float> spmm_transpose(const CSR& X, const vector<float>& M, int M_rows, int M_cols,
+                             TransposeStrategy strategy, TransposeCache* cache, const string& log_annotation) {
+    if (X.nrows != M_rows) {
+        throw runtime_error("Matrix dimension mismatch: X.nrows=" + to_string(X.nrows)
+                           + " != M.nrows=" + to_string(M_rows));
+    }
+
+    int num_threads = omp_get_max_threads();
+    // Checked once here, so Auto does not scan X a second time
+    bool cache_hit = cache != nullptr && transpose_cache_matches(*cache, X);
+    if (strategy == TransposeStrategy::Auto) {
+        strategy = cache_hit ? TransposeStrategy::CachedTranspose
+                             : select_transpose_strategy(X, M_cols, num_threads, nullptr);
+    }
+
+    auto start = high_resolution_clock::now();
+    vector<float> Z;
+    double build_ms = 0.0;
+
+    if (strategy == TransposeStrategy::PrivateBuffers) {
+        Z = spmm_transpose_private(X, M, M_cols);
+    } else {
+        TransposeCache local_cache;
+        TransposeCache* c = cache ? cache : &local_cache;
+        if (!cache_hit) {
+            auto t0 = high_resolution_clock::now();
+            c->XT = transpose_csr(X);
+            c->source_nrows = X.nrows;
+            c->source_ncols = X.ncols;
+            c->source_nnz = X.nnz;
+            c->source_checksum = csr_content_checksum(X);
+            c->built = true;
+            c->build_ms = duration_cast<microseconds>(high_resolution_clock::now() - t0).count() / 1000.0;
+            build_ms = c->build_ms;
+        }
+        Z = spmm_baseline(c->XT, M, M_rows, M_cols);
+    }
+
+    if (!log_annotation.empty()) {
+        double total_ms = duration_cast<microseconds>(high_resolution_clock::now() - start).count() / 1000.0;
+        stringstream ss;
+        ss << "spmmT strategy: "
+           << (strategy == TransposeStrategy::PrivateBuffers ? "private_buffers" : "cached_transpose")
+           << ", threads: " << num_threads << ", M_cols: " << M_cols << endl;
+        ss << fixed << setprecision(3);
+        if (build_ms > 0.0) ss << "spmmT transpose build time: " << build_ms << "ms" << endl;
+        ss << "spmmT compute time: " << total_ms << "ms" << endl;
+        log_to_file_experiment(log_annotation, "spmmT", ss.str());
+    }
+
+    return Z;
+}
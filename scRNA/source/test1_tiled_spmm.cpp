@@ -3,6 +3,7 @@
 #include "../include/spmm.hpp"
 #include "../include/csr.hpp"
 #include "../include/logger.hpp"
+#include "../include/y_writer.hpp"
 #include <H5Cpp.h>
 #include <iostream>
 #include <vector>
@@ -56,17 +57,6 @@ vector<float> load_Y_h5(const string& y_h5_path, int& nrows, int& ncols) {
 }
 
 
-void silent_save_Y(const vector<float>& Y, int rows, int cols, const string& path) {
-    try {
-        fs::create_directories(fs::path(path).parent_path());
-        H5File file(path, H5F_ACC_TRUNC);
-        hsize_t dims[2] = {static_cast<hsize_t>(rows), static_cast<hsize_t>(cols)};
-        DataSpace dataspace(2, dims);
-        DataSet dataset = file.createDataSet("Y", PredType::NATIVE_FLOAT, dataspace);
-        dataset.write(Y.data(), PredType::NATIVE_FLOAT);
-    } catch (...) {}
-}
-
 
 void compare_results(const vector<float>& Y_tiled, const vector<float>& Y_baseline, 
                     int rows, int cols, const string& test_name) {
@@ -201,7 +191,7 @@ int main(int argc, char* argv[]) {
         log_spmm_metrics(log_annotation, duration_ms, X.nnz, static_cast<double>(flops), static_cast<double>(total_bytes));
         
         
-        silent_save_Y(Y_tiled, X.nrows, w_cols, y_tile_path);
+        try_save_Y_h5(Y_tiled, X.nrows, w_cols, y_tile_path);
         cout << "Saved result to: " << y_tile_path << endl;
         
         // Compare results
@@ -4,6 +4,7 @@
 #include "../include/spmm.hpp"
 #include "../include/csr.hpp"
 #include "../include/logger.hpp"
+#include "../include/y_writer.hpp"
 #include <H5Cpp.h>
 #include <iostream>
 #include <vector>
@@ -54,17 +55,6 @@ vector<float> load_Y_h5(const string& y_h5_path, int& nrows, int& ncols) {
     return Y_data;
 }
 
-void silent_save_Y(const vector<float>& Y, int rows, int cols, const string& path) {
-    try {
-        fs::create_directories(fs::path(path).parent_path());
-        H5File file(path, H5F_ACC_TRUNC);
-        hsize_t dims[2] = {static_cast<hsize_t>(rows), static_cast<hsize_t>(cols)};
-        DataSpace dataspace(2, dims);
-        DataSet dataset = file.createDataSet("Y", PredType::NATIVE_FLOAT, dataspace);
-        dataset.write(Y.data(), PredType::NATIVE_FLOAT);
-    } catch (...) {}
-}
-
 
 void compare_results(const vector<float>& Y_perm_tiled, const vector<float>& Y_baseline, 
                     int rows, int cols, const string& test_name) {
@@ -351,7 +341,7 @@ int main(int argc, char* argv[]) {
         }
         
         // Save result to y{postfix}_perm_tiled.h5
-        silent_save_Y(Y_perm_tiled, X.nrows, w_cols, y_perm_tiled_path);
+        try_save_Y_h5(Y_perm_tiled, X.nrows, w_cols, y_perm_tiled_path);
         cout << "Saved result to: " << y_perm_tiled_path << endl;
         
         // Step 8: Compare Y_perm_tiled against baseline Y (from run0.exe)
@@ -0,0 +1,137 @@
+#include "../include/sim_accelerator.hpp"
+#include "../include/tile_spmm.hpp"
+#include "../include/tiler.hpp"
+#include "../include/disk_to_memory.hpp"
+#include "../include/csr.hpp"
+#include "../include/logger.hpp"
+#include "../config/hw_config.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+
+using namespace std;
+
+/**
+ * Extract postfix from filename (e.g., "d0.h5" -> "0")
+ */
+string extract_postfix(const string& filename) {
+    string name = filename;
+    size_t dot_pos = name.find_last_of('.');
+    if (dot_pos != string::npos) {
+        name = name.substr(0, dot_pos);
+    }
+    if (name.length() > 1) {
+        return name.substr(1);
+    }
+    return "0";
+}
+
+double elapsed_ms(chrono::high_resolution_clock::time_point start) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count() / 1000.0;
+}
+
+/**
+ * Number of elements that differ from the reference bit for bit
+ */
+size_t count_mismatches(const vector<float>& a, const vector<float>& b) {
+    size_t n = 0;
+    for (size_t i = 0; i < b.size(); i++) {
+        if (a[i] != b[i]) n++;
+    }
+    return n;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc > 4) {
+        cerr << "Usage: " << argv[0] << " <X_file.h5> <W_file.h5> [streams]" << endl;
+        cerr << "Example: " << argv[0] << " d5.h5 w5.h5 2" << endl;
+        return 1;
+    }
+    string x_filename = argv[1];
+    string w_filename = argv[2];
+    int streams = argc >= 4 ? stoi(argv[3]) : 2;
+
+    try {
+        string x_path = "../dataset/X/" + x_filename;
+        string w_path = "../dataset/W/" + w_filename;
+        string postfix = extract_postfix(x_filename);
+        const string experiment = "accel";
+
+        reset_log_experiment(postfix, experiment);
+
+        CSR X = load_X_h5_as_csr(x_path, "");
+        int W_rows, W_cols;
+        vector<float> W = load_W_h5(w_path, W_rows, W_cols, "");
+        vector<Tile> tiles = make_2d_tiles(X, TilingConfig());
+
+        // CPU-only routing is the reference
+        auto start = chrono::high_resolution_clock::now();
+        vector<float> Y_ref = process_tiles_with_predictor(X, W, W_rows, W_cols, tiles, "");
+        double cpu_ms = elapsed_ms(start);
+
+        stringstream ss;
+        ss << fixed << setprecision(3);
+        ss << "rows_X: " << X.nrows << ", cols_X: " << X.ncols << ", nnz_X: " << X.nnz << ", K: " << W_cols
+           << ", tiles: " << tiles.size() << endl;
+        ss << "CPU only: " << cpu_ms << "ms" << endl;
+
+        SimAccelConfig fast;
+        fast.streams = streams;
+        SimAccelConfig slow_link = fast;
+        slow_link.h2d_gbps = 2.0;
+        slow_link.d2h_gbps = 2.0;
+        slow_link.transfer_latency_us = 50.0;
+
+        struct Policy {
+            string label;
+            const SimAccelConfig* device;
+            double threshold;
+            bool overlap;
+        };
+        const double dense = hw_config::DENSE_TILE_THRESHOLD;
+        vector<Policy> policies = {
+            {"dense, overlap", &fast, dense, true},
+            {"dense, serial", &fast, dense, false},
+            {"all tiles, overlap", &fast, 0.0, true},
+            {"density>=0.2, overlap", &fast, 0.2, true},
+            {"dense, slow link, overlap", &slow_link, dense, true},
+            {"dense, slow link, serial", &slow_link, dense, false},
+        };
+
+        ss << setw(27) << "policy" << setw(11) << "wall ms" << setw(8) << "jobs" << setw(10) << "h2d ms"
+           << setw(12) << "kernel ms" << setw(10) << "d2h ms" << setw(13) << "makespan ms" << setw(6) << "late"
+           << setw(10) << "mismatch" << endl;
+        for (const auto& policy : policies) {
+            SimulatedAccelerator device(*policy.device);
+            AccelRouting routing;
+            routing.backend = &device;
+            routing.threshold = policy.threshold;
+            routing.overlap = policy.overlap;
+
+            start = chrono::high_resolution_clock::now();
+            vector<float> Y = process_tiles_with_predictor(X, W, W_rows, W_cols, tiles, "", nullptr, &routing);
+            double wall_ms = elapsed_ms(start);
+            AccelStats st = device.stats();
+
+            ss << setw(27) << policy.label << setw(11) << wall_ms << setw(8) << st.jobs << setw(10) << st.h2d_ms
+               << setw(12) << st.compute_ms << setw(10) << st.d2h_ms << setw(13) << st.makespan_ms << setw(6)
+               << st.late_jobs << setw(10) << count_mismatches(Y, Y_ref) << endl;
+        }
+        ss << "device: " << SimulatedAccelerator(fast).name() << "; slow link: "
+           << SimulatedAccelerator(slow_link).name() << endl;
+        ss << "(mismatches are expected only for tiles below the dense threshold that the policy offloads)" << endl;
+
+        log_to_file_experiment(postfix, experiment, ss.str());
+        cout << ss.str();
+        cout << "spmm done" << endl;
+
+        return 0;
+
+    } catch (const exception& e) {
+        cerr << "  ✗ Error: " << e.what() << endl;
+        return 1;
+    }
+}
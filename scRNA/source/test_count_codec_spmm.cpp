@@ -0,0 +1,116 @@
+#include "../include/disk_to_memory.hpp"
+#include "../include/spmm.hpp"
+#include "../include/count_codec.hpp"
+#include "../include/csr.hpp"
+#include "../include/logger.hpp"
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <string>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <limits>
+
+using namespace std;
+
+/**
+ * Extract postfix from filename (e.g., "d0.h5" -> "0")
+ */
+string extract_postfix(const string& filename) {
+    string name = filename;
+    size_t dot_pos = name.find_last_of('.');
+    if (dot_pos != string::npos) {
+        name = name.substr(0, dot_pos);
+    }
+    if (name.length() > 1) {
+        return name.substr(1);
+    }
+    return "0";
+}
+
+/**
+ * Encode X with one codec, run SpMM on it and report bytes, time and exactness
+ */
+template <typename CodeT, typename IndexT>
+void run_codec(const string& name, const CSR& X, const vector<float>& W, int W_rows, int W_cols,
+               const vector<float>& Y_ref, double baseline_ms, stringstream& ss) {
+    if (static_cast<long long>(X.ncols) - 1 > static_cast<long long>(numeric_limits<IndexT>::max())) {
+        ss << name << ": skipped (ncols does not fit narrow indices)" << endl;
+        return;
+    }
+
+    auto start = chrono::high_resolution_clock::now();
+    CountCSR<CodeT, IndexT> Xc = encode_counts<CodeT, IndexT>(X);
+    auto end = chrono::high_resolution_clock::now();
+    double encode_ms = chrono::duration_cast<chrono::microseconds>(end - start).count() / 1000.0;
+
+    start = chrono::high_resolution_clock::now();
+    vector<float> Y = spmm_counts(Xc, W, W_rows, W_cols);
+    end = chrono::high_resolution_clock::now();
+    double spmm_ms = chrono::duration_cast<chrono::microseconds>(end - start).count() / 1000.0;
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < Y.size(); i++) {
+        if (Y[i] != Y_ref[i]) mismatches++;
+    }
+
+    size_t bytes_ref = csr_bytes(X);
+    size_t bytes_enc = count_csr_bytes(Xc);
+    double escape_frac = Xc.nnz > 0 ? static_cast<double>(Xc.escapes.size()) / Xc.nnz : 0.0;
+
+    ss << fixed << setprecision(3);
+    ss << name << " encode time: " << encode_ms << "ms" << endl;
+    ss << name << " X bytes: " << bytes_enc << " (fp32 CSR: " << bytes_ref << ", ratio: "
+       << setprecision(3) << static_cast<double>(bytes_enc) / bytes_ref << ")" << endl;
+    ss << name << " escapes: " << Xc.escapes.size() << " (" << setprecision(6) << escape_frac << " of nnz)" << endl;
+    ss << setprecision(3);
+    ss << name << " spmm compute time: " << spmm_ms << "ms (baseline: " << baseline_ms << "ms)" << endl;
+    ss << name << " mismatches vs baseline: " << mismatches << endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        cerr << "Usage: " << argv[0] << " <X_file.h5> <W_file.h5>" << endl;
+        cerr << "Example: " << argv[0] << " d5.h5 w5.h5" << endl;
+        return 1;
+    }
+    string x_filename = argv[1];
+    string w_filename = argv[2];
+
+    try {
+        string x_path = "../dataset/X/" + x_filename;
+        string w_path = "../dataset/W/" + w_filename;
+        string postfix = extract_postfix(x_filename);
+        const string experiment = "countcodec";
+
+        reset_log_experiment(postfix, experiment);
+
+        CSR X = load_X_h5_as_csr(x_path, "");
+        int W_rows, W_cols;
+        vector<float> W = load_W_h5(w_path, W_rows, W_cols, "");
+
+        stringstream ss;
+        ss << "rows_X: " << X.nrows << ", cols_X: " << X.ncols << ", nnz_X: " << X.nnz << endl;
+
+        auto start = chrono::high_resolution_clock::now();
+        vector<float> Y_ref = spmm_baseline(X, W, W_rows, W_cols);
+        auto end = chrono::high_resolution_clock::now();
+        double baseline_ms = chrono::duration_cast<chrono::microseconds>(end - start).count() / 1000.0;
+
+        run_codec<uint8_t,  int>     ("u8",      X, W, W_rows, W_cols, Y_ref, baseline_ms, ss);
+        run_codec<uint16_t, int>     ("u16",     X, W, W_rows, W_cols, Y_ref, baseline_ms, ss);
+        run_codec<uint8_t,  uint16_t>("u8+idx16",  X, W, W_rows, W_cols, Y_ref, baseline_ms, ss);
+        run_codec<uint16_t, uint16_t>("u16+idx16", X, W, W_rows, W_cols, Y_ref, baseline_ms, ss);
+
+        log_to_file_experiment(postfix, experiment, ss.str());
+        cout << ss.str();
+        cout << "spmm done" << endl;
+
+        return 0;
+
+    } catch (const exception& e) {
+        cerr << "  ✗ Error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,127 @@
+#include "../include/dist_spmm.hpp"
+#include "../include/communicator.hpp"
+#include "../include/disk_to_memory.hpp"
+#include "../include/spmm.hpp"
+#include "../include/csr.hpp"
+#include "../include/logger.hpp"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <iomanip>
+#include <sstream>
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * Extract postfix from filename (e.g., "d0.h5" -> "0")
+ */
+string extract_postfix(const string& filename) {
+    string name = filename;
+    size_t dot_pos = name.find_last_of('.');
+    if (dot_pos != string::npos) {
+        name = name.substr(0, dot_pos);
+    }
+    if (name.length() > 1) {
+        return name.substr(1);
+    }
+    return "0";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc > 4) {
+        cerr << "Usage: " << argv[0] << " <X_file.h5> <W_file.h5> [ranks]" << endl;
+        cerr << "Example: " << argv[0] << " d5.h5 w5.h5 4" << endl;
+        return 1;
+    }
+    string x_filename = argv[1];
+    string w_filename = argv[2];
+    int ranks = argc >= 4 ? stoi(argv[3]) : 4;
+
+    try {
+        string x_path = "../dataset/X/" + x_filename;
+        string w_path = "../dataset/W/" + w_filename;
+        string postfix = extract_postfix(x_filename);
+        const string experiment = "dist";
+
+        reset_log_experiment(postfix, experiment);
+
+        CSR X = load_X_h5_as_csr(x_path, "");
+        int W_rows, W_cols;
+        vector<float> W = load_W_h5(w_path, W_rows, W_cols, "");
+        vector<float> Y_ref = spmm_baseline(X, W, W_rows, W_cols);
+        double max_abs = 0.0;
+        for (float v : Y_ref) max_abs = max(max_abs, static_cast<double>(fabs(v)));
+
+        stringstream ss;
+        ss << fixed << setprecision(3);
+        ss << "rows_X: " << X.nrows << ", cols_X: " << X.ncols << ", nnz_X: " << X.nnz << ", K: " << W_cols
+           << ", ranks: " << ranks << endl;
+        ss << left << setw(12) << "backend" << setw(6) << "part" << right << setw(8) << "grid"
+           << setw(12) << "total ms" << setw(14) << "spmm MB" << setw(14) << "scatter MB"
+           << setw(16) << "max compute ms" << setw(14) << "max comm ms" << setw(16) << "check" << endl;
+
+        for (int backend = 0; backend < 2; backend++) {
+            for (int part = 0; part < 2; part++) {
+                DistSpmmConfig cfg;
+                cfg.partition = part == 0 ? DistPartition::OneD : DistPartition::TwoD;
+                DistSpmmStats stats;
+                vector<float> Y;
+                auto rank_body = [&](Communicator& comm) {
+                    DistSpmmStats rank_stats;
+                    vector<float> Y_rank = dist_spmm(comm, X, W, W_rows, W_cols, cfg, &rank_stats, postfix);
+                    if (comm.rank() == 0) {
+                        Y = std::move(Y_rank);
+                        stats = rank_stats;
+                    }
+                };
+                if (backend == 0) {
+                    run_thread_ranks(ranks, rank_body);
+                } else {
+                    run_process_ranks(ranks, rank_body);
+                }
+
+                // 1D keeps spmm_baseline's order per row; 2D adds partial sums across grid columns
+                string check;
+                if (Y.size() != Y_ref.size()) {
+                    check = "size mismatch";
+                } else if (part == 0) {
+                    size_t mismatches = 0;
+                    for (size_t i = 0; i < Y_ref.size(); i++) {
+                        if (Y[i] != Y_ref[i]) mismatches++;
+                    }
+                    check = to_string(mismatches) + " diff";
+                } else {
+                    double max_diff = 0.0;
+                    for (size_t i = 0; i < Y_ref.size(); i++) {
+                        max_diff = max(max_diff, fabs(static_cast<double>(Y[i]) - Y_ref[i]));
+                    }
+                    stringstream rel;
+                    rel << scientific << setprecision(1) << (max_abs > 0.0 ? max_diff / max_abs : max_diff) << " rel";
+                    check = rel.str();
+                }
+                double max_compute = 0.0, max_comm = 0.0;
+                for (const auto& s : stats.ranks) {
+                    max_compute = max(max_compute, s.compute_ms);
+                    max_comm = max(max_comm, s.comm_ms);
+                }
+                string grid = to_string(stats.grid_rows) + "x" + to_string(stats.grid_cols);
+                ss << left << setw(12) << (backend == 0 ? "threads" : "processes") << setw(6) << (part == 0 ? "1D" : "2D")
+                   << right << setw(8) << grid << setw(12) << stats.total_ms
+                   << setw(14) << stats.spmm_bytes / 1e6 << setw(14) << stats.scatter_bytes / 1e6
+                   << setw(16) << max_compute << setw(14) << max_comm << setw(16) << check << endl;
+            }
+        }
+
+        log_to_file_experiment(postfix, experiment, ss.str());
+        cout << ss.str();
+        cout << "spmm done" << endl;
+
+        return 0;
+
+    } catch (const exception& e) {
+        cerr << "  ✗ Error: " << e.what() << endl;
+        return 1;
+    }
+}
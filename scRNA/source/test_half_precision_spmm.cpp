@@ -0,0 +1,131 @@
+#include "../include/disk_to_memory.hpp"
+#include "../include/spmm.hpp"
+#include "../include/half_spmm.hpp"
+#include "../include/csr.hpp"
+#include "../include/logger.hpp"
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <string>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+
+using namespace std;
+
+/**
+ * Extract postfix from filename (e.g., "d0.h5" -> "0")
+ */
+string extract_postfix(const string& filename) {
+    string name = filename;
+    size_t dot_pos = name.find_last_of('.');
+    if (dot_pos != string::npos) {
+        name = name.substr(0, dot_pos);
+    }
+    if (name.length() > 1) {
+        return name.substr(1);
+    }
+    return "0";
+}
+
+/**
+ * Max absolute error and max error relative to max|Y_ref|
+ */
+pair<double, double> max_errors(const vector<float>& Y_ref, const vector<float>& Y) {
+    double max_abs = 0.0;
+    double max_ref = 0.0;
+    for (size_t i = 0; i < Y_ref.size(); i++) {
+        max_abs = max(max_abs, fabs(static_cast<double>(Y_ref[i]) - static_cast<double>(Y[i])));
+        max_ref = max(max_ref, fabs(static_cast<double>(Y_ref[i])));
+    }
+    double max_rel = (max_ref > 0.0) ? max_abs / max_ref : 0.0;
+    return make_pair(max_abs, max_rel);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        cerr << "Usage: " << argv[0] << " <X_file.h5> <W_file.h5>" << endl;
+        cerr << "Example: " << argv[0] << " d5.h5 w5.h5" << endl;
+        return 1;
+    }
+    string x_filename = argv[1];
+    string w_filename = argv[2];
+
+    try {
+        string x_path = "../dataset/X/" + x_filename;
+        string w_path = "../dataset/W/" + w_filename;
+        string postfix = extract_postfix(x_filename);
+        const string experiment = "halfprec";
+
+        reset_log_experiment(postfix, experiment);
+
+        CSR X = load_X_h5_as_csr(x_path, "");
+        int W_rows, W_cols;
+        vector<float> W = load_W_h5(w_path, W_rows, W_cols, "");
+
+        stringstream ss;
+        ss << "rows_X: " << X.nrows << ", cols_X: " << X.ncols << ", nnz_X: " << X.nnz << endl;
+        ss << "rows_W: " << W_rows << ", cols_W: " << W_cols << endl;
+
+        // fp32 reference
+        auto start = chrono::high_resolution_clock::now();
+        vector<float> Y_ref = spmm_baseline(X, W, W_rows, W_cols);
+        auto end = chrono::high_resolution_clock::now();
+        double fp32_ms = chrono::duration_cast<chrono::microseconds>(end - start).count() / 1000.0;
+
+        size_t bytes_X = X.nnz * (sizeof(float) + sizeof(int)) + (X.nrows + 1) * sizeof(int);
+        size_t bytes_Y = static_cast<size_t>(X.nrows) * W_cols * sizeof(float) * 2;
+
+        ss << fixed << setprecision(3);
+        ss << "fp32 spmm compute time: " << fp32_ms << "ms" << endl;
+
+        for (StoragePrecision p : {StoragePrecision::FP16, StoragePrecision::BF16}) {
+            string name = storage_precision_name(p);
+            HalfMatrix W_half = load_W_h5_half(w_path, p, "");
+
+            start = chrono::high_resolution_clock::now();
+            vector<float> Y = spmm_baseline_half(X, W_half);
+            end = chrono::high_resolution_clock::now();
+            double half_ms = chrono::duration_cast<chrono::microseconds>(end - start).count() / 1000.0;
+
+            HalfMatrix Y_half = spmm_baseline_half_Y(X, W_half, p);
+            vector<float> Y_half_f = half_matrix_to_float(Y_half);
+
+            auto err_w = max_errors(Y_ref, Y);
+            auto err_wy = max_errors(Y_ref, Y_half_f);
+
+            // W footprint and per-nonzero W row reads (the gather traffic)
+            size_t w_bytes_fp32 = static_cast<size_t>(W_rows) * W_cols * sizeof(float);
+            size_t w_bytes_half = static_cast<size_t>(W_rows) * W_cols * storage_bytes(p);
+            size_t gather_fp32 = X.nnz * W_cols * sizeof(float);
+            size_t gather_half = X.nnz * W_cols * storage_bytes(p);
+            size_t total_fp32 = bytes_X + w_bytes_fp32 + bytes_Y;
+            size_t total_half = bytes_X + w_bytes_half + bytes_Y;
+            size_t total_half_y = bytes_X + w_bytes_half + bytes_Y / 2;
+
+            ss << setprecision(3);
+            ss << name << " spmm compute time: " << half_ms << "ms (speedup "
+               << setprecision(2) << (half_ms > 0 ? fp32_ms / half_ms : 0.0) << "x)" << endl;
+            ss << name << " W bytes: " << w_bytes_half << " (fp32: " << w_bytes_fp32 << ")" << endl;
+            ss << name << " W gather bytes: " << gather_half << " (fp32: " << gather_fp32 << ", saved: "
+               << (gather_fp32 - gather_half) << ")" << endl;
+            ss << name << " spmm bytes: " << total_half << " (fp32: " << total_fp32 << ", saved: "
+               << (total_fp32 - total_half) << ")" << endl;
+            ss << name << " spmm bytes with " << name << " Y: " << total_half_y << endl;
+            ss << scientific << setprecision(3);
+            ss << name << " W max_abs_err: " << err_w.first << ", max_rel_err: " << err_w.second << endl;
+            ss << name << " W+Y max_abs_err: " << err_wy.first << ", max_rel_err: " << err_wy.second << endl;
+            ss << fixed;
+        }
+
+        log_to_file_experiment(postfix, experiment, ss.str());
+        cout << ss.str();
+        cout << "spmm done" << endl;
+
+        return 0;
+
+    } catch (const exception& e) {
+        cerr << "  ✗ Error: " << e.what() << endl;
+        return 1;
+    }
+}
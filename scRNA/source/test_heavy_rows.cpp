@@ -0,0 +1,136 @@
+#include "../include/heavy_row_spmm.hpp"
+#include "../include/disk_to_memory.hpp"
+#include "../include/spmm.hpp"
+#include "../include/csr.hpp"
+#include "../include/logger.hpp"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * Extract postfix from filename (e.g., "d0.h5" -> "0")
+ */
+string extract_postfix(const string& filename) {
+    string name = filename;
+    size_t dot_pos = name.find_last_of('.');
+    if (dot_pos != string::npos) {
+        name = name.substr(0, dot_pos);
+    }
+    if (name.length() > 1) {
+        return name.substr(1);
+    }
+    return "0";
+}
+
+double elapsed_ms(chrono::high_resolution_clock::time_point start) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count() / 1000.0;
+}
+
+/**
+ * Largest per-thread nnz over the mean under schedule(static) with num_threads threads
+ */
+double static_imbalance(const CSR& X, int num_threads) {
+    size_t max_nnz = 0;
+    for (int t = 0; t < num_threads; t++) {
+        int r0 = static_cast<int>(static_cast<long long>(X.nrows) * t / num_threads);
+        int r1 = static_cast<int>(static_cast<long long>(X.nrows) * (t + 1) / num_threads);
+        max_nnz = max(max_nnz, static_cast<size_t>(X.indptr[r1] - X.indptr[r0]));
+    }
+    return X.nnz > 0 ? static_cast<double>(max_nnz) * num_threads / X.nnz : 1.0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc > 4) {
+        cerr << "Usage: " << argv[0] << " <X_file.h5> <W_file.h5> [fraction]" << endl;
+        cerr << "Example: " << argv[0] << " d5.h5 w5.h5 0.3" << endl;
+        return 1;
+    }
+    string x_filename = argv[1];
+    string w_filename = argv[2];
+    double fraction = argc >= 4 ? stod(argv[3]) : hw_config::HEAVY_ROW_FRACTION;
+
+    try {
+        string x_path = "../dataset/X/" + x_filename;
+        string w_path = "../dataset/W/" + w_filename;
+        string postfix = extract_postfix(x_filename);
+        const string experiment = "heavy";
+
+        reset_log_experiment(postfix, experiment);
+
+        CSR X = load_X_h5_as_csr(x_path, "");
+        int W_rows, W_cols;
+        vector<float> W = load_W_h5(w_path, W_rows, W_cols, "");
+
+        int max_row_nnz = 0;
+        for (int i = 0; i < X.nrows; i++) max_row_nnz = max(max_row_nnz, X.indptr[i + 1] - X.indptr[i]);
+
+        HeavyRowSplit S = split_heavy_rows(X, fraction, postfix);
+
+        auto start = chrono::high_resolution_clock::now();
+        vector<float> Y_ref = spmm_baseline(X, W, W_rows, W_cols);
+        double baseline_ms = elapsed_ms(start);
+        TilingConfig tiling;
+        start = chrono::high_resolution_clock::now();
+        auto tiled = spmm_tiled(X, W, W_rows, W_cols, tiling);
+        double tiled_ms = elapsed_ms(start);
+
+        HeavyRowStats hybrid_stats, hybrid_tiled_stats;
+        start = chrono::high_resolution_clock::now();
+        vector<float> Y = spmm_heavy_split(S, W, W_rows, W_cols, nullptr, &hybrid_stats, postfix);
+        double hybrid_ms = elapsed_ms(start);
+        start = chrono::high_resolution_clock::now();
+        vector<float> Y_tiled = spmm_heavy_split(S, W, W_rows, W_cols, &tiling, &hybrid_tiled_stats);
+        double hybrid_tiled_ms = elapsed_ms(start);
+
+        // Sparse rows keep spmm_baseline's order; heavy rows are summed in another order
+        vector<char> is_heavy(X.nrows, 0);
+        for (int i : S.heavy_rows) is_heavy[i] = 1;
+        size_t sparse_mismatches = 0;
+        double max_diff = 0.0, max_abs = 0.0, max_diff_tiled = 0.0;
+        for (int i = 0; i < X.nrows; i++) {
+            for (int j = 0; j < W_cols; j++) {
+                size_t e = static_cast<size_t>(i) * W_cols + j;
+                max_abs = max(max_abs, static_cast<double>(fabs(Y_ref[e])));
+                if (!is_heavy[i] && Y[e] != Y_ref[e]) sparse_mismatches++;
+                max_diff = max(max_diff, fabs(static_cast<double>(Y[e]) - Y_ref[e]));
+                max_diff_tiled = max(max_diff_tiled, fabs(static_cast<double>(Y_tiled[e]) - tiled.first[e]));
+            }
+        }
+        if (max_abs == 0.0) max_abs = 1.0;
+
+        const int threads = hw_config::NUM_THREADS;
+        stringstream ss;
+        ss << fixed << setprecision(3);
+        ss << "rows_X: " << X.nrows << ", cols_X: " << X.ncols << ", nnz_X: " << X.nnz << ", K: " << W_cols << endl;
+        ss << "max row nnz: " << max_row_nnz << " (" << 100.0 * max_row_nnz / max(1, X.ncols) << "% of cells)"
+           << ", fraction " << fraction << " -> threshold " << S.threshold_nnz << " nnz" << endl;
+        ss << "heavy rows: " << S.heavy_rows.size() << ", heavy nnz: " << S.heavy_nnz << " ("
+           << 100.0 * S.heavy_nnz / max<size_t>(1, X.nnz) << "%), dense block "
+           << S.dense.size() * sizeof(float) / 1e6 << " MB, split " << S.split_ms << "ms" << endl;
+        ss << "static-schedule imbalance (" << threads << " threads): X " << static_imbalance(X, threads)
+           << ", sparse remainder " << static_imbalance(S.light, threads) << endl;
+        ss << "baseline: " << baseline_ms << "ms, hybrid: " << hybrid_ms << "ms (sparse "
+           << hybrid_stats.sparse_ms << "ms, dense " << hybrid_stats.dense_ms << "ms)" << endl;
+        ss << "tiled: " << tiled_ms << "ms, hybrid tiled: " << hybrid_tiled_ms << "ms (sparse "
+           << hybrid_tiled_stats.sparse_ms << "ms, dense " << hybrid_tiled_stats.dense_ms << "ms)" << endl;
+        ss << "sparse-row mismatches: " << sparse_mismatches << ", max rel diff vs baseline: "
+           << scientific << setprecision(1) << max_diff / max_abs << ", vs tiled: " << max_diff_tiled / max_abs << endl;
+
+        log_to_file_experiment(postfix, experiment, ss.str());
+        cout << ss.str();
+        cout << "spmm done" << endl;
+
+        return 0;
+
+    } catch (const exception& e) {
+        cerr << "  ✗ Error: " << e.what() << endl;
+        return 1;
+    }
+}
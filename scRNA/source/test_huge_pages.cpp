@@ -0,0 +1,139 @@
+#include "../include/disk_to_memory.hpp"
+#include "../include/spmm.hpp"
+#include "../include/huge_page_alloc.hpp"
+#include "../include/csr.hpp"
+#include "../include/logger.hpp"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cmath>
+#include <string>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * Extract postfix from filename (e.g., "d0.h5" -> "0")
+ */
+string extract_postfix(const string& filename) {
+    string name = filename;
+    size_t dot_pos = name.find_last_of('.');
+    if (dot_pos != string::npos) {
+        name = name.substr(0, dot_pos);
+    }
+    if (name.length() > 1) {
+        return name.substr(1);
+    }
+    return "0";
+}
+
+double elapsed_ms(chrono::high_resolution_clock::time_point start) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count() / 1000.0;
+}
+
+/**
+ * AnonHugePages of this process in kB (from /proc/self/smaps_rollup, -1 if unavailable).
+ */
+long long anon_huge_pages_kb() {
+    ifstream in("/proc/self/smaps_rollup");
+    string line;
+    while (getline(in, line)) {
+        if (line.rfind("AnonHugePages:", 0) == 0) {
+            return stoll(line.substr(14));
+        }
+    }
+    return -1;
+}
+
+string read_first_line(const string& path) {
+    ifstream in(path);
+    string line;
+    getline(in, line);
+    return line.empty() ? "unavailable" : line;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3 && argc != 4) {
+        cerr << "Usage: " << argv[0] << " <X_file.h5> <W_file.h5> [repeats]" << endl;
+        cerr << "Example: " << argv[0] << " d5.h5 w5.h5 10" << endl;
+        return 1;
+    }
+    string x_filename = argv[1];
+    string w_filename = argv[2];
+
+    try {
+        string x_path = "../dataset/X/" + x_filename;
+        string w_path = "../dataset/W/" + w_filename;
+        string postfix = extract_postfix(x_filename);
+        const string experiment = "hugepages";
+        const int repeats = argc == 4 ? stoi(argv[3]) : 10;
+
+        reset_log_experiment(postfix, experiment);
+
+        stringstream ss;
+        ss << "transparent_hugepage: " << read_first_line("/sys/kernel/mm/transparent_hugepage/enabled") << endl;
+        ss << "hugetlbfs pool pages: " << read_first_line("/proc/sys/vm/nr_hugepages") << endl;
+        ss << "dTLB counters: not available, reporting wall time" << endl;
+        ss << fixed << setprecision(3);
+
+        vector<float> Y_ref;
+        const HugePagePolicy policies[] = {HugePagePolicy::Off, HugePagePolicy::Transparent, HugePagePolicy::Explicit};
+        for (HugePagePolicy policy : policies) {
+            set_huge_page_policy(policy);
+            HugePageCounters& counters = huge_page_counters();
+            size_t fallbacks_before = counters.explicit_fallbacks;
+            long long huge_before = anon_huge_pages_kb();
+
+            // Reload so X, W and Y are allocated under this policy
+            CSR X = load_X_h5_as_csr(x_path, "");
+            int W_rows, W_cols;
+            vector<float> W = load_W_h5(w_path, W_rows, W_cols, "");
+            vector<float> Y = spmm_baseline(X, W, W_rows, W_cols);
+            long long huge_after = anon_huge_pages_kb();
+
+            // Steady state: repeated products into the same Y
+            vector<double> times;
+            for (int r = 0; r < repeats; r++) {
+                auto start = chrono::high_resolution_clock::now();
+                spmm_baseline_into(X, W, W_rows, W_cols, Y);
+                times.push_back(elapsed_ms(start));
+            }
+            sort(times.begin(), times.end());
+
+            if (Y_ref.empty()) {
+                Y_ref = Y;
+                ss << "rows_X: " << X.nrows << ", cols_X: " << X.ncols << ", nnz_X: " << X.nnz
+                   << ", K: " << W_cols << ", X bytes: " << (X.nnz * 8 + X.indptr.size() * 4) / 1e6
+                   << " MB, W bytes: " << W.size() * 4 / 1e6 << " MB" << endl;
+            }
+            size_t mismatches = 0;
+            for (size_t i = 0; i < Y.size(); i++) {
+                if (Y[i] != Y_ref[i]) mismatches++;
+            }
+
+            ss << "policy " << huge_page_policy_name(policy) << ": spmm median " << times[times.size() / 2]
+               << "ms, min " << times.front() << "ms, AnonHugePages +" << (huge_after - huge_before) << " kB"
+               << ", hugetlb fallbacks: " << counters.explicit_fallbacks - fallbacks_before
+               << ", X.data 64B-aligned: " << (reinterpret_cast<uintptr_t>(X.data.data()) % 64 == 0 ? "yes" : "no")
+               << ", Y mismatches: " << mismatches << endl;
+        }
+
+        HugePageCounters& counters = huge_page_counters();
+        ss << "allocated: transparent " << counters.transparent_bytes / 1e6 << " MB, plain "
+           << counters.plain_bytes / 1e6 << " MB, hugetlb " << counters.explicit_bytes / 1e6 << " MB, small "
+           << counters.small_bytes / 1e6 << " MB, madvise failures: " << counters.madvise_failures << endl;
+
+        log_to_file_experiment(postfix, experiment, ss.str());
+        cout << ss.str();
+        cout << "spmm done" << endl;
+
+        return 0;
+
+    } catch (const exception& e) {
+        cerr << "  ✗ Error: " << e.what() << endl;
+        return 1;
+    }
+}
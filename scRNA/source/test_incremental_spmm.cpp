@@ -0,0 +1,185 @@
+#include "../include/disk_to_memory.hpp"
+#include "../include/spmm.hpp"
+#include "../include/spmm_transpose.hpp"
+#include "../include/incremental_spmm.hpp"
+#include "../include/csr.hpp"
+#include "../include/logger.hpp"
+#include <H5Cpp.h>
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <string>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <filesystem>
+
+using namespace std;
+using namespace H5;
+namespace fs = std::filesystem;
+
+/**
+ * Extract postfix from filename (e.g., "d0.h5" -> "0")
+ */
+string extract_postfix(const string& filename) {
+    string name = filename;
+    size_t dot_pos = name.find_last_of('.');
+    if (dot_pos != string::npos) {
+        name = name.substr(0, dot_pos);
+    }
+    if (name.length() > 1) {
+        return name.substr(1);
+    }
+    return "0";
+}
+
+double elapsed_ms(chrono::high_resolution_clock::time_point start) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count() / 1000.0;
+}
+
+/**
+ * Columns [c0, c1) of X as a new CSR (genes x (c1 - c0))
+ */
+CSR slice_columns(const CSR& X, int c0, int c1) {
+    CSR S;
+    S.nrows = X.nrows;
+    S.ncols = c1 - c0;
+    S.indptr.assign(X.nrows + 1, 0);
+    for (int i = 0; i < X.nrows; i++) {
+        for (int idx = X.indptr[i]; idx < X.indptr[i + 1]; idx++) {
+            int c = X.indices[idx];
+            if (c >= c0 && c < c1) {
+                S.indices.push_back(c - c0);
+                S.data.push_back(X.data[idx]);
+            }
+        }
+        S.indptr[i + 1] = static_cast<int>(S.indices.size());
+    }
+    S.nnz = S.indices.size();
+    return S;
+}
+
+/**
+ * Write X (genes x cells CSR) in the 10x layout: matrix/{shape,data,indices,indptr} as CSC
+ */
+void save_10x_h5(const CSR& X, const string& path) {
+    CSR C = transpose_csr(X);  // cells x genes CSR == genes x cells CSC
+    fs::create_directories(fs::path(path).parent_path());
+    H5File file(path, H5F_ACC_TRUNC);
+    Group matrix = file.createGroup("matrix");
+
+    long long shape[2] = {X.nrows, X.ncols};
+    hsize_t shape_dims[1] = {2};
+    matrix.createDataSet("shape", PredType::NATIVE_INT64, DataSpace(1, shape_dims)).write(shape, PredType::NATIVE_INT64);
+
+    hsize_t nnz_dims[1] = {static_cast<hsize_t>(C.nnz)};
+    matrix.createDataSet("data", PredType::NATIVE_FLOAT, DataSpace(1, nnz_dims)).write(C.data.data(), PredType::NATIVE_FLOAT);
+    matrix.createDataSet("indices", PredType::NATIVE_INT32, DataSpace(1, nnz_dims)).write(C.indices.data(), PredType::NATIVE_INT32);
+
+    hsize_t ptr_dims[1] = {static_cast<hsize_t>(C.indptr.size())};
+    matrix.createDataSet("indptr", PredType::NATIVE_INT32, DataSpace(1, ptr_dims)).write(C.indptr.data(), PredType::NATIVE_INT32);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc > 4) {
+        cerr << "Usage: " << argv[0] << " <X_file.h5> <W_file.h5> [base_fraction]" << endl;
+        cerr << "Example: " << argv[0] << " d5.h5 w5.h5 0.8" << endl;
+        return 1;
+    }
+    string x_filename = argv[1];
+    string w_filename = argv[2];
+
+    try {
+        string x_path = "../dataset/X/" + x_filename;
+        string w_path = "../dataset/W/" + w_filename;
+        string postfix = extract_postfix(x_filename);
+        const string experiment = "incremental";
+        double base_fraction = (argc == 4) ? stod(argv[3]) : 0.8;
+
+        reset_log_experiment(postfix, experiment);
+
+        // Full recompute reference (what baseline_run_from_disk does today)
+        auto start = chrono::high_resolution_clock::now();
+        CSR X = load_X_h5_as_csr(x_path, "");
+        int W_rows, W_cols;
+        vector<float> W = load_W_h5(w_path, W_rows, W_cols, "");
+        vector<float> Y_full = spmm_baseline(X, W, W_rows, W_cols);
+        double full_ms = elapsed_ms(start);
+
+        // Split cells into a base batch and an appended batch, both stored in the 10x layout
+        int base_cells = static_cast<int>(X.ncols * base_fraction);
+        string base_path = "../dataset/X/inc" + postfix + "_base.h5";
+        string delta_path = "../dataset/X/inc" + postfix + "_delta.h5";
+        string y_path = "../dataset/Y/inc" + postfix + ".h5";
+        save_10x_h5(slice_columns(X, 0, base_cells), base_path);
+        save_10x_h5(slice_columns(X, base_cells, X.ncols), delta_path);
+
+        // Initial run on the base batch + sidecar
+        CSR X_base = load_X_h5_as_csr(base_path, "");
+        vector<float> W_base(W.begin(), W.begin() + static_cast<size_t>(base_cells) * W_cols);
+        vector<float> Y_base = spmm_baseline(X_base, W_base, base_cells, W_cols);
+        write_Y_h5(Y_base, X.nrows, W_cols, y_path);
+        save_incremental_meta(make_incremental_meta(X_base, base_path, Y_base, W_base, base_cells, W_cols),
+                              incremental_meta_path(y_path));
+
+        // Incremental append from disk
+        start = chrono::high_resolution_clock::now();
+        bool ok = incremental_run_from_disk(y_path, delta_path, w_path, false, postfix);
+        double inc_ms = elapsed_ms(start);
+        if (!ok) {
+            throw runtime_error("incremental append failed");
+        }
+
+        int Y_rows, Y_cols;
+        vector<float> Y_inc = load_Y_h5(y_path, Y_rows, Y_cols);
+        double max_abs = 0.0, max_ref = 0.0;
+        for (size_t i = 0; i < Y_full.size(); i++) {
+            max_abs = max(max_abs, static_cast<double>(fabs(Y_inc[i] - Y_full[i])));
+            max_ref = max(max_ref, static_cast<double>(fabs(Y_full[i])));
+        }
+
+        // Full (rehash) validation cost
+        IncrementalMeta meta = load_incremental_meta(incremental_meta_path(y_path));
+        start = chrono::high_resolution_clock::now();
+        bool all_valid = true;
+        for (const auto& seg : meta.segments) {
+            string reason;
+            all_valid = all_valid && validate_x_segment(seg, true, reason);
+        }
+        double full_validation_ms = elapsed_ms(start);
+
+        // A second append of the same batch must be rejected (W rows no longer match)
+        bool reappend_rejected = !incremental_run_from_disk(y_path, delta_path, w_path, false, "");
+
+        // Changing the base batch must be detected
+        CSR X_base_modified = X_base;
+        if (X_base_modified.nnz > 0) X_base_modified.data[0] += 1.0f;
+        save_10x_h5(X_base_modified, base_path);
+        string reason;
+        bool change_detected = !validate_x_segment(meta.segments[0], false, reason);
+
+        stringstream ss;
+        ss << "rows_X: " << X.nrows << ", cols_X: " << X.ncols << ", nnz_X: " << X.nnz << endl;
+        ss << "base cells: " << base_cells << ", appended cells: " << X.ncols - base_cells
+           << ", appended nnz: " << meta.segments.back().nnz << endl;
+        ss << fixed << setprecision(3);
+        ss << "full recompute (load + spmm) time: " << full_ms << "ms" << endl;
+        ss << "incremental append (validate + load + spmm + store) time: " << inc_ms << "ms" << endl;
+        ss << "full validation (rehash all segments) time: " << full_validation_ms << "ms, valid: "
+           << (all_valid ? "yes" : "no") << endl;
+        ss << scientific << setprecision(3)
+           << "max rel diff vs full recompute: " << (max_ref > 0.0 ? max_abs / max_ref : max_abs) << endl;
+        ss << "duplicate append rejected: " << (reappend_rejected ? "yes" : "no") << endl;
+        ss << "base change detected: " << (change_detected ? "yes" : "no") << " (" << reason << ")" << endl;
+
+        log_to_file_experiment(postfix, experiment, ss.str());
+        cout << ss.str();
+        cout << "spmm done" << endl;
+
+        return 0;
+
+    } catch (const exception& e) {
+        cerr << "  ✗ Error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,182 @@
+#include "../include/jit_spmm.hpp"
+#include "../include/disk_to_memory.hpp"
+#include "../include/spmm.hpp"
+#include "../include/csr.hpp"
+#include "../include/logger.hpp"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <memory>
+#include <filesystem>
+#include <unistd.h>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+/**
+ * Extract postfix from filename (e.g., "d0.h5" -> "0")
+ */
+string extract_postfix(const string& filename) {
+    string name = filename;
+    size_t dot_pos = name.find_last_of('.');
+    if (dot_pos != string::npos) {
+        name = name.substr(0, dot_pos);
+    }
+    if (name.length() > 1) {
+        return name.substr(1);
+    }
+    return "0";
+}
+
+double elapsed_ms(chrono::high_resolution_clock::time_point start) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count() / 1000.0;
+}
+
+/**
+ * Number of elements that differ from the reference bit for bit
+ */
+size_t count_mismatches(const vector<float>& a, const vector<float>& b) {
+    size_t n = 0;
+    for (size_t i = 0; i < b.size(); i++) {
+        if (a[i] != b[i]) n++;
+    }
+    return n;
+}
+
+string describe(const JitBuildInfo& info) {
+    stringstream ss;
+    ss << fixed << setprecision(3);
+    if (info.jitted) {
+        ss << (info.cache_hit ? "cache hit" : "compiled") << ", fingerprint " << info.fingerprint_ms << "ms, codegen "
+           << info.codegen_ms << "ms (" << info.source_bytes / 1024 << " KB), compile " << info.compile_ms
+           << "ms, load " << info.load_ms << "ms";
+    } else {
+        ss << "generic fallback (" << info.fallback_reason << ")";
+    }
+    return ss.str();
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc > 4) {
+        cerr << "Usage: " << argv[0] << " <X_file.h5> <W_file.h5> [runs]" << endl;
+        cerr << "Example: " << argv[0] << " d5.h5 w5.h5 10" << endl;
+        return 1;
+    }
+    string x_filename = argv[1];
+    string w_filename = argv[2];
+    int runs = argc >= 4 ? stoi(argv[3]) : 5;
+
+    try {
+        string x_path = "../dataset/X/" + x_filename;
+        string w_path = "../dataset/W/" + w_filename;
+        string postfix = extract_postfix(x_filename);
+        const string experiment = "jit";
+
+        reset_log_experiment(postfix, experiment);
+
+        CSR X = load_X_h5_as_csr(x_path, "");
+        int W_rows, W_cols;
+        vector<float> W = load_W_h5(w_path, W_rows, W_cols, "");
+
+        stringstream ss;
+        ss << fixed << setprecision(3);
+        ss << "rows_X: " << X.nrows << ", cols_X: " << X.ncols << ", nnz_X: " << X.nnz << ", K: " << W_cols << endl;
+
+        // Build: first construction compiles unless an earlier run left the object in the cache
+        JitConfig cfg;
+        auto start = chrono::high_resolution_clock::now();
+        auto first = make_unique<JitSpmmKernel>(X, W_cols, cfg, postfix);
+        double first_ms = elapsed_ms(start);
+        ss << "first build: " << first_ms << "ms, " << describe(first->info()) << endl;
+        first.reset();
+        start = chrono::high_resolution_clock::now();
+        JitSpmmKernel jit(X, W_cols, cfg, postfix);
+        double second_ms = elapsed_ms(start);
+        ss << "second build: " << second_ms << "ms, " << describe(jit.info()) << endl;
+        ss << "unrolled rows: " << jit.info().unrolled_rows << " of " << X.nrows << ", object " << jit.info().so_path << endl;
+
+        // Executions (first call of each kernel is a warm-up)
+        vector<float> Y_ref(static_cast<size_t>(X.nrows) * W_cols);
+        vector<float> Y_fixed(Y_ref.size());
+        vector<float> Y_jit(Y_ref.size());
+        spmm_baseline_into(X, W, W_rows, W_cols, Y_ref);
+        spmm_fixed_k_into(X, W, W_rows, W_cols, Y_fixed);
+        jit.run_into(X, W, W_rows, W_cols, Y_jit);
+        double baseline_ms = 0.0, fixed_ms = 0.0, jit_ms = 0.0;
+        for (int r = 0; r < runs; r++) {
+            start = chrono::high_resolution_clock::now();
+            spmm_baseline_into(X, W, W_rows, W_cols, Y_ref);
+            baseline_ms += elapsed_ms(start);
+            start = chrono::high_resolution_clock::now();
+            spmm_fixed_k_into(X, W, W_rows, W_cols, Y_fixed);
+            fixed_ms += elapsed_ms(start);
+            start = chrono::high_resolution_clock::now();
+            jit.run_into(X, W, W_rows, W_cols, Y_jit);
+            jit_ms += elapsed_ms(start);
+        }
+        baseline_ms /= runs;
+        fixed_ms /= runs;
+        jit_ms /= runs;
+
+        ss << setw(12) << "baseline" << ": " << setw(10) << baseline_ms << "ms" << endl;
+        ss << setw(12) << "fixed K" << ": " << setw(10) << fixed_ms << "ms, " << count_mismatches(Y_fixed, Y_ref)
+           << " mismatches vs baseline" << endl;
+        ss << setw(12) << (jit.jitted() ? "jit" : "jit (generic)") << ": " << setw(10) << jit_ms << "ms, "
+           << count_mismatches(Y_jit, Y_ref) << " mismatches vs baseline, " << setprecision(2)
+           << fixed_ms / jit_ms << "x vs fixed K" << setprecision(3) << endl;
+
+        double build_ms = jit.info().jitted ? first_ms : 0.0;
+        if (jit.jitted() && jit_ms < fixed_ms) {
+            ss << "compile pays off after " << static_cast<long long>(build_ms / (fixed_ms - jit_ms)) + 1
+               << " executions (against fixed K)" << endl;
+        }
+
+        // Fallback path: no usable compiler
+        JitConfig no_cc = cfg;
+        no_cc.compiler = "/nonexistent/c++";
+        JitSpmmKernel fallback(X, W_cols, no_cc, postfix);
+        vector<float> Y_fb = fallback.run(X, W, W_rows, W_cols);
+        ss << "no compiler: " << describe(fallback.info()) << ", " << count_mismatches(Y_fb, Y_ref)
+           << " mismatches vs baseline" << endl;
+
+        // Same shape and nnz, different structure: the kernel must refuse it
+        CSR X_moved = X;
+        for (int i = 0; i < X_moved.nrows; i++) {
+            int lo = X_moved.indptr[i], hi = X_moved.indptr[i + 1];
+            if (hi > lo && X_moved.indices[hi - 1] + 1 < X_moved.ncols) {
+                X_moved.indices[hi - 1]++;
+                break;
+            }
+        }
+        bool rejected = false;
+        try {
+            jit.run_into(X_moved, W, W_rows, W_cols, Y_jit);
+        } catch (const runtime_error&) {
+            rejected = true;
+        }
+        ss << "same shape, moved nonzero: " << (rejected ? "rejected" : "NOT rejected") << endl;
+
+        // Shell metacharacters in the compiler are passed as one word, not run
+        const fs::path marker = fs::temp_directory_path() / ("jit_spmm_injected_" + to_string(getpid()));
+        JitConfig injected = cfg;
+        injected.compiler = "true; touch " + marker.string() + ";";
+        JitSpmmKernel quoted(X, W_cols, injected, postfix);
+        bool ran = fs::exists(marker);
+        fs::remove(marker);
+        ss << "compiler with shell metacharacters: " << (quoted.jitted() ? "jit" : "generic fallback")
+           << ", injected command ran: " << (ran ? "YES" : "no") << endl;
+
+        log_to_file_experiment(postfix, experiment, ss.str());
+        cout << ss.str();
+        cout << "spmm done" << endl;
+
+        return 0;
+
+    } catch (const exception& e) {
+        cerr << "  ✗ Error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,103 @@
+#include "../include/disk_to_memory.hpp"
+#include "../include/rsvd.hpp"
+#include "../include/knn_graph.hpp"
+#include "../include/csr.hpp"
+#include "../include/logger.hpp"
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <string>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+
+using namespace std;
+
+/**
+ * Extract postfix from filename (e.g., "d0.h5" -> "0")
+ */
+string extract_postfix(const string& filename) {
+    string name = filename;
+    size_t dot_pos = name.find_last_of('.');
+    if (dot_pos != string::npos) {
+        name = name.substr(0, dot_pos);
+    }
+    if (name.length() > 1) {
+        return name.substr(1);
+    }
+    return "0";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 3) {
+        cerr << "Usage: " << argv[0] << " <X_file.h5> [n_neighbors]" << endl;
+        cerr << "Example: " << argv[0] << " d4.h5 15" << endl;
+        return 1;
+    }
+    string x_filename = argv[1];
+
+    try {
+        string x_path = "../dataset/X/" + x_filename;
+        string postfix = extract_postfix(x_filename);
+        const string experiment = "knn";
+
+        reset_log_experiment(postfix, experiment);
+
+        CSR X = load_X_h5_as_csr(x_path, "");
+
+        // Project cells: scores = V * diag(S) (cells x 32)
+        RsvdParams rp;
+        rp.k = 32;
+        RsvdResult pca = randomized_svd(X, rp);
+        int n = X.ncols;
+        int dim = pca.k;
+        vector<float> cells(static_cast<size_t>(n) * dim);
+        for (int c = 0; c < n; c++) {
+            for (int j = 0; j < dim; j++) {
+                cells[static_cast<size_t>(c) * dim + j] = pca.V[static_cast<size_t>(c) * dim + j] * pca.S[j];
+            }
+        }
+
+        KnnParams params;
+        if (argc == 3) params.k = stoi(argv[2]);
+
+        stringstream ss;
+        ss << "rows_X: " << X.nrows << ", cols_X: " << X.ncols << ", nnz_X: " << X.nnz << endl;
+        ss << fixed << setprecision(3);
+        ss << "pca time: " << pca.total_ms << "ms" << endl;
+
+        KnnStats st;
+        CSR G = build_knn_graph(cells, n, dim, params, &st, postfix);
+
+        auto start = chrono::high_resolution_clock::now();
+        CSR G_exact = exact_knn_graph(cells, n, dim, params.k);
+        auto end = chrono::high_resolution_clock::now();
+        double exact_ms = chrono::duration_cast<chrono::microseconds>(end - start).count() / 1000.0;
+
+        // NN-descent from random init only, to show what the forest buys
+        KnnParams p_random = params;
+        p_random.rp_trees = 0;
+        KnnStats st_random;
+        CSR G_random = build_knn_graph(cells, n, dim, p_random, &st_random);
+
+        ss << "knn graph nnz: " << G.nnz << " (" << n << " x " << params.k << ")" << endl;
+        ss << "rp forest + nn-descent time: " << st.total_ms << "ms, iterations: " << st.iterations
+           << ", distance evals: " << st.distance_evals << endl;
+        ss << "random init + nn-descent time: " << st_random.total_ms << "ms, iterations: " << st_random.iterations
+           << ", distance evals: " << st_random.distance_evals << endl;
+        ss << "exact brute force time: " << exact_ms << "ms" << endl;
+        ss << setprecision(4);
+        ss << "recall (rp forest + nn-descent): " << knn_recall(G, G_exact) << endl;
+        ss << "recall (random init + nn-descent): " << knn_recall(G_random, G_exact) << endl;
+
+        log_to_file_experiment(postfix, experiment, ss.str());
+        cout << ss.str();
+        cout << "knn done" << endl;
+
+        return 0;
+
+    } catch (const exception& e) {
+        cerr << "  ✗ Error: " << e.what() << endl;
+        return 1;
+    }
+}
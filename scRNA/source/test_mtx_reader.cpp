@@ -0,0 +1,114 @@
+#include "../include/mtx_reader.hpp"
+#include "../include/disk_to_memory.hpp"
+#include "../include/spmm_transpose.hpp"
+#include "../include/csr.hpp"
+#include "../include/logger.hpp"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <cstdio>
+
+using namespace std;
+
+/**
+ * Extract postfix from filename (e.g., "d0.h5" -> "0")
+ */
+string extract_postfix(const string& filename) {
+    string name = filename;
+    size_t dot_pos = name.find_last_of('.');
+    if (dot_pos != string::npos) {
+        name = name.substr(0, dot_pos);
+    }
+    if (name.length() > 1) {
+        return name.substr(1);
+    }
+    return "0";
+}
+
+double elapsed_ms(chrono::high_resolution_clock::time_point start) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count() / 1000.0;
+}
+
+/**
+ * Write A (CSR) as a general real coordinate file, row by row (as scipy's mmwrite does).
+ */
+void write_mtx(const CSR& A, const string& path) {
+    ofstream out(path);
+    out << "%%MatrixMarket matrix coordinate real general\n%\n";
+    out << A.nrows << " " << A.ncols << " " << A.nnz << "\n";
+    char line[64];
+    for (int i = 0; i < A.nrows; i++) {
+        for (int idx = A.indptr[i]; idx < A.indptr[i + 1]; idx++) {
+            int n = snprintf(line, sizeof(line), "%d %d %.9g\n", i + 1, A.indices[idx] + 1, A.data[idx]);
+            out.write(line, n);
+        }
+    }
+    if (!out) throw runtime_error("Cannot write " + path);
+}
+
+bool same_csr(const CSR& a, const CSR& b) {
+    return a.nrows == b.nrows && a.ncols == b.ncols && a.nnz == b.nnz &&
+           equal(a.indptr.begin(), a.indptr.end(), b.indptr.begin()) &&
+           equal(a.indices.begin(), a.indices.end(), b.indices.begin()) &&
+           equal(a.data.begin(), a.data.end(), b.data.begin());
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 2 && argc != 3) {
+        cerr << "Usage: " << argv[0] << " <X_file.h5> [num_threads]" << endl;
+        cerr << "Example: " << argv[0] << " d5.h5 8" << endl;
+        return 1;
+    }
+    string x_filename = argv[1];
+
+    try {
+        string x_path = "../dataset/X/" + x_filename;
+        string postfix = extract_postfix(x_filename);
+        const string experiment = "mtx";
+
+        reset_log_experiment(postfix, experiment);
+
+        auto start = chrono::high_resolution_clock::now();
+        CSR X = load_X_h5_as_csr(x_path, "");
+        double h5_ms = elapsed_ms(start);
+
+        MtxReadOptions options;
+        if (argc == 3) options.num_threads = stoi(argv[2]);
+
+        stringstream ss;
+        ss << fixed << setprecision(3);
+        ss << "rows_X: " << X.nrows << ", cols_X: " << X.ncols << ", nnz_X: " << X.nnz
+           << ", load_X_h5_as_csr: " << h5_ms << "ms" << endl;
+
+        // Cell Ranger MEX orientation (genes x cells) and scanpy mmwrite orientation (cells x genes)
+        for (bool cells_by_genes : {false, true}) {
+            string mtx_path = "../dataset/X/mtx_" + postfix + (cells_by_genes ? "_cxg" : "_gxc") + ".mtx";
+            write_mtx(cells_by_genes ? transpose_csr(X) : X, mtx_path);
+
+            options.transpose = cells_by_genes;
+            MtxReadStats st;
+            CSR X_mtx = load_mtx_as_csr(mtx_path, options, &st, postfix);
+            remove(mtx_path.c_str());
+
+            ss << (cells_by_genes ? "cells x genes (transpose)" : "genes x cells") << ": "
+               << st.file_bytes / 1e6 << " MB, " << st.threads << " threads, map " << st.map_ms
+               << "ms, parse " << st.parse_ms << "ms (" << st.parse_gb_per_s << " GB/s), build "
+               << st.build_ms << "ms, total " << st.total_ms << "ms, identical CSR: "
+               << (same_csr(X, X_mtx) ? "yes" : "NO") << endl;
+        }
+
+        log_to_file_experiment(postfix, experiment, ss.str());
+        cout << ss.str();
+        cout << "spmm done" << endl;
+
+        return 0;
+
+    } catch (const exception& e) {
+        cerr << "  ✗ Error: " << e.what() << endl;
+        return 1;
+    }
+}
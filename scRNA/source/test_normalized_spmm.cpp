@@ -0,0 +1,152 @@
+#include "../include/disk_to_memory.hpp"
+#include "../include/spmm.hpp"
+#include "../include/normalize_spmm.hpp"
+#include "../include/csr.hpp"
+#include "../include/logger.hpp"
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <string>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+
+using namespace std;
+
+/**
+ * Extract postfix from filename (e.g., "d0.h5" -> "0")
+ */
+string extract_postfix(const string& filename) {
+    string name = filename;
+    size_t dot_pos = name.find_last_of('.');
+    if (dot_pos != string::npos) {
+        name = name.substr(0, dot_pos);
+    }
+    if (name.length() > 1) {
+        return name.substr(1);
+    }
+    return "0";
+}
+
+/**
+ * Dense reference for the first n_check genes: normalize, center/scale explicitly, multiply in double.
+ * Returns the max error relative to max|Y_ref| over the checked rows.
+ */
+double check_dense_reference(const CSR& X, const vector<float>& W, int W_cols, const NormalizeParams& params,
+                             const vector<float>& scale, const vector<float>& Y, int n_check) {
+    double max_err = 0.0;
+    double max_ref = 0.0;
+    vector<double> z(X.ncols);
+
+    for (int i = 0; i < min(n_check, X.nrows); i++) {
+        fill(z.begin(), z.end(), 0.0);
+        for (int idx = X.indptr[i]; idx < X.indptr[i + 1]; idx++) {
+            double v = X.data[idx];
+            if (params.library_size) v *= scale[X.indices[idx]];
+            if (params.log1p) v = log1p(v);
+            z[X.indices[idx]] = v;
+        }
+        double mu = 0.0;
+        for (double v : z) mu += v;
+        mu /= X.ncols;
+        double var = 0.0;
+        for (double v : z) var += (v - mu) * (v - mu);
+        var /= (X.ncols - 1);
+        double sd = (params.scale && var > 0.0) ? sqrt(var) : 1.0;
+        for (double& v : z) v = ((params.center ? v - mu : v)) / sd;
+
+        for (int j = 0; j < W_cols; j++) {
+            double ref = 0.0;
+            for (int c = 0; c < X.ncols; c++) {
+                ref += z[c] * W[static_cast<size_t>(c) * W_cols + j];
+            }
+            max_err = max(max_err, fabs(ref - Y[static_cast<size_t>(i) * W_cols + j]));
+            max_ref = max(max_ref, fabs(ref));
+        }
+    }
+    return max_ref > 0.0 ? max_err / max_ref : max_err;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        cerr << "Usage: " << argv[0] << " <X_file.h5> <W_file.h5>" << endl;
+        cerr << "Example: " << argv[0] << " d5.h5 w5.h5" << endl;
+        return 1;
+    }
+    string x_filename = argv[1];
+    string w_filename = argv[2];
+
+    try {
+        string x_path = "../dataset/X/" + x_filename;
+        string w_path = "../dataset/W/" + w_filename;
+        string postfix = extract_postfix(x_filename);
+        const string experiment = "normspmm";
+
+        reset_log_experiment(postfix, experiment);
+
+        CSR X = load_X_h5_as_csr(x_path, "");
+        int W_rows, W_cols;
+        vector<float> W = load_W_h5(w_path, W_rows, W_cols, "");
+
+        stringstream ss;
+        ss << "rows_X: " << X.nrows << ", cols_X: " << X.ncols << ", nnz_X: " << X.nnz << endl;
+        ss << fixed << setprecision(3);
+
+        // Copy-based path: materialize normalized X, then run the baseline kernel
+        NormalizeParams params;
+        auto start = chrono::high_resolution_clock::now();
+        vector<float> scale = compute_cell_scale_factors(X, params.target_sum);
+        CSR X_norm = X;
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < X_norm.nrows; i++) {
+            for (int idx = X_norm.indptr[i]; idx < X_norm.indptr[i + 1]; idx++) {
+                X_norm.data[idx] = log1pf(X_norm.data[idx] * scale[X_norm.indices[idx]]);
+            }
+        }
+        vector<float> Y_copy = spmm_baseline(X_norm, W, W_rows, W_cols);
+        auto end = chrono::high_resolution_clock::now();
+        double copy_ms = chrono::duration_cast<chrono::microseconds>(end - start).count() / 1000.0;
+        ss << "copy+spmm (libsize+log1p) time: " << copy_ms << "ms" << endl;
+
+        struct Variant { string name; bool center; bool scale; };
+        vector<Variant> variants = {{"libsize+log1p", false, false},
+                                    {"libsize+log1p+center", true, false},
+                                    {"libsize+log1p+center+scale", true, true}};
+
+        for (const auto& v : variants) {
+            NormalizeParams p;
+            p.center = v.center;
+            p.scale = v.scale;
+
+            start = chrono::high_resolution_clock::now();
+            vector<float> Y = spmm_normalized(X, W, W_rows, W_cols, p);
+            end = chrono::high_resolution_clock::now();
+            double fused_ms = chrono::duration_cast<chrono::microseconds>(end - start).count() / 1000.0;
+
+            double rel_err = check_dense_reference(X, W, W_cols, p, scale, Y, 256);
+
+            ss << fixed << setprecision(3);
+            ss << v.name << " fused time: " << fused_ms << "ms" << endl;
+            ss << scientific << setprecision(3);
+            ss << v.name << " max_rel_err vs dense reference (first 256 genes): " << rel_err << endl;
+
+            if (!v.center && !v.scale) {
+                double max_diff = 0.0;
+                for (size_t i = 0; i < Y.size(); i++) {
+                    max_diff = max(max_diff, static_cast<double>(fabs(Y[i] - Y_copy[i])));
+                }
+                ss << v.name << " max_abs_diff vs copy+spmm: " << max_diff << endl;
+            }
+        }
+
+        log_to_file_experiment(postfix, experiment, ss.str());
+        cout << ss.str();
+        cout << "spmm done" << endl;
+
+        return 0;
+
+    } catch (const exception& e) {
+        cerr << "  ✗ Error: " << e.what() << endl;
+        return 1;
+    }
+}
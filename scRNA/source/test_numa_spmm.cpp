@@ -0,0 +1,133 @@
+#include "../include/disk_to_memory.hpp"
+#include "../include/spmm.hpp"
+#include "../include/numa_spmm.hpp"
+#include "../include/csr.hpp"
+#include "../include/logger.hpp"
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <sched.h>
+#include <string>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <omp.h>
+
+using namespace std;
+
+/**
+ * Extract postfix from filename (e.g., "d0.h5" -> "0")
+ */
+string extract_postfix(const string& filename) {
+    string name = filename;
+    size_t dot_pos = name.find_last_of('.');
+    if (dot_pos != string::npos) {
+        name = name.substr(0, dot_pos);
+    }
+    if (name.length() > 1) {
+        return name.substr(1);
+    }
+    return "0";
+}
+
+double elapsed_ms(chrono::high_resolution_clock::time_point start) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count() / 1000.0;
+}
+
+double max_abs_diff(const NumaBuffer<float>& a, const vector<float>& b) {
+    double d = 0.0;
+    for (size_t i = 0; i < b.size(); i++) d = max(d, static_cast<double>(fabs(a[i] - b[i])));
+    return d;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3 && argc != 4) {
+        cerr << "Usage: " << argv[0] << " <X_file.h5> <W_file.h5> [num_threads]" << endl;
+        cerr << "Example: " << argv[0] << " d5.h5 w5.h5 16" << endl;
+        return 1;
+    }
+    string x_filename = argv[1];
+    string w_filename = argv[2];
+
+    try {
+        string x_path = "../dataset/X/" + x_filename;
+        string w_path = "../dataset/W/" + w_filename;
+        string postfix = extract_postfix(x_filename);
+        const string experiment = "numa";
+        const int repeats = 5;
+
+        reset_log_experiment(postfix, experiment);
+
+        CSR X = load_X_h5_as_csr(x_path, "");
+        int W_rows, W_cols;
+        vector<float> W = load_W_h5(w_path, W_rows, W_cols, "");
+
+        NumaConfig cfg;
+        if (argc == 4) cfg.num_threads = stoi(argv[3]);
+
+        NumaTopology topo = detect_numa_topology();
+        stringstream ss;
+        ss << "rows_X: " << X.nrows << ", cols_X: " << X.ncols << ", nnz_X: " << X.nnz
+           << ", K: " << W_cols << ", threads: " << cfg.num_threads << endl;
+        ss << "numa nodes: " << topo.num_nodes() << ", cpus:";
+        for (const auto& cpus : topo.node_cpus) ss << " " << cpus.size();
+        ss << endl;
+        ss << fixed << setprecision(3);
+
+        // Baseline with the same thread count, loader placement
+        omp_set_num_threads(cfg.num_threads);
+        vector<float> Y_ref = spmm_baseline(X, W, W_rows, W_cols);
+        auto start = chrono::high_resolution_clock::now();
+        for (int r = 0; r < repeats; r++) Y_ref = spmm_baseline(X, W, W_rows, W_cols);
+        double baseline_ms = elapsed_ms(start) / repeats;
+        ss << "baseline time: " << baseline_ms << "ms" << endl;
+
+        // Variants: full NUMA mode, no W replica, no pinning
+        struct Variant { const char* name; bool pin; bool replicate; };
+        const Variant variants[] = {{"numa", true, true}, {"numa_shared_W", true, false}, {"numa_unpinned", false, true}};
+        cpu_set_t mask_before;
+        sched_getaffinity(0, sizeof(mask_before), &mask_before);
+        for (const Variant& v : variants) {
+            NumaConfig vc = cfg;
+            vc.pin_threads = v.pin;
+            vc.replicate_W = v.replicate;
+            NumaCSR Xn = numa_place_csr(X, vc, v.pin && v.replicate ? postfix : "");
+
+            NumaSpmmStats stats;
+            // First call first-touches Y; the repeats reuse it in place
+            NumaBuffer<float> Y = spmm_numa(Xn, W, W_rows, W_cols, &stats);
+            double compute_ms = 0.0, total_ms = 0.0;
+            start = chrono::high_resolution_clock::now();
+            for (int r = 0; r < repeats; r++) {
+                spmm_numa_into(Xn, W, W_rows, W_cols, Span<float>(Y.data(), Y.size()), &stats,
+                               r == 0 && v.pin && v.replicate ? postfix : "");
+                compute_ms += stats.compute_ms;
+            }
+            total_ms = elapsed_ms(start) / repeats;
+            compute_ms /= repeats;
+
+            ss << v.name << ": placement " << Xn.placement_ms << "ms, pinned: " << (Xn.pinned ? "yes" : "no")
+               << ", total " << total_ms << "ms, compute " << compute_ms << "ms (replicate "
+               << stats.replicate_ms << "ms)" << endl;
+            for (size_t p = 0; p < Xn.panels.size(); p++) {
+                ss << "  node " << Xn.panels[p].node << ": rows " << Xn.panels[p].row_end - Xn.panels[p].row_begin
+                   << ", nnz " << Xn.panels[p].nnz << ", " << stats.node_ms[p] << "ms, "
+                   << stats.node_gbps[p] << " GB/s" << endl;
+            }
+            ss << "  max abs diff vs baseline: " << scientific << max_abs_diff(Y, Y_ref) << fixed << endl;
+            cpu_set_t mask_after;
+            sched_getaffinity(0, sizeof(mask_after), &mask_after);
+            ss << "  caller affinity restored: " << (CPU_EQUAL(&mask_before, &mask_after) ? "yes" : "NO") << endl;
+        }
+
+        log_to_file_experiment(postfix, experiment, ss.str());
+        cout << ss.str();
+        cout << "spmm done" << endl;
+
+        return 0;
+
+    } catch (const exception& e) {
+        cerr << "  ✗ Error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,124 @@
+#include "../include/pipeline_spmm.hpp"
+#include "../include/disk_to_memory.hpp"
+#include "../include/spmm.hpp"
+#include "../include/incremental_spmm.hpp"
+#include "../include/csr.hpp"
+#include "../include/logger.hpp"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <cstdio>
+
+using namespace std;
+
+/**
+ * Extract postfix from filename (e.g., "d0.h5" -> "0")
+ */
+string extract_postfix(const string& filename) {
+    string name = filename;
+    size_t dot_pos = name.find_last_of('.');
+    if (dot_pos != string::npos) {
+        name = name.substr(0, dot_pos);
+    }
+    if (name.length() > 1) {
+        return name.substr(1);
+    }
+    return "0";
+}
+
+double elapsed_ms(chrono::high_resolution_clock::time_point start) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count() / 1000.0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc > 5) {
+        cerr << "Usage: " << argv[0] << " <X_file.h5> <W_file.h5> [panel_cells] [queue_depth]" << endl;
+        cerr << "Example: " << argv[0] << " d5.h5 w5.h5 16384 4" << endl;
+        return 1;
+    }
+    string x_filename = argv[1];
+    string w_filename = argv[2];
+
+    try {
+        string x_path = "../dataset/X/" + x_filename;
+        string w_path = "../dataset/W/" + w_filename;
+        string postfix = extract_postfix(x_filename);
+        const string experiment = "pipeline";
+
+        reset_log_experiment(postfix, experiment);
+
+        // Sequential reference: load X, load W, compute, store
+        string y_seq_path = "Y_seq_" + postfix + ".h5";
+        auto start = chrono::high_resolution_clock::now();
+        CSR X = load_X_h5_as_csr(x_path, "");
+        double load_x_ms = elapsed_ms(start);
+        start = chrono::high_resolution_clock::now();
+        int W_rows, W_cols;
+        vector<float> W = load_W_h5(w_path, W_rows, W_cols, "");
+        double load_w_ms = elapsed_ms(start);
+        start = chrono::high_resolution_clock::now();
+        vector<float> Y_ref = spmm_baseline(X, W, W_rows, W_cols);
+        double compute_ms = elapsed_ms(start);
+        start = chrono::high_resolution_clock::now();
+        write_Y_h5(Y_ref, X.nrows, W_cols, y_seq_path);
+        double store_ms = elapsed_ms(start);
+        double seq_ms = load_x_ms + load_w_ms + compute_ms + store_ms;
+
+        stringstream ss;
+        ss << fixed << setprecision(3);
+        ss << "rows_X: " << X.nrows << ", cols_X: " << X.ncols << ", nnz_X: " << X.nnz << ", K: " << W_cols << endl;
+        ss << "sequential: load X " << load_x_ms << "ms, load W " << load_w_ms << "ms, compute "
+           << compute_ms << "ms, store " << store_ms << "ms, total " << seq_ms << "ms" << endl;
+
+        PipelineConfig cfg;
+        if (argc >= 4) cfg.panel_cells = stoi(argv[3]);
+        if (argc >= 5) cfg.queue_depth = stoi(argv[4]);
+        cfg.y_path = "Y_pipeline_" + postfix + ".h5";
+
+        PipelineStats stats;
+        vector<float> Y = pipelined_spmm_from_disk(x_path, w_path, cfg, &stats, postfix);
+
+        // Compare both the in-memory result and what the store stage wrote
+        int Y_rows, Y_cols;
+        vector<float> Y_stored = load_Y_h5(cfg.y_path, Y_rows, Y_cols);
+        size_t mismatches = 0, stored_mismatches = 0;
+        for (size_t i = 0; i < Y_ref.size(); i++) {
+            if (Y[i] != Y_ref[i]) mismatches++;
+            if (i < Y_stored.size() && Y_stored[i] != Y_ref[i]) stored_mismatches++;
+        }
+        if (Y_stored.size() != Y_ref.size()) stored_mismatches = Y_ref.size();
+        remove(y_seq_path.c_str());
+        remove(cfg.y_path.c_str());
+
+        ss << "pipeline: panel_cells " << cfg.panel_cells << ", queue_depth " << cfg.queue_depth
+           << ", total " << stats.total_ms << "ms (" << seq_ms / stats.total_ms << "x vs sequential)" << endl;
+        ss << left << setw(10) << "stage" << right << setw(8) << "items" << setw(12) << "busy ms"
+           << setw(12) << "Mnnz/s" << setw(12) << "wait in" << setw(12) << "wait out"
+           << setw(14) << "out queue" << setw(10) << "full %" << endl;
+        for (const auto& s : stats.stages) {
+            ss << left << setw(10) << s.name << right << setw(8) << s.items << setw(12) << s.busy_ms
+               << setw(12) << (s.busy_ms > 0.0 && s.nnz > 0 ? s.nnz / (s.busy_ms * 1e3) : 0.0)
+               << setw(12) << s.wait_in_ms << setw(12) << s.wait_out_ms;
+            if (s.out_capacity > 0) {
+                ss << setw(9) << s.out_mean_occupancy << "/" << setw(4) << s.out_capacity
+                   << setw(10) << 100.0 * s.out_full_fraction;
+            }
+            ss << endl;
+        }
+        ss << "bottleneck: " << stats.bottleneck << endl;
+        ss << "Y mismatches: " << mismatches << ", stored Y mismatches: " << stored_mismatches << endl;
+
+        log_to_file_experiment(postfix, experiment, ss.str());
+        cout << ss.str();
+        cout << "spmm done" << endl;
+
+        return 0;
+
+    } catch (const exception& e) {
+        cerr << "  ✗ Error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,137 @@
+#include "../include/disk_to_memory.hpp"
+#include "../include/rsvd.hpp"
+#include "../include/csr.hpp"
+#include "../include/logger.hpp"
+#include <H5Cpp.h>
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <string>
+#include <iomanip>
+#include <sstream>
+#include <filesystem>
+
+using namespace std;
+using namespace H5;
+namespace fs = std::filesystem;
+
+/**
+ * Extract postfix from filename (e.g., "d0.h5" -> "0")
+ */
+string extract_postfix(const string& filename) {
+    string name = filename;
+    size_t dot_pos = name.find_last_of('.');
+    if (dot_pos != string::npos) {
+        name = name.substr(0, dot_pos);
+    }
+    if (name.length() > 1) {
+        return name.substr(1);
+    }
+    return "0";
+}
+
+/**
+ * Save U, S, V to HDF5 file
+ */
+void save_pca_h5(const RsvdResult& res, const string& path) {
+    try {
+        fs::create_directories(fs::path(path).parent_path());
+        H5File file(path, H5F_ACC_TRUNC);
+
+        hsize_t u_dims[2] = {static_cast<hsize_t>(res.nrows), static_cast<hsize_t>(res.k)};
+        DataSpace u_space(2, u_dims);
+        file.createDataSet("U", PredType::NATIVE_FLOAT, u_space).write(res.U.data(), PredType::NATIVE_FLOAT);
+
+        hsize_t s_dims[1] = {static_cast<hsize_t>(res.k)};
+        DataSpace s_space(1, s_dims);
+        file.createDataSet("S", PredType::NATIVE_FLOAT, s_space).write(res.S.data(), PredType::NATIVE_FLOAT);
+
+        hsize_t v_dims[2] = {static_cast<hsize_t>(res.ncols), static_cast<hsize_t>(res.k)};
+        DataSpace v_space(2, v_dims);
+        file.createDataSet("V", PredType::NATIVE_FLOAT, v_space).write(res.V.data(), PredType::NATIVE_FLOAT);
+    } catch (Exception& e) {
+        cerr << "HDF5 error saving PCA: " << e.getDetailMsg() << endl;
+        throw;
+    }
+}
+
+/**
+ * Relative residual ||A v_j - s_j u_j|| / s_j for component j (A = centered X).
+ * (A^T u_j = s_j v_j holds by construction, so the A v_j side is the informative one.)
+ */
+double component_residual(const CSR& X, const RsvdResult& res, int j) {
+    int n = X.ncols;
+    int k = res.k;
+    double v_sum = 0.0;
+    for (int c = 0; c < n; c++) v_sum += res.V[static_cast<size_t>(c) * k + j];
+
+    double norm = 0.0;
+    for (int i = 0; i < X.nrows; i++) {
+        double xv = 0.0;
+        double s = 0.0;
+        for (int idx = X.indptr[i]; idx < X.indptr[i + 1]; idx++) {
+            xv += X.data[idx] * static_cast<double>(res.V[static_cast<size_t>(X.indices[idx]) * k + j]);
+            s += X.data[idx];
+        }
+        double av = xv - (s / n) * v_sum;
+        double d = av - static_cast<double>(res.S[j]) * res.U[static_cast<size_t>(i) * k + j];
+        norm += d * d;
+    }
+    return res.S[j] > 0.0f ? sqrt(norm) / res.S[j] : 0.0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 3) {
+        cerr << "Usage: " << argv[0] << " <X_file.h5> [k]" << endl;
+        cerr << "Example: " << argv[0] << " d4.h5 32" << endl;
+        return 1;
+    }
+    string x_filename = argv[1];
+
+    try {
+        string x_path = "../dataset/X/" + x_filename;
+        string postfix = extract_postfix(x_filename);
+        const string experiment = "rsvd";
+
+        reset_log_experiment(postfix, experiment);
+
+        CSR X = load_X_h5_as_csr(x_path, "");
+
+        RsvdParams params;
+        if (argc == 3) params.k = stoi(argv[2]);
+
+        stringstream ss;
+        ss << "rows_X: " << X.nrows << ", cols_X: " << X.ncols << ", nnz_X: " << X.nnz << endl;
+        log_to_file_experiment(postfix, experiment, ss.str());
+
+        RsvdResult res = randomized_svd(X, params, postfix);
+
+        stringstream out;
+        out << "component, singular_value, explained_variance_ratio, residual" << endl;
+        double cumulative = 0.0;
+        for (int j = 0; j < res.k; j++) {
+            double var = static_cast<double>(res.S[j]) * res.S[j] / max(1, X.ncols - 1);
+            double ratio = res.total_variance > 0.0 ? var / res.total_variance : 0.0;
+            cumulative += ratio;
+            out << j << ", " << fixed << setprecision(4) << res.S[j] << ", " << setprecision(6) << ratio;
+            if (j < 5) {
+                out << ", " << scientific << setprecision(3) << component_residual(X, res, j);
+            }
+            out << fixed << endl;
+        }
+        out << "cumulative explained_variance_ratio: " << setprecision(6) << cumulative << endl;
+        log_to_file_experiment(postfix, experiment, out.str());
+
+        save_pca_h5(res, "../dataset/PCA/pca" + postfix + ".h5");
+
+        cout << out.str();
+        cout << fixed << setprecision(3) << "rsvd total time: " << res.total_ms << "ms" << endl;
+        cout << "pca done" << endl;
+
+        return 0;
+
+    } catch (const exception& e) {
+        cerr << "  ✗ Error: " << e.what() << endl;
+        return 1;
+    }
+}
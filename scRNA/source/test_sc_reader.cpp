@@ -0,0 +1,251 @@
+#include "../include/sc_reader.hpp"
+#include "../include/disk_to_memory.hpp"
+#include "../include/csr.hpp"
+#include "../include/spmm_transpose.hpp"
+#include "../include/logger.hpp"
+#include <H5Cpp.h>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <filesystem>
+#include <algorithm>
+
+using namespace std;
+using namespace H5;
+namespace fs = std::filesystem;
+
+/**
+ * Extract postfix from filename (e.g., "d0.h5" -> "0")
+ */
+string extract_postfix(const string& filename) {
+    string name = filename;
+    size_t dot_pos = name.find_last_of('.');
+    if (dot_pos != string::npos) {
+        name = name.substr(0, dot_pos);
+    }
+    if (name.length() > 1) {
+        return name.substr(1);
+    }
+    return "0";
+}
+
+double elapsed_ms(chrono::high_resolution_clock::time_point start) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count() / 1000.0;
+}
+
+string preview(const vector<string>& names) {
+    string out;
+    for (size_t i = 0; i < names.size() && i < 3; i++) {
+        out += (i ? ", " : "") + names[i];
+    }
+    return names.size() > 3 ? out + ", ..." : out;
+}
+
+bool same_csr(const CSR& a, const CSR& b) {
+    return a.nrows == b.nrows && a.ncols == b.ncols && a.nnz == b.nnz &&
+           equal(a.indptr.begin(), a.indptr.end(), b.indptr.begin()) &&
+           equal(a.indices.begin(), a.indices.end(), b.indices.begin()) &&
+           equal(a.data.begin(), a.data.end(), b.data.begin());
+}
+
+/*
+ * Fixture writers: the same matrix and annotations in the other layouts ScDataset reads.
+ * 10x strings are fixed-length, AnnData strings variable-length, as the real tools write them.
+ */
+void write_strings(Group& g, const string& name, const vector<string>& values, bool fixed_length) {
+    hsize_t n = values.size();
+    if (fixed_length) {
+        size_t len = 1;
+        for (const string& v : values) len = max(len, v.size());
+        StrType type(PredType::C_S1, len);
+        vector<char> buf(n * len, '\0');
+        for (size_t i = 0; i < n; i++) copy(values[i].begin(), values[i].end(), buf.begin() + i * len);
+        g.createDataSet(name, type, DataSpace(1, &n)).write(buf.data(), type);
+    } else {
+        StrType type(PredType::C_S1, H5T_VARIABLE);
+        vector<const char*> ptrs(n);
+        for (size_t i = 0; i < n; i++) ptrs[i] = values[i].c_str();
+        g.createDataSet(name, type, DataSpace(1, &n)).write(ptrs.data(), type);
+    }
+}
+
+void write_string_attr(H5Object& obj, const string& name, const string& value) {
+    StrType type(PredType::C_S1, H5T_VARIABLE);
+    obj.createAttribute(name, type, DataSpace(H5S_SCALAR)).write(type, value);
+}
+
+/* indptr / indices (int64) and data (float32) of M */
+void write_compressed(Group& g, const CSR& M) {
+    vector<long long> indptr(M.indptr.begin(), M.indptr.end());
+    vector<long long> indices(M.indices.begin(), M.indices.end());
+    hsize_t n_ptr = indptr.size(), n_nz = M.nnz;
+    g.createDataSet("indptr", PredType::STD_I64LE, DataSpace(1, &n_ptr)).write(indptr.data(), PredType::NATIVE_INT64);
+    g.createDataSet("indices", PredType::STD_I64LE, DataSpace(1, &n_nz)).write(indices.data(), PredType::NATIVE_INT64);
+    g.createDataSet("data", PredType::IEEE_F32LE, DataSpace(1, &n_nz)).write(M.data.data(), PredType::NATIVE_FLOAT);
+}
+
+struct Annotations {
+    vector<string> names, ids, types, barcodes;
+};
+
+void write_tenx_v2(const string& path, const CSR& X, const Annotations& a) {
+    H5File file(path, H5F_ACC_TRUNC);
+    Group g = file.createGroup("GRCh38");
+    write_compressed(g, transpose_csr(X));   // cells x genes, i.e. genes x cells CSC
+    long long shape[2] = {X.nrows, X.ncols};
+    hsize_t two = 2;
+    g.createDataSet("shape", PredType::STD_I32LE, DataSpace(1, &two)).write(shape, PredType::NATIVE_INT64);
+    write_strings(g, "barcodes", a.barcodes, true);
+    write_strings(g, "genes", a.ids, true);
+    write_strings(g, "gene_names", a.names, true);
+}
+
+/* encoding: "csr_matrix", "csc_matrix" or "dense" */
+void write_h5ad(const string& path, const CSR& X, const Annotations& a, const string& encoding) {
+    H5File file(path, H5F_ACC_TRUNC);
+    Group obs = file.createGroup("obs");
+    write_string_attr(obs, "_index", "barcode");
+    write_strings(obs, "barcode", a.barcodes, false);
+
+    // var: names as the index, ids as a column, feature types as a categorical
+    Group var = file.createGroup("var");
+    write_string_attr(var, "_index", "_index");
+    write_strings(var, "_index", a.names, false);
+    write_strings(var, "gene_ids", a.ids, false);
+    Group types = var.createGroup("feature_types");
+    vector<string> categories;
+    vector<signed char> codes(a.types.size());
+    for (size_t i = 0; i < a.types.size(); i++) {
+        auto it = find(categories.begin(), categories.end(), a.types[i]);
+        codes[i] = static_cast<signed char>(it - categories.begin());
+        if (it == categories.end()) categories.push_back(a.types[i]);
+    }
+    write_strings(types, "categories", categories, false);
+    hsize_t n_codes = codes.size();
+    types.createDataSet("codes", PredType::STD_I8LE, DataSpace(1, &n_codes)).write(codes.data(), PredType::NATIVE_SCHAR);
+
+    if (encoding == "dense") {
+        hsize_t dims[2] = {static_cast<hsize_t>(X.ncols), static_cast<hsize_t>(X.nrows)};
+        vector<float> dense(static_cast<size_t>(X.ncols) * X.nrows, 0.0f);
+        for (int g = 0; g < X.nrows; g++) {
+            for (int idx = X.indptr[g]; idx < X.indptr[g + 1]; idx++) {
+                dense[static_cast<size_t>(X.indices[idx]) * X.nrows + g] = X.data[idx];
+            }
+        }
+        file.createDataSet("X", PredType::IEEE_F32LE, DataSpace(2, dims)).write(dense.data(), PredType::NATIVE_FLOAT);
+        return;
+    }
+    Group x = file.createGroup("X");
+    write_string_attr(x, "encoding-type", encoding);
+    long long shape[2] = {X.ncols, X.nrows};
+    hsize_t two = 2;
+    x.createAttribute("shape", PredType::STD_I64LE, DataSpace(1, &two)).write(PredType::NATIVE_INT64, shape);
+    // cells x genes CSR is the transpose; cells x genes CSC has the genes x cells rows as columns
+    write_compressed(x, encoding == "csr_matrix" ? transpose_csr(X) : X);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 4) {
+        cerr << "Usage: " << argv[0] << " <X_file.h5|X_file.h5ad> [reference_X.h5] [feature_type]" << endl;
+        cerr << "Example: " << argv[0] << " pbmc.h5ad d5.h5 \"Gene Expression\"" << endl;
+        return 1;
+    }
+    string x_filename = argv[1];
+
+    try {
+        string x_path = "../dataset/X/" + x_filename;
+        string postfix = extract_postfix(x_filename);
+        const string experiment = "screader";
+
+        reset_log_experiment(postfix, experiment);
+
+        ScReadOptions options;
+        if (argc == 4) options.feature_type = argv[3];
+
+        auto start = chrono::high_resolution_clock::now();
+        ScDataset dataset(x_path, options);
+        double open_ms = elapsed_ms(start);
+        start = chrono::high_resolution_clock::now();
+        CSR X = dataset.load_X();
+        double load_ms = elapsed_ms(start);
+        start = chrono::high_resolution_clock::now();
+        const vector<string>& genes = dataset.gene_names();
+        const vector<string>& ids = dataset.gene_ids();
+        const vector<string>& types = dataset.feature_types();
+        const vector<string>& barcodes = dataset.barcodes();
+        double names_ms = elapsed_ms(start);
+
+        stringstream ss;
+        ss << fixed << setprecision(3);
+        ss << "format: " << sc_format_name(dataset.format()) << ", genes: " << X.nrows << ", cells: " << X.ncols
+           << ", nnz: " << X.nnz << " (stored " << dataset.nnz_stored() << ")" << endl;
+        ss << "open " << open_ms << "ms, load X " << load_ms << "ms, names " << names_ms << "ms" << endl;
+        ss << "gene names: " << preview(genes) << endl;
+        ss << "gene ids: " << preview(ids) << endl;
+        ss << "feature types: " << preview(types) << endl;
+        ss << "barcodes: " << preview(barcodes) << endl;
+
+        // Reference: the legacy loader on a 10x file holding the same matrix
+        string reference = argc >= 3 ? argv[2] : "";
+        if (reference.empty() && dataset.format() == ScFormat::TenXV3) reference = x_filename;
+        if (!reference.empty() && options.feature_type.empty()) {
+            start = chrono::high_resolution_clock::now();
+            CSR X_ref = load_X_h5_as_csr("../dataset/X/" + reference, "");
+            double ref_ms = elapsed_ms(start);
+            ss << "load_X_h5_as_csr(" << reference << "): " << ref_ms << "ms, identical CSR: "
+               << (same_csr(X, X_ref) ? "yes" : "NO") << endl;
+        }
+
+        // Fixtures: write the v3 matrix and annotations as 10x v2 and h5ad (CSR, CSC, dense),
+        // read each back and compare against the v3 load
+        if (dataset.format() == ScFormat::TenXV3 && options.feature_type.empty()) {
+            const string fixture_dir = "../build/sc_reader_fixtures";
+            fs::create_directories(fixture_dir);
+            const Annotations v3 = {genes, ids, types, barcodes};
+            Annotations v2 = v3;
+            v2.types.assign(v3.types.size(), "Gene Expression");   // v2 has no feature types
+            const size_t dense_limit = size_t(1) << 26;              // Skip dense fixtures above 256 MB
+
+            struct Fixture { const char* name; const char* encoding; };
+            const Fixture fixtures[] = {{"v2", "10x_v2"}, {"h5ad_csr", "csr_matrix"},
+                                        {"h5ad_csc", "csc_matrix"}, {"h5ad_dense", "dense"}};
+            for (const Fixture& f : fixtures) {
+                string encoding = f.encoding;
+                if (encoding == "dense" && static_cast<size_t>(X.nrows) * X.ncols > dense_limit) {
+                    ss << "fixture " << f.name << ": skipped (" << X.nrows << " x " << X.ncols << " dense)" << endl;
+                    continue;
+                }
+                string path = fixture_dir + "/" + postfix + "_" + f.name + (encoding == "10x_v2" ? ".h5" : ".h5ad");
+                if (encoding == "10x_v2") {
+                    write_tenx_v2(path, X, v3);
+                } else {
+                    write_h5ad(path, X, v3, encoding);
+                }
+
+                start = chrono::high_resolution_clock::now();
+                ScDataset fixture(path, options);
+                CSR X_fixture = fixture.load_X();
+                double fixture_ms = elapsed_ms(start);
+                const Annotations& expected = encoding == "10x_v2" ? v2 : v3;
+                bool same_names = fixture.gene_names() == expected.names && fixture.gene_ids() == expected.ids
+                                  && fixture.feature_types() == expected.types && fixture.barcodes() == expected.barcodes;
+                ss << "fixture " << f.name << " (" << sc_format_name(fixture.format()) << "): load X " << fixture_ms
+                   << "ms, identical CSR: " << (same_csr(X_fixture, X) ? "yes" : "NO")
+                   << ", identical annotations: " << (same_names ? "yes" : "NO") << endl;
+            }
+        }
+
+        log_to_file_experiment(postfix, experiment, ss.str());
+        cout << ss.str();
+        cout << "spmm done" << endl;
+
+        return 0;
+
+    } catch (const exception& e) {
+        cerr << "  ✗ Error: " << e.what() << endl;
+        return 1;
+    }
+}
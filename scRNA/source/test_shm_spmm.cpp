@@ -0,0 +1,138 @@
+#include "../include/shm_spmm.hpp"
+#include "../include/disk_to_memory.hpp"
+#include "../include/spmm.hpp"
+#include "../include/csr.hpp"
+#include "../include/logger.hpp"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <omp.h>
+
+using namespace std;
+
+/**
+ * Extract postfix from filename (e.g., "d0.h5" -> "0")
+ */
+string extract_postfix(const string& filename) {
+    string name = filename;
+    size_t dot_pos = name.find_last_of('.');
+    if (dot_pos != string::npos) {
+        name = name.substr(0, dot_pos);
+    }
+    if (name.length() > 1) {
+        return name.substr(1);
+    }
+    return "0";
+}
+
+double elapsed_ms(chrono::high_resolution_clock::time_point start) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count() / 1000.0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc > 4) {
+        cerr << "Usage: " << argv[0] << " <X_file.h5> <W_file.h5> [max_workers]" << endl;
+        cerr << "Example: " << argv[0] << " d5.h5 w5.h5 8" << endl;
+        return 1;
+    }
+    string x_filename = argv[1];
+    string w_filename = argv[2];
+    int max_workers = argc >= 4 ? stoi(argv[3]) : hw_config::NUM_THREADS;
+
+    try {
+        string x_path = "../dataset/X/" + x_filename;
+        string w_path = "../dataset/W/" + w_filename;
+        string postfix = extract_postfix(x_filename);
+        const string experiment = "shm";
+
+        reset_log_experiment(postfix, experiment);
+
+        CSR X = load_X_h5_as_csr(x_path, "");
+        int W_rows, W_cols;
+        vector<float> W = load_W_h5(w_path, W_rows, W_cols, "");
+        vector<float> Y_ref = spmm_baseline(X, W, W_rows, W_cols);
+
+        stringstream ss;
+        ss << fixed << setprecision(3);
+        ss << "rows_X: " << X.nrows << ", cols_X: " << X.ncols << ", nnz_X: " << X.nnz << ", K: " << W_cols << endl;
+        ss << left << setw(8) << "P" << right << setw(14) << "omp ms" << setw(12) << "mode"
+           << setw(12) << "setup ms" << setw(12) << "launch ms" << setw(12) << "total ms"
+           << setw(14) << "vs omp(P)" << setw(14) << "vs shm(1)" << setw(12) << "imbalance"
+           << setw(14) << "check" << endl;
+
+        // Scaling: P worker processes vs P OpenMP threads, both on the same X and W
+        double shm_1[2] = {0.0, 0.0};
+        vector<float> Y_omp = make_huge_page_vector<float>(Y_ref.size());
+        Span<float> Y_span(Y_omp.data(), Y_omp.size());
+        for (int P = 1; P <= max_workers; P *= 2) {
+            omp_set_num_threads(P);
+            double omp_ms = 1e30;
+            for (int rep = 0; rep < 3; rep++) {
+                auto start = chrono::high_resolution_clock::now();
+                spmm_baseline_into(X, W, W_rows, W_cols, Y_span);
+                omp_ms = min(omp_ms, elapsed_ms(start));
+            }
+
+            for (int m = 0; m < 2; m++) {
+                ShmSpmmConfig cfg;
+                cfg.num_workers = P;
+                cfg.mode = m == 0 ? ShmShardMode::GenePanels : ShmShardMode::CellRanges;
+                ShmSpmm session(X, W, W_rows, W_cols, cfg);
+                ShmSpmmStats stats, best;
+                vector<float> Y;
+                best.total_ms = 1e30;
+                for (int rep = 0; rep < 3; rep++) {
+                    Y = session.run(&stats, rep == 0 ? postfix : "");
+                    if (stats.total_ms < best.total_ms) best = stats;
+                }
+                if (P == 1) shm_1[m] = best.total_ms;
+
+                // Gene panels must match spmm_baseline exactly; cell ranges sum partials in another order
+                string check;
+                if (m == 0) {
+                    size_t mismatches = 0;
+                    for (size_t i = 0; i < Y_ref.size(); i++) {
+                        if (Y[i] != Y_ref[i]) mismatches++;
+                    }
+                    check = to_string(mismatches) + " diff";
+                } else {
+                    // Max abs difference relative to the largest |Y|
+                    double max_diff = 0.0, max_abs = 0.0;
+                    for (size_t i = 0; i < Y_ref.size(); i++) {
+                        max_diff = max(max_diff, fabs(static_cast<double>(Y[i]) - Y_ref[i]));
+                        max_abs = max(max_abs, static_cast<double>(fabs(Y_ref[i])));
+                    }
+                    double max_rel = max_abs > 0.0 ? max_diff / max_abs : max_diff;
+                    stringstream rel;
+                    rel << scientific << setprecision(1) << max_rel << " rel";
+                    check = rel.str();
+                }
+                double max_w = *max_element(best.worker_ms.begin(), best.worker_ms.end());
+                double mean_w = 0.0;
+                for (double t : best.worker_ms) mean_w += t;
+                mean_w /= P;
+
+                ss << left << setw(8) << P << right << setw(14) << omp_ms
+                   << setw(12) << (m == 0 ? "genes" : "cells") << setw(12) << best.setup_ms
+                   << setw(12) << best.launch_ms << setw(12) << best.total_ms
+                   << setw(13) << omp_ms / best.total_ms << "x" << setw(13) << shm_1[m] / best.total_ms << "x"
+                   << setw(12) << (mean_w > 0.0 ? max_w / mean_w : 1.0) << setw(14) << check << endl;
+            }
+        }
+
+        log_to_file_experiment(postfix, experiment, ss.str());
+        cout << ss.str();
+        cout << "spmm done" << endl;
+
+        return 0;
+
+    } catch (const exception& e) {
+        cerr << "  ✗ Error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,160 @@
+#include "../include/disk_to_memory.hpp"
+#include "../include/spgemm.hpp"
+#include "../include/spmm_transpose.hpp"
+#include "../include/csr.hpp"
+#include "../include/logger.hpp"
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <string>
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+
+/**
+ * Extract postfix from filename (e.g., "d0.h5" -> "0")
+ */
+string extract_postfix(const string& filename) {
+    string name = filename;
+    size_t dot_pos = name.find_last_of('.');
+    if (dot_pos != string::npos) {
+        name = name.substr(0, dot_pos);
+    }
+    if (name.length() > 1) {
+        return name.substr(1);
+    }
+    return "0";
+}
+
+/**
+ * Max relative difference of C against dense reference rows
+ * C_ref(i, :) = A(i, :) * B for a sample of rows (no pruning).
+ */
+double check_sampled_rows(const CSR& A, const CSR& B, const CSR& C, int samples) {
+    double max_diff = 0.0;
+    int step = max(1, A.nrows / max(1, samples));
+    vector<double> ref(B.ncols);
+    for (int i = 0; i < A.nrows; i += step) {
+        fill(ref.begin(), ref.end(), 0.0);
+        for (int idx = A.indptr[i]; idx < A.indptr[i + 1]; idx++) {
+            int k = A.indices[idx];
+            for (int jdx = B.indptr[k]; jdx < B.indptr[k + 1]; jdx++) {
+                ref[B.indices[jdx]] += static_cast<double>(A.data[idx]) * B.data[jdx];
+            }
+        }
+        double scale = 1.0;
+        for (double v : ref) scale = max(scale, fabs(v));
+        vector<double> got(B.ncols, 0.0);
+        for (int idx = C.indptr[i]; idx < C.indptr[i + 1]; idx++) got[C.indices[idx]] = C.data[idx];
+        for (int c = 0; c < B.ncols; c++) max_diff = max(max_diff, fabs(got[c] - ref[c]) / scale);
+    }
+    return max_diff;
+}
+
+/**
+ * Identical structure and values
+ */
+bool same_csr(const CSR& a, const CSR& b) {
+    return a.nrows == b.nrows && a.ncols == b.ncols && a.indptr == b.indptr
+        && a.indices == b.indices && a.data == b.data;
+}
+
+void report(const string& name, const SpgemmStats& st, stringstream& ss) {
+    ss << fixed << setprecision(3);
+    ss << name << " products: " << st.products << ", nnz out: " << st.nnz_out
+       << ", panels: " << st.num_panels << ", dense/hash row-panels: "
+       << st.dense_rows << "/" << st.hash_rows << endl;
+    ss << name << " symbolic: " << st.symbolic_ms << "ms, numeric: " << st.numeric_ms
+       << "ms, total: " << st.total_ms << "ms" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 3) {
+        cerr << "Usage: " << argv[0] << " <X_file.h5> [top_k]" << endl;
+        cerr << "Example: " << argv[0] << " d4.h5 50" << endl;
+        return 1;
+    }
+    string x_filename = argv[1];
+
+    try {
+        string x_path = "../dataset/X/" + x_filename;
+        string postfix = extract_postfix(x_filename);
+        const string experiment = "spgemm";
+        int top_k = (argc == 3) ? stoi(argv[2]) : 50;
+
+        reset_log_experiment(postfix, experiment);
+
+        CSR X = load_X_h5_as_csr(x_path, "");
+        CSR XT = transpose_csr(X);
+
+        stringstream ss;
+        ss << "rows_X: " << X.nrows << ", cols_X: " << X.ncols << ", nnz_X: " << X.nnz << endl;
+
+        // Gene-gene co-expression: accumulators and panel widths must agree exactly
+        SpgemmParams p_auto;
+        SpgemmStats st;
+        CSR G = spgemm(X, XT, p_auto, &st);
+        report("genes auto", st, ss);
+
+        SpgemmParams p_dense;
+        p_dense.accumulator = SpgemmAccumulator::Dense;
+        CSR G_dense = spgemm(X, XT, p_dense, &st);
+        report("genes dense", st, ss);
+
+        SpgemmParams p_hash;
+        p_hash.accumulator = SpgemmAccumulator::Hash;
+        CSR G_hash = spgemm(X, XT, p_hash, &st);
+        report("genes hash", st, ss);
+
+        SpgemmParams p_panel;
+        p_panel.panel_cols = 256;
+        CSR G_panel = spgemm(X, XT, p_panel, &st);
+        report("genes auto panel256", st, ss);
+
+        ss << "genes dense == auto: " << (same_csr(G_dense, G) ? "yes" : "no")
+           << ", hash == auto: " << (same_csr(G_hash, G) ? "yes" : "no")
+           << ", panel256 == auto: " << (same_csr(G_panel, G) ? "yes" : "no") << endl;
+        ss << scientific << setprecision(3)
+           << "genes max rel diff vs reference (sampled rows): " << check_sampled_rows(X, XT, G, 32) << endl;
+
+        // Panel split must not rely on sorted columns in B: even positions of each row, then odd
+        CSR XT_unsorted = XT;
+        for (int r = 0; r < XT.nrows; r++) {
+            int dest = XT.indptr[r];
+            for (int parity = 0; parity < 2; parity++) {
+                for (int idx = XT.indptr[r] + parity; idx < XT.indptr[r + 1]; idx += 2) {
+                    XT_unsorted.indices[dest] = XT.indices[idx];
+                    XT_unsorted.data[dest] = XT.data[idx];
+                    dest++;
+                }
+            }
+        }
+        CSR G_unsorted = spgemm(X, XT_unsorted, p_panel, &st);
+        ss << "genes panel256 unsorted B: same structure: "
+           << (G_unsorted.indptr == G.indptr && G_unsorted.indices == G.indices ? "yes" : "no")
+           << ", max rel diff vs reference (sampled rows): " << check_sampled_rows(X, XT, G_unsorted, 32) << endl;
+
+        // Pruned outputs
+        SpgemmParams p_topk;
+        p_topk.top_k = top_k;
+        p_topk.exclude_diagonal = true;
+        CSR G_topk = gene_coexpression(X, p_topk, &st, postfix);
+        report("genes top" + to_string(top_k), st, ss);
+
+        CSR S_topk = cell_similarity(X, p_topk, &st, postfix);
+        report("cells top" + to_string(top_k), st, ss);
+        ss << "cells nnz unpruned: " << st.nnz_unpruned << " (dense would be "
+           << static_cast<size_t>(X.ncols) * X.ncols << ")" << endl;
+
+        log_to_file_experiment(postfix, experiment, ss.str());
+        cout << ss.str();
+        cout << "spgemm done" << endl;
+
+        return 0;
+
+    } catch (const exception& e) {
+        cerr << "  ✗ Error: " << e.what() << endl;
+        return 1;
+    }
+}
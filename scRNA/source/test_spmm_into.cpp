@@ -0,0 +1,161 @@
+#include "../include/disk_to_memory.hpp"
+#include "../include/spmm.hpp"
+#include "../include/tile_spmm.hpp"
+#include "../include/tiler.hpp"
+#include "../include/span.hpp"
+#include "../include/csr.hpp"
+#include "../include/logger.hpp"
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <string>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+/*
+ * Global allocation counter (all operator new calls in the process).
+ */
+static atomic<size_t> g_allocations{0};
+
+void* operator new(size_t size) {
+    g_allocations++;
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+/**
+ * Extract postfix from filename (e.g., "d0.h5" -> "0")
+ */
+string extract_postfix(const string& filename) {
+    string name = filename;
+    size_t dot_pos = name.find_last_of('.');
+    if (dot_pos != string::npos) {
+        name = name.substr(0, dot_pos);
+    }
+    if (name.length() > 1) {
+        return name.substr(1);
+    }
+    return "0";
+}
+
+double elapsed_ms(chrono::high_resolution_clock::time_point start) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count() / 1000.0;
+}
+
+size_t count_mismatches(const float* a, const float* b, size_t n) {
+    size_t m = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (a[i] != b[i]) m++;
+    }
+    return m;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        cerr << "Usage: " << argv[0] << " <X_file.h5> <W_file.h5>" << endl;
+        cerr << "Example: " << argv[0] << " d5.h5 w5.h5" << endl;
+        return 1;
+    }
+    string x_filename = argv[1];
+    string w_filename = argv[2];
+
+    try {
+        string x_path = "../dataset/X/" + x_filename;
+        string w_path = "../dataset/W/" + w_filename;
+        string postfix = extract_postfix(x_filename);
+        const string experiment = "spmminto";
+        const int repeats = 10;
+
+        reset_log_experiment(postfix, experiment);
+
+        CSR X = load_X_h5_as_csr(x_path, "");
+        int W_rows, W_cols;
+        vector<float> W = load_W_h5(w_path, W_rows, W_cols, "");
+        size_t y_size = static_cast<size_t>(X.nrows) * W_cols;
+
+        stringstream ss;
+        ss << "rows_X: " << X.nrows << ", cols_X: " << X.ncols << ", nnz_X: " << X.nnz
+           << ", K: " << W_cols << ", repeats: " << repeats << endl;
+        ss << fixed << setprecision(3);
+
+        // Repeated baseline runs: a fresh Y per call vs one reused buffer
+        vector<float> Y_ref = spmm_baseline(X, W, W_rows, W_cols);
+        size_t a0 = g_allocations;
+        auto start = chrono::high_resolution_clock::now();
+        for (int r = 0; r < repeats; r++) {
+            vector<float> Y = spmm_baseline(X, W, W_rows, W_cols);
+        }
+        double alloc_ms = elapsed_ms(start) / repeats;
+        size_t alloc_count = g_allocations - a0;
+
+        vector<float> Y_buf(y_size);
+        a0 = g_allocations;
+        start = chrono::high_resolution_clock::now();
+        for (int r = 0; r < repeats; r++) {
+            spmm_baseline_into(X, W, W_rows, W_cols, Y_buf);
+        }
+        double into_ms = elapsed_ms(start) / repeats;
+        size_t into_count = g_allocations - a0;
+
+        ss << "spmm_baseline: " << alloc_ms << "ms/run, heap allocations: " << alloc_count << endl;
+        ss << "spmm_baseline_into (reused Y): " << into_ms << "ms/run, heap allocations: " << into_count << endl;
+        ss << "  mismatches vs spmm_baseline: " << count_mismatches(Y_buf.data(), Y_ref.data(), y_size) << endl;
+
+        // Multi-W batch: two products side by side in one buffer, via per-product sub-spans
+        vector<float> Y_two(2 * y_size, 0.0f);
+        spmm_baseline_into(X, W, W_rows, W_cols, Span<float>(Y_two.data(), y_size), false);
+        spmm_baseline_into(X, W, W_rows, W_cols, Span<float>(Y_two).subspan(y_size, y_size), false);
+        ss << "two-product buffer mismatches: "
+           << count_mismatches(Y_two.data(), Y_ref.data(), y_size)
+              + count_mismatches(Y_two.data() + y_size, Y_ref.data(), y_size) << endl;
+
+        // Accumulate: zero_Y = false adds onto existing contents (rounding differs from Y + Y)
+        spmm_baseline_into(X, W, W_rows, W_cols, Y_buf, false);
+        double acc_max = 0.0, ref_max = 0.0;
+        for (size_t i = 0; i < y_size; i++) {
+            acc_max = max(acc_max, fabs(static_cast<double>(Y_buf[i]) - 2.0 * Y_ref[i]));
+            ref_max = max(ref_max, fabs(2.0 * Y_ref[i]));
+        }
+        ss << "accumulate (Y += X*W) max rel diff vs 2*Y: " << scientific
+           << (ref_max > 0.0 ? acc_max / ref_max : acc_max) << fixed << endl;
+
+        // Tiled and predictor engines into the same (dirty) buffer
+        TilingConfig cfg;
+        auto tiled = spmm_tiled(X, W, W_rows, W_cols, cfg);
+        size_t num_tiles = spmm_tiled_into(X, W, W_rows, W_cols, cfg, Y_buf);
+        ss << "spmm_tiled_into: " << num_tiles << " tiles, mismatches vs spmm_tiled: "
+           << count_mismatches(Y_buf.data(), tiled.first.data(), y_size) << endl;
+
+        vector<Tile> tiles = make_2d_tiles(X, cfg, "");
+        vector<float> Y_pred = process_tiles_with_predictor(X, W, W_rows, W_cols, tiles, "");
+        process_tiles_with_predictor_into(X, W, W_rows, W_cols, tiles, Y_buf, true, "");
+        ss << "process_tiles_with_predictor_into mismatches: "
+           << count_mismatches(Y_buf.data(), Y_pred.data(), y_size) << endl;
+
+        // Undersized output is rejected
+        try {
+            spmm_baseline_into(X, W, W_rows, W_cols, Span<float>(Y_buf.data(), y_size - 1));
+            ss << "undersized buffer: accepted (unexpected)" << endl;
+        } catch (const runtime_error& e) {
+            ss << "undersized buffer: rejected (" << e.what() << ")" << endl;
+        }
+
+        log_to_file_experiment(postfix, experiment, ss.str());
+        cout << ss.str();
+        cout << "spmm done" << endl;
+
+        return 0;
+
+    } catch (const exception& e) {
+        cerr << "  ✗ Error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,161 @@
+#include "../include/spmm_plan.hpp"
+#include "../include/disk_to_memory.hpp"
+#include "../include/spmm.hpp"
+#include "../include/tile_spmm.hpp"
+#include "../include/tiler.hpp"
+#include "../include/csr.hpp"
+#include "../include/logger.hpp"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * Extract postfix from filename (e.g., "d0.h5" -> "0")
+ */
+string extract_postfix(const string& filename) {
+    string name = filename;
+    size_t dot_pos = name.find_last_of('.');
+    if (dot_pos != string::npos) {
+        name = name.substr(0, dot_pos);
+    }
+    if (name.length() > 1) {
+        return name.substr(1);
+    }
+    return "0";
+}
+
+double elapsed_ms(chrono::high_resolution_clock::time_point start) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count() / 1000.0;
+}
+
+/**
+ * Largest |a - b| relative to the largest |b|
+ */
+double max_rel_diff(const vector<float>& a, const vector<float>& b) {
+    double max_diff = 0.0, max_abs = 0.0;
+    for (size_t i = 0; i < b.size(); i++) {
+        max_diff = max(max_diff, fabs(static_cast<double>(a[i]) - b[i]));
+        max_abs = max(max_abs, static_cast<double>(fabs(b[i])));
+    }
+    return max_abs > 0.0 ? max_diff / max_abs : max_diff;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc > 4) {
+        cerr << "Usage: " << argv[0] << " <X_file.h5> <W_file.h5> [num_W]" << endl;
+        cerr << "Example: " << argv[0] << " d5.h5 w5.h5 8" << endl;
+        return 1;
+    }
+    string x_filename = argv[1];
+    string w_filename = argv[2];
+    int num_W = argc >= 4 ? stoi(argv[3]) : 4;
+
+    try {
+        string x_path = "../dataset/X/" + x_filename;
+        string w_path = "../dataset/W/" + w_filename;
+        string postfix = extract_postfix(x_filename);
+        const string experiment = "plan";
+
+        reset_log_experiment(postfix, experiment);
+
+        CSR X = load_X_h5_as_csr(x_path, "");
+        int W_rows, W_cols;
+        vector<float> W = load_W_h5(w_path, W_rows, W_cols, "");
+
+        // The loaded W plus num_W - 1 random ones of the same shape
+        vector<vector<float>> Ws;
+        Ws.push_back(W);
+        mt19937 rng(42);
+        uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        for (int w = 1; w < num_W; w++) {
+            vector<float> Wr(W.size());
+            for (auto& v : Wr) v = dist(rng);
+            Ws.push_back(std::move(Wr));
+        }
+
+        SpmmPlan plan(X, SpmmPlanConfig(), postfix);
+        const SpmmPlanInfo& info = plan.info();
+
+        // Unplanned entry points on the loaded W (each redoes its analysis)
+        auto start = chrono::high_resolution_clock::now();
+        vector<float> Y_ref = spmm_baseline(X, W, W_rows, W_cols);
+        double baseline_ms = elapsed_ms(start);
+        TilingConfig tiling;
+        start = chrono::high_resolution_clock::now();
+        auto tiled = spmm_tiled(X, W, W_rows, W_cols, tiling);
+        double tiled_ms = elapsed_ms(start);
+        start = chrono::high_resolution_clock::now();
+        vector<Tile> tiles = make_2d_tiles(X, tiling);
+        predict_tile_density(tiles);
+        vector<float> Y_pred = process_tiles_with_predictor(X, W, W_rows, W_cols, tiles, "");
+        double predictor_ms = elapsed_ms(start);
+
+        stringstream ss;
+        ss << fixed << setprecision(3);
+        ss << "rows_X: " << X.nrows << ", cols_X: " << X.ncols << ", nnz_X: " << X.nnz << ", K: " << W_cols << endl;
+        ss << "inspect: " << info.inspect_ms << "ms (heavy rows " << info.heavy_ms << "ms, tiling " << info.tiling_ms
+           << "ms, conversion " << info.convert_ms << "ms, partition " << info.partition_ms << "ms)" << endl;
+        ss << "routing: " << info.heavy_rows << " heavy rows (" << info.heavy_nnz << " nnz), " << info.dense_tiles
+           << " dense tiles of " << info.num_tiles << " (" << info.dense_nnz << " nnz), " << info.sparse_nnz
+           << " sparse nnz in " << info.sparse_panels << " panels, plan " << info.plan_bytes / 1e6 << " MB" << endl;
+
+        // Execute against every W, with spmm_baseline on the same W for the timing check.
+        // One untimed execute first, so both timed calls find W in cache
+        vector<float> Y(static_cast<size_t>(X.nrows) * W_cols);
+        double exec_sum = 0.0, exec_best = 0.0, baseline_best = 0.0;
+        for (int w = 0; w < num_W; w++) {
+            plan.execute_into(Ws[w], W_rows, W_cols, Y);
+            start = chrono::high_resolution_clock::now();
+            vector<float> Y_check = spmm_baseline(X, Ws[w], W_rows, W_cols);
+            double b_ms = elapsed_ms(start);
+            baseline_best = w == 0 ? b_ms : min(baseline_best, b_ms);
+            SpmmPlanExecStats st;
+            plan.execute_into(Ws[w], W_rows, W_cols, Y, &st);
+            exec_sum += st.total_ms;
+            exec_best = w == 0 ? st.total_ms : min(exec_best, st.total_ms);
+            ss << "execute W" << w << ": " << st.total_ms << "ms (sparse " << st.sparse_ms << "ms, dense "
+               << st.dense_ms << "ms, heavy " << st.heavy_ms << "ms), max rel diff vs baseline "
+               << scientific << setprecision(1) << max_rel_diff(Y, Y_check) << fixed << setprecision(3) << endl;
+        }
+        double exec_ms = exec_sum / num_W;
+        ss << "mean execute: " << exec_ms << "ms" << endl;
+        // The plan keeps whatever it cannot do cheaper in spmm_baseline's loop, so it must not
+        // lose to it. Best of num_W runs each, with a 5% allowance for timer noise
+        ss << "best execute: " << exec_best << "ms, best baseline: " << baseline_best << "ms, execute vs baseline: "
+           << setprecision(2) << exec_best / baseline_best << "x, "
+           << (exec_best <= baseline_best * 1.05 ? "ok" : "SLOWER") << setprecision(3) << endl;
+
+        auto report = [&](const string& name, double ms) {
+            double n = plan.break_even_runs(ms, exec_ms);
+            ss << setw(12) << name << ": " << setw(10) << ms << "ms per call, break-even after ";
+            if (isinf(n)) {
+                ss << "never (plan is not faster)" << endl;
+            } else {
+                ss << static_cast<long long>(ceil(n)) << " executions" << endl;
+            }
+        };
+        report("baseline", baseline_ms);
+        report("tiled", tiled_ms);
+        report("predictor", predictor_ms);
+        ss << scientific << setprecision(1) << "tiled max rel diff: " << max_rel_diff(tiled.first, Y_ref)
+           << ", predictor max rel diff: " << max_rel_diff(Y_pred, Y_ref) << endl;
+
+        log_to_file_experiment(postfix, experiment, ss.str());
+        cout << ss.str();
+        cout << "spmm done" << endl;
+
+        return 0;
+
+    } catch (const exception& e) {
+        cerr << "  ✗ Error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,166 @@
+#include "../include/disk_to_memory.hpp"
+#include "../include/spmm.hpp"
+#include "../include/spmm_stats.hpp"
+#include "../include/tile_spmm.hpp"
+#include "../include/tiler.hpp"
+#include "../include/csr.hpp"
+#include "../include/logger.hpp"
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <string>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+
+using namespace std;
+
+/**
+ * Extract postfix from filename (e.g., "d0.h5" -> "0")
+ */
+string extract_postfix(const string& filename) {
+    string name = filename;
+    size_t dot_pos = name.find_last_of('.');
+    if (dot_pos != string::npos) {
+        name = name.substr(0, dot_pos);
+    }
+    if (name.length() > 1) {
+        return name.substr(1);
+    }
+    return "0";
+}
+
+double elapsed_ms(chrono::high_resolution_clock::time_point start) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count() / 1000.0;
+}
+
+/**
+ * Largest relative difference over all statistics; counts must match exactly
+ */
+double stats_max_rel_diff(const SpmmStats& a, const SpmmStats& b, size_t& count_mismatches) {
+    auto rel = [](double x, double y) { return fabs(x - y) / max(1.0, fabs(y)); };
+    double d = 0.0;
+    count_mismatches = 0;
+    for (int i = 0; i < b.nrows; i++) {
+        if (a.row_nnz[i] != b.row_nnz[i]) count_mismatches++;
+        d = max(d, rel(a.row_sum[i], b.row_sum[i]));
+        d = max(d, rel(a.row_sumsq[i], b.row_sumsq[i]));
+    }
+    for (int c = 0; c < b.ncols; c++) {
+        if (a.col_nnz[c] != b.col_nnz[c]) count_mismatches++;
+        d = max(d, rel(a.col_sum[c], b.col_sum[c]));
+    }
+    return d;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        cerr << "Usage: " << argv[0] << " <X_file.h5> <W_file.h5>" << endl;
+        cerr << "Example: " << argv[0] << " d5.h5 w5.h5" << endl;
+        return 1;
+    }
+    string x_filename = argv[1];
+    string w_filename = argv[2];
+
+    try {
+        string x_path = "../dataset/X/" + x_filename;
+        string w_path = "../dataset/W/" + w_filename;
+        string postfix = extract_postfix(x_filename);
+        const string experiment = "spmmstats";
+        const int repeats = 5;
+
+        reset_log_experiment(postfix, experiment);
+
+        CSR X = load_X_h5_as_csr(x_path, "");
+        int W_rows, W_cols;
+        vector<float> W = load_W_h5(w_path, W_rows, W_cols, "");
+
+        stringstream ss;
+        ss << "rows_X: " << X.nrows << ", cols_X: " << X.ncols << ", nnz_X: " << X.nnz << endl;
+        ss << fixed << setprecision(3);
+
+        // Separate passes: SpMM, then a standalone QC pass
+        auto start = chrono::high_resolution_clock::now();
+        vector<float> Y_ref;
+        for (int r = 0; r < repeats; r++) Y_ref = spmm_baseline(X, W, W_rows, W_cols);
+        double spmm_ms = elapsed_ms(start) / repeats;
+
+        SpmmStats stats_ref;
+        start = chrono::high_resolution_clock::now();
+        for (int r = 0; r < repeats; r++) compute_spmm_stats(X, stats_ref);
+        double qc_ms = elapsed_ms(start) / repeats;
+
+        // Fused baseline
+        SpmmStats stats_fused;
+        start = chrono::high_resolution_clock::now();
+        vector<float> Y_fused;
+        for (int r = 0; r < repeats; r++) Y_fused = spmm_baseline(X, W, W_rows, W_cols, "", &stats_fused);
+        double fused_ms = elapsed_ms(start) / repeats;
+
+        size_t y_mismatches = 0;
+        for (size_t i = 0; i < Y_ref.size(); i++) {
+            if (Y_fused[i] != Y_ref[i]) y_mismatches++;
+        }
+
+        ss << "baseline spmm time: " << spmm_ms << "ms" << endl;
+        ss << "standalone qc pass time: " << qc_ms << "ms" << endl;
+        ss << "separate spmm + qc time: " << spmm_ms + qc_ms << "ms" << endl;
+        ss << "fused spmm + stats time: " << fused_ms << "ms (overhead vs spmm: "
+           << setprecision(2) << 100.0 * (fused_ms - spmm_ms) / spmm_ms << "%)" << endl;
+        ss << setprecision(3);
+        ss << "fused Y mismatches vs baseline: " << y_mismatches << endl;
+
+        // Tiled engines with the same sink
+        TilingConfig cfg;
+        SpmmStats stats_tiled;
+        start = chrono::high_resolution_clock::now();
+        spmm_tiled(X, W, W_rows, W_cols, cfg, "", &stats_tiled);
+        double tiled_ms = elapsed_ms(start);
+
+        vector<Tile> tiles = make_2d_tiles(X, cfg, "");
+        SpmmStats stats_pred;
+        start = chrono::high_resolution_clock::now();
+        process_tiles_with_predictor(X, W, W_rows, W_cols, tiles, "", &stats_pred);
+        double pred_ms = elapsed_ms(start);
+
+        ss << "tiled spmm + stats time: " << tiled_ms << "ms" << endl;
+        ss << "predictor spmm + stats time: " << pred_ms << "ms" << endl;
+
+        size_t mm_fused, mm_tiled, mm_pred;
+        double d_fused = stats_max_rel_diff(stats_fused, stats_ref, mm_fused);
+        double d_tiled = stats_max_rel_diff(stats_tiled, stats_ref, mm_tiled);
+        double d_pred = stats_max_rel_diff(stats_pred, stats_ref, mm_pred);
+        ss << scientific << setprecision(3);
+        ss << "baseline stats max rel diff: " << d_fused << ", count mismatches: " << mm_fused << endl;
+        ss << "tiled stats max rel diff: " << d_tiled << ", count mismatches: " << mm_tiled << endl;
+        ss << "predictor stats max rel diff: " << d_pred << ", count mismatches: " << mm_pred << endl;
+
+        // A few derived QC numbers
+        double lib_min = stats_fused.col_sum.empty() ? 0.0 : stats_fused.col_sum[0];
+        double lib_max = lib_min, lib_total = 0.0;
+        for (double v : stats_fused.col_sum) {
+            lib_min = min(lib_min, v);
+            lib_max = max(lib_max, v);
+            lib_total += v;
+        }
+        vector<double> gene_var = spmm_stats_row_variance(stats_fused);
+        int expressed = 0;
+        for (int n : stats_fused.row_nnz) expressed += (n > 0);
+        ss << fixed << setprecision(1);
+        ss << "cell library size min/mean/max: " << lib_min << " / "
+           << (X.ncols > 0 ? lib_total / X.ncols : 0.0) << " / " << lib_max << endl;
+        ss << "genes expressed in at least one cell: " << expressed << " of " << X.nrows << endl;
+        ss << setprecision(4) << "max gene variance: "
+           << (gene_var.empty() ? 0.0 : *max_element(gene_var.begin(), gene_var.end())) << endl;
+
+        log_to_file_experiment(postfix, experiment, ss.str());
+        cout << ss.str();
+        cout << "spmm done" << endl;
+
+        return 0;
+
+    } catch (const exception& e) {
+        cerr << "  ✗ Error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,154 @@
+#include "../include/disk_to_memory.hpp"
+#include "../include/spmm.hpp"
+#include "../include/spmm_transpose.hpp"
+#include "../include/csr.hpp"
+#include "../include/logger.hpp"
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <string>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <omp.h>
+
+using namespace std;
+
+/**
+ * Extract postfix from filename (e.g., "d0.h5" -> "0")
+ */
+string extract_postfix(const string& filename) {
+    string name = filename;
+    size_t dot_pos = name.find_last_of('.');
+    if (dot_pos != string::npos) {
+        name = name.substr(0, dot_pos);
+    }
+    if (name.length() > 1) {
+        return name.substr(1);
+    }
+    return "0";
+}
+
+/**
+ * Serial double-precision reference for Z = X^T * M
+ */
+vector<double> spmm_transpose_reference(const CSR& X, const vector<float>& M, int M_cols) {
+    vector<double> Z(static_cast<size_t>(X.ncols) * M_cols, 0.0);
+    for (int i = 0; i < X.nrows; i++) {
+        for (int idx = X.indptr[i]; idx < X.indptr[i + 1]; idx++) {
+            double x_val = X.data[idx];
+            for (int j = 0; j < M_cols; j++) {
+                Z[static_cast<size_t>(X.indices[idx]) * M_cols + j] += x_val * M[static_cast<size_t>(i) * M_cols + j];
+            }
+        }
+    }
+    return Z;
+}
+
+double max_rel_diff(const vector<float>& Z, const vector<double>& Z_ref) {
+    double max_abs = 0.0, max_ref = 0.0;
+    for (size_t i = 0; i < Z.size(); i++) {
+        max_abs = max(max_abs, fabs(Z[i] - Z_ref[i]));
+        max_ref = max(max_ref, fabs(Z_ref[i]));
+    }
+    return max_ref > 0.0 ? max_abs / max_ref : max_abs;
+}
+
+double elapsed_ms(chrono::high_resolution_clock::time_point start) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count() / 1000.0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        cerr << "Usage: " << argv[0] << " <X_file.h5> <W_file.h5>" << endl;
+        cerr << "Example: " << argv[0] << " d5.h5 w5.h5" << endl;
+        return 1;
+    }
+    string x_filename = argv[1];
+    string w_filename = argv[2];
+
+    try {
+        string x_path = "../dataset/X/" + x_filename;
+        string w_path = "../dataset/W/" + w_filename;
+        string postfix = extract_postfix(x_filename);
+        const string experiment = "spmmT";
+        const int repeats = 5;
+
+        reset_log_experiment(postfix, experiment);
+
+        CSR X = load_X_h5_as_csr(x_path, "");
+        int W_rows, W_cols;
+        vector<float> W = load_W_h5(w_path, W_rows, W_cols, "");
+
+        // Y = X * W (genes x K) is the natural input of a transposed product (back to cells x K)
+        vector<float> Y = spmm_baseline(X, W, W_rows, W_cols);
+        int Y_rows = X.nrows;
+        vector<double> Z_ref = spmm_transpose_reference(X, Y, W_cols);
+
+        int threads = omp_get_max_threads();
+        stringstream ss;
+        ss << "rows_X: " << X.nrows << ", cols_X: " << X.ncols << ", nnz_X: " << X.nnz
+           << ", K: " << W_cols << ", threads: " << threads << endl;
+        ss << fixed << setprecision(3);
+
+        // Private buffers
+        auto start = chrono::high_resolution_clock::now();
+        vector<float> Z_priv;
+        for (int r = 0; r < repeats; r++) {
+            Z_priv = spmm_transpose(X, Y, Y_rows, W_cols, TransposeStrategy::PrivateBuffers);
+        }
+        double priv_ms = elapsed_ms(start) / repeats;
+
+        // Cached transpose: first call pays the build, the rest reuse it
+        TransposeCache cache;
+        start = chrono::high_resolution_clock::now();
+        vector<float> Z_cached = spmm_transpose(X, Y, Y_rows, W_cols, TransposeStrategy::CachedTranspose, &cache);
+        double cached_first_ms = elapsed_ms(start);
+        start = chrono::high_resolution_clock::now();
+        for (int r = 0; r < repeats; r++) {
+            Z_cached = spmm_transpose(X, Y, Y_rows, W_cols, TransposeStrategy::CachedTranspose, &cache);
+        }
+        double cached_ms = elapsed_ms(start) / repeats;
+
+        // Auto (fresh cache, so the choice reflects the heuristic rather than an existing X^T)
+        TransposeCache auto_cache;
+        TransposeStrategy chosen = select_transpose_strategy(X, W_cols, threads, &auto_cache);
+        start = chrono::high_resolution_clock::now();
+        vector<float> Z_auto = spmm_transpose(X, Y, Y_rows, W_cols, TransposeStrategy::Auto, &auto_cache, postfix);
+        double auto_ms = elapsed_ms(start);
+
+        ss << "private_buffers time: " << priv_ms << "ms" << endl;
+        ss << "cached_transpose build time: " << cache.build_ms << "ms" << endl;
+        ss << "cached_transpose first call time: " << cached_first_ms << "ms" << endl;
+        ss << "cached_transpose reuse time: " << cached_ms << "ms" << endl;
+        if (priv_ms > cached_ms) {
+            ss << "cached_transpose break-even calls: "
+               << static_cast<int>(ceil(cache.build_ms / (priv_ms - cached_ms))) << endl;
+        } else {
+            ss << "cached_transpose break-even calls: never (private buffers faster per call)" << endl;
+        }
+        ss << "auto strategy: "
+           << (chosen == TransposeStrategy::PrivateBuffers ? "private_buffers" : "cached_transpose")
+           << ", time: " << auto_ms << "ms" << endl;
+        ss << scientific << setprecision(3);
+        ss << "private_buffers max rel diff: " << max_rel_diff(Z_priv, Z_ref) << endl;
+        ss << "cached_transpose max rel diff: " << max_rel_diff(Z_cached, Z_ref) << endl;
+        ss << "auto max rel diff: " << max_rel_diff(Z_auto, Z_ref) << endl;
+
+        // Same CSR object rescaled in place: the cache must rebuild, not return the old X^T
+        for (size_t idx = 0; idx < X.nnz; idx++) X.data[idx] *= 2.0f;
+        vector<double> Z_ref_scaled = spmm_transpose_reference(X, Y, W_cols);
+        vector<float> Z_scaled = spmm_transpose(X, Y, Y_rows, W_cols, TransposeStrategy::CachedTranspose, &cache);
+        ss << "cached_transpose after in-place rescale max rel diff: " << max_rel_diff(Z_scaled, Z_ref_scaled) << endl;
+
+        log_to_file_experiment(postfix, experiment, ss.str());
+        cout << ss.str();
+        cout << "spmm done" << endl;
+
+        return 0;
+
+    } catch (const exception& e) {
+        cerr << "  ✗ Error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,143 @@
+#include "../include/static_tiling.hpp"
+#include "../include/disk_to_memory.hpp"
+#include "../include/spmm.hpp"
+#include "../include/tiler.hpp"
+#include "../include/csr.hpp"
+#include "../include/logger.hpp"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <utility>
+
+using namespace std;
+
+/**
+ * Extract postfix from filename (e.g., "d0.h5" -> "0")
+ */
+string extract_postfix(const string& filename) {
+    string name = filename;
+    size_t dot_pos = name.find_last_of('.');
+    if (dot_pos != string::npos) {
+        name = name.substr(0, dot_pos);
+    }
+    if (name.length() > 1) {
+        return name.substr(1);
+    }
+    return "0";
+}
+
+double elapsed_ms(chrono::high_resolution_clock::time_point start) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count() / 1000.0;
+}
+
+/**
+ * Number of elements that differ from the reference bit for bit
+ */
+size_t count_mismatches(const vector<float>& a, const vector<float>& b) {
+    size_t n = 0;
+    for (size_t i = 0; i < b.size(); i++) {
+        if (a[i] != b[i]) n++;
+    }
+    return n;
+}
+
+bool same_tiles(const vector<Tile>& a, const vector<Tile>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t t = 0; t < a.size(); t++) {
+        if (a[t].row_start != b[t].row_start || a[t].row_end != b[t].row_end || a[t].col_start != b[t].col_start
+            || a[t].col_end != b[t].col_end || a[t].nnz != b[t].nnz) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc > 4) {
+        cerr << "Usage: " << argv[0] << " <X_file.h5> <W_file.h5> [runs]" << endl;
+        cerr << "Example: " << argv[0] << " d5.h5 w5.h5 3" << endl;
+        return 1;
+    }
+    string x_filename = argv[1];
+    string w_filename = argv[2];
+    int runs = argc >= 4 ? stoi(argv[3]) : 1;
+
+    try {
+        string x_path = "../dataset/X/" + x_filename;
+        string w_path = "../dataset/W/" + w_filename;
+        string postfix = extract_postfix(x_filename);
+        const string experiment = "static_tiling";
+
+        reset_log_experiment(postfix, experiment);
+
+        CSR X = load_X_h5_as_csr(x_path, "");
+        int W_rows, W_cols;
+        vector<float> W = load_W_h5(w_path, W_rows, W_cols, "");
+        vector<float> Y_ref = spmm_baseline(X, W, W_rows, W_cols);
+
+        stringstream ss;
+        ss << fixed << setprecision(3);
+        ss << "rows_X: " << X.nrows << ", cols_X: " << X.ncols << ", nnz_X: " << X.nnz << ", K: " << W_cols
+           << ", rows sorted: " << (csr_rows_sorted(X) ? "yes" : "no") << endl;
+        ss << setw(9) << "shape" << setw(10) << "tiles" << setw(13) << "tiler rt" << setw(13) << "tiler ct"
+           << setw(13) << "spmm rt" << setw(13) << "spmm ct" << setw(9) << "speedup" << setw(11) << "mismatch" << endl;
+
+        // Every instantiated shape, plus odd shapes that stay on the runtime path
+        vector<pair<int, int>> shapes;
+        for (int tr : {32, 64, 128, 256}) {
+            for (int tc : {32, 64, 128, 256}) shapes.emplace_back(tr, tc);
+        }
+        shapes.emplace_back(48, 100);
+        shapes.emplace_back(64, 1000);
+
+        vector<float> Y_rt(Y_ref.size()), Y_ct(Y_ref.size());
+        for (const auto& shape : shapes) {
+            TilingConfig rt(shape.first, shape.second);
+            TilingConfig ct(shape.first, shape.second);
+            ct.static_dispatch = true;
+            const bool dispatched = find_static_tiling(ct) != nullptr;
+
+            double tiler_rt = 0.0, tiler_ct = 0.0, spmm_rt = 0.0, spmm_ct = 0.0;
+            bool tiles_match = true;
+            size_t num_tiles = 0;
+            for (int r = 0; r < runs; r++) {
+                auto start = chrono::high_resolution_clock::now();
+                vector<Tile> tiles_rt = make_2d_tiles(X, rt);
+                tiler_rt += elapsed_ms(start);
+                start = chrono::high_resolution_clock::now();
+                vector<Tile> tiles_ct = make_2d_tiles(X, ct);
+                tiler_ct += elapsed_ms(start);
+                tiles_match = tiles_match && same_tiles(tiles_rt, tiles_ct);
+
+                start = chrono::high_resolution_clock::now();
+                num_tiles = spmm_tiled_into(X, W, W_rows, W_cols, rt, Y_rt);
+                spmm_rt += elapsed_ms(start);
+                start = chrono::high_resolution_clock::now();
+                spmm_tiled_into(X, W, W_rows, W_cols, ct, Y_ct);
+                spmm_ct += elapsed_ms(start);
+            }
+
+            ss << setw(9) << (to_string(shape.first) + "x" + to_string(shape.second)) << setw(10) << num_tiles
+               << setw(13) << tiler_rt / runs << setw(13) << tiler_ct / runs << setw(13) << spmm_rt / runs
+               << setw(13) << spmm_ct / runs << setw(8) << setprecision(2) << spmm_rt / spmm_ct << "x"
+               << setprecision(3) << setw(11) << count_mismatches(Y_ct, Y_rt)
+               << (dispatched ? "" : "  (runtime path)") << (tiles_match ? "" : "  TILES DIFFER") << endl;
+            if (count_mismatches(Y_rt, Y_ref) != 0) {
+                ss << "  runtime path differs from baseline in " << count_mismatches(Y_rt, Y_ref) << " elements" << endl;
+            }
+        }
+
+        log_to_file_experiment(postfix, experiment, ss.str());
+        cout << ss.str();
+        cout << "spmm done" << endl;
+
+        return 0;
+
+    } catch (const exception& e) {
+        cerr << "  ✗ Error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,155 @@
+#include "../include/disk_to_memory.hpp"
+#include "../include/tile_spmm.hpp"
+#include "../include/tile_arena.hpp"
+#include "../include/tiler.hpp"
+#include "../include/csr.hpp"
+#include "../include/logger.hpp"
+#include "../config/hw_config.h"
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <string>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+/*
+ * Global allocation counter: every operator new in the process goes through here,
+ * so the counts include the std::vector temporaries inside the tile kernels.
+ */
+static atomic<size_t> g_allocations{0};
+
+void* operator new(size_t size) {
+    g_allocations++;
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+/**
+ * Extract postfix from filename (e.g., "d0.h5" -> "0")
+ */
+string extract_postfix(const string& filename) {
+    string name = filename;
+    size_t dot_pos = name.find_last_of('.');
+    if (dot_pos != string::npos) {
+        name = name.substr(0, dot_pos);
+    }
+    if (name.length() > 1) {
+        return name.substr(1);
+    }
+    return "0";
+}
+
+double elapsed_ms(chrono::high_resolution_clock::time_point start) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count() / 1000.0;
+}
+
+/**
+ * The tile loop as it was before the arena: one set of std::vector temporaries per tile.
+ */
+vector<float> process_tiles_vectors(const CSR& X, const vector<float>& W, int W_rows, int W_cols,
+                                    const vector<Tile>& tiles) {
+    vector<float> Y(static_cast<size_t>(X.nrows) * W_cols, 0.0f);
+    for (const auto& tile : tiles) {
+        CSR X_tile = extract_tile_csr(X, tile);
+        vector<float> W_tile = extract_tile_W(W, W_rows, W_cols, tile);
+        int W_tile_rows = tile.col_end - tile.col_start;
+        vector<float> Y_tile = tile.density() >= hw_config::DENSE_TILE_THRESHOLD
+            ? dense_perm_spmm_tile(X_tile, W_tile, W_tile_rows, W_cols)
+            : sparse_spmm_tile(X_tile, W_tile, W_tile_rows, W_cols);
+        for (int i = 0; i < X_tile.nrows; i++) {
+            for (int j = 0; j < W_cols; j++) {
+                Y[static_cast<size_t>(tile.row_start + i) * W_cols + j] += Y_tile[i * W_cols + j];
+            }
+        }
+    }
+    return Y;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        cerr << "Usage: " << argv[0] << " <X_file.h5> <W_file.h5>" << endl;
+        cerr << "Example: " << argv[0] << " d5.h5 w5.h5" << endl;
+        return 1;
+    }
+    string x_filename = argv[1];
+    string w_filename = argv[2];
+
+    try {
+        string x_path = "../dataset/X/" + x_filename;
+        string w_path = "../dataset/W/" + w_filename;
+        string postfix = extract_postfix(x_filename);
+        const string experiment = "tilearena";
+
+        reset_log_experiment(postfix, experiment);
+
+        CSR X = load_X_h5_as_csr(x_path, "");
+        int W_rows, W_cols;
+        vector<float> W = load_W_h5(w_path, W_rows, W_cols, "");
+
+        TilingConfig cfg;
+        vector<Tile> tiles = make_2d_tiles(X, cfg, "");
+        size_t dense_tiles = 0;
+        for (const auto& tile : tiles) {
+            if (tile.density() >= hw_config::DENSE_TILE_THRESHOLD) dense_tiles++;
+        }
+
+        stringstream ss;
+        ss << "rows_X: " << X.nrows << ", cols_X: " << X.ncols << ", nnz_X: " << X.nnz
+           << ", K: " << W_cols << ", tiles: " << tiles.size() << " (dense: " << dense_tiles << ")" << endl;
+        ss << fixed << setprecision(3);
+
+        // Before: per-tile vectors
+        size_t a0 = g_allocations;
+        auto start = chrono::high_resolution_clock::now();
+        vector<float> Y_vec = process_tiles_vectors(X, W, W_rows, W_cols, tiles);
+        double vec_ms = elapsed_ms(start);
+        size_t vec_allocs = g_allocations - a0;
+
+        // After: arena-backed predictor loop (first call sizes the arena, second is steady state)
+        a0 = g_allocations;
+        start = chrono::high_resolution_clock::now();
+        vector<float> Y_first = process_tiles_with_predictor(X, W, W_rows, W_cols, tiles, "");
+        double first_ms = elapsed_ms(start);
+        size_t first_allocs = g_allocations - a0;
+
+        a0 = g_allocations;
+        start = chrono::high_resolution_clock::now();
+        vector<float> Y_arena = process_tiles_with_predictor(X, W, W_rows, W_cols, tiles, "");
+        double arena_ms = elapsed_ms(start);
+        size_t arena_allocs = g_allocations - a0;
+
+        const TileArena& arena = thread_tile_arena();
+        size_t mismatches = 0;
+        for (size_t i = 0; i < Y_vec.size(); i++) {
+            if (Y_vec[i] != Y_arena[i] || Y_first[i] != Y_arena[i]) mismatches++;
+        }
+
+        ss << "vector tile loop: " << vec_ms << "ms, heap allocations: " << vec_allocs
+           << " (" << setprecision(1) << static_cast<double>(vec_allocs) / max<size_t>(1, tiles.size())
+           << " per tile)" << setprecision(3) << endl;
+        ss << "arena tile loop (first call): " << first_ms << "ms, heap allocations: " << first_allocs << endl;
+        ss << "arena tile loop (steady state): " << arena_ms << "ms, heap allocations: " << arena_allocs
+           << " (output Y only)" << endl;
+        ss << "arena capacity: " << arena.capacity() << " bytes, peak use: " << arena.peak_bytes()
+           << " bytes, block allocations: " << arena.heap_allocations() << ", resets: " << arena.resets() << endl;
+        ss << "Y mismatches (vector vs arena): " << mismatches << endl;
+
+        log_to_file_experiment(postfix, experiment, ss.str());
+        cout << ss.str();
+        cout << "spmm done" << endl;
+
+        return 0;
+
+    } catch (const exception& e) {
+        cerr << "  ✗ Error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,137 @@
+#include "../include/disk_to_memory.hpp"
+#include "../include/spmm.hpp"
+#include "../include/incremental_spmm.hpp"
+#include "../include/y_writer.hpp"
+#include "../include/csr.hpp"
+#include "../include/logger.hpp"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <iomanip>
+#include <sstream>
+#include <cstdio>
+
+using namespace std;
+
+/**
+ * Extract postfix from filename (e.g., "d0.h5" -> "0")
+ */
+string extract_postfix(const string& filename) {
+    string name = filename;
+    size_t dot_pos = name.find_last_of('.');
+    if (dot_pos != string::npos) {
+        name = name.substr(0, dot_pos);
+    }
+    if (name.length() > 1) {
+        return name.substr(1);
+    }
+    return "0";
+}
+
+/**
+ * Read the file back and count elements that differ from Y.
+ */
+size_t count_mismatches(const vector<float>& Y, const string& path) {
+    int rows, cols;
+    vector<float> Y_read = load_Y_h5(path, rows, cols);
+    if (Y_read.size() != Y.size()) return Y.size();
+    size_t mismatches = 0;
+    for (size_t i = 0; i < Y.size(); i++) {
+        if (Y_read[i] != Y[i]) mismatches++;
+    }
+    return mismatches;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3 && argc != 4) {
+        cerr << "Usage: " << argv[0] << " <X_file.h5> <W_file.h5> [chunk_rows]" << endl;
+        cerr << "Example: " << argv[0] << " d5.h5 w5.h5 4096" << endl;
+        return 1;
+    }
+    string x_filename = argv[1];
+    string w_filename = argv[2];
+
+    try {
+        string x_path = "../dataset/X/" + x_filename;
+        string w_path = "../dataset/W/" + w_filename;
+        string postfix = extract_postfix(x_filename);
+        const string experiment = "ywrite";
+        const int chunk_rows = argc == 4 ? stoi(argv[3]) : YWriterConfig().chunk_rows;
+
+        reset_log_experiment(postfix, experiment);
+
+        CSR X = load_X_h5_as_csr(x_path, "");
+        int W_rows, W_cols;
+        vector<float> W = load_W_h5(w_path, W_rows, W_cols, "");
+        vector<float> Y = spmm_baseline(X, W, W_rows, W_cols);
+        const int rows = X.nrows;
+        const string y_path = "../dataset/Y/ywrite_" + postfix + ".h5";
+
+        stringstream ss;
+        ss << fixed << setprecision(3);
+        ss << "Y: " << rows << " x " << W_cols << " (" << Y.size() * sizeof(float) / 1e6 << " MB)"
+           << ", chunk_rows: " << chunk_rows << endl;
+
+        struct Variant {
+            string name;
+            YWriterConfig cfg;
+        };
+        vector<Variant> variants;
+        YWriterConfig cfg;
+        cfg.chunk_rows = 0;
+        variants.push_back({"contiguous", cfg});
+        cfg.chunk_rows = chunk_rows;
+        variants.push_back({"chunked", cfg});
+        cfg.compression = YCompression::Deflate;
+        cfg.deflate_level = 1;
+        variants.push_back({"deflate-1", cfg});
+        cfg.deflate_level = 4;
+        variants.push_back({"deflate-4", cfg});
+        cfg.num_threads = 1;
+        variants.push_back({"deflate-4 1 thread", cfg});
+        cfg.num_threads = YWriterConfig().num_threads;
+        cfg.compression = YCompression::LZ4;
+        variants.push_back({"lz4", cfg});
+
+        for (const auto& v : variants) {
+            YWriteStats st;
+            save_Y_h5(Y, rows, W_cols, y_path, v.cfg, &st, postfix);
+            ss << left << setw(20) << v.name << right << " " << st.compression << ": stored "
+               << st.stored_bytes / 1e6 << " MB (ratio " << (st.stored_bytes ? double(st.raw_bytes) / st.stored_bytes : 0.0)
+               << "), compress " << st.compress_ms << "ms, write " << st.write_ms << "ms, total "
+               << st.total_ms << "ms, " << st.mb_per_s << " MB/s, direct chunks " << st.direct_chunks
+               << ", mismatches " << count_mismatches(Y, y_path) << endl;
+        }
+
+        // Row slabs as they complete (out-of-core / pipelined use): one aligned and one unaligned slab size
+        cfg.compression = YCompression::Deflate;
+        for (int slab_rows : {chunk_rows, chunk_rows / 2 + 1}) {
+            if (slab_rows <= 0) continue;
+            YWriter writer(y_path, rows, W_cols, cfg);
+            for (int r0 = 0; r0 < rows; r0 += slab_rows) {
+                int n = min(slab_rows, rows - r0);
+                writer.write_rows(r0, n, Y.data() + static_cast<size_t>(r0) * W_cols);
+            }
+            writer.close();
+            const YWriteStats& st = writer.stats();
+            ss << "slabs of " << slab_rows << " rows: " << st.slabs << " slabs, direct chunks "
+               << st.direct_chunks << ", total " << st.total_ms << "ms, " << st.mb_per_s
+               << " MB/s, mismatches " << count_mismatches(Y, y_path) << endl;
+        }
+        remove(y_path.c_str());
+
+        // Errors are reported now, not swallowed
+        bool ok = try_save_Y_h5(Y, rows, W_cols, "/proc/ywrite_" + postfix + ".h5");
+        ss << "write to unwritable path reported: " << (ok ? "no" : "yes") << endl;
+
+        log_to_file_experiment(postfix, experiment, ss.str());
+        cout << ss.str();
+        cout << "spmm done" << endl;
+
+        return 0;
+
+    } catch (const exception& e) {
+        cerr << "  ✗ Error: " << e.what() << endl;
+        return 1;
+    }
+}
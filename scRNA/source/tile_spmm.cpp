@@ -11,6 +11,8 @@
 #include <filesystem>
 #include <omp.h>
 #include <cstring>
+#include <algorithm>
+#include <numeric>
 
 using namespace std;
 using namespace std::chrono;
@@ -45,7 +47,7 @@ CSR extract_tile_csr(const CSR& X, const Tile& tile) {
     X_tile.indices.resize(X_tile.nnz);
     X_tile.data.resize(X_tile.nnz);
     
-    vector<int> write_ptr = X_tile.indptr;
+    vector<int> write_ptr(X_tile.indptr.begin(), X_tile.indptr.end());
     for (int i = tile.row_start; i < tile.row_end; i++) {
         int tile_row = i - tile.row_start;
         int row_start = X.indptr[i];
@@ -131,6 +133,13 @@ vector<float> permute_dense_cols(const vector<float>& X_dense, int M, int K,
 vector<float> dense_spmm_cpu_tile(const float* X_dense, const float* W_dense,
                                   int M, int K, int N) {
     vector<float> Y_dense(M * N, 0.0f);
+    dense_spmm_cpu_tile_into(X_dense, W_dense, Y_dense, M, K, N);
+    return Y_dense;
+}
+
+void dense_spmm_cpu_tile_into(const float* X_dense, const float* W_dense, Span<float> Y_dense,
+                              int M, int K, int N, bool zero_Y) {
+    require_span_size(Y_dense, static_cast<size_t>(M) * N, "Y_dense");
     
     #ifdef _OPENMP
     #pragma omp parallel for
@@ -141,11 +150,13 @@ vector<float> dense_spmm_cpu_tile(const float* X_dense, const float* W_dense,
             for (int k = 0; k < K; k++) {
                 sum += X_dense[i * K + k] * W_dense[k * N + j];
             }
-            Y_dense[i * N + j] = sum;
+            if (zero_Y) {
+                Y_dense[i * N + j] = sum;
+            } else {
+                Y_dense[i * N + j] += sum;
+            }
         }
     }
-    
-    return Y_dense;
 }
 
 vector<float> dense_perm_spmm_tile(const CSR& X_tile, const vector<float>& W_tile, 
@@ -195,9 +206,10 @@ vector<float> dense_perm_spmm_tile(const CSR& X_tile, const vector<float>& W_til
         Y_tile_permuted.data(),            // M_tile × N
         M_tile, K_tile, N);
     #else
-    Y_tile_permuted = dense_spmm_cpu_tile(
+    dense_spmm_cpu_tile_into(
         X_dense_row_col_permuted.data(),   // M_tile × K_tile
         W_tile_row_permuted.data(),       // K_tile × N
+        Y_tile_permuted,                  // M_tile × N
         M_tile, K_tile, N);
     #endif
     
@@ -213,11 +225,212 @@ vector<float> sparse_spmm_tile(const CSR& X_tile, const vector<float>& W_tile,
     return spmm_baseline(X_tile, W_tile, W_tile_rows, W_cols);
 }
 
+TileCSRView extract_tile_csr(const CSR& X, const Tile& tile, TileArena& arena) {
+    TileCSRView X_tile;
+    X_tile.nrows = tile.row_end - tile.row_start;
+    X_tile.ncols = tile.col_end - tile.col_start;
+    X_tile.indptr = arena.alloc<int>(X_tile.nrows + 1);
+    
+    // First pass: count nnz per row in the tile
+    X_tile.indptr[0] = 0;
+    for (int i = tile.row_start; i < tile.row_end; i++) {
+        int tile_row = i - tile.row_start;
+        int row_nnz = 0;
+        for (int idx = X.indptr[i]; idx < X.indptr[i + 1]; idx++) {
+            int col = X.indices[idx];
+            if (col >= tile.col_start && col < tile.col_end) {
+                row_nnz++;
+            }
+        }
+        X_tile.indptr[tile_row + 1] = X_tile.indptr[tile_row] + row_nnz;
+    }
+    X_tile.nnz = X_tile.indptr[X_tile.nrows];
+    
+    // Second pass: copy data with remapped column indices
+    X_tile.indices = arena.alloc<int>(X_tile.nnz);
+    X_tile.data = arena.alloc<float>(X_tile.nnz);
+    for (int i = tile.row_start; i < tile.row_end; i++) {
+        int dest = X_tile.indptr[i - tile.row_start];
+        for (int idx = X.indptr[i]; idx < X.indptr[i + 1]; idx++) {
+            int col = X.indices[idx];
+            if (col >= tile.col_start && col < tile.col_end) {
+                X_tile.indices[dest] = col - tile.col_start;  // Remap to 0-based
+                X_tile.data[dest] = X.data[idx];
+                dest++;
+            }
+        }
+    }
+    
+    return X_tile;
+}
+
+float* extract_tile_W(const vector<float>& W, int W_rows, int W_cols, const Tile& tile, TileArena& arena) {
+    int W_tile_rows = tile.col_end - tile.col_start;
+    float* W_tile = arena.alloc<float>(static_cast<size_t>(W_tile_rows) * W_cols);
+    
+    for (int i = 0; i < W_tile_rows; i++) {
+        int orig_row = tile.col_start + i;
+        if (orig_row >= 0 && orig_row < W_rows) {
+            memcpy(W_tile + i * W_cols, W.data() + static_cast<size_t>(orig_row) * W_cols, W_cols * sizeof(float));
+        } else {
+            fill(W_tile + i * W_cols, W_tile + (i + 1) * W_cols, 0.0f);
+        }
+    }
+    
+    return W_tile;
+}
+
+/* Same ordering as create_row_new2old / create_col_new2old (descending nnz), into arena storage */
+static int* arena_new2old_desc(const size_t* nnz, int n, TileArena& arena) {
+    int* new2old = arena.alloc<int>(n);
+    iota(new2old, new2old + n, 0);
+    sort(new2old, new2old + n, [nnz](int a, int b) { return nnz[a] > nnz[b]; });
+    return new2old;
+}
+
+/* Steps (a) and (b) of dense_perm_spmm_tile: permuted dense X and W in arena storage */
+struct PermutedDenseTile {
+    int M = 0;
+    int K = 0;
+    int N = 0;
+    float* X = nullptr;          // M x K, rows and columns permuted
+    float* W = nullptr;          // K x N, rows permuted to match X's columns
+    int* row_new2old = nullptr;  // Permuted row -> tile row
+};
+
+static PermutedDenseTile prepare_dense_perm_tile(const TileCSRView& X_tile, const float* W_tile,
+                                                 int W_tile_rows, int W_cols, TileArena& arena) {
+    int M_tile = X_tile.nrows;
+    int K_tile = X_tile.ncols;
+    int N = W_cols;
+    size_t MK = static_cast<size_t>(M_tile) * K_tile;
+    
+    // Step (a): Convert CSR tile to dense M×K buffer
+    float* X_dense = arena.alloc<float>(MK);
+    fill(X_dense, X_dense + MK, 0.0f);
+    for (int i = 0; i < M_tile; i++) {
+        for (int idx = X_tile.indptr[i]; idx < X_tile.indptr[i + 1]; idx++) {
+            X_dense[i * K_tile + X_tile.indices[idx]] = X_tile.data[idx];
+        }
+    }
+    
+    // Step (b): Apply row/column permutation
+    size_t* nnz_per_row = arena.alloc<size_t>(M_tile);
+    for (int i = 0; i < M_tile; i++) {
+        nnz_per_row[i] = static_cast<size_t>(X_tile.indptr[i + 1] - X_tile.indptr[i]);
+    }
+    int* row_new2old = arena_new2old_desc(nnz_per_row, M_tile, arena);
+    float* X_dense_row_permuted = arena.alloc<float>(MK);
+    for (int new_row = 0; new_row < M_tile; new_row++) {
+        memcpy(X_dense_row_permuted + new_row * K_tile, X_dense + row_new2old[new_row] * K_tile,
+               K_tile * sizeof(float));
+    }
+    
+    size_t* nnz_per_col = arena.alloc<size_t>(K_tile);
+    fill(nnz_per_col, nnz_per_col + K_tile, size_t(0));
+    for (int i = 0; i < M_tile; i++) {
+        for (int k = 0; k < K_tile; k++) {
+            if (X_dense_row_permuted[i * K_tile + k] != 0.0f) {
+                nnz_per_col[k]++;
+            }
+        }
+    }
+    int* col_new2old = arena_new2old_desc(nnz_per_col, K_tile, arena);
+    
+    if (K_tile != W_tile_rows) {
+        throw runtime_error("dense_perm_spmm_tile: column permutation size mismatch");
+    }
+    
+    float* X_dense_row_col_permuted = arena.alloc<float>(MK);
+    for (int i = 0; i < M_tile; i++) {
+        for (int new_col = 0; new_col < K_tile; new_col++) {
+            X_dense_row_col_permuted[i * K_tile + new_col] = X_dense_row_permuted[i * K_tile + col_new2old[new_col]];
+        }
+    }
+    float* W_tile_row_permuted = arena.alloc<float>(static_cast<size_t>(K_tile) * N);
+    for (int new_row = 0; new_row < K_tile; new_row++) {
+        memcpy(W_tile_row_permuted + new_row * N, W_tile + col_new2old[new_row] * N, N * sizeof(float));
+    }
+    
+    PermutedDenseTile d;
+    d.M = M_tile;
+    d.K = K_tile;
+    d.N = N;
+    d.X = X_dense_row_col_permuted;
+    d.W = W_tile_row_permuted;
+    d.row_new2old = row_new2old;
+    return d;
+}
+
+void dense_perm_spmm_tile(const TileCSRView& X_tile, const float* W_tile,
+                          int W_tile_rows, int W_cols, float* Y_tile, TileArena& arena) {
+    PermutedDenseTile d = prepare_dense_perm_tile(X_tile, W_tile, W_tile_rows, W_cols, arena);
+    int M_tile = d.M;
+    int K_tile = d.K;
+    int N = d.N;
+    
+    // Step (c): Call either CUDA or CPU GEMM
+    float* Y_tile_permuted = arena.alloc<float>(static_cast<size_t>(M_tile) * N);
+    
+    #ifdef USE_CUDA
+    fill(Y_tile_permuted, Y_tile_permuted + static_cast<size_t>(M_tile) * N, 0.0f);
+    dense_spmm_cuda_tile(d.X, d.W, Y_tile_permuted, M_tile, K_tile, N);
+    #else
+    dense_spmm_cpu_tile_into(d.X, d.W, Span<float>(Y_tile_permuted, static_cast<size_t>(M_tile) * N),
+                             M_tile, K_tile, N);
+    #endif
+    
+    // Step (d): Unpermute the Y rows into the caller's buffer
+    for (int i_new = 0; i_new < M_tile; i_new++) {
+        memcpy(Y_tile + d.row_new2old[i_new] * N, Y_tile_permuted + i_new * N, N * sizeof(float));
+    }
+}
+
+void sparse_spmm_tile(const TileCSRView& X_tile, const float* W_tile,
+                      int W_tile_rows, int W_cols, float* Y_tile) {
+    if (X_tile.ncols != W_tile_rows) {
+        throw runtime_error("Matrix dimension mismatch: X.ncols=" + to_string(X_tile.ncols) 
+                           + " != W.nrows=" + to_string(W_tile_rows));
+    }
+    
+    // Same loop as spmm_baseline, writing into arena storage
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < X_tile.nrows; i++) {
+        float* y = Y_tile + i * W_cols;
+        for (int j = 0; j < W_cols; j++) y[j] = 0.0f;
+        
+        for (int idx = X_tile.indptr[i]; idx < X_tile.indptr[i + 1]; idx++) {
+            int k = X_tile.indices[idx];
+            float x_val = X_tile.data[idx];
+            
+            for (int j = 0; j < W_cols; j++) {
+                y[j] += x_val * W_tile[k * W_cols + j];
+            }
+        }
+    }
+}
+
 vector<float> process_tiles_with_predictor(const CSR& X_original, 
                                           const vector<float>& W_original,
                                           int W_rows, int W_cols,
                                           const vector<Tile>& tiles,
-                                          const string& log_annotation) {
+                                          const string& log_annotation,
+                                          SpmmStats* stats,
+                                          const AccelRouting* accel) {
+    vector<float> Y_final = make_huge_page_vector<float>(static_cast<size_t>(X_original.nrows) * W_cols);
+    process_tiles_with_predictor_into(X_original, W_original, W_rows, W_cols, tiles, Y_final, false,
+                                      log_annotation, stats, accel);
+    return Y_final;
+}
+
+void process_tiles_with_predictor_into(const CSR& X_original,
+                                       const vector<float>& W_original,
+                                       int W_rows, int W_cols,
+                                       const vector<Tile>& tiles,
+                                       Span<float> Y_final, bool zero_Y,
+                                       const string& log_annotation,
+                                       SpmmStats* stats,
+                                       const AccelRouting* accel) {
     // Log OpenMP thread information
     if (!log_annotation.empty()) {
         int max_threads = omp_get_max_threads();
@@ -232,7 +445,14 @@ vector<float> process_tiles_with_predictor(const CSR& X_original,
     
     int Y_rows = X_original.nrows;
     int Y_cols = W_cols;
-    vector<float> Y_final(Y_rows * Y_cols, 0.0f);
+    require_span_size(Y_final, static_cast<size_t>(Y_rows) * Y_cols, "Y");
+    if (zero_Y) {
+        fill(Y_final.begin(), Y_final.begin() + static_cast<size_t>(Y_rows) * Y_cols, 0.0f);
+    }
+    
+    if (stats != nullptr) {
+        reset_spmm_stats(*stats, X_original.nrows, X_original.ncols);
+    }
     
     // Start timing
     auto start_time = high_resolution_clock::now();
@@ -245,22 +465,132 @@ vector<float> process_tiles_with_predictor(const CSR& X_original,
     size_t cuda_dense_tiles = 0;
     #endif
     size_t cpu_dense_tiles = 0;
+    size_t accel_dense_tiles = 0;
+    
+    // Size this thread's arena for the largest tile once; every tile then reuses the block
+    TileArena& arena = thread_tile_arena();
+    int max_tile_rows = 0, max_tile_cols = 0;
+    for (const auto& tile : tiles) {
+        max_tile_rows = max(max_tile_rows, tile.row_end - tile.row_start);
+        max_tile_cols = max(max_tile_cols, tile.col_end - tile.col_start);
+    }
+    arena.reserve(tile_arena_bytes(max_tile_rows, max_tile_cols, W_cols));
+    
+    // Tile results are folded into Y in tile order. While a device tile is outstanding, later
+    // results wait in a ring of max_in_flight slots, so Y does not depend on when the device
+    // finishes. Slot buffers are sized for the largest tile and allocated once per call.
+    AccelBackend* backend = accel != nullptr ? accel->backend : nullptr;
+    struct PendingTile {
+        const Tile* tile = nullptr;
+        float* Y = nullptr;               // Tile rows x W_cols (device tiles: permuted rows)
+        int* row_new2old = nullptr;       // Device tiles only
+        float* X_dense = nullptr;         // Device inputs, kept until the job completes
+        float* W_dense = nullptr;
+        bool on_device = false;
+        AccelTicket ticket = 0;
+    };
+    size_t ring_depth = backend != nullptr ? static_cast<size_t>(max(1, accel->max_in_flight)) : 0;
+    size_t slot_X = static_cast<size_t>(max_tile_rows) * max_tile_cols;
+    size_t slot_W = static_cast<size_t>(max_tile_cols) * W_cols;
+    size_t slot_Y = static_cast<size_t>(max_tile_rows) * W_cols;
+    vector<float> ring_floats(ring_depth * (slot_X + slot_W + slot_Y));
+    vector<int> ring_ints(ring_depth * static_cast<size_t>(max_tile_rows));
+    vector<PendingTile> ring(ring_depth);
+    for (size_t s = 0; s < ring_depth; s++) {
+        float* base = ring_floats.data() + s * (slot_X + slot_W + slot_Y);
+        ring[s].X_dense = base;
+        ring[s].W_dense = base + slot_X;
+        ring[s].Y = base + slot_X + slot_W;
+        ring[s].row_new2old = ring_ints.data() + s * static_cast<size_t>(max_tile_rows);
+    }
+    size_t ring_head = 0, ring_count = 0;
+    struct PendingGuard {
+        vector<PendingTile>& ring;
+        size_t& head;
+        size_t& count;
+        AccelBackend* b;
+        ~PendingGuard() {
+            // Jobs still reference the slot buffers if a tile threw
+            for (size_t i = 0; i < count; i++) {
+                PendingTile& p = ring[(head + i) % ring.size()];
+                if (p.on_device) b->wait(p.ticket);
+            }
+        }
+    } pending_guard{ring, ring_head, ring_count, backend};
+    
+    auto fold_tile = [&](const Tile& tile, const float* Y_tile, const int* row_new2old) {
+        int tile_rows = tile.row_end - tile.row_start;
+        for (int i = 0; i < tile_rows; i++) {
+            int global_row = tile.row_start + (row_new2old != nullptr ? row_new2old[i] : i);
+            for (int j = 0; j < Y_cols; j++) {
+                Y_final[global_row * Y_cols + j] += Y_tile[i * Y_cols + j];
+            }
+        }
+    };
+    auto fold_front = [&]() {
+        PendingTile& p = ring[ring_head];
+        fold_tile(*p.tile, p.Y, p.on_device ? p.row_new2old : nullptr);
+        p.tile = nullptr;
+        p.on_device = false;
+        ring_head = (ring_head + 1) % ring_depth;
+        ring_count--;
+    };
+    auto drain = [&](bool block) {
+        while (ring_count > 0) {
+            PendingTile& p = ring[ring_head];
+            if (p.on_device) {
+                if (block) {
+                    backend->wait(p.ticket);
+                } else if (!backend->poll(p.ticket)) {
+                    break;
+                }
+            }
+            fold_front();
+        }
+    };
+    // Next free slot; when the ring is full, wait for the oldest tile and fold it first
+    auto push_slot = [&](const Tile& tile) -> PendingTile& {
+        if (ring_count == ring_depth) {
+            PendingTile& front = ring[ring_head];
+            if (front.on_device) backend->wait(front.ticket);
+            fold_front();
+        }
+        PendingTile& p = ring[(ring_head + ring_count) % ring_depth];
+        p.tile = &tile;
+        p.on_device = false;
+        ring_count++;
+        return p;
+    };
     
     // Process each tile
     for (const auto& tile : tiles) {
+        arena.reset();
+        
         // Extract tile as standalone CSR
-        CSR X_tile = extract_tile_csr(X_original, tile);
+        TileCSRView X_tile = extract_tile_csr(X_original, tile, arena);
         
         // Extract corresponding W rows
-        vector<float> W_tile = extract_tile_W(W_original, W_rows, W_cols, tile);
+        float* W_tile = extract_tile_W(W_original, W_rows, W_cols, tile, arena);
         int W_tile_rows = tile.col_end - tile.col_start;
         
-        vector<float> Y_tile;
+        float* Y_tile = nullptr;
+        bool offloaded = backend != nullptr && tile.density() >= accel->threshold;
         
         // Route based on density threshold
-        if (tile.density() >= hw_config::DENSE_TILE_THRESHOLD) {
+        if (offloaded) {
+            // Accelerator: prepare on the host, copy into a ring slot that outlives the arena, submit
+            PermutedDenseTile d = prepare_dense_perm_tile(X_tile, W_tile, W_tile_rows, W_cols, arena);
+            PendingTile& p = push_slot(tile);
+            memcpy(p.X_dense, d.X, static_cast<size_t>(d.M) * d.K * sizeof(float));
+            memcpy(p.W_dense, d.W, static_cast<size_t>(d.K) * d.N * sizeof(float));
+            memcpy(p.row_new2old, d.row_new2old, d.M * sizeof(int));
+            p.ticket = backend->submit_gemm(p.X_dense, p.W_dense, p.Y, d.M, d.K, d.N);
+            p.on_device = true;
+            accel_dense_tiles++;
+        } else if (tile.density() >= hw_config::DENSE_TILE_THRESHOLD) {
             // Dense tile: use dense materialization + CUDA/CPU GEMM
-            Y_tile = dense_perm_spmm_tile(X_tile, W_tile, W_tile_rows, W_cols);
+            Y_tile = arena.alloc<float>(static_cast<size_t>(X_tile.nrows) * W_cols);
+            dense_perm_spmm_tile(X_tile, W_tile, W_tile_rows, W_cols, Y_tile, arena);
             #ifdef USE_CUDA
             cuda_dense_tiles++;
             #else
@@ -268,7 +598,24 @@ vector<float> process_tiles_with_predictor(const CSR& X_original,
             #endif
         } else {
             // Sparse tile: direct SpMM (CSR-based with OpenMP)
-            Y_tile = sparse_spmm_tile(X_tile, W_tile, W_tile_rows, W_cols);
+            Y_tile = arena.alloc<float>(static_cast<size_t>(X_tile.nrows) * W_cols);
+            sparse_spmm_tile(X_tile, W_tile, W_tile_rows, W_cols, Y_tile);
+        }
+        
+        // Fold tile QC stats into the sink while X_tile is still hot
+        if (stats != nullptr) {
+            for (int i = 0; i < X_tile.nrows; i++) {
+                int global_row = tile.row_start + i;
+                for (int idx = X_tile.indptr[i]; idx < X_tile.indptr[i + 1]; idx++) {
+                    int global_col = tile.col_start + X_tile.indices[idx];
+                    double x_val = X_tile.data[idx];
+                    stats->row_nnz[global_row]++;
+                    stats->row_sum[global_row] += x_val;
+                    stats->row_sumsq[global_row] += x_val * x_val;
+                    stats->col_nnz[global_col]++;
+                    stats->col_sum[global_col] += x_val;
+                }
+            }
         }
         
         // Accumulate metrics
@@ -283,15 +630,21 @@ vector<float> process_tiles_with_predictor(const CSR& X_original,
         size_t bytes_Y = static_cast<size_t>(X_tile.nrows) * W_cols * sizeof(float) * 2; // read + write
         total_bytes += bytes_X_data + bytes_X_indices + bytes_X_indptr + bytes_W + bytes_Y;
         
-        // Accumulate results into final Y (map tile rows back to global rows)
-        int tile_rows = tile.row_end - tile.row_start;
-        for (int i = 0; i < tile_rows; i++) {
-            int global_row = tile.row_start + i;
-            for (int j = 0; j < Y_cols; j++) {
-                Y_final[global_row * Y_cols + j] += Y_tile[i * Y_cols + j];
+        // Accumulate results into final Y (map tile rows back to global rows), or queue them
+        // behind an outstanding device tile
+        if (!offloaded) {
+            if (ring_count == 0) {
+                fold_tile(tile, Y_tile, nullptr);
+            } else {
+                PendingTile& p = push_slot(tile);
+                memcpy(p.Y, Y_tile, static_cast<size_t>(X_tile.nrows) * Y_cols * sizeof(float));
             }
         }
+        if (backend != nullptr) {
+            drain(!accel->overlap);
+        }
     }
+    drain(true);
     
     // End timing
     auto end_time = high_resolution_clock::now();
@@ -309,6 +662,11 @@ vector<float> process_tiles_with_predictor(const CSR& X_original,
         ss << "CPU dense tiles: " << cpu_dense_tiles << endl;
         log_to_file_tilepredpermspmm(log_annotation, ss.str());
         #endif
+        if (backend != nullptr) {
+            stringstream acc;
+            acc << "Accelerator dense tiles: " << accel_dense_tiles << " (" << backend->name() << ")" << endl;
+            log_to_file_tilepredpermspmm(log_annotation, acc.str());
+        }
     }
     
     // Log metrics
@@ -411,7 +769,4 @@ vector<float> process_tiles_with_predictor(const CSR& X_original,
             }
         }
     }
-    
-    return Y_final;
 }
-
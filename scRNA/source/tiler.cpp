@@ -1,4 +1,5 @@
 #include "../include/tiler.hpp"
+#include "../include/static_tiling.hpp"
 #include "../include/logger.hpp"
 #include <algorithm>
 #include <cmath>
@@ -11,6 +12,15 @@ vector<Tile> make_2d_tiles(const CSR& X_prime, const TilingConfig& cfg, const st
     int T_R = cfg.tile_rows;
     int T_C = cfg.tile_cols;
     
+    // Power-of-two shapes: same tiles from the compile-time engine
+    if (const StaticTilingKernels* st = find_static_tiling(cfg)) {
+        vector<Tile> tiles = st->make_tiles(X_prime);
+        if (!log_annotation.empty()) {
+            log_tiler_metrics(log_annotation, tiles.size());
+        }
+        return tiles;
+    }
+    
     // Calculate number of tiles in each dimension
     int num_row_tiles = static_cast<int>(ceil(static_cast<double>(n_rows) / T_R));
     int num_col_tiles = static_cast<int>(ceil(static_cast<double>(n_cols) / T_C));
@@ -0,0 +1,243 @@
+#include "../include/y_writer.hpp"
+#include "../include/logger.hpp"
+#include <H5Cpp.h>
+#include <zlib.h>
+#include <omp.h>
+#include <stdexcept>
+#include <filesystem>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+
+using namespace std;
+using namespace H5;
+namespace fs = std::filesystem;
+
+/* Registered id of the HDF5 LZ4 filter plugin */
+static const H5Z_filter_t H5Z_FILTER_LZ4_PLUGIN = 32004;
+
+static double ms_since(chrono::high_resolution_clock::time_point t) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - t).count() / 1000.0;
+}
+
+YWriter::YWriter(const string& path, int rows, int cols, const YWriterConfig& cfg)
+    : path_(path), rows_(rows), cols_(cols), cfg_(cfg), deflate_(false),
+      start_(chrono::high_resolution_clock::now()) {
+    if (rows < 0 || cols < 0) {
+        throw runtime_error("Y writer: invalid shape " + to_string(rows) + " x " + to_string(cols));
+    }
+    chunk_rows_ = (cfg.chunk_rows > 0 && rows > 0 && cols > 0) ? min(cfg.chunk_rows, rows) : 0;
+    stats_.layout = chunk_rows_ > 0 ? "chunked" : "contiguous";
+    stats_.compression = "none";
+
+    try {
+        fs::path parent = fs::path(path).parent_path();
+        if (!parent.empty()) fs::create_directories(parent);
+
+        file_ = make_unique<H5File>(path, H5F_ACC_TRUNC);
+        hsize_t dims[2] = {static_cast<hsize_t>(rows), static_cast<hsize_t>(cols)};
+        DataSpace space(2, dims);
+        DSetCreatPropList plist;
+        if (chunk_rows_ > 0) {
+            hsize_t chunk[2] = {static_cast<hsize_t>(chunk_rows_), static_cast<hsize_t>(cols)};
+            plist.setChunk(2, chunk);
+
+            YCompression compression = cfg.compression;
+            string fallback;
+            if (compression == YCompression::LZ4 && H5Zfilter_avail(H5Z_FILTER_LZ4_PLUGIN) <= 0) {
+                compression = YCompression::Deflate;
+                fallback = " (lz4 filter not available)";
+            }
+            if (compression == YCompression::LZ4) {
+                plist.setFilter(H5Z_FILTER_LZ4_PLUGIN, H5Z_FLAG_MANDATORY, 0, nullptr);
+                stats_.compression = "lz4";
+            } else if (compression == YCompression::Deflate) {
+                int level = max(1, min(9, cfg.deflate_level));
+                if (cfg.shuffle) plist.setShuffle();
+                plist.setDeflate(level);
+                deflate_ = true;
+                stats_.compression = "deflate-" + to_string(level) + (cfg.shuffle ? "+shuffle" : "") + fallback;
+            }
+        } else if (cfg.compression != YCompression::None) {
+            stats_.compression = "none (contiguous layout)";
+        }
+        dataset_ = make_unique<DataSet>(file_->createDataSet("Y", PredType::NATIVE_FLOAT, space, plist));
+    } catch (Exception& e) {
+        throw runtime_error("HDF5 error creating Y in " + path + ": " + e.getDetailMsg());
+    } catch (const fs::filesystem_error& e) {
+        throw runtime_error("Cannot create output directory for " + path + ": " + e.what());
+    }
+}
+
+YWriter::~YWriter() {
+    try {
+        close();
+    } catch (...) {
+        // Destructors must not throw; call close() to see write errors
+    }
+}
+
+bool YWriter::direct_chunk_slab(int row_begin, int row_count) const {
+    if (!deflate_ || row_count <= 0) return false;
+    if (row_begin % chunk_rows_ != 0) return false;
+    return row_count % chunk_rows_ == 0 || row_begin + row_count == rows_;
+}
+
+void YWriter::write_rows(int row_begin, int row_count, const float* slab) {
+    if (!dataset_) {
+        throw runtime_error("Y writer: " + path_ + " is already closed");
+    }
+    if (row_begin < 0 || row_count < 0 || row_begin + row_count > rows_) {
+        throw runtime_error("Y writer: rows [" + to_string(row_begin) + ", " + to_string(row_begin + row_count)
+                           + ") out of range for " + to_string(rows_) + " rows");
+    }
+    if (row_count == 0 || cols_ == 0) return;
+
+    if (direct_chunk_slab(row_begin, row_count)) {
+        write_direct_chunks(row_begin, row_count, slab);
+    } else {
+        write_hyperslab(row_begin, row_count, slab);
+    }
+    stats_.slabs++;
+    stats_.raw_bytes += static_cast<size_t>(row_count) * cols_ * sizeof(float);
+}
+
+void YWriter::write_hyperslab(int row_begin, int row_count, const float* slab) {
+    auto start = chrono::high_resolution_clock::now();
+    try {
+        hsize_t offset[2] = {static_cast<hsize_t>(row_begin), 0};
+        hsize_t count[2] = {static_cast<hsize_t>(row_count), static_cast<hsize_t>(cols_)};
+        DataSpace file_space = dataset_->getSpace();
+        file_space.selectHyperslab(H5S_SELECT_SET, count, offset);
+        DataSpace mem_space(2, count);
+        dataset_->write(slab, PredType::NATIVE_FLOAT, mem_space, file_space);
+    } catch (Exception& e) {
+        throw runtime_error("HDF5 error writing Y rows to " + path_ + ": " + e.getDetailMsg());
+    }
+    stats_.write_ms += ms_since(start);
+}
+
+void YWriter::write_direct_chunks(int row_begin, int row_count, const float* slab) {
+    const int n_chunks = (row_count + chunk_rows_ - 1) / chunk_rows_;
+    const size_t chunk_elems = static_cast<size_t>(chunk_rows_) * cols_;
+    const size_t chunk_bytes = chunk_elems * sizeof(float);
+    const int level = max(1, min(9, cfg_.deflate_level));
+    vector<vector<unsigned char>> packed(n_chunks);
+    int failed_chunk = -1;
+
+    // Same filter pipeline HDF5 would run (shuffle, then zlib deflate), one chunk per task
+    auto start = chrono::high_resolution_clock::now();
+    #pragma omp parallel num_threads(max(1, cfg_.num_threads))
+    {
+        vector<float> padded;
+        vector<unsigned char> shuffled;
+        #pragma omp for schedule(dynamic, 1)
+        for (int c = 0; c < n_chunks; c++) {
+            int r0 = c * chunk_rows_;
+            int n = min(chunk_rows_, row_count - r0);
+            const float* src = slab + static_cast<size_t>(r0) * cols_;
+            if (n < chunk_rows_) {
+                // Edge chunk: HDF5 stores chunks at full size
+                padded.assign(chunk_elems, 0.0f);
+                memcpy(padded.data(), src, static_cast<size_t>(n) * cols_ * sizeof(float));
+                src = padded.data();
+            }
+            const unsigned char* bytes = reinterpret_cast<const unsigned char*>(src);
+            if (cfg_.shuffle) {
+                shuffled.resize(chunk_bytes);
+                for (size_t i = 0; i < chunk_elems; i++) {
+                    for (size_t b = 0; b < sizeof(float); b++) {
+                        shuffled[b * chunk_elems + i] = bytes[i * sizeof(float) + b];
+                    }
+                }
+                bytes = shuffled.data();
+            }
+            uLongf len = compressBound(chunk_bytes);
+            packed[c].resize(len);
+            if (compress2(packed[c].data(), &len, bytes, chunk_bytes, level) != Z_OK) {
+                #pragma omp critical
+                failed_chunk = c;
+            } else {
+                packed[c].resize(len);
+            }
+        }
+    }
+    stats_.compress_ms += ms_since(start);
+    if (failed_chunk >= 0) {
+        throw runtime_error("Y writer: zlib failed to compress chunk at row "
+                           + to_string(row_begin + failed_chunk * chunk_rows_) + " of " + path_);
+    }
+
+    start = chrono::high_resolution_clock::now();
+    for (int c = 0; c < n_chunks; c++) {
+        hsize_t offset[2] = {static_cast<hsize_t>(row_begin + c * chunk_rows_), 0};
+        if (H5Dwrite_chunk(dataset_->getId(), H5P_DEFAULT, 0, offset, packed[c].size(), packed[c].data()) < 0) {
+            throw runtime_error("HDF5 error writing Y chunk at row " + to_string(offset[0]) + " to " + path_);
+        }
+        stats_.direct_chunks++;
+    }
+    stats_.write_ms += ms_since(start);
+}
+
+void YWriter::close() {
+    if (!file_) return;
+    try {
+        stats_.stored_bytes = dataset_->getStorageSize();
+        dataset_->close();
+        file_->close();
+    } catch (Exception& e) {
+        dataset_.reset();
+        file_.reset();
+        throw runtime_error("HDF5 error closing Y file " + path_ + ": " + e.getDetailMsg());
+    }
+    dataset_.reset();
+    file_.reset();
+    stats_.total_ms = ms_since(start_);
+    stats_.mb_per_s = stats_.total_ms > 0.0 ? stats_.raw_bytes / (stats_.total_ms * 1e3) : 0.0;
+}
+
+void save_Y_h5(const vector<float>& Y, int rows, int cols, const string& path,
+               const YWriterConfig& cfg, YWriteStats* stats, const string& log_annotation) {
+    size_t needed = static_cast<size_t>(rows) * cols;
+    if (Y.size() < needed) {
+        throw runtime_error("Matrix dimension mismatch: Y has " + to_string(Y.size())
+                           + " elements, needs " + to_string(rows) + " x " + to_string(cols));
+    }
+    YWriter writer(path, rows, cols, cfg);
+    writer.write_rows(0, rows, Y.data());
+    writer.close();
+    const YWriteStats& st = writer.stats();
+    if (stats) *stats = st;
+
+    if (!log_annotation.empty()) {
+        stringstream ss;
+        ss << fixed << setprecision(3);
+        ss << "Y write: " << path << ", " << rows << " x " << cols << ", " << st.layout
+           << ", compression: " << st.compression << ", raw " << st.raw_bytes / 1e6 << " MB, stored "
+           << st.stored_bytes / 1e6 << " MB, compress " << st.compress_ms << "ms, write " << st.write_ms
+           << "ms, total " << st.total_ms << "ms (" << st.mb_per_s << " MB/s)" << endl;
+        log_to_file_experiment(log_annotation, "ywrite", ss.str());
+    }
+}
+
+bool try_save_Y_h5(const vector<float>& Y, int rows, int cols, const string& path,
+                   const YWriterConfig& cfg, const string& log_annotation) {
+    // The failure is reported in one line below: keep HDF5's error stack off stderr meanwhile,
+    // and give the caller back whatever handler it had installed
+    H5E_auto2_t saved_func = nullptr;
+    void* saved_data = nullptr;
+    H5Eget_auto2(H5E_DEFAULT, &saved_func, &saved_data);
+    H5Eset_auto2(H5E_DEFAULT, nullptr, nullptr);
+
+    bool saved = true;
+    try {
+        save_Y_h5(Y, rows, cols, path, cfg, nullptr, log_annotation);
+    } catch (const exception& e) {
+        cerr << "  ✗ Error saving Y to " << path << ": " << e.what() << endl;
+        saved = false;
+    }
+    H5Eset_auto2(H5E_DEFAULT, saved_func, saved_data);
+    return saved;
+}